@@ -0,0 +1,230 @@
+/*
+ * Run functions on secondary CPUs, powered on and off with PSCI
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+/*
+ * U-Boot normally leaves the secondary CPUs powered off in the PSCI
+ * firmware. mp_run_start() powers one on with CPU_ON at mp_run_entry, which
+ * enables the MMU with the boot CPU's page tables, so both CPUs see the same
+ * coherent memory, and calls the function on a stack of its own. When the
+ * function returns the CPU sets @done and powers itself off again with
+ * CPU_OFF.
+ *
+ * Only CPUs with enable-method = "psci" in the control device tree are
+ * used, and only when U-Boot runs below EL3, i.e. when there is PSCI
+ * firmware to call.
+ */
+
+#include <common.h>
+#include <fdtdec.h>
+#include <malloc.h>
+#include <mp_run.h>
+#include <watchdog.h>
+#include <asm/cache.h>
+#include <asm/psci.h>
+#include <asm/system.h>
+#include <asm/armv8/mmu.h>
+#include <linux/compiler.h>
+#include <linux/psci.h>
+
+DECLARE_GLOBAL_DATA_PTR;
+
+#define MP_RUN_MAX_CPUS		8
+#define MP_RUN_STACK_SIZE	(16 * 1024)
+
+/* How long a CPU may take to come out of CPU_ON and reach its function */
+#define MP_RUN_START_TIMEOUT_MS	100
+
+/*
+ * Callers give each CPU about the same share of the work and do their own
+ * share before waiting, so a CPU taking several times as long as they did
+ * has faulted or hung rather than fallen behind
+ */
+#define MP_RUN_DONE_FACTOR	4
+#define MP_RUN_DONE_MIN_US	(1000 * 1000)
+
+/*
+ * Everything mp_run_entry needs before the MMU is on comes first, at the
+ * offsets it expects, and is flushed to memory by mp_run_start()
+ */
+struct mp_run_cpu {
+	u64 sp;
+	u64 gd;
+	u64 ttbr;
+	u64 tcr;
+	u64 mair;
+	u64 el;			/* CurrentEL value the CPU must start in */
+	void (*func)(void *arg);
+	void *arg;
+
+	u64 mpidr;
+	void *stack;
+	int started;		/* Set by the CPU once its MMU is on */
+	int done;		/* Set by the CPU once @func has returned */
+	bool broken;		/* Did not start or finish, do not use again */
+	ulong start_us;		/* timer_get_us() when it was started */
+} __aligned(ARCH_DMA_MINALIGN);
+
+static struct mp_run_cpu mp_run_cpus[MP_RUN_MAX_CPUS];
+static int mp_run_cpu_count;
+
+void mp_run_entry(void);
+
+static int mp_run_psci(u64 fn, u64 arg0, u64 arg1, u64 arg2)
+{
+	struct pt_regs regs;
+
+	regs.regs[0] = fn;
+	regs.regs[1] = arg0;
+	regs.regs[2] = arg1;
+	regs.regs[3] = arg2;
+	smc_call(&regs);
+
+	return regs.regs[0];
+}
+
+/* Find the CPUs that PSCI can start, other than this one */
+static int mp_run_find_cpus(void)
+{
+	const void *blob = gd->fdt_blob;
+	u64 self = read_mpidr() & 0xff00ffffffUL;
+	const char *method;
+	int node, parent, count = 1;
+	u64 mpidr;
+
+	parent = fdt_path_offset(blob, "/cpus");
+	if (parent < 0)
+		return count;
+
+	fdt_for_each_subnode(node, blob, parent) {
+		if (count == MP_RUN_MAX_CPUS)
+			break;
+		if (strcmp(fdt_getprop(blob, node, "device_type", NULL) ?: "",
+			   "cpu") || !fdtdec_get_is_enabled(blob, node))
+			continue;
+		method = fdt_getprop(blob, node, "enable-method", NULL);
+		if (!method || strcmp(method, "psci"))
+			continue;
+		mpidr = fdtdec_get_addr(blob, node, "reg");
+		if (mpidr == FDT_ADDR_T_NONE || mpidr == self)
+			continue;
+		mp_run_cpus[count++].mpidr = mpidr;
+	}
+
+	return count;
+}
+
+int mp_run_count(void)
+{
+	if (current_el() == 3 || !dcache_status() || !gd->fdt_blob)
+		return 1;
+	if (!mp_run_cpu_count)
+		mp_run_cpu_count = mp_run_find_cpus();
+
+	return mp_run_cpu_count;
+}
+
+int mp_run_start(int nr, void (*func)(void *arg), void *arg)
+{
+	struct mp_run_cpu *cpu = &mp_run_cpus[nr];
+	int el = current_el();
+	int ret;
+
+	if (nr < 1 || nr >= mp_run_count() || cpu->broken)
+		return -EINVAL;
+
+	if (!cpu->stack) {
+		cpu->stack = memalign(ARCH_DMA_MINALIGN, MP_RUN_STACK_SIZE);
+		if (!cpu->stack)
+			return -ENOMEM;
+	}
+
+	cpu->sp = (ulong)cpu->stack + MP_RUN_STACK_SIZE;
+	cpu->gd = (ulong)gd;
+	cpu->ttbr = gd->arch.tlb_addr;
+	cpu->tcr = get_tcr(el, NULL, NULL);
+	cpu->mair = MEMORY_ATTRIBUTES;
+	cpu->el = el << 2;
+	cpu->func = func;
+	cpu->arg = arg;
+	cpu->started = 0;
+	cpu->done = 0;
+
+	/*
+	 * The CPU reads its struct before its caches are on, and must not
+	 * find stale lines of its stack in ours once they are
+	 */
+	flush_dcache_range((ulong)cpu, (ulong)(cpu + 1));
+	flush_dcache_range((ulong)cpu->stack,
+			   (ulong)cpu->stack + MP_RUN_STACK_SIZE);
+
+	cpu->start_us = timer_get_us();
+	ret = mp_run_psci(ARM_PSCI_0_2_FN64_CPU_ON, cpu->mpidr,
+			  (ulong)mp_run_entry, (ulong)cpu);
+	if (ret != ARM_PSCI_RET_SUCCESS) {
+		debug("%s: CPU %llx not started (%d)\n", __func__, cpu->mpidr,
+		      ret);
+		return -EIO;
+	}
+
+	return 0;
+}
+
+int mp_run_wait(int nr)
+{
+	struct mp_run_cpu *cpu = &mp_run_cpus[nr];
+	ulong start = get_timer(0);
+	ulong now, limit;
+
+	if (nr < 1 || nr >= mp_run_count())
+		return -EINVAL;
+	while (!READ_ONCE(cpu->started)) {
+		if (get_timer(start) > MP_RUN_START_TIMEOUT_MS) {
+			printf("CPU %llx did not start\n", cpu->mpidr);
+			cpu->broken = true;
+			return -ETIMEDOUT;
+		}
+		WATCHDOG_RESET();
+	}
+
+	now = timer_get_us();
+	limit = max_t(ulong, (now - cpu->start_us) * MP_RUN_DONE_FACTOR,
+		      MP_RUN_DONE_MIN_US);
+	while (!READ_ONCE(cpu->done)) {
+		if (timer_get_us() - now > limit) {
+			printf("CPU %llx did not finish\n", cpu->mpidr);
+			cpu->broken = true;
+			return -ETIMEDOUT;
+		}
+		WATCHDOG_RESET();
+	}
+
+	/* Let CPU_OFF finish so that the CPU can be started again */
+	start = get_timer(0);
+	while (mp_run_psci(ARM_PSCI_0_2_FN64_AFFINITY_INFO, cpu->mpidr, 0, 0) !=
+	       PSCI_0_2_AFFINITY_LEVEL_OFF) {
+		if (get_timer(start) > MP_RUN_START_TIMEOUT_MS) {
+			cpu->broken = true;
+			break;
+		}
+	}
+
+	return 0;
+}
+
+/* Called by mp_run_entry on the secondary CPU, with the MMU on */
+void __noreturn mp_run_secondary(struct mp_run_cpu *cpu)
+{
+	WRITE_ONCE(cpu->started, 1);
+	cpu->func(cpu->arg);
+
+	dsb();
+	WRITE_ONCE(cpu->done, 1);
+	dsb();
+
+	mp_run_psci(ARM_PSCI_0_2_FN_CPU_OFF, 0, 0, 0);
+	while (1)
+		wfi();
+}
@@ -0,0 +1,27 @@
+/*
+ * Run functions on secondary CPUs, as host threads
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <mp_run.h>
+#include <os.h>
+
+int mp_run_count(void)
+{
+	return min(os_get_cpu_count(), OS_MAX_THREADS);
+}
+
+int mp_run_start(int cpu, void (*func)(void *arg), void *arg)
+{
+	if (cpu < 1 || cpu >= mp_run_count())
+		return -EINVAL;
+
+	return os_thread_start(cpu, func, arg);
+}
+
+int mp_run_wait(int cpu)
+{
+	return os_thread_join(cpu);
+}
@@ -7,6 +7,7 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <getopt.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdint.h>
 #include <stdlib.h>
@@ -628,3 +629,56 @@ void os_localtime(struct rtc_time *rt)
 	rt->tm_yday = tm->tm_yday;
 	rt->tm_isdst = tm->tm_isdst;
 }
+
+int os_get_cpu_count(void)
+{
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+
+	return count > 0 ? count : 1;
+}
+
+static struct os_thread {
+	pthread_t thread;
+	void (*func)(void *arg);
+	void *arg;
+	bool running;
+} os_threads[OS_MAX_THREADS];
+
+static void *os_thread_entry(void *data)
+{
+	struct os_thread *t = data;
+
+	t->func(t->arg);
+
+	return NULL;
+}
+
+int os_thread_start(int id, void (*func)(void *arg), void *arg)
+{
+	struct os_thread *t;
+
+	if (id < 0 || id >= OS_MAX_THREADS || os_threads[id].running)
+		return -EINVAL;
+	t = &os_threads[id];
+	t->func = func;
+	t->arg = arg;
+	if (pthread_create(&t->thread, NULL, os_thread_entry, t))
+		return -EAGAIN;
+	t->running = true;
+
+	return 0;
+}
+
+int os_thread_join(int id)
+{
+	struct os_thread *t;
+
+	if (id < 0 || id >= OS_MAX_THREADS || !os_threads[id].running)
+		return -EINVAL;
+	t = &os_threads[id];
+	t->running = false;
+	if (pthread_join(t->thread, NULL))
+		return -EINVAL;
+
+	return 0;
+}
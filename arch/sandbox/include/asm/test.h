@@ -79,4 +79,21 @@ long sandbox_i2c_rtc_get_set_base_time(struct udevice *dev, long base_time);
 
 int sandbox_usb_keyb_add_string(struct udevice *dev, const char *str);
 
+/**
+ * sandbox_crypto_set_chunk() - set how fast the sandbox crypto engine runs
+ *
+ * @dev:		Crypto device
+ * @chunk:		Number of bytes to hash each time the device is
+ *			polled, or 0 to stop it
+ */
+void sandbox_crypto_set_chunk(struct udevice *dev, uint chunk);
+
+/**
+ * sandbox_crypto_get_count() - get the number of jobs a device has run
+ *
+ * @dev:		Crypto device
+ * @return number of jobs finished since the device was probed
+ */
+int sandbox_crypto_get_count(struct udevice *dev);
+
 #endif
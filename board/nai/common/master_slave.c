@@ -10,18 +10,20 @@
 #include <dm/device.h>
 #include <serial.h>
 #include <watchdog.h>
+#include <crc.h>
 #include <master_slave.h>
 
 /* Local functions */
 static u32 send_req(CMD *req, u32 len, bool verbose);
 static u32 get_resp(CMD *resp, bool verbose);
 static void dump_cmd(CMD *resp, u32 len);
-static u32 uart1_rx(u8 *buf);
-static u32 uart1_tx(u8 *buf, u32 len);
+static int zynq_uart1_tstc(void);
+static int zynq_uart1_getc_nowait(void);
+static void zynq_uart1_putc(const char c);
 static u16 crc_ccitt(u8 *buf, u32 len);
-static u32 stuff_bytes(u8 *inbuf, u32 inlen, u8 *outbuf);
-static u32 encode_frame(u8 *inbuf, u32 inlen, u8 *outbuf, bool verbose);
-static u32 decode_frame(u8 *inbuf, u32 inlen, u8 *outbuf, bool verbose);
+static void tx_stuffed(u8 *buf, u32 len);
+static u32 encode_frame(u8 *inbuf, u32 inlen, bool verbose);
+static u32 decode_frame(u8 *outbuf, u32 outlen, bool verbose);
 
 /* Local variables */
 static struct udevice *uart1_dev = NULL;
@@ -81,10 +83,20 @@ u32 slave_echo(u8 *buf, u32 len, u8 *outbuf, bool verbose)
 }
 
 
+/*
+ * Reads of more than MAX_RW_COUNT values are split into several read
+ * requests. Up to SLAVE_PIPELINE_DEPTH of them are sent ahead, so the
+ * slave can work on the next one while the previous response is still
+ * coming in over the UART.
+ */
 u32 slave_read(u32 addr, u32 width, u32 count, u32 *buf, bool verbose)
 {
     CMD *req, *resp;
-    u32 txlen, rxlen;
+    u32 rxlen;
+    u32 sent = 0, done = 0;
+    u32 inflight = 0;
+    u32 chunk;
+    u32 ok = 1;
 
     /* Allocate memory for request buffer */
     req = (CMD *)malloc(sizeof(CMD));
@@ -106,34 +118,53 @@ u32 slave_read(u32 addr, u32 width, u32 count, u32 *buf, bool verbose)
     /* Prepare request command */
     req->cmd = CMD_READ;
     req->len = ADDR_SIZE + WIDTH_SIZE + COUNT_SIZE;
-    req->read.addr = addr;
     req->read.width = width;
-    req->read.count = count;
-    txlen = CMD_SIZE + LEN_SIZE + req->len;
 
-    /* Send request to slave */
-    send_req(req, txlen, verbose);
+    while (done < count)
+    {
+        /* Keep the pipeline full */
+        while (ok && (sent < count) && (inflight < SLAVE_PIPELINE_DEPTH))
+        {
+            chunk = min(count - sent, (u32)MAX_RW_COUNT);
+            req->read.addr = addr + (sent * width);
+            req->read.count = chunk;
+
+            /* Send request to slave */
+            send_req(req, CMD_SIZE + LEN_SIZE + req->len, verbose);
+            sent += chunk;
+            inflight++;
+        }
 
-    /* Wait for response from slave */
-    rxlen = get_resp(resp, verbose);
+        /* Nothing left to wait for after an error */
+        if (!inflight)
+            break;
 
-    /* Valid response? */
-    if (rxlen && resp->cmd == CMD_READ_RESP && resp->read_resp.addr == addr &&
-        resp->read_resp.width == width && resp->read_resp.count == count)
-    {
-        if (buf)
-            memcpy(buf, resp->read_resp.val8, width * count);
-    }
-    else
-    {
-        count = 0;
+        /* Wait for the oldest response from slave */
+        rxlen = get_resp(resp, verbose);
+        inflight--;
+        chunk = min(count - done, (u32)MAX_RW_COUNT);
+
+        /* Valid response? */
+        if (ok && rxlen && resp->cmd == CMD_READ_RESP &&
+            resp->read_resp.addr == addr + (done * width) &&
+            resp->read_resp.width == width && resp->read_resp.count == chunk)
+        {
+            if (buf)
+                memcpy((u8 *)buf + (done * width), resp->read_resp.val8, width * chunk);
+            done += chunk;
+        }
+        else
+        {
+            /* Stop sending, but collect what is still in flight */
+            ok = 0;
+        }
     }
 
     /* Free memory */
     free(req);
     free(resp);
 
-    return count;
+    return (ok ? count : 0);
 }
 
 
@@ -373,61 +404,22 @@ static void dump_cmd(CMD *resp, u32 len)
 
 u32 slave_rx(u8 *buf, bool verbose)
 {
-    u8  *rxbuf;
-    u32 rxlen;
-    u32 len = 0;
-
-    /* Allocate memory for RX buffer */
-    rxbuf = (u8 *)malloc(FRAME_BUFFER_SIZE);
-    if (!rxbuf)
-    {
-        printf("%s: no memory!\n", __FUNCTION__);
+    /* Received anything? */
+    if (!zynq_uart1_tstc())
         return 0;
-    }
-
-    /* Receive encoded frame */
-    rxlen = uart1_rx(rxbuf);
-
-    /* Decode it */
-    if (rxlen)
-        len = decode_frame(rxbuf, rxlen, buf, verbose);
-
-    /* Free memory */
-    free(rxbuf);
 
-    return len;
+    /* Decode it straight from the UART into buf */
+    return decode_frame(buf, sizeof(CMD), verbose);
 }
 
 
 u32 slave_tx(u8 *buf, u32 len, bool verbose)
 {
-    u8  *encbuf;
-    u32 enclen;
-
     Xil_AssertNonvoid(buf);
     Xil_AssertNonvoid((len >= MIN_CMD_LEN) && (len <= MAX_CMD_LEN));
 
-    /* Allocate memory for encode buffer */
-    encbuf = (u8 *)malloc(FRAME_BUFFER_SIZE);
-    if (!encbuf)
-    {
-        printf("%s: no memory!\n", __FUNCTION__);
-        return 0;
-    }
-
-    /* Encode it */
-    enclen = encode_frame(buf, len, encbuf, verbose);
-
-    /* Send encoded frame */
-    if (enclen)
-        len = uart1_tx(encbuf, enclen);
-    else
-        len = 0;
-
-    /* Free memory */
-    free(encbuf);
-
-    return len;
+    /* Encode it straight to the UART */
+    return encode_frame(buf, len, verbose);
 }
 
 /****************************** UART Routines ******************************/
@@ -469,6 +461,14 @@ static int zynq_uart1_getc(void) {
     return (err >= 0 ? err : 0);
 }
 
+/* Next byte from the RX FIFO, or -EAGAIN if it is empty */
+static int zynq_uart1_getc_nowait(void) {
+    if (!uart1_initialized)
+        return -EAGAIN;
+
+    return uart1_ops->getc(uart1_dev);
+}
+
 static void zynq_uart1_putc(const char c) {
     int err;
 
@@ -500,214 +500,167 @@ void uart1_loopback(bool en)
 }
 
 
-static u32 uart1_rx(u8 *buf)
-{
-    u32     len = 0;
-    u32     count, last_count = 0;
-    ulong   time = 0;
-
-    /* Received anything? */
-    if (!zynq_uart1_tstc())
-        return 0;
-
-    /* Get it */
-    while (1)
-    {
-        count = zynq_uart1_tstc();
-        if (count)
-            buf[len] = zynq_uart1_getc();
-
-        /* Finished receiving? */
-        if (count == 0)
-        {
-            /* Got EOF? */
-            if ((len > 1) && (buf[len - 1] == HDLC_FRAME_DELIMITER))
-                break;
-
-            if (last_count)
-            {
-                /* Start EOF timer */
-                time = get_timer(0);
-            }
-            else
-            {
-                /* Timeout? */
-                if (get_timer(time) > UART_FIFO_TIMEOUT)
-                    break;
-            }
-        }
-
-        /* Update counters */
-        last_count = count;
-        len += count;
-    }
-
-    return len;
-}
-
-
-static u32 uart1_tx(u8 *buf, u32 len)
-{
-    u32 count = 0;
-
-    /* Send it */
-    while (count < len)
-    {
-        zynq_uart1_putc(buf[count]);
-        ++count;
-    }
-
-    return count;
-}
-
 /****************************** HDLC Routines ******************************/
 
 static u16 crc_ccitt(u8 *buf, u32 len)
 {
-    u16 crc = 0xFFFF;
-    u8  *pBuf = buf;
-
-    while (len--)
-    {
-        crc = (crc >> 8) | (crc << 8);
-        crc ^= *pBuf++;
-        crc ^= (crc & 0xFF) >> 4;
-        crc ^= crc << 12;
-        crc ^= (crc & 0xFF) << 5;
-    }
-
-    return crc;
+    /* CRC-CCITT (x^16+x^12+x^5+1), initial value 0xFFFF, table driven */
+    return crc16_ccitt(0xFFFF, buf, len);
 }
 
 
-static u32 stuff_bytes(u8 *inbuf, u32 inlen, u8 *outbuf)
+/* Send buf to the UART, escaping delimiters on the way */
+static void tx_stuffed(u8 *buf, u32 len)
 {
     u8  data;
     u32 i;
-    u32 count = 0;
 
-    for (i = 0; i < inlen; ++i)
+    for (i = 0; i < len; ++i)
     {
-        data = inbuf[i];
+        data = buf[i];
         if (data == HDLC_FRAME_DELIMITER || data == HDLC_CONTROL_ESCAPE)
         {
+            zynq_uart1_putc(HDLC_CONTROL_ESCAPE);
             data ^= HDLC_ESCAPE_BIT;
-            *outbuf++ = HDLC_CONTROL_ESCAPE;
-            count++;
         }
 
-        *outbuf++ = data;
-        count++;
+        zynq_uart1_putc(data);
     }
-
-    return count;
 }
 
 
-static u32 encode_frame(u8 *inbuf, u32 inlen, u8 *outbuf, bool verbose)
+static u32 encode_frame(u8 *inbuf, u32 inlen, bool verbose)
 {
     u16 crc;
-    u32 len = 0;
-    u32 bytes;
-    u8  *pBuf = outbuf;
-
-    /* Insert SOF */
-    *pBuf++ = HDLC_FRAME_DELIMITER;
-    len++;
-
-    /* Encode data */
-    bytes = stuff_bytes(inbuf, inlen, pBuf);
-    pBuf += bytes;
-    len += bytes;
-
-    /* Encode CRC */
-    crc = crc_ccitt(inbuf, inlen);
-    bytes = stuff_bytes((u8 *)&crc, sizeof(crc), pBuf);
-    pBuf += bytes;
-    len += bytes;
-
-    /* Insert EOF */
-    *pBuf++ = HDLC_FRAME_DELIMITER;
-    len++;
 
     if (verbose)
     {
         printf("\n%s, inbuf (%lu bytes):\n", __FUNCTION__, (ulong)inlen);
         print_buffer((u32)inbuf, (void *)inbuf, 1, inlen, 0);
-        printf("\n%s: outbuf (%lu bytes):\n", __FUNCTION__, (ulong)len);
-        print_buffer((u32)outbuf, (void *)outbuf, 1, len, 0);
     }
 
-    return len;
+    crc = crc_ccitt(inbuf, inlen);
+
+    /* SOF, data, CRC, EOF */
+    zynq_uart1_putc(HDLC_FRAME_DELIMITER);
+    tx_stuffed(inbuf, inlen);
+    tx_stuffed((u8 *)&crc, sizeof(crc));
+    zynq_uart1_putc(HDLC_FRAME_DELIMITER);
+
+    return inlen;
 }
 
 
-static u32 decode_frame(u8 *inbuf, u32 inlen, u8 *outbuf, bool verbose)
+/*
+ * Receive one frame from the UART and decode it into outbuf. The RX FIFO
+ * is drained until it is empty before checking the time again, and the
+ * last two decoded bytes are held back since they turn out to be the CRC
+ * once the EOF shows up. Stops right after the EOF, so a following frame
+ * stays in the FIFO for the next call.
+ */
+static u32 decode_frame(u8 *outbuf, u32 outlen, bool verbose)
 {
-    u16 crc, crc_calc;
-    u8  data;
-    u32 i;
+    u16 crc, crc_calc = 0xFFFF;
+    u8  tail[CRC_SIZE];
+    u32 ntail = 0;
     u32 len = 0;
-    u8  *pBuf = outbuf;
+    u32 raw = 0;
+    int c;
+    bool sof = false;
+    bool esc = false;
+    bool eof = false;
+    ulong time = 0;
     u32 err = 0;
 
-    /* Verify frame length */
-    if (inlen < MIN_FRAME_LEN || inlen > MAX_FRAME_LEN)
+    time = get_timer(0);
+    while (!eof)
     {
-        printf("%s: Invalid len (%lu)\n", __FUNCTION__, (ulong)inlen);
-        err = 1;
-        goto cleanup;
-    }
+        c = zynq_uart1_getc_nowait();
+        if (c < 0)
+        {
+            /* FIFO empty, give up if the slave went quiet mid frame */
+            if (get_timer(time) > UART_FIFO_TIMEOUT)
+            {
+                printf("%s: Timeout (%lu bytes)\n", __FUNCTION__, (ulong)raw);
+                err = 1;
+                break;
+            }
+            WATCHDOG_RESET();
+            continue;
+        }
+        time = get_timer(0);
+        raw++;
 
-    /* Check for SOF */
-    if (inbuf[0] != HDLC_FRAME_DELIMITER)
-    {
-        printf("%s: No SOF (0x%02X)\n", __FUNCTION__, inbuf[0]);
-        err = 1;
-        goto cleanup;
-    }
+        if (c == HDLC_FRAME_DELIMITER)
+        {
+            /* SOF, or an EOF directly followed by a SOF */
+            if (!sof || (!len && !ntail))
+            {
+                sof = true;
+                continue;
+            }
+            eof = true;
+            break;
+        }
 
-    /* Check for EOF */
-    if (inbuf[inlen - 1] != HDLC_FRAME_DELIMITER)
-    {
-        printf("%s: No EOF (0x%02X)\n", __FUNCTION__, inbuf[inlen - 1]);
-        err = 1;
-        goto cleanup;
-    }
+        if (!sof)
+        {
+            printf("%s: No SOF (0x%02X)\n", __FUNCTION__, c);
+            err = 1;
+            break;
+        }
 
-    /* Decode data + CRC, skip SOF and EOF */
-    for (i = 1; i < (inlen - 1); ++i)
-    {
-        data = inbuf[i];
-        if (data == HDLC_CONTROL_ESCAPE)
+        if (c == HDLC_CONTROL_ESCAPE)
         {
-            data = inbuf[++i];
-            data ^= HDLC_ESCAPE_BIT;
+            esc = true;
+            continue;
+        }
+        if (esc)
+        {
+            c ^= HDLC_ESCAPE_BIT;
+            esc = false;
+        }
+
+        /* Hold back the last two bytes */
+        if (ntail == CRC_SIZE)
+        {
+            if (len >= outlen)
+            {
+                printf("%s: Invalid len (%lu)\n", __FUNCTION__, (ulong)raw);
+                err = 1;
+                break;
+            }
+            outbuf[len] = tail[0];
+            crc_calc = crc16_ccitt(crc_calc, &outbuf[len], 1);
+            len++;
+            tail[0] = tail[1];
+            ntail--;
         }
+        tail[ntail++] = c;
+    }
 
-        *pBuf++ = data;
-        len++;
+    if (!err && (ntail < CRC_SIZE || len < MIN_CMD_LEN))
+    {
+        printf("%s: Invalid len (%lu)\n", __FUNCTION__, (ulong)raw);
+        err = 1;
     }
 
     /* Verify CRC */
-    len -= sizeof(crc);
-    memmove(&crc, &outbuf[len], sizeof(crc));
-    crc_calc = crc_ccitt(outbuf, len);
-    if (crc != crc_calc)
+    if (!err)
     {
-        printf("%s: Bad CRC (rx=0x%04X, calc=0x%04X)\n", __FUNCTION__, crc, crc_calc);
-        err = 1;
+        memcpy(&crc, tail, sizeof(crc));
+        if (crc != crc_calc)
+        {
+            printf("%s: Bad CRC (rx=0x%04X, calc=0x%04X)\n", __FUNCTION__, crc, crc_calc);
+            err = 1;
+        }
     }
 
-cleanup:
     if (err || verbose)
     {
-        printf("\n%s: inbuf (%lu bytes):\n", __FUNCTION__, (ulong)inlen);
-        print_buffer((u32)inbuf, (void *)inbuf, 1, inlen, 0);
         printf("\n%s: outbuf (%lu bytes):\n", __FUNCTION__, (ulong)len);
         print_buffer((u32)outbuf, (void *)outbuf, 1, len, 0);
     }
 
     return (err ? 0 : len);
 }
-
@@ -5,6 +5,7 @@
 #include <common.h>
 #include <asm/io.h>
 #include <malloc.h>
+#include <bootstage.h>
 #include <i2c.h>
 #include <nai_mb_fpga_address.h>
 #include <nai_icb.h>
@@ -78,6 +79,7 @@ static unsigned int const i2c_bus_num[] = {
 #define HSS_MOD_OPERSTATE_FW_ENTERED_BIT                 (1UL << 16)
 #define HSS_MOD_FW_READY_TIMEOUT                         (5 * 1000) // 5 * 1000ms = 5 seconds
 #define HSS_MOD_RECOVERY_COUNT    5
+#define HSS_MOD_PS_STAGGER_USDELAY   MODULE_25000_USDELAY  //gap between hss module power supply enables
 
 #ifdef CONFIG_NAI_DEFAULT_MODULE_LO_SIZE_LIMIT
 #define MODULE_LO_SIZE CONFIG_NAI_DEFAULT_MODULE_LO_SIZE_LIMIT
@@ -98,6 +100,37 @@ static unsigned int const i2c_bus_num[] = {
 #endif
 
 
+#ifdef CONFIG_NAI_MODULE_PARALLEL_INIT
+/*per slot states of _hss_bringup_all*/
+typedef enum {
+    HSS_BRINGUP_IDLE,       /*waiting for its power supply turn*/
+    HSS_BRINGUP_PS_ON,      /*power supply enabled, settling*/
+    HSS_BRINGUP_CLK_ON,     /*module clock enabled, settling*/
+    HSS_BRINGUP_RESET_OFF,  /*released from reset, settling*/
+    HSS_BRINGUP_DETECT,     /*polling hss detection done*/
+    HSS_BRINGUP_HSS_WAIT,   /*detected, waiting for the hss interface release*/
+    HSS_BRINGUP_LINK,       /*polling hss link done*/
+    HSS_BRINGUP_FW_RDY,     /*polling module fw entered bit*/
+    HSS_BRINGUP_DONE
+} HSS_BRINGUP_STATE;
+
+typedef struct {
+    HSS_BRINGUP_STATE state;
+    ulong settle_start;     /*timer_get_us() when the settle delay started*/
+    ulong poll_start;       /*get_timer() base of the current polling state*/
+} HSS_BRINGUP;
+
+/*bootstage needs names that stay around, one set per slot*/
+static const char * const hss_bootstage_name[][3] = {
+    { "module1_detect", "module1_link", "module1_ready" },
+    { "module2_detect", "module2_link", "module2_ready" },
+    { "module3_detect", "module3_link", "module3_ready" },
+    { "module4_detect", "module4_link", "module4_ready" },
+    { "module5_detect", "module5_link", "module5_ready" },
+    { "module6_detect", "module6_link", "module6_ready" },
+};
+#endif
+
 /*MB Reset Register Map 0x43C1 0008*/
 typedef volatile struct {
     
@@ -273,6 +306,9 @@ static void _hss_module_reset(u8 slot);
 static void _hss_wait_link(u8 slot);
 static void _hss_wait_detection(u8 slot);
 static void _hss_wait_fw_rdy(u8 slot);
+#ifdef CONFIG_NAI_MODULE_PARALLEL_INIT
+static void _hss_bringup_all(u8 initMask, u8 postMask);
+#endif
 
 static void _em1_module_init(u8 slot);
 static void _es1_module_init(u8 slot);
@@ -1197,12 +1233,234 @@ static void _hss_wait_fw_rdy(u8 slot)
 
 }
 
+#ifdef CONFIG_NAI_MODULE_PARALLEL_INIT
+static void _hss_bringup_settle(HSS_BRINGUP *bu, HSS_BRINGUP_STATE state)
+{
+    bu->state = state;
+    bu->settle_start = timer_get_us();
+}
+
+static void _hss_bringup_poll(HSS_BRINGUP *bu, HSS_BRINGUP_STATE state)
+{
+    bu->state = state;
+    bu->poll_start = get_timer(0);
+}
+
+/*
+ * Advance one slot of _hss_bringup_all by at most one step. Never waits,
+ * settle delays and timeouts are checked against the time stamps in bu.
+ * Returns 1 if the slot changed state.
+ */
+static int _hss_bringup_step(u8 slot, HSS_BRINGUP *bu, ulong *last_ps_on)
+{
+    s32 status = NAI_SUCCESS;
+    u32 data = 0;
+    u8 done = 0;
+    u8 ok = 0;
+    
+    switch (bu->state)
+    {
+        case HSS_BRINGUP_IDLE :
+          /*stagger the supplies so the slots do not all draw inrush at once*/
+          if((timer_get_us() - *last_ps_on) < HSS_MOD_PS_STAGGER_USDELAY)
+              return 0;
+          
+          /*change mod mio[7:0] config src to HSS*/
+          pModConfReg->mod_src_sel[slot] = 0;
+          /*held hss interface in reset*/
+          #if defined(CONFIG_NAI_MODULE_HSS_WR)
+            pModConfReg->hss_if_reset = 0x3f;
+          #else
+            pModConfReg->hss_if_reset |= (1 << slot);
+          #endif
+          /*enable module power supply*/
+          pModConfReg->pwr_supply_en |= (1 << slot);
+          *last_ps_on = timer_get_us();
+          _hss_bringup_settle(bu, HSS_BRINGUP_PS_ON);
+          break;
+          
+        case HSS_BRINGUP_PS_ON :
+          if((timer_get_us() - bu->settle_start) < MODULE_25000_USDELAY)
+              return 0;
+          /*enable module clock*/
+          pModConfReg->clk_en |= (1 << slot);
+          _hss_bringup_settle(bu, HSS_BRINGUP_CLK_ON);
+          break;
+          
+        case HSS_BRINGUP_CLK_ON :
+          if((timer_get_us() - bu->settle_start) < MODULE_25000_USDELAY)
+              return 0;
+          /*take module out of reset*/
+          pModConfReg->resetn |= (1 << slot);
+          _hss_bringup_settle(bu, HSS_BRINGUP_RESET_OFF);
+          break;
+          
+        case HSS_BRINGUP_RESET_OFF :
+          if((timer_get_us() - bu->settle_start) < MODULE_25000_USDELAY)
+              return 0;
+          /*set module power status*/
+          pCommonModule->mod[slot].status.bits.power = 1;
+          pCommonModule->mod[slot].status.bits.hss_det_done = 0;
+          _hss_bringup_poll(bu, HSS_BRINGUP_DETECT);
+          break;
+          
+        case HSS_BRINGUP_DETECT :
+          done = pModConfReg->det_status.bits.detection_done & (1 << slot);
+          ok = pModConfReg->det_status.bits.detected & (1 << slot);
+          if(!(done && ok) && (get_timer(bu->poll_start) <= MODULE_DONE_TIMEOUT))
+              return 0;
+          
+          DEBUGF("Module# %x HSS Detected [detected = 0x%02x] [detection_done = 0x%02x]\n",slot,ok,done);
+          if(done && ok)
+          {
+              pCommonModule->mod[slot].status.bits.hss_det_done = 1;
+              bootstage_mark_name(BOOTSTAGE_ID_ALLOC, hss_bootstage_name[slot][0]);
+              bu->state = HSS_BRINGUP_HSS_WAIT;
+          }
+          else
+          {
+              bu->state = HSS_BRINGUP_DONE;
+          }
+          break;
+          
+        case HSS_BRINGUP_LINK :
+          done = pModConfReg->link_status.bits.link_done & (1 << slot);
+          ok = pModConfReg->link_status.bits.linked & (1 << slot);
+          if(!(done && ok) && (get_timer(bu->poll_start) <= MODULE_DONE_TIMEOUT))
+              return 0;
+          
+          DEBUGF("Module# %x HSS Link [linked = 0x%02x] [link_done = 0x%02x]\n",slot,ok,done);
+          if(done && ok)
+          {
+              pCommonModule->mod[slot].status.bits.hss_link_done = 1;
+              bootstage_mark_name(BOOTSTAGE_ID_ALLOC, hss_bootstage_name[slot][1]);
+              _hss_bringup_poll(bu, HSS_BRINGUP_FW_RDY);
+          }
+          else
+          {
+              bu->state = HSS_BRINGUP_DONE;
+          }
+          break;
+          
+        case HSS_BRINGUP_FW_RDY :
+          status = nai_read_reg32_by_slot_request((u8)(slot+1), (u32)HSS_MOD_READY_STATE, &data);
+          if((status == NAI_SUCCESS) && !(data & HSS_MOD_OPERSTATE_FW_ENTERED_BIT) &&
+             (get_timer(bu->poll_start) <= HSS_MOD_FW_READY_TIMEOUT))
+              return 0;
+          
+          DEBUGF("Module# %x HSS FW 0x%08x\n", slot,data);
+          if((status == NAI_SUCCESS) && (data & HSS_MOD_OPERSTATE_FW_ENTERED_BIT))
+          {
+              pCommonModule->mod[slot].status.bits.hss_fw_ready = 1;
+              bootstage_mark_name(BOOTSTAGE_ID_ALLOC, hss_bootstage_name[slot][2]);
+          }
+          bu->state = HSS_BRINGUP_DONE;
+          break;
+          
+        default :
+          return 0;
+    }
+    
+    return 1;
+}
+
+/*
+ * Same as _hss_module_init() for every slot in init_mask followed by
+ * _hss_module_post_init() for every slot in post_mask, but all slots are
+ * advanced from one polling loop so their settle delays and timeouts
+ * overlap instead of adding up.
+ */
+static void _hss_bringup_all(u8 init_mask, u8 post_mask)
+{
+    HSS_BRINGUP bu[MAX_MODULE_SLOT];
+    ulong last_ps_on = timer_get_us() - HSS_MOD_PS_STAGGER_USDELAY;
+    u8 slot = 0;
+    u8 pending = 0;
+    u8 hss_wait = 0;
+    
+    memset(bu, 0, sizeof(bu));
+    
+    for(slot = 0; slot < MAX_MODULE_SLOT; slot++)
+    {
+        if(init_mask & (1 << slot))
+        {
+            bu[slot].state = HSS_BRINGUP_IDLE;
+        }
+        else if(post_mask & (1 << slot))
+        {
+            /*already powered, only wait for it*/
+            pModConfReg->mod_src_sel[slot] = 0;
+            pCommonModule->mod[slot].status.bits.hss_det_done = 0;
+            _hss_bringup_poll(&bu[slot], HSS_BRINGUP_DETECT);
+        }
+        else
+        {
+            continue;
+        }
+        
+        pCommonModule->mod[slot].status.bits.hss_link_done = 0;
+        pCommonModule->mod[slot].status.bits.hss_fw_ready = 0;
+        pending |= (1 << slot);
+    }
+    
+    nai_init_msg_utils(MB_SLOT);
+    
+    while(pending)
+    {
+        hss_wait = 0;
+        
+        for(slot = 0; slot < MAX_MODULE_SLOT; slot++)
+        {
+            if(!(pending & (1 << slot)))
+                continue;
+            
+            while(_hss_bringup_step(slot, &bu[slot], &last_ps_on))
+                ;
+            
+            if(bu[slot].state == HSS_BRINGUP_DONE)
+                pending &= ~(1 << slot);
+            else if(bu[slot].state == HSS_BRINGUP_HSS_WAIT)
+                hss_wait |= (1 << slot);
+        }
+        
+        #if defined(CONFIG_NAI_MODULE_HSS_WR)
+        /*TODO: This a workaround for 6U MB
+         *because HSS IF reset bitmap is not
+         *supported in 6U MB FPGA. Release all
+         *hss interfaces at once, after every
+         *pending slot was detected or failed
+         */
+        if(!hss_wait || (hss_wait != pending))
+            continue;
+        pModConfReg->hss_if_reset = 0;
+        #else
+        for(slot = 0; slot < MAX_MODULE_SLOT; slot++)
+        {
+            /*release module hss interface from reset*/
+            if(hss_wait & (1 << slot))
+                pModConfReg->hss_if_reset &= ~(1 << slot);
+        }
+        #endif
+        
+        for(slot = 0; slot < MAX_MODULE_SLOT; slot++)
+        {
+            if(hss_wait & (1 << slot))
+                _hss_bringup_poll(&bu[slot], HSS_BRINGUP_LINK);
+        }
+    }
+}
+#endif
+
 static void _init_module(void)
 {
     u8 slot  = 0;
     u32 id = 0;
     u32 detected = 0;
     u32 power = 0;
+#ifdef CONFIG_NAI_MODULE_PARALLEL_INIT
+    u8 hss_init = 0;
+    u8 hss_post = 0;
+#endif
     
     for(slot = 0; slot < MAX_MODULE_SLOT; slot++)
     {
@@ -1265,12 +1523,20 @@ static void _init_module(void)
                    * assume it's a hss interface module.
                    */ 
                   if(!(power))
+#ifdef CONFIG_NAI_MODULE_PARALLEL_INIT
+                    hss_init |= (1 << slot);
+#else
                     _hss_module_init(slot);
+#endif
                   break;
                 default :                  
                   DEBUGF("%s:HSS module 0x%08x \n",__func__,id);
                   if(!(power))
+#ifdef CONFIG_NAI_MODULE_PARALLEL_INIT
+                    hss_init |= (1 << slot);
+#else
                     _hss_module_init(slot);
+#endif
                   break;
             }
         }
@@ -1302,11 +1568,19 @@ static void _init_module(void)
                 (id != (MODULE_ID_FM7|MODULE_ID_SPACE)) &&
                 (id != (MODULE_ID_TE1|MODULE_ID_SPACE)))
             {
+#ifdef CONFIG_NAI_MODULE_PARALLEL_INIT
+                hss_post |= (1 << slot);
+#else
                 _hss_module_post_init(slot);
+#endif
             }
         }
     }
-
+    
+#ifdef CONFIG_NAI_MODULE_PARALLEL_INIT
+    /*power on, detect and link train all hss modules together*/
+    _hss_bringup_all(hss_init, hss_post);
+#endif
 }
 
 static void _deinit_module(void)
@@ -315,6 +315,51 @@ U_BOOT_CMD(
 );
 #endif
 
+#if defined(CONFIG_CMD_IMINPLACE)
+static int do_iminplace(cmd_tbl_t *cmdtp, int flag, int argc,
+			char * const argv[])
+{
+	ulong load, comp_len, unc_len, addr;
+	int comp, ret;
+
+	if (argc != 5)
+		return CMD_RET_USAGE;
+
+	load = simple_strtoul(argv[1], NULL, 16);
+	comp = genimg_get_comp_id(argv[2]);
+	comp_len = simple_strtoul(argv[3], NULL, 16);
+	unc_len = simple_strtoul(argv[4], NULL, 16);
+	if (comp < 0) {
+		printf("Unknown compression '%s'\n", argv[2]);
+		return CMD_RET_FAILURE;
+	}
+
+	ret = bootm_inplace_addr(comp, load, unc_len, comp_len, &addr);
+	if (ret == -EPROTONOSUPPORT) {
+		printf("Cannot decompress %s in place\n",
+		       genimg_get_comp_name(comp));
+		return CMD_RET_FAILURE;
+	} else if (ret) {
+		printf("No room to decompress at %08lx in place\n", load);
+		return CMD_RET_FAILURE;
+	}
+	printf("Image data can be placed at %08lx\n", addr);
+	env_set_hex("inplace_addr", addr);
+
+	return CMD_RET_SUCCESS;
+}
+
+U_BOOT_CMD(
+	iminplace,	5,	1,	do_iminplace,
+	"find where to load an image to decompress it in place",
+	"load_addr comp comp_size unc_size\n"
+	"    - set 'inplace_addr' to where image data of 'comp_size' bytes,\n"
+	"      compressed with 'comp', must start so that bootm decompresses\n"
+	"      it to 'load_addr' without copying it first. For a legacy\n"
+	"      image, load the image one header (0x40 bytes) lower"
+);
+#endif
+
 
 /*******************************************************************/
 /* imls - list all images found in flash */
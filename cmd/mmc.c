@@ -292,7 +292,12 @@ static int do_mmc_read(cmd_tbl_t *cmdtp, int flag,
 	printf("\nMMC read: dev # %d, block # %d, count %d ... ",
 	       curr_device, blk, cnt);
 
+	fit_stream_start(addr);
+	fit_cache_load_start(addr, mmc_get_blk_desc(mmc), 0, NULL,
+			     (loff_t)blk * mmc->read_bl_len);
 	n = blk_dread(mmc_get_blk_desc(mmc), blk, cnt, addr);
+	fit_cache_load_end(n == cnt ? n * mmc->read_bl_len : 0);
+	fit_stream_end(n == cnt ? n * mmc->read_bl_len : 0);
 	printf("%d blocks read: %s\n", n, (n == cnt) ? "OK" : "ERROR");
 
 	return (n == cnt) ? CMD_RET_SUCCESS : CMD_RET_FAILURE;
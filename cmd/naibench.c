@@ -0,0 +1,398 @@
+/*
+ * NAI Bench
+ *
+ * Timed module transfers over the serdes message API. Needs nothing but the serdes library, so it also runs on
+ * the sandbox against the loopback modules of CONFIG_NAI_SERDES_SANDBOX.
+ */
+#include "NAIComms.h"
+#include "cmd_naiconfigmsgutils.h"
+#include "cmd_naiopermsgutils.h"
+#include "cmd_naimsgutils.h"
+
+#ifndef __UBOOT
+#include <stdio.h>
+#else
+#include <common.h>
+#include <command.h>
+#include <malloc.h>
+#endif
+
+#define NAI_BENCH_FLASH_OFFSET		0x600000	/* Same scratch area as naisend */
+#define NAI_BENCH_FLASH_BYTES		0x40000
+#define NAI_BENCH_FLASH_PAGE_BYTES	0x10000		/* Erase page, also the largest stop and wait request */
+#define NAI_BENCH_EEPROM_BYTES		0x100
+
+static uint32_t nai_bench_rate(uint32_t unCount, uint32_t unMicroseconds)
+{
+	return (unMicroseconds > 0) ? (uint32_t)(((uint64_t)unCount * 1000000) / unMicroseconds) : 0;
+}
+
+static void nai_bench_print(const char *pcName, uint32_t unMsgs, uint32_t unBytes, uint32_t unMicroseconds)
+{
+	printf("%s: %u msgs, %u bytes in %u us (%u msgs/s, %u bytes/s)\r\n", pcName, unMsgs, unBytes, unMicroseconds,
+		   nai_bench_rate(unMsgs, unMicroseconds), nai_bench_rate(unBytes, unMicroseconds));
+}
+
+static void nai_bench_print_tx_stats(void)
+{
+	MsgTxStats tTxStats;
+
+	nai_get_msg_tx_stats(&tTxStats, FALSE);
+	printf("TX FIFO: %u packets, %u words in %u us\r\n", tTxStats.unPackets, tTxStats.unWords, tTxStats.unMicroseconds);
+}
+
+/**************************************************************************************************************/
+/**
+\ingroup Bench
+<summary>
+do_naiflashbench erases, writes, reads back and verifies a flash image on a module, timing the writes and the
+reads separately. Stop and wait writes and all reads go out one erase page (64K) per request; windowed writes
+hand the whole image to nai_write_module_flash_windowed_request.
+</summary>
+<returns>int : CMD_RET_SUCCESS if every request succeeded and the image read back intact</returns>
+*/
+/**************************************************************************************************************/
+int do_naiflashbench(cmd_tbl_t * cmdtp, int flag, int argc, char * const argv[])
+{
+	int32_t nStatus = NAI_SUCCESS;
+	uint8_t ucTargetModuleSlot = MODULE_1_SLOT;
+	uint32_t unOffset = NAI_BENCH_FLASH_OFFSET;
+	uint32_t unLen = NAI_BENCH_FLASH_BYTES;
+	uint32_t unLoopCnt = 1;
+	BOOL bWindowed = FALSE;
+	uint8_t *pucImage = NULL;
+	uint8_t *pucReadBack = NULL;
+	uint32_t unPages = 0;
+	uint32_t unChunk = 0;
+	uint32_t unStart = 0;
+	uint32_t unEraseMsgs = 0, unWriteMsgs = 0, unReadMsgs = 0;
+	uint32_t unEraseUs = 0, unWriteUs = 0, unReadUs = 0;
+	uint32_t unBytes = 0;
+	uint32_t unMismatchCount = 0;
+	uint32_t i = 0, k = 0;
+
+	if (argc >= 2)
+		ucTargetModuleSlot = (uint8_t)simple_strtoul (argv[1], NULL, 16);
+
+	if (argc >= 3)
+		unOffset = (uint32_t)simple_strtoul (argv[2], NULL, 16);
+
+	if (argc >= 4)
+		unLen = (uint32_t)simple_strtoul (argv[3], NULL, 16);
+
+	if (argc >= 5)
+		unLoopCnt = (uint32_t)simple_strtoul (argv[4], NULL, 10);
+
+	if (argc >= 6)
+		bWindowed = (simple_strtoul (argv[5], NULL, 10) != 0);
+
+	/* Erase requests carry the page count in 8 bits */
+	unPages = ((unOffset % NAI_BENCH_FLASH_PAGE_BYTES) + unLen + NAI_BENCH_FLASH_PAGE_BYTES - 1) / NAI_BENCH_FLASH_PAGE_BYTES;
+	if (unLen == 0 || unLoopCnt == 0 || unPages > 0xFF)
+		return CMD_RET_USAGE;
+
+	pucImage = (uint8_t *)malloc(unLen);
+	pucReadBack = (uint8_t *)malloc(unLen);
+	if (pucImage == NULL || pucReadBack == NULL)
+	{
+		free(pucImage);
+		free(pucReadBack);
+		return CMD_RET_FAILURE;
+	}
+
+	nai_init_msg_utils(MB_SLOT);
+	printf("Flash benchmark: SlotID = 0x%x Offset = 0x%x Size = 0x%x Loops = %u (%s)\r\n", ucTargetModuleSlot, unOffset,
+		   unLen, unLoopCnt, bWindowed ? "windowed" : "stop and wait");
+	nai_get_msg_tx_stats(NULL, TRUE);
+
+	for (i = 0; i < unLoopCnt && nStatus == NAI_SUCCESS; i++)
+	{
+		/* A different image every loop so stale flash contents cannot pass the verify */
+		for (k = 0; k < unLen; k++)
+			pucImage[k] = (uint8_t)(k ^ (k >> 8) ^ (i * 0x3B));
+		memset(pucReadBack, 0, unLen);
+
+		unStart = timer_get_us();
+		nStatus = nai_erase_flash_request(MB_SLOT, ucTargetModuleSlot, unOffset, (uint8_t)unPages);
+		unEraseUs += timer_get_us() - unStart;
+		unEraseMsgs++;
+		if (nStatus != NAI_SUCCESS)
+		{
+			printf("Failed nai_erase_flash_request - Status = %d\r\n", nStatus);
+			break;
+		}
+
+		unStart = timer_get_us();
+		if (bWindowed)
+		{
+			nStatus = nai_write_module_flash_windowed_request(MB_SLOT, ucTargetModuleSlot, unOffset, pucImage, unLen);
+			unWriteMsgs += (unLen + SERDES_WINDOW_CHUNK_BYTES - 1) / SERDES_WINDOW_CHUNK_BYTES;
+		}
+		else
+		{
+			for (k = 0; k < unLen && nStatus == NAI_SUCCESS; k += unChunk)
+			{
+				unChunk = MIN(unLen - k, NAI_BENCH_FLASH_PAGE_BYTES);
+				nStatus = nai_write_module_flash_request(MB_SLOT, ucTargetModuleSlot, unOffset + k, &pucImage[k], unChunk);
+				unWriteMsgs++;
+			}
+		}
+		unWriteUs += timer_get_us() - unStart;
+		if (nStatus != NAI_SUCCESS)
+		{
+			printf("Failed flash write - Status = %d\r\n", nStatus);
+			break;
+		}
+
+		unStart = timer_get_us();
+		for (k = 0; k < unLen && nStatus == NAI_SUCCESS; k += unChunk)
+		{
+			unChunk = MIN(unLen - k, NAI_BENCH_FLASH_PAGE_BYTES);
+			nStatus = nai_read_module_flash_request(MB_SLOT, ucTargetModuleSlot, unOffset + k, &pucReadBack[k], unChunk);
+			unReadMsgs++;
+		}
+		unReadUs += timer_get_us() - unStart;
+		if (nStatus != NAI_SUCCESS)
+		{
+			printf("Failed nai_read_module_flash_request - Status = %d\r\n", nStatus);
+			break;
+		}
+
+		for (k = 0; k < unLen; k++)
+		{
+			if (pucImage[k] != pucReadBack[k])
+				unMismatchCount++;
+		}
+		unBytes += unLen;
+	}
+
+	if (nStatus == NAI_SUCCESS)
+	{
+		printf("Erase: %u msgs in %u us\r\n", unEraseMsgs, unEraseUs);
+		nai_bench_print("Write", unWriteMsgs, unBytes, unWriteUs);
+		nai_bench_print("Read ", unReadMsgs, unBytes, unReadUs);
+		nai_bench_print_tx_stats();
+		printf("%u mismatches\r\n", unMismatchCount);
+	}
+
+	free(pucImage);
+	free(pucReadBack);
+	return (nStatus == NAI_SUCCESS && unMismatchCount == 0) ? CMD_RET_SUCCESS : CMD_RET_FAILURE;
+}
+
+/**************************************************************************************************************/
+/**
+\ingroup Bench
+<summary>
+do_naieeprombench writes and reads back a full EEPROM image on a module, alternating between the original contents
+and their complement so every write changes every byte. The original contents are written back at the end.
+</summary>
+<returns>int : CMD_RET_SUCCESS if every request succeeded and the image read back intact</returns>
+*/
+/**************************************************************************************************************/
+int do_naieeprombench(cmd_tbl_t * cmdtp, int flag, int argc, char * const argv[])
+{
+	int32_t nStatus = NAI_SUCCESS;
+	uint8_t ucTargetModuleSlot = MODULE_1_SLOT;
+	uint16_t usChipID = I2C_FUNCTIONAL_MODULE_EEPROM;
+	uint32_t unLoopCnt = 16;
+	uint8_t ucOriginal[NAI_BENCH_EEPROM_BYTES];
+	uint8_t ucImage[NAI_BENCH_EEPROM_BYTES];
+	uint8_t ucReadBack[NAI_BENCH_EEPROM_BYTES];
+	uint8_t ucXor = 0;
+	uint32_t unStart = 0;
+	uint32_t unWriteMsgs = 0, unReadMsgs = 0;
+	uint32_t unWriteUs = 0, unReadUs = 0;
+	uint32_t unMismatchCount = 0;
+	uint32_t i = 0, k = 0;
+
+	if (argc >= 2)
+		ucTargetModuleSlot = (uint8_t)simple_strtoul (argv[1], NULL, 16);
+
+	if (argc >= 3)
+		usChipID = (uint16_t)simple_strtoul (argv[2], NULL, 16);
+
+	if (argc >= 4)
+		unLoopCnt = (uint32_t)simple_strtoul (argv[3], NULL, 10);
+
+	if (unLoopCnt == 0)
+		return CMD_RET_USAGE;
+
+	nai_init_msg_utils(MB_SLOT);
+	printf("EEPROM benchmark: SlotID = 0x%x ChipID = 0x%x Size = 0x%x Loops = %u\r\n", ucTargetModuleSlot, usChipID,
+		   NAI_BENCH_EEPROM_BYTES, unLoopCnt);
+
+	nStatus = nai_read_module_eeprom_request(usChipID, MB_SLOT, ucTargetModuleSlot, 0, ucOriginal, NAI_BENCH_EEPROM_BYTES);
+	if (nStatus != NAI_SUCCESS)
+	{
+		printf("Failed nai_read_module_eeprom_request - Status = %d\r\n", nStatus);
+		return CMD_RET_FAILURE;
+	}
+
+	nai_get_msg_tx_stats(NULL, TRUE);
+
+	for (i = 0; i < unLoopCnt && nStatus == NAI_SUCCESS; i++)
+	{
+		ucXor = (i & 1) ? 0x00 : 0xFF;
+		for (k = 0; k < NAI_BENCH_EEPROM_BYTES; k++)
+			ucImage[k] = ucOriginal[k] ^ ucXor;
+		memset(ucReadBack, 0, NAI_BENCH_EEPROM_BYTES);
+
+		unStart = timer_get_us();
+		nStatus = nai_write_module_eeprom_request(usChipID, MB_SLOT, ucTargetModuleSlot, 0, ucImage, NAI_BENCH_EEPROM_BYTES);
+		unWriteUs += timer_get_us() - unStart;
+		unWriteMsgs++;
+		if (nStatus != NAI_SUCCESS)
+		{
+			printf("Failed nai_write_module_eeprom_request - Status = %d\r\n", nStatus);
+			break;
+		}
+
+		unStart = timer_get_us();
+		nStatus = nai_read_module_eeprom_request(usChipID, MB_SLOT, ucTargetModuleSlot, 0, ucReadBack, NAI_BENCH_EEPROM_BYTES);
+		unReadUs += timer_get_us() - unStart;
+		unReadMsgs++;
+		if (nStatus != NAI_SUCCESS)
+		{
+			printf("Failed nai_read_module_eeprom_request - Status = %d\r\n", nStatus);
+			break;
+		}
+
+		for (k = 0; k < NAI_BENCH_EEPROM_BYTES; k++)
+		{
+			if (ucImage[k] != ucReadBack[k])
+				unMismatchCount++;
+		}
+	}
+
+	/* Leave the EEPROM as we found it */
+	if (ucXor != 0)
+	{
+		if (nai_write_module_eeprom_request(usChipID, MB_SLOT, ucTargetModuleSlot, 0, ucOriginal, NAI_BENCH_EEPROM_BYTES) != NAI_SUCCESS)
+		{
+			printf("Failed to restore the EEPROM contents\r\n");
+			if (nStatus == NAI_SUCCESS)
+				nStatus = NAI_COMMAND_FAILED;
+		}
+	}
+
+	if (nStatus == NAI_SUCCESS)
+	{
+		nai_bench_print("Write", unWriteMsgs, unWriteMsgs * NAI_BENCH_EEPROM_BYTES, unWriteUs);
+		nai_bench_print("Read ", unReadMsgs, unReadMsgs * NAI_BENCH_EEPROM_BYTES, unReadUs);
+		nai_bench_print_tx_stats();
+		printf("%u mismatches\r\n", unMismatchCount);
+	}
+
+	return (nStatus == NAI_SUCCESS && unMismatchCount == 0) ? CMD_RET_SUCCESS : CMD_RET_FAILURE;
+}
+
+int do_naibatchbench(cmd_tbl_t * cmdtp, int flag, int argc, char * const argv[])
+{
+	int32_t nStatus = NAI_SUCCESS;
+	uint8_t ucTargetModuleSlot = 1;
+	uint32_t unModuleOffset = 0x0;
+	uint32_t unCount = 256;
+	uint32_t unValue = 0;
+	uint32_t unStart = 0;
+	uint32_t unSingleWriteUs = 0, unBatchWriteUs = 0;
+	uint32_t unSingleReadUs = 0, unBatchReadUs = 0;
+	uint32_t unMismatchCount = 0;
+	uint32_t i = 0;
+	NAIRegOp *ptOps = NULL;
+
+	if (argc >= 2)
+		ucTargetModuleSlot = (uint8_t)simple_strtoul (argv[1], NULL, 16);
+
+	if (argc >= 3)
+		unModuleOffset = (uint32_t)simple_strtoul (argv[2], NULL, 16);
+
+	if (argc >= 4)
+		unCount = (uint32_t)simple_strtoul (argv[3], NULL, 10);
+
+	if (unCount == 0)
+		return CMD_RET_USAGE;
+
+	ptOps = (NAIRegOp *)malloc(sizeof(NAIRegOp) * unCount);
+	if (ptOps == NULL)
+		return CMD_RET_FAILURE;
+
+	nai_init_msg_utils(MB_SLOT);
+	printf("Batch benchmark: SlotID = 0x%x ModuleOffset = 0x%x Count = %u\r\n", ucTargetModuleSlot, unModuleOffset, unCount);
+
+	/* One request per register */
+	unStart = timer_get_us();
+	for (i = 0; i < unCount && nStatus == NAI_SUCCESS; i++)
+		nStatus = nai_write_reg32_by_slot_request(ucTargetModuleSlot, unModuleOffset + (i * 4), (0xA5000000 | i));
+	unSingleWriteUs = timer_get_us() - unStart;
+
+	unStart = timer_get_us();
+	for (i = 0; i < unCount && nStatus == NAI_SUCCESS; i++)
+	{
+		nStatus = nai_read_reg32_by_slot_request(ucTargetModuleSlot, unModuleOffset + (i * 4), &unValue);
+		if (unValue != (0xA5000000 | i))
+			unMismatchCount++;
+	}
+	unSingleReadUs = timer_get_us() - unStart;
+
+	/* Same traffic as one batch each */
+	for (i = 0; i < unCount; i++)
+	{
+		ptOps[i].ucOp = NAI_REGOP_WRITE32;
+		ptOps[i].unModuleOffset = unModuleOffset + (i * 4);
+		ptOps[i].unValue = (0x5A000000 | i);
+	}
+
+	unStart = timer_get_us();
+	if (nStatus == NAI_SUCCESS)
+		nStatus = nai_batch_reg32_by_slot_request(ucTargetModuleSlot, ptOps, unCount, NULL);
+	unBatchWriteUs = timer_get_us() - unStart;
+
+	for (i = 0; i < unCount; i++)
+		ptOps[i].ucOp = NAI_REGOP_READ32;
+
+	unStart = timer_get_us();
+	if (nStatus == NAI_SUCCESS)
+		nStatus = nai_batch_reg32_by_slot_request(ucTargetModuleSlot, ptOps, unCount, NULL);
+	unBatchReadUs = timer_get_us() - unStart;
+
+	for (i = 0; i < unCount && nStatus == NAI_SUCCESS; i++)
+	{
+		if (ptOps[i].unResult != (0x5A000000 | i))
+			unMismatchCount++;
+	}
+
+	if (nStatus != NAI_SUCCESS)
+		printf("Failed batch benchmark - Status = %d\r\n", nStatus);
+	else
+	{
+		printf("Single writes: %u us (%u ops/s)\r\n", unSingleWriteUs, (unSingleWriteUs > 0) ? (uint32_t)(((uint64_t)unCount * 1000000) / unSingleWriteUs) : 0);
+		printf("Batch writes : %u us (%u ops/s)\r\n", unBatchWriteUs, (unBatchWriteUs > 0) ? (uint32_t)(((uint64_t)unCount * 1000000) / unBatchWriteUs) : 0);
+		printf("Single reads : %u us (%u ops/s)\r\n", unSingleReadUs, (unSingleReadUs > 0) ? (uint32_t)(((uint64_t)unCount * 1000000) / unSingleReadUs) : 0);
+		printf("Batch reads  : %u us (%u ops/s)\r\n", unBatchReadUs, (unBatchReadUs > 0) ? (uint32_t)(((uint64_t)unCount * 1000000) / unBatchReadUs) : 0);
+		printf("%u mismatches\r\n", unMismatchCount);
+	}
+
+	free(ptOps);
+	return (nStatus == NAI_SUCCESS && unMismatchCount == 0) ? CMD_RET_SUCCESS : CMD_RET_FAILURE;
+}
+
+/***************************************************/
+
+U_BOOT_CMD(
+	naiflashbench, 6, 1, do_naiflashbench,
+	"times writing and reading back a module flash image",
+	"[slot id(8bit HEX)] [flash offset(32bit HEX)] [image size(32bit HEX)] [loop count(Base 10)] [windowed flash writes: 1=WINDOWED 0=STOP AND WAIT]"
+);
+
+U_BOOT_CMD(
+	naieeprombench, 4, 1, do_naieeprombench,
+	"times writing and reading back a module EEPROM image",
+	"[slot id(8bit HEX)] [chip id(8bit HEX)] [loop count(Base 10)]"
+);
+
+U_BOOT_CMD(
+	naibatchbench, 4, 1, do_naibatchbench,
+	"compares single register requests against a batch request",
+	"[slot id(8bit HEX)] [module offset(32bit HEX)] [register count(Base 10)]"
+);
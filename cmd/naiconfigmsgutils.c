@@ -33,6 +33,7 @@
 #include <malloc.h>
 #include <crc.h>
 #include <i2c.h>
+#include <mapmem.h>
 #endif
 
 #ifdef __LINUX
@@ -191,13 +192,76 @@ BOOL g_bExitConfigMode; /* Also used in cmd_naireceive.c - governs when to exit
 /* We provide higher level calls so no need to expose the inner workings of actual read or write requests */
 static int32_t make_read_request(uint16_t usCommandType, uint8_t ucRequesterID, uint8_t ucCompleterID, uint16_t usChipID, uint unOffset, uint8_t *pucBuf, int32_t nLen);
 static int32_t make_write_request(uint16_t usCommandType, uint8_t ucRequesterID, uint8_t ucCompleterID, uint16_t usChipID, uint unEepromOffset, uint8_t *pucBuf, int32_t nLen);
+static MsgPacketList * create_nai_write_request(uint16_t usCommandType, uint8_t ucRequesterID, uint8_t ucCompleterID, uint16_t usChipID, uint unOffset, uint8_t *pucBuf, int32_t nLen);
+static int32_t make_windowed_write_request(uint16_t usCommandType, uint8_t ucRequesterID, uint8_t ucCompleterID, uint16_t usChipID, uint unOffset, uint8_t *pucBuf, int32_t nLen, int32_t nChunkLen);
 static int32_t make_generic_zero_payload_cmd_request(uint16_t usCommandType, uint8_t ucRequesterID, uint8_t ucCompleterID);
 
 #ifdef __UBOOT
 static int32_t nai_debug_test(void);
 #endif
 
+#ifndef _QSPI_SUPPORT
 static uint8_t pucTempBuf[MAX_FLASH_PAGE_BYTES];
+#endif
+
+#ifdef _PERFORM_QSPI_ERASE_ON_FLASH_WRITE
+/* Where the last nai_write_to_flash message ended, and the end of the sectors erased for it */
+static uint32_t g_unFlashWriteNext = 0;
+static uint32_t g_unFlashWriteEraseEnd = 0;
+#endif
+
+/* MsgPacket / MsgPacketList pools - each slot is padded out to a 4 byte multiple so every packet stays aligned */
+typedef union
+{
+	MsgPacket tPacket;
+	uint32_t unAlign[(sizeof(MsgPacket) + 3) / 4];
+} MsgPacketSlot;
+
+/* The pool is counted in padded slots so it never takes more than NAI_MSG_PACKET_POOL_BYTES */
+#define NAI_MSG_PACKET_POOL_COUNT (NAI_MSG_PACKET_POOL_BYTES / sizeof(MsgPacketSlot))
+
+typedef union
+{
+	MsgPacketList tPacketList;
+	uint32_t unAlign[(sizeof(MsgPacketList) + 3) / 4];
+} MsgPacketListSlot;
+
+static MsgPacketSlot g_tMsgPacketPool[NAI_MSG_PACKET_POOL_COUNT];
+static MsgPacketListSlot g_tMsgPacketListPool[NAI_MSG_PACKET_LIST_POOL_COUNT];
+static MsgPacket *g_ptFreeMsgPackets = NULL;
+static MsgPacketList *g_ptFreeMsgPacketLists = NULL;
+static BOOL g_bMsgPoolInitialized = FALSE;
+static MsgPoolStats g_tMsgPoolStats;
+
+static void init_nai_msg_pool(void);
+static MsgPacketList * acquire_nai_msg_packet_list(void);
+static void release_nai_msg_packet_list(MsgPacketList *ptMsgPacketList);
+
+#ifdef _COMPUTE_CRC
+/* Scratch copy of a packet's headers, masked before they are folded into the message CRC */
+static NAIMsg g_tMsgCRCHdr;
+
+static uint32_t update_nai_msg_packet_crc(uint32_t unCRC, MsgPacket *ptMsgPacket);
+#endif
+
+/* TX path - packets are staged as 32 bit FIFO words (two buffers so packet N+1 is staged while packet N drains) and
+ * the FIFO addresses of the last requester / completer pair are cached */
+#define NAI_TX_STAGE_WORDS ((MAX_SERDES_MSG_IN_WORDS + 1) / 2)
+
+#ifdef _BURST_FIFO_TX
+static uint32_t g_unTxStage[2][NAI_TX_STAGE_WORDS] __attribute__ ((aligned(32)));
+static uint8_t g_ucTxCachedRequesterID = INVALID_SLOT_ID;
+static uint8_t g_ucTxCachedCompleterID = INVALID_SLOT_ID;
+static uint32_t g_unTxCachedFIFOAddr = 0;
+static uint32_t g_unTxCachedPktReadyAddr = 0;
+
+static uint32_t stage_nai_msg_packet(MsgPacket *ptMsgPacket, uint32_t unMsgCRC, uint32_t *punStage);
+#endif
+static MsgTxStats g_tMsgTxStats;
+
+static uint32_t nai_get_tx_time_us(void);
+static int32_t push_nai_msg_packets(MsgPacketList *ptMsgPackets, MsgList *ptRxMsgList);
+static int32_t get_nai_msg_execution_status(MsgPacketList *ptMsgPacketList);
 
 /**************************************************************************************************************/
 /* NAI Message Utility Command Routines                                                                       */
@@ -275,6 +339,308 @@ static uint16_t get_next_tran_id(void)
 	return usTranID;
 }
 
+/**************************************************************************************************************/
+/* NAI Message Pool Routines                                                                                  */
+/** \defgroup MessagePool Message Pool Functions                                                              */
+/**************************************************************************************************************/
+
+/**************************************************************************************************************/
+/**
+\ingroup MessagePool
+<summary>
+init_nai_msg_pool is responsible for threading every slot of the static MsgPacket and MsgPacketList pools onto
+their free lists. This is done lazily the first time a packet or packet list is requested.
+</summary>
+<returns>VOID</returns>
+*/
+/**************************************************************************************************************/
+static void init_nai_msg_pool(void)
+{
+	uint32_t i = 0;
+
+	g_ptFreeMsgPackets = NULL;
+	for (i = 0; i < NAI_MSG_PACKET_POOL_COUNT; i++)
+	{
+		g_tMsgPacketPool[i].tPacket.ucOwner = NAI_MSG_PACKET_FROM_POOL;
+		g_tMsgPacketPool[i].tPacket.ptNext = g_ptFreeMsgPackets;
+		g_ptFreeMsgPackets = &(g_tMsgPacketPool[i].tPacket);
+	}
+
+	g_ptFreeMsgPacketLists = NULL;
+	for (i = 0; i < NAI_MSG_PACKET_LIST_POOL_COUNT; i++)
+	{
+		g_tMsgPacketListPool[i].tPacketList.ucOwner = NAI_MSG_PACKET_FROM_POOL;
+		g_tMsgPacketListPool[i].tPacketList.ptNext = g_ptFreeMsgPacketLists;
+		g_ptFreeMsgPacketLists = &(g_tMsgPacketListPool[i].tPacketList);
+	}
+
+	memset(&g_tMsgPoolStats, 0, sizeof(MsgPoolStats));
+	g_bMsgPoolInitialized = TRUE;
+}
+
+/**************************************************************************************************************/
+/**
+\ingroup MessagePool
+<summary>
+acquire_nai_msg_packet is responsible for handing out an (uninitialized) MsgPacket in O(1). Packets come from the
+static pool; only when the pool is exhausted do we fall back to the heap. Callers may build the packet contents
+directly in the returned storage and then hand it to append_nai_msg_packet.
+</summary>
+<returns> MsgPacket* : Pointer to the MsgPacket (NULL if no memory is available)</returns>
+*/
+/**************************************************************************************************************/
+MsgPacket * acquire_nai_msg_packet(void)
+{
+	MsgPacket *ptNewMsgPacket = NULL;
+
+	if (!g_bMsgPoolInitialized)
+		init_nai_msg_pool();
+
+	if (g_ptFreeMsgPackets != NULL)
+	{
+		ptNewMsgPacket = g_ptFreeMsgPackets;
+		g_ptFreeMsgPackets = ptNewMsgPacket->ptNext;
+
+		g_tMsgPoolStats.unPoolAcquires++;
+		g_tMsgPoolStats.unInUse++;
+		if (g_tMsgPoolStats.unInUse > g_tMsgPoolStats.unHighWater)
+			g_tMsgPoolStats.unHighWater = g_tMsgPoolStats.unInUse;
+	}
+	else
+	{
+		ptNewMsgPacket = aligned_malloc(sizeof(MsgPacket), 4);
+		if (ptNewMsgPacket == NULL)
+			return NULL;
+
+		ptNewMsgPacket->ucOwner = NAI_MSG_PACKET_FROM_HEAP;
+		g_tMsgPoolStats.unHeapAllocs++;
+	}
+
+	ptNewMsgPacket->ptNext = NULL;
+	return ptNewMsgPacket;
+}
+
+/**************************************************************************************************************/
+/**
+\ingroup MessagePool
+<summary>
+release_nai_msg_packet is responsible for giving a MsgPacket back to wherever it came from in O(1). Caller owned 
+packets (see attach_nai_msg_packet) are left untouched.
+</summary>
+<param name="ptMsgPacket"> : (Input) Pointer to MsgPacket struct to release.</param>
+<returns>VOID</returns>
+*/
+/**************************************************************************************************************/
+void release_nai_msg_packet(MsgPacket *ptMsgPacket)
+{
+	if (ptMsgPacket == NULL)
+		return;
+
+	switch (ptMsgPacket->ucOwner)
+	{
+		case NAI_MSG_PACKET_FROM_POOL :
+			ptMsgPacket->ptNext = g_ptFreeMsgPackets;
+			g_ptFreeMsgPackets = ptMsgPacket;
+			g_tMsgPoolStats.unInUse--;
+			break;
+
+		case NAI_MSG_PACKET_FROM_HEAP :
+			aligned_free(ptMsgPacket);
+			break;
+
+		default: /* NAI_MSG_PACKET_CALLER_OWNED */
+			ptMsgPacket->ptNext = NULL;
+			break;
+	};
+}
+
+/**************************************************************************************************************/
+/**
+\ingroup MessagePool
+<summary>
+acquire_nai_msg_packet_list is responsible for handing out an (uninitialized) MsgPacketList in O(1), falling back
+to the heap when the list pool is exhausted.
+</summary>
+<returns> MsgPacketList* : Pointer to the MsgPacketList (NULL if no memory is available)</returns>
+*/
+/**************************************************************************************************************/
+static MsgPacketList * acquire_nai_msg_packet_list(void)
+{
+	MsgPacketList *ptNewMsgPacketList = NULL;
+
+	if (!g_bMsgPoolInitialized)
+		init_nai_msg_pool();
+
+	if (g_ptFreeMsgPacketLists != NULL)
+	{
+		ptNewMsgPacketList = g_ptFreeMsgPacketLists;
+		g_ptFreeMsgPacketLists = ptNewMsgPacketList->ptNext;
+	}
+	else
+	{
+		ptNewMsgPacketList = aligned_malloc(sizeof(MsgPacketList), 4);
+		if (ptNewMsgPacketList == NULL)
+			return NULL;
+
+		ptNewMsgPacketList->ucOwner = NAI_MSG_PACKET_FROM_HEAP;
+		g_tMsgPoolStats.unHeapAllocs++;
+	}
+
+	return ptNewMsgPacketList;
+}
+
+/**************************************************************************************************************/
+/**
+\ingroup MessagePool
+<summary>
+release_nai_msg_packet_list is responsible for giving a MsgPacketList back to wherever it came from in O(1). The
+packets of the list must already have been deleted (see delete_nai_msg_packets).
+</summary>
+<param name="ptMsgPacketList"> : (Input) Pointer to MsgPacketList struct to release.</param>
+<returns>VOID</returns>
+*/
+/**************************************************************************************************************/
+static void release_nai_msg_packet_list(MsgPacketList *ptMsgPacketList)
+{
+	if (ptMsgPacketList == NULL)
+		return;
+
+	if (ptMsgPacketList->ucOwner == NAI_MSG_PACKET_FROM_POOL)
+	{
+		ptMsgPacketList->ptNext = g_ptFreeMsgPacketLists;
+		g_ptFreeMsgPacketLists = ptMsgPacketList;
+	}
+	else
+		aligned_free(ptMsgPacketList);
+}
+
+/**************************************************************************************************************/
+/**
+\ingroup MessagePool
+<summary>
+free_nai_msg_packet_list is responsible for deleting all packets of a MsgPacketList and then releasing the list
+itself. This replaces the delete_nai_msg_packets / aligned_free pair for lists created with 
+create_nai_msg_packet_list.
+</summary>
+<param name="ptMsgPacketList"> : (Input) Pointer to MsgPacketList struct to free.</param>
+<returns>VOID</returns>
+<seealso cref="delete_nai_msg_packets">
+*/
+/**************************************************************************************************************/
+void free_nai_msg_packet_list(MsgPacketList *ptMsgPacketList)
+{
+	if (ptMsgPacketList == NULL)
+		return;
+
+	delete_nai_msg_packets(ptMsgPacketList);
+	release_nai_msg_packet_list(ptMsgPacketList);
+}
+
+/**************************************************************************************************************/
+/**
+\ingroup MessagePool
+<summary>
+nai_get_msg_pool_stats is responsible for returning the MsgPacket pool usage counters.
+</summary>
+<param name="ptStats"> : (Output) Pointer to MsgPoolStats struct to fill in.</param>
+<param name="bReset"> : (Input) Reset the acquire and heap allocation counters after reading them.</param>
+<returns>VOID</returns>
+*/
+/**************************************************************************************************************/
+void nai_get_msg_pool_stats(MsgPoolStats *ptStats, BOOL bReset)
+{
+	if (!g_bMsgPoolInitialized)
+		init_nai_msg_pool();
+
+	if (ptStats != NULL)
+		memcpy(ptStats, &g_tMsgPoolStats, sizeof(MsgPoolStats));
+
+	if (bReset)
+	{
+		g_tMsgPoolStats.unPoolAcquires = 0;
+		g_tMsgPoolStats.unHeapAllocs = 0;
+		g_tMsgPoolStats.unHighWater = g_tMsgPoolStats.unInUse;
+	}
+}
+
+/**************************************************************************************************************/
+/**
+\ingroup MessageProcessing
+<summary>
+nai_get_msg_tx_stats is responsible for returning the TX FIFO throughput counters maintained by nai_send_msg.
+</summary>
+<param name="ptStats"> : (Output) Pointer to MsgTxStats struct to fill in.</param>
+<param name="bReset"> : (Input) Reset the counters after reading them.</param>
+<returns>VOID</returns>
+<seealso cref="nai_send_msg">
+*/
+/**************************************************************************************************************/
+void nai_get_msg_tx_stats(MsgTxStats *ptStats, BOOL bReset)
+{
+	if (ptStats != NULL)
+		memcpy(ptStats, &g_tMsgTxStats, sizeof(MsgTxStats));
+
+	if (bReset)
+		memset(&g_tMsgTxStats, 0, sizeof(MsgTxStats));
+}
+
+/**************************************************************************************************************/
+/**
+\ingroup MessageProcessing
+<summary>
+nai_get_tx_time_us is responsible for returning a free running microsecond timestamp used for the TX statistics.
+</summary>
+<returns>uint32_t : Microsecond timestamp</returns>
+*/
+/**************************************************************************************************************/
+static uint32_t nai_get_tx_time_us(void)
+{
+#if defined(__UBOOT)
+	return (uint32_t)timer_get_us();
+#else
+	return nai_get_timer(0) * 1000;
+#endif
+}
+
+#ifdef _BURST_FIFO_TX
+/**************************************************************************************************************/
+/**
+\ingroup MessageProcessing
+<summary>
+stage_nai_msg_packet is responsible for storing the message CRC in the specified packet and packing the packet
+(SERDES header + payload) into 32 bit FIFO words ready to be pushed into a TX FIFO.
+</summary>
+<param name="ptMsgPacket"> : (Input) Pointer to the MsgPacket to be staged.</param>
+<param name="unMsgCRC"> : (Input) CRC of the entire message (see compute_nai_msg_crc).</param>
+<param name="punStage"> : (Output) Staging buffer of at least NAI_TX_STAGE_WORDS 32 bit words.</param>
+<returns>uint32_t : Number of 32 bit FIFO words staged</returns>
+<seealso cref="nai_send_msg">
+*/
+/**************************************************************************************************************/
+static uint32_t stage_nai_msg_packet(MsgPacket *ptMsgPacket, uint32_t unMsgCRC, uint32_t *punStage)
+{
+	uint32_t i = 0;
+	uint32_t unNumWords = (TOTAL_SERDES_READWRITEREQ_HDR_IN_WORDS + (ptMsgPacket->tNAIMsg.tSerdesHdr.ucPayloadLength));
+	FIFOValue tFIFOVal;
+
+	if (unNumWords > MAX_SERDES_MSG_IN_WORDS)
+		unNumWords = MAX_SERDES_MSG_IN_WORDS;
+
+	ptMsgPacket->tNAIMsg.tSerdesPayLd.tTransportHdr.unCRC = unMsgCRC; /* Store the calculated MSG CRC in each packet that makes up the entire MSG */
+
+	/* An odd word count still sends a full 32 bit FIFO word (hi word is whatever follows in the packet) */
+	unNumWords = (unNumWords + 1) / 2;
+	for (i=0; i < unNumWords; i++)
+	{
+		tFIFOVal.usLoWord = ptMsgPacket->tNAIMsg.msg[(i * 2)];
+		tFIFOVal.usHiWord = ptMsgPacket->tNAIMsg.msg[(i * 2) + 1];
+		punStage[i] = tFIFOVal.unValue;
+	}
+
+	return unNumWords;
+}
+#endif
+
 /**************************************************************************************************************/
 /* NAI Message Creation Routines                                                                              */
 /** \defgroup MessageCreation Message Creation Functions                                                      */
@@ -291,8 +657,7 @@ create_nai_msg_packet is responsible for creating a new MsgPacket struct from th
 /**************************************************************************************************************/
 MsgPacket * create_nai_msg_packet(uint16_t* pusData)
 {
-//	MsgPacket *ptNewMsgPacket = malloc(sizeof(MsgPacket));
-	MsgPacket *ptNewMsgPacket = aligned_malloc(sizeof(MsgPacket), 4);
+	MsgPacket *ptNewMsgPacket = acquire_nai_msg_packet();
 
 #ifdef _DEBUG_X
 	int32_t i=0;
@@ -300,8 +665,10 @@ MsgPacket * create_nai_msg_packet(uint16_t* pusData)
 	for (i=0; i < MAX_SERDES_MSG_IN_WORDS; i++)
 		printf("usData[%d] = 0x%4.4x\r\n", i, pusData[i]);
 #endif
+	if (ptNewMsgPacket == NULL)
+		return NULL;
+
 	memcpy(ptNewMsgPacket->tNAIMsg.msg, pusData, (MAX_SERDES_MSG_IN_WORDS*2));
-	ptNewMsgPacket->ptNext = NULL;
 
 	return ptNewMsgPacket;
 }
@@ -319,14 +686,13 @@ payload.
 /**************************************************************************************************************/
 MsgPacket * clone_nai_msg_packet_sans_payload(MsgPacket *ptMsgPacket)
 {
-//	MsgPacket *ptNewMsgPacket = malloc(sizeof(MsgPacket));
-	MsgPacket *ptNewMsgPacket = aligned_malloc(sizeof(MsgPacket), 4);
+	MsgPacket *ptNewMsgPacket = acquire_nai_msg_packet();
 
-	/* Make a copy of the Msg Packet passed in */
-	memcpy(ptNewMsgPacket->tNAIMsg.msg, ptMsgPacket->tNAIMsg.msg, (MAX_SERDES_MSG_IN_WORDS*2));
-	ptNewMsgPacket->ptNext = NULL;
+	if (ptNewMsgPacket == NULL)
+		return NULL;
 
-	/* Clear out payload */
+	/* Copy only the headers of the Msg Packet passed in and clear out the payload */
+	memcpy(ptNewMsgPacket->tNAIMsg.msg, ptMsgPacket->tNAIMsg.msg, (CONFIG_TOTAL_PKT_HDR_IN_WORDS*2));
 	memset(&(ptNewMsgPacket->tNAIMsg.tSerdesPayLd.tTransportPayLd.tCommandPayLd.usData[0]), 0, (CONFIG_MAX_PAYLOAD_IN_WORDS*2)); 
 
 	return ptNewMsgPacket;
@@ -343,13 +709,16 @@ create_nai_msg_packet_list is responsible for creating a new (empty) MsgPacketLi
 /**************************************************************************************************************/
 MsgPacketList * create_nai_msg_packet_list()
 {
-//	MsgPacketList *ptNewMsgPacketList = malloc(sizeof(MsgPacketList));
-	MsgPacketList *ptNewMsgPacketList = aligned_malloc(sizeof(MsgPacketList), 4);
-		
+	MsgPacketList *ptNewMsgPacketList = acquire_nai_msg_packet_list();
+
+	if (ptNewMsgPacketList == NULL)
+		return NULL;
+
 	ptNewMsgPacketList->ptStart = NULL;
 	ptNewMsgPacketList->ptEnd = ptNewMsgPacketList->ptStart;
 	ptNewMsgPacketList->ptNext = NULL;
 	ptNewMsgPacketList->nCount = 0;
+	reset_nai_msg_crc(ptNewMsgPacketList);
 
 	return ptNewMsgPacketList;
 }
@@ -409,7 +778,7 @@ void init_nai_msgs(MsgList *ptMsgList)
 \ingroup MessageCreation
 <summary>
 create_and_append_nai_msg_packet is responsible for creating a new MsgPacket for the specified message data and
-appending it to the supplied MsgPacketList.
+appending it to the supplied MsgPacketList. The data is copied, so the caller may reuse its buffer straight away.
 </summary>
 <param name="ptMsgPacketList"> : (Input) Pointer to MsgPacketList struct (structure containing 1 or more message 
 packets).</param>
@@ -422,12 +791,33 @@ void create_and_append_nai_msg_packet(MsgPacketList *ptMsgPacketList, uint16_t*
 {	
 	MsgPacket *ptNewMsgPacket = create_nai_msg_packet(pusData);
 
+	if (ptNewMsgPacket != NULL)
+		append_nai_msg_packet(ptMsgPacketList, ptNewMsgPacket);
+}
+
+/**************************************************************************************************************/
+/**
+\ingroup MessageCreation
+<summary>
+append_nai_msg_packet is responsible for appending an already built MsgPacket (see acquire_nai_msg_packet) to the
+supplied MsgPacketList without copying it.
+</summary>
+<param name="ptMsgPacketList"> : (Input) Pointer to MsgPacketList struct (structure containing 1 or more message 
+packets).</param>
+<param name="ptNewMsgPacket"> : (Input) Packet to append. The list takes ownership of the packet.</param>
+<returns>None</returns>
+*/
+/**************************************************************************************************************/
+void append_nai_msg_packet(MsgPacketList *ptMsgPacketList, MsgPacket *ptNewMsgPacket)
+{
 #ifdef _VERBOSE
 	printf("Trans ID: %u Adding New Msg Packet - Sequence #: %u\r\n", 
 				ptNewMsgPacket->tNAIMsg.tSerdesPayLd.tTransportHdr.usID, 
 				ptNewMsgPacket->tNAIMsg.tSerdesPayLd.tTransportHdr.usSequenceNum);
 #endif
 
+	ptNewMsgPacket->ptNext = NULL;
+
 	if (ptMsgPacketList->ptEnd == NULL)
 	{
 		ptMsgPacketList->ptStart = ptNewMsgPacket;
@@ -442,6 +832,31 @@ void create_and_append_nai_msg_packet(MsgPacketList *ptMsgPacketList, uint16_t*
 	ptMsgPacketList->nCount++;
 }
 
+/**************************************************************************************************************/
+/**
+\ingroup MessageCreation
+<summary>
+attach_nai_msg_packet is responsible for appending a caller supplied MsgPacket to the specified MsgPacketList
+without copying it. The packet is marked as caller owned so delete_nai_msg_packets will unlink it but never free it.
+Only the MsgPacket itself (SERDES headers + payload) is used in place; a flat payload buffer still has to be split
+into packets, which create_and_append_nai_msg_packet and the write request builders do by copying it.
+The list refers to the caller's packet until it is deleted: the caller must not modify, reuse or free the packet
+before delete_nai_msg_packets (or free_nai_msg_packet_list) has been called on the list. Note that sending the
+message also writes the message CRC into each packet.
+</summary>
+<param name="ptMsgPacketList"> : (Input) Pointer to MsgPacketList struct (structure containing 1 or more message 
+packets).</param>
+<param name="ptMsgPacket"> : (Input) Caller owned packet. Must remain valid and unchanged until the list is deleted.</param>
+<returns>None</returns>
+<seealso cref="append_nai_msg_packet">
+*/
+/**************************************************************************************************************/
+void attach_nai_msg_packet(MsgPacketList *ptMsgPacketList, MsgPacket *ptMsgPacket)
+{
+	ptMsgPacket->ucOwner = NAI_MSG_PACKET_CALLER_OWNED;
+	append_nai_msg_packet(ptMsgPacketList, ptMsgPacket);
+}
+
 /**************************************************************************************************************/
 /**
 \ingroup MessageCreation
@@ -461,10 +876,11 @@ void delete_nai_msg_packets(MsgPacketList *ptMsgPacketList)
 	{
 		ptTraverse = ptMsgPacketList->ptStart;
 		ptMsgPacketList->ptStart = ptMsgPacketList->ptStart->ptNext;		
-//		free(ptTraverse);
-		aligned_free(ptTraverse);
+		release_nai_msg_packet(ptTraverse);
 		ptMsgPacketList->nCount--;			
 	}
+	ptMsgPacketList->ptEnd = NULL;
+	reset_nai_msg_crc(ptMsgPacketList);
 }
 
 /**************************************************************************************************************/
@@ -500,6 +916,48 @@ void add_nai_msg(MsgList *ptMsgList, MsgPacketList *ptMsgPacketList)
 	ptMsgList->nCount++;
 }
 
+/**************************************************************************************************************/
+/**
+\ingroup MessageCreation
+<summary>
+remove_nai_msg is responsible for unlinking the specified MsgPacketList (all packets for a given message) from the
+specified MsgList (list of MsgPacketList). The MsgPacketList itself is left intact for the caller to free.
+</summary>
+<param name="ptMsgList"> : (Input) Pointer to MsgList struct (structure containing 1 or more messages).</param>
+<param name="ptMsgPacketList"> : (Input) Pointer to MsgPacketList struct to be unlinked.</param>
+<returns>BOOL : TRUE if the MsgPacketList was found (and unlinked)</returns>
+<seealso cref="add_nai_msg">
+<seealso cref="free_nai_msg_packet_list">
+*/
+/**************************************************************************************************************/
+BOOL remove_nai_msg(MsgList *ptMsgList, MsgPacketList *ptMsgPacketList)
+{
+	MsgPacketList *ptPrev = NULL;
+	MsgPacketList *ptTraverse = ptMsgList->ptStart;
+
+	while (ptTraverse != NULL && ptTraverse != ptMsgPacketList)
+	{
+		ptPrev = ptTraverse;
+		ptTraverse = ptTraverse->ptNext;
+	}
+
+	if (ptTraverse == NULL)
+		return FALSE;
+
+	if (ptPrev == NULL)
+		ptMsgList->ptStart = ptTraverse->ptNext;
+	else
+		ptPrev->ptNext = ptTraverse->ptNext;
+
+	if (ptMsgList->ptEnd == ptTraverse)
+		ptMsgList->ptEnd = ptPrev;
+
+	ptTraverse->ptNext = NULL;
+	ptMsgList->nCount--;
+
+	return TRUE;
+}
+
 /**************************************************************************************************************/
 /**
 \ingroup MessageCreation
@@ -519,11 +977,10 @@ void delete_nai_msgs(MsgList *ptMsgList)
 	{
 		ptTraverse = ptMsgList->ptStart;
 		ptMsgList->ptStart = ptMsgList->ptStart->ptNext;
-		delete_nai_msg_packets(ptTraverse);
-//		free(ptTraverse);
-		aligned_free(ptTraverse);
+		free_nai_msg_packet_list(ptTraverse);
 		ptMsgList->nCount--;
 	}
+	ptMsgList->ptEnd = NULL;
 }
 
 /**************************************************************************************************************/
@@ -657,26 +1114,25 @@ uint32_t compute_nai_msg_crc(MsgPacketList *ptMsgPacketList)
 	uint32_t unCRC = 0;
 
 #ifdef _COMPUTE_CRC
-	MsgPacket *ptTraverse = ptMsgPacketList->ptStart;
-	NAIMsg *ptMsgCopy = NULL;
-//	ptMsgCopy = (NAIMsg *)malloc(sizeof(NAIMsg));
-	ptMsgCopy = (NAIMsg *)aligned_malloc(sizeof(NAIMsg), 4);
+	MsgPacket *ptTraverse = NULL;
+
+	/* Resume from the last packet already folded into the running CRC; only packets appended since are scanned */
+	if (ptMsgPacketList->ptCRCEnd == NULL)
+	{
+		ptMsgPacketList->unCRC = 0;
+		ptTraverse = ptMsgPacketList->ptStart;
+	}
+	else
+		ptTraverse = ptMsgPacketList->ptCRCEnd->ptNext;
 
 	while (ptTraverse != NULL)
 	{	
-		/* Let's make sure our buffer is all zero to start */
-		memset(ptMsgCopy->msg, 0, sizeof(NAIMsg));
-
-		/* Make a copy of the message we want to perform a CRC on...we do this because we need to 
-           strip some information that is ok to change during transit before we compute the CRC */
-		memcpy(ptMsgCopy->msg, ptTraverse->tNAIMsg.msg, sizeof(NAIMsg));
-		ptMsgCopy->tSerdesHdr.usSERDES0 &= 0x3F; /* This zeros out SeqNumRx (bit 7) and SeqNumTx (bit 6) */
-		ptMsgCopy->tSerdesHdr.usSERDES4 &= 0x0F; /* This zeros out COMPLETER_ID (bits 4 - 7) */
-		ptMsgCopy->tSerdesPayLd.tTransportHdr.unCRC = 0; /* Do not take CRC into account when computing CRC (since it is not present when we 1st calculate CRC */
-
-		unCRC = crc32(unCRC, (void *)ptMsgCopy->msg, ptMsgCopy->tSerdesHdr.ucPayloadLength);
+		ptMsgPacketList->unCRC = update_nai_msg_packet_crc(ptMsgPacketList->unCRC, ptTraverse);
+		ptMsgPacketList->ptCRCEnd = ptTraverse;
 		ptTraverse = ptTraverse->ptNext;
 	}
+
+	unCRC = ptMsgPacketList->unCRC;
 #else
 #ifdef _VERBOSE
 	printf("***COMPUTING OF CRC HAS BEEN TURNED OFF***\r\n");	
@@ -685,12 +1141,67 @@ uint32_t compute_nai_msg_crc(MsgPacketList *ptMsgPacketList)
 	return unCRC;
 }
 
+/**************************************************************************************************************/
+/**
+\ingroup MessageValidation
+<summary>
+reset_nai_msg_crc is responsible for discarding the running CRC of a message. It must be called before packets
+that have already been folded into the CRC (see compute_nai_msg_crc) are modified in place, e.g. when a request is
+turned into its response.
+</summary>
+<param name="ptMsgPacketList"> : (Input) Pointer to MsgPacketList struct (structure containing 1 or more message 
+packets).</param>
+<returns>None</returns>
+*/
+/**************************************************************************************************************/
+void reset_nai_msg_crc(MsgPacketList *ptMsgPacketList)
+{
+	ptMsgPacketList->unCRC = 0;
+	ptMsgPacketList->ptCRCEnd = NULL;
+}
+
+#ifdef _COMPUTE_CRC
+/**************************************************************************************************************/
+/**
+\ingroup MessageValidation
+<summary>
+update_nai_msg_packet_crc is responsible for folding a single packet into a running message CRC. Only the headers
+hold fields that are allowed to change in transit (SeqNumRx/SeqNumTx, COMPLETER_ID and the CRC itself), so only 
+the headers are copied and masked; the payload is run through crc32 in place.
+</summary>
+<param name="unCRC"> : (Input) CRC of the packets before this one (0 for the first packet).</param>
+<param name="ptMsgPacket"> : (Input) Pointer to MsgPacket struct to fold in.</param>
+<returns>uint32_t : updated CRC</returns>
+*/
+/**************************************************************************************************************/
+static uint32_t update_nai_msg_packet_crc(uint32_t unCRC, MsgPacket *ptMsgPacket)
+{
+	uint32_t unLength = 0;
+	uint32_t unHdrLength = 0;
+
+	memcpy(g_tMsgCRCHdr.msg, ptMsgPacket->tNAIMsg.msg, (CONFIG_TOTAL_PKT_HDR_IN_WORDS*2));
+	g_tMsgCRCHdr.tSerdesHdr.usSERDES0 &= 0x3F; /* This zeros out SeqNumRx (bit 7) and SeqNumTx (bit 6) */
+	g_tMsgCRCHdr.tSerdesHdr.usSERDES4 &= 0x0F; /* This zeros out COMPLETER_ID (bits 4 - 7) */
+	g_tMsgCRCHdr.tSerdesPayLd.tTransportHdr.unCRC = 0; /* Do not take CRC into account when computing CRC (since it is not present when we 1st calculate CRC */
+
+	unLength = g_tMsgCRCHdr.tSerdesHdr.ucPayloadLength;
+	unHdrLength = MIN(unLength, (CONFIG_TOTAL_PKT_HDR_IN_WORDS*2));
+
+	unCRC = crc32(unCRC, (void *)g_tMsgCRCHdr.msg, unHdrLength);
+	if (unLength > unHdrLength)
+		unCRC = crc32(unCRC, ((uint8_t *)ptMsgPacket->tNAIMsg.msg) + unHdrLength, (unLength - unHdrLength));
+
+	return unCRC;
+}
+#endif
+
 /**************************************************************************************************************/
 /**
 \ingroup MessageValidation
 <summary>
 compute_crc_and_update_packet_list is responsible for computing the CRC for an entire message (possibly over 
-multiple packets) and then updating each packet of the message with the overall CRC.
+multiple packets) and then updating each packet of the message with the overall CRC. Packets already folded into
+the running CRC are not rescanned; callers that rewrote packets in place must call reset_nai_msg_crc first.
 </summary>
 <param name="ptMsgPacketList"> : (Input) Pointer to MsgPacketList struct (structure containing 1 or more message 
 packets).</param>
@@ -884,6 +1395,9 @@ int32_t deal_with_nai_msg(MsgPacketList *ptMsgPacketList)
 				break;
 
 			case COMMAND_TYPECODE_RESET_MODULE :
+#ifdef _QSPI_SUPPORT
+				sync_qspi();
+#endif
 				nai_reset_module();
 				break;
 
@@ -1097,8 +1611,7 @@ int32_t nai_send_msg_finished_response(MsgPacketList *ptMsgPacketList, int32_t n
 #endif
 		/* Send Msg */
 		nStatus = nai_send_msg(ptResponsePacketList);
-		delete_nai_msg_packets(ptResponsePacketList);
-		aligned_free(ptResponsePacketList);
+		free_nai_msg_packet_list(ptResponsePacketList);
 		ptResponsePacketList = NULL;
 	}
 #ifdef _VERBOSE
@@ -1148,46 +1661,55 @@ int32_t nai_send_msgs(MsgList *ptMsgList)
 /**
 \ingroup MessageProcessing
 <summary>
-nai_send_msg is responsible for sending each MsgPacket found in the specified MsgPacketList over SERDES.
+push_nai_msg_packets is responsible for pushing each MsgPacket found in the specified MsgPacketList into the TX 
+FIFO without waiting for any completion response. While waiting for the TX FIFO to drain, any packets the completer 
+sends back are received into ptRxMsgList (when supplied) so a completer busy answering earlier messages cannot 
+stall the transmit.
 </summary>
 <param name="ptMsgPackets"> : (Input) Pointer to MsgPacketList struct (structure containing 1 or more message 
 packets).</param>
+<param name="ptRxMsgList"> : (Output) Pointer to MsgList struct collecting packets received while transmitting 
+(NULL when no other messages are in flight).</param>
 <returns>int32_t : Status 
 	- 0  : SUCCESS
 	- Non-Zero : ERROR
 </returns>
 <seealso cref="compute_nai_msg_crc">
+<seealso cref="nai_write32_fifo">
+<seealso cref="nai_get_msg_tx_stats">
 */
 /**************************************************************************************************************/
-int32_t nai_send_msg(MsgPacketList *ptMsgPackets)
+static int32_t push_nai_msg_packets(MsgPacketList *ptMsgPackets, MsgList *ptRxMsgList)
 {
 	int32_t nStatus = NAI_SUCCESS;
-	BOOL bWaitForStatusReply = FALSE;
-	int32_t i = 0;
 	volatile uint32_t unAddr = 0;
 	volatile uint32_t unBeginTxAddr = 0; 
-	int32_t nNumLoops = 0; 
 	uint32_t unMsgCRC = 0;
 	uint8_t ucCompleterID = 0;
 	uint8_t ucRequesterID = 0;
 	uint32_t ulTimer = 0;
-	MsgList tMsgList;
-	uint32_t unCompletionTimeout = 0;
-	
-#ifdef _DEBUG_X
-	uint32_t unTemp = 0;
+	uint32_t unTxStartTime = 0;
+#ifdef _BURST_FIFO_TX
+	uint8_t ucStage = 0;
+	uint32_t unStageWords = 0;
+#else
+	int32_t i = 0;
+	int32_t nNumLoops = 0; 
 #endif
 
 #ifdef _VERBOSE
 	int32_t nLoopCount = 0;
-	printf("**************nai_send_msg**************\r\n");
 #endif
 
-	bWaitForStatusReply = nai_msg_requires_finished_response(ptMsgPackets);
-
 	unMsgCRC = compute_nai_msg_crc(ptMsgPackets);
 
+	unTxStartTime = nai_get_tx_time_us();
+
 	MsgPacket *ptTraverse = ptMsgPackets->ptStart;
+#ifdef _BURST_FIFO_TX
+	if (ptTraverse != NULL)
+		unStageWords = stage_nai_msg_packet(ptTraverse, unMsgCRC, g_unTxStage[ucStage]);
+#endif
 	while (ptTraverse != NULL)
 	{
 		ucRequesterID = nai_get_serdes_requester_id(ptTraverse);
@@ -1205,6 +1727,16 @@ int32_t nai_send_msg(MsgPacketList *ptMsgPackets)
 		/* We have a message to send...but the FIFO is not ready...need to wait!*/	
 		while (!nai_tx_fifo_empty(ucRequesterID, ucCompleterID))
 		{
+			/* When other messages are in flight the completer may be stuck sending us their responses...drain them
+			 * so it can get back to emptying our TX FIFO */
+			if ((ptRxMsgList != NULL) && nai_rx_fifo_pkt_ready(ucRequesterID, ucCompleterID))
+			{
+				nStatus = nai_receive_msg_packet(ucRequesterID, ucCompleterID, ptRxMsgList);
+				if (nStatus != NAI_SUCCESS)
+					break;
+				ulTimer = nai_get_timer(0);
+			}
+
 			/* If FIFO did not get serviced within a reasonable amount of time..get out */
 			if (nai_get_timer(ulTimer) > (COMPLETION_TIMEOUT))
 			{
@@ -1215,31 +1747,137 @@ int32_t nai_send_msg(MsgPacketList *ptMsgPackets)
 
 		if (nStatus != NAI_SUCCESS)
 			break;
-		
+
+#ifdef _BURST_FIFO_TX
+		/* FIFO addresses only depend on the requester / completer pair so only look them up when the pair changes */
+		if ((ucRequesterID != g_ucTxCachedRequesterID) || (ucCompleterID != g_ucTxCachedCompleterID))
+		{
+			g_unTxCachedFIFOAddr = nai_get_tx_fifo_address(ucRequesterID, ucCompleterID);
+			g_unTxCachedPktReadyAddr = nai_get_tx_fifo_pkt_ready_address(ucRequesterID, ucCompleterID);
+			g_ucTxCachedRequesterID = ucRequesterID;
+			g_ucTxCachedCompleterID = ucCompleterID;
+		}
+		unAddr = g_unTxCachedFIFOAddr;
+		unBeginTxAddr = g_unTxCachedPktReadyAddr;
+
+#ifdef _VERBOSE
+		printf("Sending Msg Sequence #: %u\r\n", ptTraverse->tNAIMsg.tSerdesPayLd.tTransportHdr.usSequenceNum);
+		printf("Num FIFO Words        : %u\r\n", unStageWords); 
+#endif
+		nStatus = nai_write32_fifo(unAddr, g_unTxStage[ucStage], unStageWords);
+		if (nStatus != NAI_SUCCESS)
+			break;
+
+		/* Now force transfer of data now that the FIFO is filled with current message*/
+		nai_write32(unBeginTxAddr, (uint32_t)1);
+		g_tMsgTxStats.unPackets++;
+		g_tMsgTxStats.unWords += unStageWords;
+
+		/* Stage the next packet into the other buffer while the FPGA drains this one */
+		ptTraverse = ptTraverse->ptNext;
+		ucStage ^= 1;
+		if (ptTraverse != NULL)
+			unStageWords = stage_nai_msg_packet(ptTraverse, unMsgCRC, g_unTxStage[ucStage]);
+#else
 		ptTraverse->tNAIMsg.tSerdesPayLd.tTransportHdr.unCRC = unMsgCRC; /* Store the calculated MSG CRC in each packet that makes up the entire MSG */			
 		unAddr = nai_get_tx_fifo_address(ucRequesterID, ucCompleterID);
 		unBeginTxAddr = nai_get_tx_fifo_pkt_ready_address(ucRequesterID, ucCompleterID);
 
-		nNumLoops = ((TOTAL_SERDES_READWRITEREQ_HDR_IN_WORDS + (ptTraverse->tNAIMsg.tSerdesHdr.ucPayloadLength))); /* TOTAL_SERDES_READWRITEREQ_HDR_IN_WORDS = 6 Words + Num Words in Serdes PayLoad */
+		nNumLoops = ((TOTAL_SERDES_READWRITEREQ_HDR_IN_WORDS + (ptTraverse->tNAIMsg.tSerdesHdr.ucPayloadLength))); /* TOTAL_SERDES_READWRITEREQ_HDR_IN_WORDS = 6 Words + Num Words in Serdes PayLoad */
+#ifdef _VERBOSE
+		printf("Sending Msg Sequence #: %u\r\n", ptTraverse->tNAIMsg.tSerdesPayLd.tTransportHdr.usSequenceNum);
+		printf("Num Words for FIFO    : %d\r\n", nNumLoops); 
+#endif
+		for (i=0; i <nNumLoops; i++)
+		{
+			FIFOValue tFIFOVal;
+			tFIFOVal.usLoWord = ptTraverse->tNAIMsg.msg[i++];
+			tFIFOVal.usHiWord = ptTraverse->tNAIMsg.msg[i];
+
+#ifdef _DEBUG_X
+			printf("FIFO VAL = 0x%8x\r\n", tFIFOVal.unValue);
+#endif
+			nai_write32(unAddr, tFIFOVal.unValue);
+			g_tMsgTxStats.unWords++;
+		}
+
+		/* Now force transfer of data now that the FIFO is filled with current message*/
+		nai_write32(unBeginTxAddr, (uint32_t)1);
+		g_tMsgTxStats.unPackets++;
+		ptTraverse = ptTraverse->ptNext;				
+#endif
+	}
+
+	g_tMsgTxStats.unMicroseconds += (nai_get_tx_time_us() - unTxStartTime);
+
+	return nStatus;
+}
+
+/**************************************************************************************************************/
+/**
+\ingroup MessageProcessing
+<summary>
+get_nai_msg_execution_status is responsible for extracting the "Execution Status" out of a request finished
+response (see nai_send_msg_finished_response).
+</summary>
+<param name="ptMsgPacketList"> : (Input) Pointer to MsgPacketList struct holding the finished response.</param>
+<returns>int32_t : Execution status reported by the completer (NAI_SUCCESS if the response carries none)</returns>
+*/
+/**************************************************************************************************************/
+static int32_t get_nai_msg_execution_status(MsgPacketList *ptMsgPacketList)
+{
+	int32_t nStatus = NAI_SUCCESS;
+	MsgPacket *ptMsgPacket = ptMsgPacketList->ptStart;
+	FIFOValue tFIFOValue;
+
+	if (ptMsgPacket != NULL && (ptMsgPacket->tNAIMsg.tSerdesPayLd.tTransportHdr.usPacketPayLdLength >= 2))
+	{			
+		tFIFOValue.usLoWord = ptMsgPacket->tNAIMsg.tSerdesPayLd.tTransportPayLd.tCommandPayLd.usData[0];
+		tFIFOValue.usHiWord = ptMsgPacket->tNAIMsg.tSerdesPayLd.tTransportPayLd.tCommandPayLd.usData[1];
+		nStatus = (int32_t)tFIFOValue.unValue; 
+	}
+
+	return nStatus;
+}
+
+/**************************************************************************************************************/
+/**
+\ingroup MessageProcessing
+<summary>
+nai_send_msg is responsible for sending each MsgPacket found in the specified MsgPacketList over SERDES.
+</summary>
+<param name="ptMsgPackets"> : (Input) Pointer to MsgPacketList struct (structure containing 1 or more message 
+packets).</param>
+<returns>int32_t : Status 
+	- 0  : SUCCESS
+	- Non-Zero : ERROR
+</returns>
+<seealso cref="push_nai_msg_packets">
+<seealso cref="get_nai_msg_execution_status">
+*/
+/**************************************************************************************************************/
+int32_t nai_send_msg(MsgPacketList *ptMsgPackets)
+{
+	int32_t nStatus = NAI_SUCCESS;
+	BOOL bWaitForStatusReply = FALSE;
+	uint8_t ucCompleterID = 0;
+	uint8_t ucRequesterID = 0;
+	uint32_t ulTimer = 0;
+	MsgList tMsgList;
+	uint32_t unCompletionTimeout = 0;
+
 #ifdef _VERBOSE
-		printf("Sending Msg Sequence #: %u\r\n", ptTraverse->tNAIMsg.tSerdesPayLd.tTransportHdr.usSequenceNum);
-		printf("Num Words for FIFO    : %d\r\n", nNumLoops); 
+	printf("**************nai_send_msg**************\r\n");
 #endif
-		for (i=0; i <nNumLoops; i++)
-		{
-			FIFOValue tFIFOVal;
-			tFIFOVal.usLoWord = ptTraverse->tNAIMsg.msg[i++];
-			tFIFOVal.usHiWord = ptTraverse->tNAIMsg.msg[i];
 
-#ifdef _DEBUG_X
-			printf("FIFO VAL = 0x%8x\r\n", tFIFOVal.unValue);
-#endif
-			nai_write32(unAddr, tFIFOVal.unValue);
-		}
+	bWaitForStatusReply = nai_msg_requires_finished_response(ptMsgPackets);
 
-		/* Now force transfer of data now that the FIFO is filled with current message*/
-		nai_write32(unBeginTxAddr, (uint32_t)1);
-		ptTraverse = ptTraverse->ptNext;				
+	nStatus = push_nai_msg_packets(ptMsgPackets, NULL);
+
+	if (ptMsgPackets->ptStart != NULL)
+	{
+		ucRequesterID = nai_get_serdes_requester_id(ptMsgPackets->ptStart);
+		ucCompleterID = nai_get_serdes_completer_id(ptMsgPackets->ptStart);
 	}
 
 	/* OK - if we got here and no errors...then we need to wait to get completion status on the msg that was sent */
@@ -1277,19 +1915,8 @@ int32_t nai_send_msg(MsgPacketList *ptMsgPackets)
 				if (validate_nai_msgs(&tMsgList) == 0)
 				{
 					/* NOTE: Shound only have 1 message (1 packet) being returned */
-					MsgPacketList *ptFirstMsg = tMsgList.ptStart;
-					if (ptFirstMsg != NULL)
-					{
-						/* Extract the "Execution Status" out of the payload */
-						MsgPacket *ptTraverse = ptFirstMsg->ptStart;
-						if (ptTraverse != NULL && (ptTraverse->tNAIMsg.tSerdesPayLd.tTransportHdr.usPacketPayLdLength >= 2))
-						{			
-							FIFOValue tFIFOValue;
-							tFIFOValue.usLoWord = ptTraverse->tNAIMsg.tSerdesPayLd.tTransportPayLd.tCommandPayLd.usData[0];
-							tFIFOValue.usHiWord = ptTraverse->tNAIMsg.tSerdesPayLd.tTransportPayLd.tCommandPayLd.usData[1];
-							nStatus = (int32_t)tFIFOValue.unValue; 
-						}
-					}				
+					if (tMsgList.ptStart != NULL)
+						nStatus = get_nai_msg_execution_status(tMsgList.ptStart);
 				}
 			}
 
@@ -1501,7 +2128,8 @@ uint16_t calculate_nai_expected_sequence_count(uint32_t unPayloadWordLength)
 /**
 \ingroup FlashUtils
 <summary>
-nai_erase_flash is responsible for erasing specified portion of FLASH.
+nai_erase_flash is responsible for erasing specified portion of FLASH. With _QSPI_ERASE_AHEAD the erase is only 
+queued (see queue_erase_qspi) so the finished response goes out before the sectors are actually erased.
 </summary>
 <param name="ptMsgPacketList"> : (Input) Pointer to MsgPacketList struct.</param>
 <returns>int32_t : Status 
@@ -1542,8 +2170,8 @@ int32_t nai_erase_flash(MsgPacketList *ptMsgPacketList)
 #endif
 
 #ifdef _QSPI_SUPPORT
-	probe_qspi();
-	nStatus = erase_qspi(unEraseOffset, (ucNumPages * MAX_FLASH_PAGE_BYTES));
+	/* With _QSPI_ERASE_AHEAD this returns straight away; the sectors are erased while the next messages arrive */
+	nStatus = queue_erase_qspi(unEraseOffset, (ucNumPages * MAX_FLASH_PAGE_BYTES));
 #endif
 
 	return nStatus;
@@ -1554,6 +2182,8 @@ int32_t nai_erase_flash(MsgPacketList *ptMsgPacketList)
 \ingroup FlashUtils
 <summary>
 nai_write_to_flash is responsible for writing a specific message to Flash (Message may consist of multiple packets).
+Packet payloads are streamed to the flash as they are walked (see stream_to_qspi) instead of being gathered into a
+buffer first.
 </summary>
 <param name="ptMsgPacketList"> : (Input) Pointer to MsgPacketList struct (structure containing 1 or more message 
 packets).</param>
@@ -1567,25 +2197,12 @@ packets).</param>
 int32_t nai_write_to_flash(MsgPacketList *ptMsgPacketList)
 {
 	int32_t nStatus = NAI_SUCCESS;
-#ifdef _QSPI_SUPPORT
-	volatile uint32_t unAddress;	
-#endif	
 	uint32_t unOffset = 0x0;	
 	uint16_t usPacketPayLdLength = 0;
-	uint16_t usPacketPayLdLengthInWords = 0;
-	uint32_t i = 0;
-	uint32_t k = 0;
-	uint32_t unMsgPayLdLength = 0;
-	uint32_t unWriteBufLengthInWords = (MAX_FLASH_PAGE_BYTES >> 1);
-	uint32_t unTotalWordsToWrite = 0;
 #ifdef _PERFORM_QSPI_ERASE_ON_FLASH_WRITE
-	uint16_t usNumSectorsToErase = 0;
+	uint32_t unTotalBytesToWrite = 0;
 	uint32_t unEraseOffset = 0x0;
 #endif
-	WORDValue tWORDValue;
-#ifdef _QSPI_SUPPORT
-	memset(pucTempBuf, 0, MAX_FLASH_PAGE_BYTES);
-#endif
 
 #ifdef _VERBOSE
 	printf("BEGIN nai_write_to_flash\r\n");
@@ -1600,46 +2217,38 @@ int32_t nai_write_to_flash(MsgPacketList *ptMsgPacketList)
 	if (ptMsgPacket == NULL)
 		return NAI_INVALID_PARAMETER_VALUE;
 
-	/* Determine actual payload (minus header info) for entire message (all packets)!*/
-	unTotalWordsToWrite = (ptMsgPacket->tNAIMsg.tSerdesPayLd.tTransportHdr.unMsgLength - (ptMsgPacket->tNAIMsg.tSerdesPayLd.tTransportHdr.usExpectedSequenceCount * CONFIG_TOTAL_PKT_HDR_IN_WORDS));
-	if (unTotalWordsToWrite < unWriteBufLengthInWords)
-		unWriteBufLengthInWords = unTotalWordsToWrite;
-
-	/* Determine how many sectors need erasing! */
-#ifdef _PERFORM_QSPI_ERASE_ON_FLASH_WRITE
-	usNumSectorsToErase = (uint16_t)((unWriteBufLengthInWords << 1) / MAX_FLASH_PAGE_BYTES);
-	if (((unWriteBufLengthInWords << 1) % MAX_FLASH_PAGE_BYTES) != 0)
-		usNumSectorsToErase++;
-#endif
 	unOffset = ptMsgPacket->tNAIMsg.tSerdesPayLd.tTransportPayLd.tCommandHdr.unOffset;		
 //printf("offset = 0x%4.4x\r\n", unOffset);
 
+#ifdef _PERFORM_QSPI_ERASE_ON_FLASH_WRITE
+	/* Determine actual payload (minus header info) for entire message (all packets)!*/
+	unTotalBytesToWrite = ((ptMsgPacket->tNAIMsg.tSerdesPayLd.tTransportHdr.unMsgLength - (ptMsgPacket->tNAIMsg.tSerdesPayLd.tTransportHdr.usExpectedSequenceCount * CONFIG_TOTAL_PKT_HDR_IN_WORDS)) << 1);
+
 	/* We must erase full sectors in qspi that start on sector boundaries! */
 	/* If offset is not on a page boundary..we just divide by the page size and truncate (by casting) */
-#ifdef _PERFORM_QSPI_ERASE_ON_FLASH_WRITE
-	if ((unOffset % MAX_FLASH_PAGE_BYTES) != 0)
-		unEraseOffset = ((uint32_t)(unOffset / MAX_FLASH_PAGE_BYTES) * MAX_FLASH_PAGE_BYTES);
-	else /* Erase offset is the same as the write request offset */
-		unEraseOffset = unOffset;
-#endif
+	unEraseOffset = ((uint32_t)(unOffset / MAX_FLASH_PAGE_BYTES) * MAX_FLASH_PAGE_BYTES);
+
+	/* When this message continues the previous one, the sector the previous one ended in has already been erased
+	   (and partly written) so it must not be erased again */
+	if (unOffset == g_unFlashWriteNext && unOffset < g_unFlashWriteEraseEnd)
+		unEraseOffset = g_unFlashWriteEraseEnd;
+	g_unFlashWriteNext = unOffset + unTotalBytesToWrite;
 
-	/* Now we can erase what we need to use */
 #ifdef _VERBOSE
-#ifdef _PERFORM_QSPI_ERASE_ON_FLASH_WRITE
-	printf("Erase qspi - unEraseOffset = 0x%4.4x  Amount to Erase in Bytes = 0x%4.4x\r\n", unEraseOffset, (usNumSectorsToErase * MAX_FLASH_PAGE_BYTES));
-#endif	
+	printf("Erase qspi - unEraseOffset = 0x%4.4x  Amount to Erase in Bytes = 0x%4.4x\r\n", unEraseOffset, ((unOffset + unTotalBytesToWrite) - MIN(unEraseOffset, (unOffset + unTotalBytesToWrite))));
 #endif
 
 #ifdef _QSPI_SUPPORT
-	probe_qspi();
-#ifdef _PERFORM_QSPI_ERASE_ON_FLASH_WRITE
-	nStatus = erase_qspi(unEraseOffset, (usNumSectorsToErase * MAX_FLASH_PAGE_BYTES));
-	if (nStatus != NAI_SUCCESS)
-		return nStatus;
+	/* The sectors are only queued here; stream_to_qspi erases each one just ahead of the page it programs */
+	if (unEraseOffset < (unOffset + unTotalBytesToWrite))
+	{
+		g_unFlashWriteEraseEnd = roundup((unOffset + unTotalBytesToWrite), MAX_FLASH_PAGE_BYTES);
+		nStatus = queue_erase_qspi(unEraseOffset, (g_unFlashWriteEraseEnd - unEraseOffset));
+	}
 #endif
 #endif
 
-	while (ptMsgPacket != NULL)
+	while (ptMsgPacket != NULL && nStatus == NAI_SUCCESS)
 	{	
 		usPacketPayLdLength = ptMsgPacket->tNAIMsg.tSerdesPayLd.tTransportHdr.usPacketPayLdLength;
 
@@ -1650,60 +2259,29 @@ int32_t nai_write_to_flash(MsgPacketList *ptMsgPacketList)
 		if ((usPacketPayLdLength % 2) != 0)
 			usPacketPayLdLength++;
 
-		/* Let's minimize the number of calls to write to qspi. - Build up a full msg buffer prior to calling the write */
-		if (nStatus == NAI_SUCCESS)
-		{	
-			usPacketPayLdLengthInWords = convert_bytes_to_words(usPacketPayLdLength);
-			for (k = 0; k < usPacketPayLdLengthInWords; k++)
-			{
-				tWORDValue.usValue = ptMsgPacket->tNAIMsg.tSerdesPayLd.tTransportPayLd.tCommandPayLd.usData[k];
-				pucTempBuf[i++] = tWORDValue.ucLoByte;
-				pucTempBuf[i++] = tWORDValue.ucHiByte;
-				unMsgPayLdLength += 2;
-
-
-				if (i == MAX_FLASH_PAGE_BYTES)
-				{
+		/* The payload words are stored low byte first, which on this (little endian) CPU is already flash byte 
+		   order...so hand the packet payload straight to the flash stream, full pages are programmed as they fill */
 #ifdef _QSPI_SUPPORT
-					unAddress = (volatile uint32_t)&pucTempBuf[0];
-
-#ifdef _VERBOSE
-					printf("Address = 0x%8.4x  Offset = 0x%4.4x  Size of msg buffer:%u\r\n", unAddress, unOffset, MAX_FLASH_PAGE_BYTES);
-#endif
-					nStatus = write_to_qspi(unAddress, unOffset, MAX_FLASH_PAGE_BYTES);
-//printf("After write_to_qspi\r\n");
-#endif
-					unOffset += unMsgPayLdLength;
-					unMsgPayLdLength = 0;
-					i = 0;
-				}
-			}
-		}
-
-		if (nStatus != NAI_SUCCESS)
-		{
-#ifdef _VERBOSE
-			printf("ERROR - write_to_qspi - status = %d\r\n", nStatus);
+		nStatus = stream_to_qspi(unOffset, (uint8_t *)&(ptMsgPacket->tNAIMsg.tSerdesPayLd.tTransportPayLd.tCommandPayLd.usData[0]), usPacketPayLdLength);
 #endif
-			return nStatus;
-		}
+		unOffset += usPacketPayLdLength;
 
 		ptMsgPacket = ptMsgPacket->ptNext;
 	}
 
 #ifdef _QSPI_SUPPORT
-	/* NOTE: It is possible that we had an even multiple of the MAX_FLASH_PAGE .. so there is nothing left to write here! */
-	if (nStatus == NAI_SUCCESS && unMsgPayLdLength > 0)
+	/* Program the partial page left at the end of the message so the data is in flash before we respond */
+	if (nStatus == NAI_SUCCESS)
+		nStatus = flush_qspi_stream();
+#endif
+
+	if (nStatus != NAI_SUCCESS)
 	{
-		/* Interact with QSPI */
-		unAddress = (volatile uint32_t)&pucTempBuf[0];
 #ifdef _VERBOSE
-		printf("Address = 0x%8.4x  Offset = 0x%4.4x  Size of msg buffer:%u\r\n", unAddress, unOffset, unMsgPayLdLength);
+		printf("ERROR - write_to_qspi - status = %d\r\n", nStatus);
 #endif
-
-		nStatus = write_to_qspi(unAddress, unOffset, unMsgPayLdLength);
+		return nStatus;
 	}
-#endif
 
 #ifdef _VERBOSE
 	printf("END nai_write_to_flash\r\n");
@@ -1735,7 +2313,7 @@ packets).</param>
 int32_t nai_read_from_flash(MsgPacketList *ptMsgPacketList)
 {
 	int32_t nStatus = NAI_SUCCESS;
-	volatile uint32_t unAddress;	
+	ulong unAddress;	
 	uint32_t unOffset = 0;
     uint32_t unRequestPayLdByteCount = 0;
 	uint32_t unFlashPacketByteCountToRead = 0;
@@ -1763,6 +2341,9 @@ int32_t nai_read_from_flash(MsgPacketList *ptMsgPacketList)
 	/* Determine expected sequence count...NOTE this takes into account all header info */
 	usExpectedSequenceCount = calculate_nai_expected_sequence_count(convert_bytes_to_words(unRequestPayLdByteCount));
 
+	/* The request packets are rewritten into the response below, so their running CRC no longer applies */
+	reset_nai_msg_crc(ptMsgPacketList);
+
 	/* SERDES HEADER */
 	/* NOTE: Passed in packet receiver is now the completer and pass in packet completer is now the requester since we are responding! */
 	ucNewCompleterID = (uint8_t)(ptMsgPacket->tNAIMsg.tSerdesHdr.ucRequesterID);
@@ -1793,9 +2374,12 @@ int32_t nai_read_from_flash(MsgPacketList *ptMsgPacketList)
 	/* COMMAND PAYLOAD */
 	/* ptMsgPacket->tNAIMsg.tSerdesPayLd.tTransportHdr.usPacketPayLdLength = 0; */ /*Packet payload length stored in bytes */
 
-	/* Interact with QSPI */
+	/* Interact with QSPI - anything still staged or queued for erase must reach the flash before we read it back */
 #ifdef _QSPI_SUPPORT
+	nStatus = sync_qspi();
 	probe_qspi();
+	if (nStatus != NAI_SUCCESS)
+		unRequestPayLdByteCount = 0;
 #endif
 
 	while (unRequestPayLdByteCount != 0)
@@ -1803,10 +2387,10 @@ int32_t nai_read_from_flash(MsgPacketList *ptMsgPacketList)
 		usSeqNum++;
 		ptMsgPacket->tNAIMsg.tSerdesPayLd.tTransportHdr.usSequenceNum = usSeqNum;
 
-		unAddress = (volatile uint32_t)(&(ptMsgPacket->tNAIMsg.tSerdesPayLd.tTransportPayLd.tCommandPayLd.usData[0]));
+		unAddress = map_to_sysmem(&(ptMsgPacket->tNAIMsg.tSerdesPayLd.tTransportPayLd.tCommandPayLd.usData[0]));
 
 	#ifdef _VERBOSE
-		printf("Read Back Address = %8.4x\r\n",unAddress);
+		printf("Read Back Address = %8.4lx\r\n",unAddress);
 	#endif
 
 		unFlashPacketByteCountToRead = MIN(unRequestPayLdByteCount, unMaxPayloadInBytes);	
@@ -1814,7 +2398,7 @@ int32_t nai_read_from_flash(MsgPacketList *ptMsgPacketList)
 #ifdef _QSPI_SUPPORT
 		#ifdef _VERBOSE
 		printf("About to call read_from_qspi\r\n");
-		printf("unAddress = %8.4x\r\n", unAddress);
+		printf("unAddress = %8.4lx\r\n", unAddress);
 		printf("unOffset = %8.4x (%u)\r\n",unOffset, unOffset);
 		printf("unFlashPacketByteCountToRead = %8.4x (%u)\r\n",unFlashPacketByteCountToRead, unFlashPacketByteCountToRead);		
 		
@@ -2016,6 +2600,9 @@ int32_t nai_read_from_eeprom(MsgPacketList *ptMsgPacketList)
 		return -2;
 
 	/* Now we re-use the request packet as our return packet ... NOTE: we could create a brand-new packet if that makes more sense....time will tell*/
+	/* The request packets are rewritten into the response below, so their running CRC no longer applies */
+	reset_nai_msg_crc(ptMsgPacketList);
+
 	/* SERDES HEADER */
 	ucNewCompleterID = (ptMsgPacket->tNAIMsg.tSerdesHdr.ucRequesterID);
 	ucNewRequesterID = (ptMsgPacket->tNAIMsg.tSerdesHdr.ucCompleterID);
@@ -2138,7 +2725,7 @@ request is being to.</param>
 <seealso cref="create_nai_msg_packet_list">
 <seealso cref="create_and_append_nai_msg_packet">
 <seealso cref="nai_send_msg">
-<seealso cref="delete_nai_msg_packets">
+<seealso cref="free_nai_msg_packet_list">
 <seealso cref="init_nai_msgs">
 */
 /**************************************************************************************************************/
@@ -2205,8 +2792,7 @@ static int32_t make_read_request(uint16_t usCommandType, uint8_t ucRequesterID,
 
 	/* Send request for data */
 	nStatus = nai_send_msg(ptMsgPacketList); /*Don't need to wait for read request..as we will be waiting below!*/
-	delete_nai_msg_packets(ptMsgPacketList);
-	aligned_free(ptMsgPacketList);
+	free_nai_msg_packet_list(ptMsgPacketList);
 	ptMsgPacketList = NULL;
 
 	if (nStatus == NAI_SUCCESS)
@@ -2269,8 +2855,8 @@ static int32_t make_read_request(uint16_t usCommandType, uint8_t ucRequesterID,
 /**
 \ingroup HighLevelAPI
 <summary>
-make_write_request is responsible for doing all of the dirty work associated with writing data to Flash or Eeprom.
-Based upon the information provided via parameters, a valid write request packet will be constructed and sent.
+create_nai_write_request is responsible for building (but not sending) the MsgPacketList of a write request. 
+Every packet of the request shares a newly assigned transaction ID.
 </summary>
 <param name="usCommandType"> : (Input) Defines the type of Write command. (COMMAND_TYPECODE_WRITEEEPROM or 
 COMMAND_TYPECODE_WRITEFLASH)</param>
@@ -2279,20 +2865,15 @@ COMMAND_TYPECODE_WRITEFLASH)</param>
 request is being to.</param>
 <param name="usChipID"> : (Input) ID of chip to write to (may have mutliple eeproms or flash devices</param>
 <param name="unOffset"> : (Input) Offset (in Bytes) into the hardware the write request is being made to. (eeprom or flash)</param>
-<param name="pucBuf"> : (Input) Buffer to hold payload of data to write.</param>
+<param name="pucBuf"> : (Input) Buffer to hold payload of data to write. It is copied into the packets, so it may be reused as soon as this returns.</param>
 <param name="nLen"> : (Input) Length (in Bytes) of how much data to write.</param>
-<returns>int32_t : Status 
-	- 0  : SUCCESS
-	- Non-Zero : ERROR
-</returns>
-<seealso cref="create_and_append_nai_msg_packet">
-<seealso cref="nai_send_msg">
-<seealso cref="delete_nai_msg_packets">
+<returns> MsgPacketList* : Pointer to the request (NULL if it could not be allocated)</returns>
+<seealso cref="acquire_nai_msg_packet">
+<seealso cref="append_nai_msg_packet">
 */
 /**************************************************************************************************************/
-static int32_t make_write_request(uint16_t usCommandType, uint8_t ucRequesterID, uint8_t ucCompleterID, uint16_t usChipID, uint unOffset, uint8_t *pucBuf, int32_t nLen)
+static MsgPacketList * create_nai_write_request(uint16_t usCommandType, uint8_t ucRequesterID, uint8_t ucCompleterID, uint16_t usChipID, uint unOffset, uint8_t *pucBuf, int32_t nLen)
 {
-	int32_t nStatus = NAI_SUCCESS;
 	uint32_t unMsgPayloadWordLength = convert_bytes_to_words(nLen); /* # of words to write */
 	int32_t i = 0, k = 0;	
 	int32_t nMsgPacketCount = 0;
@@ -2302,8 +2883,11 @@ static int32_t make_write_request(uint16_t usCommandType, uint8_t ucRequesterID,
 	uint16_t usID = get_next_tran_id();
 	uint16_t usExpectedSequenceCount = 0;
 	WORDValue tWordValue;
+	MsgPacket *ptNewMsgPacket = NULL;
 
 	ptMsgPacketList = create_nai_msg_packet_list();
+	if (ptMsgPacketList == NULL)
+		return NULL;
 
 	nMsgPacketCount = 0;		
 	nPayloadWordsLeftToRead = (int32_t)unMsgPayloadWordLength;		
@@ -2314,39 +2898,46 @@ static int32_t make_write_request(uint16_t usCommandType, uint8_t ucRequesterID,
 	do
 	{		
 		nMsgPacketCount++;
-		NAIMsg tNAIMsg;		
-		memset(&tNAIMsg, 0, sizeof(NAIMsg));
+
+		/* Build each packet directly in its (pooled) storage rather than on the stack followed by a copy */
+		ptNewMsgPacket = acquire_nai_msg_packet();
+		if (ptNewMsgPacket == NULL)
+		{
+			free_nai_msg_packet_list(ptMsgPacketList);
+			return NULL;
+		}
+		memset(ptNewMsgPacket->tNAIMsg.msg, 0, sizeof(NAIMsg));
 
 		/* SERDES HEADER */
 #ifdef _VERBOSE
-	printf("IN make_write_request\r\n");
+	printf("IN create_nai_write_request\r\n");
 	printf("RequesterID = 0x%2.2x(%u)\r\n", ucRequesterID, ucRequesterID);
 	printf("CompleterID = 0x%2.2x(%u)\r\n", ucCompleterID, ucCompleterID);
 #endif
-		tNAIMsg.tSerdesHdr.ucType = 3;
-		tNAIMsg.tSerdesHdr.ucToHPS = 1;
-		tNAIMsg.tSerdesHdr.ucPayloadLength = (uint8_t)(MIN((nPayloadWordsLeftToRead+CONFIG_TOTAL_PKT_HDR_IN_WORDS), MAX_SERDES_MSG_IN_WORDS) - TOTAL_SERDES_READWRITEREQ_HDR_IN_WORDS);
-		tNAIMsg.tSerdesHdr.usSERDES2 = 0;
-		tNAIMsg.tSerdesHdr.usSERDES3 = 0;
-		tNAIMsg.tSerdesHdr.ucRequesterID = ucRequesterID;
-		tNAIMsg.tSerdesHdr.ucCompleterID = ucCompleterID;
-		tNAIMsg.tSerdesHdr.usSERDES5 = 0;
+		ptNewMsgPacket->tNAIMsg.tSerdesHdr.ucType = 3;
+		ptNewMsgPacket->tNAIMsg.tSerdesHdr.ucToHPS = 1;
+		ptNewMsgPacket->tNAIMsg.tSerdesHdr.ucPayloadLength = (uint8_t)(MIN((nPayloadWordsLeftToRead+CONFIG_TOTAL_PKT_HDR_IN_WORDS), MAX_SERDES_MSG_IN_WORDS) - TOTAL_SERDES_READWRITEREQ_HDR_IN_WORDS);
+		ptNewMsgPacket->tNAIMsg.tSerdesHdr.usSERDES2 = 0;
+		ptNewMsgPacket->tNAIMsg.tSerdesHdr.usSERDES3 = 0;
+		ptNewMsgPacket->tNAIMsg.tSerdesHdr.ucRequesterID = ucRequesterID;
+		ptNewMsgPacket->tNAIMsg.tSerdesHdr.ucCompleterID = ucCompleterID;
+		ptNewMsgPacket->tNAIMsg.tSerdesHdr.usSERDES5 = 0;
 
 		/* Serdes Payload length must be a multiple of 2 */
-		if ((tNAIMsg.tSerdesHdr.ucPayloadLength % 2) != 0)	
-			tNAIMsg.tSerdesHdr.ucPayloadLength++;
+		if ((ptNewMsgPacket->tNAIMsg.tSerdesHdr.ucPayloadLength % 2) != 0)	
+			ptNewMsgPacket->tNAIMsg.tSerdesHdr.ucPayloadLength++;
 
 		/* TRANSPORT HEADER */
-		tNAIMsg.tSerdesPayLd.tTransportHdr.usID = usID;
-		tNAIMsg.tSerdesPayLd.tTransportHdr.unMsgLength = (unMsgPayloadWordLength + (usExpectedSequenceCount * CONFIG_TOTAL_PKT_HDR_IN_WORDS));    /* Length in Words */
-		tNAIMsg.tSerdesPayLd.tTransportHdr.usSequenceNum = nMsgPacketCount;
-		tNAIMsg.tSerdesPayLd.tTransportHdr.usExpectedSequenceCount = usExpectedSequenceCount;
+		ptNewMsgPacket->tNAIMsg.tSerdesPayLd.tTransportHdr.usID = usID;
+		ptNewMsgPacket->tNAIMsg.tSerdesPayLd.tTransportHdr.unMsgLength = (unMsgPayloadWordLength + (usExpectedSequenceCount * CONFIG_TOTAL_PKT_HDR_IN_WORDS));    /* Length in Words */
+		ptNewMsgPacket->tNAIMsg.tSerdesPayLd.tTransportHdr.usSequenceNum = nMsgPacketCount;
+		ptNewMsgPacket->tNAIMsg.tSerdesPayLd.tTransportHdr.usExpectedSequenceCount = usExpectedSequenceCount;
 
 		/* COMMAND HEADER */
-		tNAIMsg.tSerdesPayLd.tTransportPayLd.tCommandHdr.usChipID = usChipID;
-		tNAIMsg.tSerdesPayLd.tTransportPayLd.tCommandHdr.usCommandType = usCommandType;
-		tNAIMsg.tSerdesPayLd.tTransportPayLd.tCommandHdr.unOffset = (uint32_t)unOffset;
-	    tNAIMsg.tSerdesPayLd.tTransportPayLd.tCommandHdr.unPayLdRequestLength = 0x0;
+		ptNewMsgPacket->tNAIMsg.tSerdesPayLd.tTransportPayLd.tCommandHdr.usChipID = usChipID;
+		ptNewMsgPacket->tNAIMsg.tSerdesPayLd.tTransportPayLd.tCommandHdr.usCommandType = usCommandType;
+		ptNewMsgPacket->tNAIMsg.tSerdesPayLd.tTransportPayLd.tCommandHdr.unOffset = (uint32_t)unOffset;
+	    ptNewMsgPacket->tNAIMsg.tSerdesPayLd.tTransportPayLd.tCommandHdr.unPayLdRequestLength = 0x0;
 
 		/* COMMAND PAYLOAD */
 #ifdef _VERBOSE
@@ -2362,13 +2953,13 @@ static int32_t make_write_request(uint16_t usCommandType, uint8_t ucRequesterID,
 				tWordValue.ucHiByte = pucBuf[k++];
 			else
 				tWordValue.ucHiByte = 0x00;
-		   	tNAIMsg.tSerdesPayLd.tTransportPayLd.tCommandPayLd.usData[i] = tWordValue.usValue;
+		   	ptNewMsgPacket->tNAIMsg.tSerdesPayLd.tTransportPayLd.tCommandPayLd.usData[i] = tWordValue.usValue;
 		}
 
-		tNAIMsg.tSerdesPayLd.tTransportHdr.usPacketPayLdLength = (nPayloadWordCount * 2); /*Packet payload length stored in bytes */
+		ptNewMsgPacket->tNAIMsg.tSerdesPayLd.tTransportHdr.usPacketPayLdLength = (nPayloadWordCount * 2); /*Packet payload length stored in bytes */
 
 		/* Let's build a linked list of message packets that will represent a full message */
-		create_and_append_nai_msg_packet(ptMsgPacketList, tNAIMsg.msg);
+		append_nai_msg_packet(ptMsgPacketList, ptNewMsgPacket);
 		nPayloadWordsLeftToRead -= nPayloadWordCount;
 #ifdef _VERBOSE
 		printf("Num Msg Words Left To Read: %ld\r\n", nPayloadWordsLeftToRead);
@@ -2376,12 +2967,170 @@ static int32_t make_write_request(uint16_t usCommandType, uint8_t ucRequesterID,
 
 	} while (nPayloadWordsLeftToRead > 0);
 
+	return ptMsgPacketList;
+}
+
+/**************************************************************************************************************/
+/**
+\ingroup HighLevelAPI
+<summary>
+make_write_request is responsible for doing all of the dirty work associated with writing data to Flash or Eeprom.
+Based upon the information provided via parameters, a valid write request packet will be constructed and sent.
+</summary>
+<param name="usCommandType"> : (Input) Defines the type of Write command. (COMMAND_TYPECODE_WRITEEEPROM or 
+COMMAND_TYPECODE_WRITEFLASH)</param>
+<param name="ucRequesterID"> : (Input) Defines the Slot Number of the requesting module or mother board.</param>
+<param name="ucCompleterID"> : (Input) Defines the Slot Number of the target module or mother board the 
+request is being to.</param>
+<param name="usChipID"> : (Input) ID of chip to write to (may have mutliple eeproms or flash devices</param>
+<param name="unOffset"> : (Input) Offset (in Bytes) into the hardware the write request is being made to. (eeprom or flash)</param>
+<param name="pucBuf"> : (Input) Buffer to hold payload of data to write.</param>
+<param name="nLen"> : (Input) Length (in Bytes) of how much data to write.</param>
+<returns>int32_t : Status 
+	- 0  : SUCCESS
+	- Non-Zero : ERROR
+</returns>
+<seealso cref="create_nai_write_request">
+<seealso cref="nai_send_msg">
+<seealso cref="free_nai_msg_packet_list">
+*/
+/**************************************************************************************************************/
+static int32_t make_write_request(uint16_t usCommandType, uint8_t ucRequesterID, uint8_t ucCompleterID, uint16_t usChipID, uint unOffset, uint8_t *pucBuf, int32_t nLen)
+{
+	int32_t nStatus = NAI_SUCCESS;
+	MsgPacketList *ptMsgPacketList = NULL;
+
+	ptMsgPacketList = create_nai_write_request(usCommandType, ucRequesterID, ucCompleterID, usChipID, unOffset, pucBuf, nLen);
+	if (ptMsgPacketList == NULL)
+		return NAI_UNABLE_TO_ALLOCATE_MEMORY;
+
 	/* Send request to write data */
-//printf("make_write_request ... about to send message\r\n");
 	nStatus = nai_send_msg(ptMsgPacketList); 
-//printf("make_write_request ... after send message\r\n");
-	delete_nai_msg_packets(ptMsgPacketList);
-	aligned_free(ptMsgPacketList);
+	free_nai_msg_packet_list(ptMsgPacketList);
+
+	return nStatus;
+}
+
+/**************************************************************************************************************/
+/**
+\ingroup HighLevelAPI
+<summary>
+make_windowed_write_request is responsible for writing a large buffer as a series of write requests of at most 
+nChunkLen bytes each, keeping up to SERDES_TX_WINDOW requests (each with its own transaction ID) in flight instead
+of waiting for the finished response of every request before sending the next. Finished responses are matched
+back to their request by transaction ID (see find_nai_msg_packet_list) so they may complete in any order.
+</summary>
+<param name="usCommandType"> : (Input) Defines the type of Write command. (COMMAND_TYPECODE_WRITEEEPROM or 
+COMMAND_TYPECODE_WRITEFLASH)</param>
+<param name="ucRequesterID"> : (Input) Defines the Slot Number of the requesting module or mother board.</param>
+<param name="ucCompleterID"> : (Input) Defines the Slot Number of the target module or mother board the 
+request is being to.</param>
+<param name="usChipID"> : (Input) ID of chip to write to (may have mutliple eeproms or flash devices</param>
+<param name="unOffset"> : (Input) Offset (in Bytes) into the hardware the write request is being made to. (eeprom or flash)</param>
+<param name="pucBuf"> : (Input) Buffer to hold payload of data to write.</param>
+<param name="nLen"> : (Input) Length (in Bytes) of how much data to write.</param>
+<param name="nChunkLen"> : (Input) Maximum length (in Bytes) of each write request.</param>
+<returns>int32_t : Status 
+	- 0  : SUCCESS
+	- Non-Zero : ERROR (first failing execution status reported by the completer)
+</returns>
+<seealso cref="create_nai_write_request">
+<seealso cref="push_nai_msg_packets">
+<seealso cref="find_nai_msg_packet_list">
+<seealso cref="get_nai_msg_execution_status">
+*/
+/**************************************************************************************************************/
+static int32_t make_windowed_write_request(uint16_t usCommandType, uint8_t ucRequesterID, uint8_t ucCompleterID, uint16_t usChipID, uint unOffset, uint8_t *pucBuf, int32_t nLen, int32_t nChunkLen)
+{
+	int32_t nStatus = NAI_SUCCESS;
+	int32_t nExecStatus = NAI_SUCCESS;
+	int32_t nBytesSent = 0;
+	int32_t nChunk = 0;
+	int32_t nInFlight = 0;
+	int32_t i = 0;
+	uint16_t usInFlightIDs[SERDES_TX_WINDOW];
+	uint32_t unCompletionTimeout = 0;
+	uint32_t ulTimer = 0;
+	MsgList tRxMsgList;
+	MsgPacketList *ptMsgPacketList = NULL;
+
+	if (pucBuf == NULL || nLen <= 0 || nChunkLen <= 0)
+		return NAI_INVALID_PARAMETER_VALUE;
+
+	init_nai_msgs(&tRxMsgList);
+	ulTimer = nai_get_timer(0);
+
+	while ((nStatus == NAI_SUCCESS) && ((nBytesSent < nLen) || (nInFlight > 0)))
+	{
+		/* Keep the window full */
+		if ((nBytesSent < nLen) && (nInFlight < SERDES_TX_WINDOW) && (nExecStatus == NAI_SUCCESS))
+		{
+			nChunk = MIN(nChunkLen, (nLen - nBytesSent));
+			ptMsgPacketList = create_nai_write_request(usCommandType, ucRequesterID, ucCompleterID, usChipID, (unOffset + nBytesSent), (pucBuf + nBytesSent), nChunk);
+			if (ptMsgPacketList == NULL)
+			{
+				nStatus = NAI_UNABLE_TO_ALLOCATE_MEMORY;
+				break;
+			}
+
+			unCompletionTimeout = MAX(unCompletionTimeout, nai_get_completion_timeout(ptMsgPacketList->ptStart));
+			usInFlightIDs[nInFlight] = ptMsgPacketList->ptStart->tNAIMsg.tSerdesPayLd.tTransportHdr.usID;
+
+			nStatus = push_nai_msg_packets(ptMsgPacketList, &tRxMsgList);
+			free_nai_msg_packet_list(ptMsgPacketList);
+			ptMsgPacketList = NULL;
+			if (nStatus != NAI_SUCCESS)
+				break;
+
+			nInFlight++;
+			nBytesSent += nChunk;
+			ulTimer = nai_get_timer(0);
+			continue;
+		}
+
+		/* Window is full (or everything has been sent)...collect finished responses */
+		if (nai_rx_fifo_pkt_ready(ucRequesterID, ucCompleterID))
+		{
+			nStatus = nai_receive_msg_packet(ucRequesterID, ucCompleterID, &tRxMsgList);
+			if (nStatus != NAI_SUCCESS)
+				break;
+		}
+
+		for (i=0; i < nInFlight; i++)
+		{
+			MsgPacketList *ptResponse = find_nai_msg_packet_list(&tRxMsgList, usInFlightIDs[i]);
+			if (ptResponse == NULL || ptResponse->unWordsLeftToRead > 0)
+				continue;
+
+			if (validate_nai_msg(ptResponse) == 0)
+			{
+				int32_t nResponseStatus = get_nai_msg_execution_status(ptResponse);
+				if ((nResponseStatus != NAI_SUCCESS) && (nExecStatus == NAI_SUCCESS))
+					nExecStatus = nResponseStatus;
+			}
+
+			remove_nai_msg(&tRxMsgList, ptResponse);
+			free_nai_msg_packet_list(ptResponse);
+
+			/* Retire the transaction ID (order within the window does not matter) */
+			usInFlightIDs[i] = usInFlightIDs[--nInFlight];
+			i--;
+			ulTimer = nai_get_timer(0);
+		}
+
+		/* Stop sending once the completer reports a failure, but still drain what is already in flight */
+		if (nExecStatus != NAI_SUCCESS)
+			nBytesSent = nLen;
+
+		/* Requests complete one after the other so only time out if nothing has completed for a full request */
+		if ((nInFlight > 0) && (nai_get_timer(ulTimer) > unCompletionTimeout))
+			nStatus = NAI_RX_FIFO_PKT_NOT_READY_TIMEOUT;
+	}
+
+	delete_nai_msgs(&tRxMsgList);
+
+	if (nStatus == NAI_SUCCESS)
+		nStatus = nExecStatus;
 
 	return nStatus;
 }
@@ -2405,7 +3154,7 @@ request is being to.</param>
 </returns>
 <seealso cref="create_and_append_nai_msg_packet">
 <seealso cref="nai_send_msg">
-<seealso cref="delete_nai_msg_packets">
+<seealso cref="free_nai_msg_packet_list">
 */
 /**************************************************************************************************************/
 static int32_t make_generic_zero_payload_cmd_request(uint16_t usCommandType, uint8_t ucRequesterID, uint8_t ucCompleterID)
@@ -2449,8 +3198,7 @@ static int32_t make_generic_zero_payload_cmd_request(uint16_t usCommandType, uin
 
 	/* Send request to write data */
 	nStatus = nai_send_msg(ptMsgPacketList); 
-	delete_nai_msg_packets(ptMsgPacketList);
-	aligned_free(ptMsgPacketList);
+	free_nai_msg_packet_list(ptMsgPacketList);
 
 	return nStatus;
 }
@@ -2536,8 +3284,7 @@ request is being to.</param>
 <seealso cref="create_nai_msg_packet_list">
 <seealso cref="create_and_append_nai_msg_packet">
 <seealso cref="nai_send_msg">
-<seealso cref="delete_nai_msg_packets">
-<seealso cref="aligned_free">
+<seealso cref="free_nai_msg_packet_list">
 */
 /**************************************************************************************************************/
 int32_t nai_erase_flash_request(uint8_t ucRequesterID, uint8_t ucCompleterID, uint32_t unFlashOffset, uint8_t ucNumPages)
@@ -2581,8 +3328,7 @@ int32_t nai_erase_flash_request(uint8_t ucRequesterID, uint8_t ucCompleterID, ui
 
 	/* Send request to write data */
 	nStatus = nai_send_msg(ptMsgPacketList); 
-	delete_nai_msg_packets(ptMsgPacketList);
-	aligned_free(ptMsgPacketList);
+	free_nai_msg_packet_list(ptMsgPacketList);
 
 	return nStatus;
 }
@@ -2642,6 +3388,35 @@ int32_t nai_write_module_flash_request(uint8_t ucRequesterID, uint8_t ucComplete
 }
 #endif
 
+#if defined(__UBOOT) || defined(__LINUX)
+/**************************************************************************************************************/
+/**
+\ingroup HighLevelAPI
+<summary>
+nai_write_module_flash_windowed_request is responsible for making a request to have the desired number of bytes 
+written to FLASH, split into SERDES_WINDOW_CHUNK_BYTES sized requests with up to SERDES_TX_WINDOW of them in flight.
+</summary>
+<param name="ucRequesterID"> : (Input) Defines the Slot Number of the requesting module or mother board.</param>
+<param name="ucCompleterID"> : (Input) Defines the Slot Number of the target module or mother board the 
+request is being to.</param>
+<param name="unFlashOffset"> : (Input) Offset (in Bytes) into the FLASH hardware the write request is being made to.</param>
+<param name="pucBuf"> : (Input) Buffer to hold payload of data to write.</param>
+<param name="nLen"> : (Input) Length (in Bytes) of how much data to write.</param>
+<returns>int32_t : Status 
+	- 0  : SUCCESS
+	- Non-Zero : ERROR
+</returns>
+<seealso cref="make_windowed_write_request">
+*/
+/**************************************************************************************************************/
+int32_t nai_write_module_flash_windowed_request(uint8_t ucRequesterID, uint8_t ucCompleterID, uint32_t unFlashOffset, uint8_t *pucBuf, int32_t nLen)
+{
+	int32_t nStatus = NAI_SUCCESS;
+	nStatus = make_windowed_write_request(COMMAND_TYPECODE_WRITEFLASH, ucRequesterID, ucCompleterID, 0, unFlashOffset, pucBuf, nLen, SERDES_WINDOW_CHUNK_BYTES);
+	return nStatus;
+}
+#endif
+
 #if defined(__UBOOT) || defined(__LINUX)
 /**************************************************************************************************************/
 /**
@@ -2960,6 +3735,9 @@ int32_t nai_retrieve_slot(MsgPacketList *ptMsgPacketList)
 	/* Determine expected sequence count...NOTE this takes into account all header info */
 	usExpectedSequenceCount = 1; /*Only requesting slot number .. so 1 packet-sequence is all that is needed */
 
+	/* The request packets are rewritten into the response below, so their running CRC no longer applies */
+	reset_nai_msg_crc(ptMsgPacketList);
+
 	/* SERDES HEADER */
 	/* NOTE: Passed in packet receiver is now the completer and pass in packet completer is now the requester since we are responding! */
 	ucNewCompleterID = (uint8_t)(ptMsgPacket->tNAIMsg.tSerdesHdr.ucRequesterID);
@@ -3053,8 +3831,9 @@ int32_t nai_debug_test()
 	uint32_t unOffset = 0;
 	uint32_t unFailures = 0;
 	BOOL bMisMatch = FALSE;
-	volatile uint32_t unAddr = 0;
+	ulong unAddr = 0;
 
+	sync_qspi();
 	probe_qspi();
 
 	for (i=0; i < nLoopCnt; i++)
@@ -3076,7 +3855,7 @@ int32_t nai_debug_test()
 		}
 
 
-		unAddr = (volatile uint32_t)&pTemp[0];
+		unAddr = map_to_sysmem(&pTemp[0]);
 		printf("write_to_qspi  [%d  of  %d]\r\n", i+1, nLoopCnt);
 		nStatus = write_to_qspi(unAddr, unOffset, nLen);
 		
@@ -3088,7 +3867,7 @@ int32_t nai_debug_test()
 			break;
 		}
 
-		unAddr = (volatile uint32_t)&pTempRead[0];
+		unAddr = map_to_sysmem(&pTempRead[0]);
 		nStatus = read_from_qspi(unAddr, unOffset, nLen);
 
 		if (nStatus != NAI_SUCCESS)
@@ -5205,6 +5984,9 @@ static int32_t nai_get_isolated_dt(MsgPacketList *ptMsgPacketList)
 					if (nStatus == NAI_SUCCESS)
 					{
 						/* Now we re-use the request packet as our return packet ... NOTE: we could create a brand-new packet if that makes more sense....time will tell*/
+						/* The request packets are rewritten into the response below, so their running CRC no longer applies */
+						reset_nai_msg_crc(ptMsgPacketList);
+
 						/* SERDES HEADER */
 						ucNewCompleterID = (ptMsgPacket->tNAIMsg.tSerdesHdr.ucRequesterID);
 						ucNewRequesterID = (ptMsgPacket->tNAIMsg.tSerdesHdr.ucCompleterID);
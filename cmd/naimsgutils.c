@@ -33,6 +33,7 @@
 #include <malloc.h>
 #include <crc.h>
 #include <i2c.h>
+#include <spi_flash.h>
 #include <nai_mb_fpga_address.h>
 #endif
 
@@ -47,6 +48,19 @@ static int32_t MAX_ARG_LEN = 33;
 extern int do_spi_flash(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[]);
 extern int do_spi_flash_erase(int argc, char * const argv[]);
 extern int do_spi_flash_read_write(int argc, char * const argv[]);
+extern struct spi_flash *sf_selected_flash(void);
+
+/* QSPI write stream and erase queue (see stream_to_qspi and queue_erase_qspi) */
+static struct spi_flash *g_ptQSPIFlash = NULL;
+static uint8_t g_ucQSPIStreamBuf[QSPI_STREAM_BUF_BYTES];
+static uint32_t g_unQSPIStreamOffset = 0; /* Flash offset of the first staged byte */
+static uint32_t g_unQSPIStreamStaged = 0; /* Number of bytes staged in g_ucQSPIStreamBuf */
+static uint32_t g_unQSPIEraseNext = 0; /* Next queued flash offset to erase */
+static uint32_t g_unQSPIEraseEnd = 0; /* End of the queued erase range (equal to g_unQSPIEraseNext when nothing is queued) */
+static int32_t g_nQSPIEraseStatus = NAI_SUCCESS; /* First failure of a queued erase, reported by the next stream_to_qspi / sync_qspi */
+#if defined(_DMA_FIFO_TX) && defined(CONFIG_ZYNQ_DMA)
+extern int XDmaPs_FifoTransfer(u32 Src, u32 Dst, int Len, u8 isSrcFIFO, u8 isDestFIFO);
+#endif
 #endif
 
 #ifdef __LINUX
@@ -355,6 +369,8 @@ void nai_write16(uint32_t unAddress, uint16_t usValue)
 {
 	#ifdef __LINUX		
 		write_LWHPS2FPGA_Int16(LWHPS2FPGA_OPER_COMMONAREA_ADDR+unAddress,usValue);
+	#elif defined(CONFIG_NAI_SERDES_SANDBOX)
+		sandbox_nai_serdes_write32(g_unBaseAddress + unAddress, usValue);
 	#elif defined(__UBOOT) || defined (__BAREMETAL)
 		*((volatile uint32_t *)(g_unBaseAddress + unAddress)) = usValue;
 	#elif __VXWORKS	
@@ -378,6 +394,8 @@ uint16_t nai_read16(uint32_t unAddress)
 
 	#ifdef __LINUX
 		read_LWHPS2FPGA_Int16(LWHPS2FPGA_OPER_COMMONAREA_ADDR+unAddress,&usValue);
+	#elif defined(CONFIG_NAI_SERDES_SANDBOX)
+		usValue = (uint16_t)sandbox_nai_serdes_read32(g_unBaseAddress + unAddress);
 	#elif defined(__UBOOT) || defined(__BAREMETAL)
 		usValue =  (uint16_t)(*(volatile uint32_t *)(g_unBaseAddress + unAddress));
 	#elif __VXWORKS	
@@ -402,6 +420,8 @@ void nai_write32(uint32_t unAddress, uint32_t unValue)
 {
 	#ifdef __LINUX
 	write_LWHPS2FPGA_Int32(LWHPS2FPGA_OPER_COMMONAREA_ADDR+unAddress,unValue);
+	#elif defined(CONFIG_NAI_SERDES_SANDBOX)
+		sandbox_nai_serdes_write32(g_unBaseAddress + unAddress, unValue);
 	#elif defined(__UBOOT) || defined(__BAREMETAL)
 #ifdef _DEBUG_X
 		printf("nai_write32 address 0x%x, value 0x%x\n", g_unBaseAddress + unAddress, unValue);
@@ -432,6 +452,8 @@ uint32_t nai_read32(uint32_t unAddress)
 		
 	#ifdef __LINUX
 	read_LWHPS2FPGA_Int32(LWHPS2FPGA_OPER_COMMONAREA_ADDR+unAddress,&unValue);
+	#elif defined(CONFIG_NAI_SERDES_SANDBOX)
+		unValue = sandbox_nai_serdes_read32(g_unBaseAddress + unAddress);
 	#elif defined(__UBOOT) || defined(__BAREMETAL)
 		unValue =  *(volatile uint32_t *)(g_unBaseAddress + unAddress);
 	#elif __VXWORKS			
@@ -441,6 +463,65 @@ uint32_t nai_read32(uint32_t unAddress)
 	return unValue;
 }
 
+/**************************************************************************************************************/
+/**
+\ingroup MessageProcessing
+<summary>
+nai_write32_fifo is responsible for pushing a block of 32 bit values into a single (non-incrementing) FIFO
+address. On U-Boot / Baremetal the values are written with unrolled volatile stores (or handed to the Zynq PL330
+when _DMA_FIFO_TX is defined and the block is large enough); other platforms and the sandbox emulation
+(CONFIG_NAI_SERDES_SANDBOX) fall back to nai_write32.
+</summary>
+<param name="unAddress"> : (Input) 32 Bit address of the FIFO data port.</param>
+<param name="punValues"> : (Input) 32 Bit values to be written (must stay valid until the call returns).</param>
+<param name="unCount"> : (Input) Number of 32 bit values to be written.</param>
+<returns>int32_t : Status 
+	- 0  : SUCCESS
+	- Non-Zero : ERROR (NAI_TX_FIFO_DMA_FAILED - the FIFO may hold part of the block)
+</returns>
+<seealso cref="nai_write32">
+*/
+/**************************************************************************************************************/
+int32_t nai_write32_fifo(uint32_t unAddress, const uint32_t *punValues, uint32_t unCount)
+{
+#if (defined(__UBOOT) || defined(__BAREMETAL)) && !defined(CONFIG_NAI_SERDES_SANDBOX)
+	volatile uint32_t *punFIFO = (volatile uint32_t *)(g_unBaseAddress + unAddress);
+
+#if defined(_DMA_FIFO_TX) && defined(CONFIG_ZYNQ_DMA)
+	if (unCount >= DMA_FIFO_TX_MIN_WORDS)
+	{
+		flush_dcache_range((unsigned long)punValues, (unsigned long)(punValues + unCount));
+		if (XDmaPs_FifoTransfer((uint32_t)punValues, (uint32_t)punFIFO, (int)(unCount * 4), 0, 1) != 0)
+			return NAI_TX_FIFO_DMA_FAILED;
+		return NAI_SUCCESS;
+	}
+#endif
+	while (unCount >= 4)
+	{
+		*punFIFO = punValues[0];
+		*punFIFO = punValues[1];
+		*punFIFO = punValues[2];
+		*punFIFO = punValues[3];
+		punValues += 4;
+		unCount -= 4;
+	}
+
+	while (unCount > 0)
+	{
+		*punFIFO = *punValues++;
+		unCount--;
+	}
+#else
+	while (unCount > 0)
+	{
+		nai_write32(unAddress, *punValues++);
+		unCount--;
+	}
+#endif
+
+	return NAI_SUCCESS;
+}
+
 #if defined(__UBOOT) || defined(__BAREMETAL)
 /**************************************************************************************************************/
 /**
@@ -458,7 +539,7 @@ void nai_common_write32(uint32_t unAddress, uint32_t unValue)
 #ifdef _DEBUG_X
 	printf("nai_common_write32 address 0x%x, value 0x%x\n", getNaiModuleCommonBaseAddr() + unAddress, unValue);
 #endif
-	*((volatile uint32_t *)(getNaiModuleCommonBaseAddr() + unAddress)) = unValue;
+	*((volatile uint32_t *)(uintptr_t)(getNaiModuleCommonBaseAddr() + unAddress)) = unValue;
 }
 
 /**************************************************************************************************************/
@@ -474,7 +555,7 @@ nai_common_read32 is responsible for reading a 32 bit value from the specified a
 uint32_t nai_common_read32(uint32_t unAddress)
 {
 	uint32_t unValue = 0;		
-	unValue =  *(volatile uint32_t *)(getNaiModuleCommonBaseAddr() + unAddress);	
+	unValue =  *(volatile uint32_t *)(uintptr_t)(getNaiModuleCommonBaseAddr() + unAddress);	
 	return unValue;
 }
 #endif
@@ -497,7 +578,7 @@ void nai_dt2_write32(uint32_t unAddress, uint32_t unValue)
 #ifdef _VERBOSE
 	printf("nai_dt_write32 address 0x%x, value 0x%x\n", getNaiModuleDT2CtrlBaseAddr() + unAddress, unValue);
 #endif
-	*((volatile uint32_t *)(getNaiModuleDT2CtrlBaseAddr() + unAddress)) = unValue;
+	*((volatile uint32_t *)(uintptr_t)(getNaiModuleDT2CtrlBaseAddr() + unAddress)) = unValue;
 	
 	/* NOTE: we need to provide a slight delay between writes ... without delay we get inconsistent results */
 	ulTimer = nai_get_timer(0);
@@ -523,7 +604,7 @@ uint32_t nai_dt2_read32(uint32_t unAddress)
 	uint32_t unValue = 0;
 	int32_t ulTimer;
 	
-	unValue =  *(volatile uint32_t *)(getNaiModuleDT2CtrlBaseAddr() + unAddress);
+	unValue =  *(volatile uint32_t *)(uintptr_t)(getNaiModuleDT2CtrlBaseAddr() + unAddress);
 #ifdef _VERBOSE	
 //	printf("nai_dt_read32 address 0x%x, value 0x%x\n", getNaiModuleDT2CtrlBaseAddr() + unAddress, unValue);
 #endif	
@@ -556,7 +637,7 @@ void nai_dt2_cal_write32(uint32_t unAddress, uint32_t unValue)
 #ifdef _VERBOSE
 	printf("nai_dt2_cal_write32 address 0x%x, value 0x%x\n", getNaiModuleDT2CalBaseAddr() + unAddress, unValue);
 #endif
-	*((volatile uint32_t *)(getNaiModuleDT2CalBaseAddr() + unAddress)) = unValue;
+	*((volatile uint32_t *)(uintptr_t)(getNaiModuleDT2CalBaseAddr() + unAddress)) = unValue;
 	
 	/* NOTE: we need to provide a slight delay between writes ... without delay we get inconsistent results */
 	ulTimer = nai_get_timer(0);
@@ -582,7 +663,7 @@ uint32_t nai_dt2_cal_read32(uint32_t unAddress)
 	uint32_t unValue = 0;
 	int32_t ulTimer;
 	
-	unValue =  *(volatile uint32_t *)(getNaiModuleDT2CalBaseAddr() + unAddress);
+	unValue =  *(volatile uint32_t *)(uintptr_t)(getNaiModuleDT2CalBaseAddr() + unAddress);
 #ifdef _VERBOSE	
 	printf("nai_dt2_cal_read32 address 0x%x, value 0x%x\n", getNaiModuleDT2CalBaseAddr() + unAddress, unValue);
 #endif	
@@ -1083,7 +1164,8 @@ int32_t do_naisleep(uint32_t unSeconds)
 /**
 \ingroup FlashUtils
 <summary>
-probe_qspi is responsible for probing to see if flash is present.
+probe_qspi is responsible for probing to see if flash is present. Probing frees the flash selected before, so
+anything still staged for it is synced first and g_ptQSPIFlash is refreshed afterwards.
 </summary>
 <returns>int32_t : Status 
 	- 0  : SUCCESS
@@ -1111,7 +1193,9 @@ int32_t probe_qspi()
 		argv[1] = &arg1[0];
 		argv[2] = NULL;
 	
+		sync_qspi();
 		nStatus = do_spi_flash(NULL, 0, argc, argv);
+		g_ptQSPIFlash = (nStatus == NAI_SUCCESS) ? sf_selected_flash() : NULL;
 		
 		if (nStatus == NAI_SUCCESS)
 			g_bQSPIProbed = TRUE;
@@ -1169,7 +1253,7 @@ int32_t erase_qspi(uint32_t unOffset, uint32_t unLen)
 <summary>
 write_to_qspi is responsible for writing the specified amount of data to flash.
 </summary>
-<param name="unAddr"> : (Input) Address of RAM from which to take data to write.</param>
+<param name="unAddr"> : (Input) Address of RAM from which to take data to write (see map_to_sysmem).</param>
 <param name="unOffset"> : (Input) Offset into flash of where to start writing.</param>
 <param name="unLen"> : (Input) Length (in Bytes) of how much data to write.</param>
 <returns>int32_t : Status 
@@ -1178,7 +1262,7 @@ write_to_qspi is responsible for writing the specified amount of data to flash.
 </returns>
 */
 /**************************************************************************************************************/
-int32_t write_to_qspi( uint32_t unAddr, uint32_t unOffset, uint32_t unLen)
+int32_t write_to_qspi( ulong unAddr, uint32_t unOffset, uint32_t unLen)
 {
 	int32_t nStatus = NAI_SUCCESS;	
 	int32_t argc = 4;
@@ -1190,7 +1274,7 @@ int32_t write_to_qspi( uint32_t unAddr, uint32_t unOffset, uint32_t unLen)
 	char arg3[MAX_ARG_LEN];
 
 	snprintf(arg0, MAX_ARG_LEN, "write");
-	snprintf(arg1, MAX_ARG_LEN, "0x%x", unAddr);
+	snprintf(arg1, MAX_ARG_LEN, "0x%lx", unAddr);
 	snprintf(arg2, MAX_ARG_LEN, "0x%x", unOffset);
 	snprintf(arg3, MAX_ARG_LEN, "0x%x", unLen);
 	
@@ -1210,7 +1294,7 @@ int32_t write_to_qspi( uint32_t unAddr, uint32_t unOffset, uint32_t unLen)
 <summary>
 read_from_qspi is responsible for reading the specified amount of data from flash to a memory location in RAM.
 </summary>
-<param name="unAddr"> : (Input) Address of RAM where data will be stored when flash is read.</param>
+<param name="unAddr"> : (Input) Address of RAM where data will be stored when flash is read (see map_to_sysmem).</param>
 <param name="unOffset"> : (Input) Offset into flash of where to start reading.</param>
 <param name="unLen"> : (Input) Length (in Bytes) of how much data to read.</param>
 <returns>int32_t : Status 
@@ -1219,7 +1303,7 @@ read_from_qspi is responsible for reading the specified amount of data from flas
 </returns>
 */
 /**************************************************************************************************************/
-int32_t read_from_qspi( uint32_t unAddr, uint32_t unOffset, uint32_t unLen)
+int32_t read_from_qspi( ulong unAddr, uint32_t unOffset, uint32_t unLen)
 {
 	int32_t nStatus = NAI_SUCCESS;
 	int32_t argc = 4;
@@ -1231,7 +1315,7 @@ int32_t read_from_qspi( uint32_t unAddr, uint32_t unOffset, uint32_t unLen)
 	char arg3[MAX_ARG_LEN];
 
 	snprintf(arg0, MAX_ARG_LEN, "read");
-	snprintf(arg1, MAX_ARG_LEN, "0x%x", unAddr);
+	snprintf(arg1, MAX_ARG_LEN, "0x%lx", unAddr);
 	snprintf(arg2, MAX_ARG_LEN, "0x%x", unOffset);
 	snprintf(arg3, MAX_ARG_LEN, "0x%x", unLen);
 
@@ -1253,6 +1337,270 @@ int32_t read_from_qspi( uint32_t unAddr, uint32_t unOffset, uint32_t unLen)
 	nStatus = do_spi_flash_read_write(argc, argv);
 	return nStatus;
 }
+
+/**************************************************************************************************************/
+/**
+\ingroup FlashUtils
+<summary>
+get_qspi_flash is responsible for returning the flash selected by probe_qspi. The handle is kept for the lifetime
+of U-Boot so the QSPI stream routines can drive the flash directly instead of going through the sf command.
+</summary>
+<returns> struct spi_flash* : Pointer to the flash (NULL if no flash was found)</returns>
+*/
+/**************************************************************************************************************/
+static struct spi_flash * get_qspi_flash(void)
+{
+	if (g_ptQSPIFlash == NULL)
+		probe_qspi();
+
+	return g_ptQSPIFlash;
+}
+
+/**************************************************************************************************************/
+/**
+\ingroup FlashUtils
+<summary>
+erase_queued_qspi_sectors is responsible for erasing the queued sectors (see queue_erase_qspi) that start below
+the specified flash offset. Once an erase fails the rest of the queue is dropped and the failure is held until the
+next call to stream_to_qspi or sync_qspi reports it.
+</summary>
+<param name="unUpTo"> : (Input) Erase every queued sector starting below this offset.</param>
+<returns>int32_t : Status
+	- 0  : SUCCESS
+	- Non-Zero : ERROR
+</returns>
+*/
+/**************************************************************************************************************/
+static int32_t erase_queued_qspi_sectors(uint32_t unUpTo)
+{
+	uint32_t unLen = 0;
+
+	while (g_nQSPIEraseStatus == NAI_SUCCESS && g_unQSPIEraseNext < MIN(unUpTo, g_unQSPIEraseEnd))
+	{
+		unLen = MIN(g_ptQSPIFlash->erase_size, (g_unQSPIEraseEnd - g_unQSPIEraseNext));
+
+#ifdef _VERBOSE
+		printf("Erase qspi - Offset = 0x%8.4x  Length = 0x%4.4x\r\n", g_unQSPIEraseNext, unLen);
+#endif
+		if (spi_flash_erase(g_ptQSPIFlash, g_unQSPIEraseNext, unLen) != 0)
+		{
+			printf("ERROR - erase qspi at 0x%x failed\r\n", g_unQSPIEraseNext);
+			g_nQSPIEraseStatus = NAI_QSPI_ERASE_FAILED;
+			g_unQSPIEraseNext = g_unQSPIEraseEnd;
+		}
+		else
+			g_unQSPIEraseNext += unLen;
+	}
+
+	return g_nQSPIEraseStatus;
+}
+
+/**************************************************************************************************************/
+/**
+\ingroup FlashUtils
+<summary>
+program_staged_qspi is responsible for programming the first unLen staged bytes of the QSPI stream, erasing any
+queued sector they fall in first.
+</summary>
+<param name="unLen"> : (Input) Number of staged bytes to program.</param>
+<returns>int32_t : Status
+	- 0  : SUCCESS
+	- Non-Zero : ERROR
+</returns>
+*/
+/**************************************************************************************************************/
+static int32_t program_staged_qspi(uint32_t unLen)
+{
+	int32_t nStatus = erase_queued_qspi_sectors(g_unQSPIStreamOffset + unLen);
+
+	if (nStatus == NAI_SUCCESS && spi_flash_write(g_ptQSPIFlash, g_unQSPIStreamOffset, unLen, g_ucQSPIStreamBuf) != 0)
+	{
+		printf("ERROR - write qspi at 0x%x failed\r\n", g_unQSPIStreamOffset);
+		nStatus = NAI_QSPI_WRITE_FAILED;
+	}
+
+	/* Whatever happened, these bytes are no longer pending */
+	g_unQSPIStreamStaged -= unLen;
+	g_unQSPIStreamOffset += unLen;
+	memmove(g_ucQSPIStreamBuf, &g_ucQSPIStreamBuf[unLen], g_unQSPIStreamStaged);
+
+	return nStatus;
+}
+
+/**************************************************************************************************************/
+/**
+\ingroup FlashUtils
+<summary>
+flush_qspi_stream is responsible for programming whatever is still staged in the QSPI stream (a partial flash
+page at the end of a message).
+</summary>
+<returns>int32_t : Status
+	- 0  : SUCCESS
+	- Non-Zero : ERROR
+</returns>
+<seealso cref="stream_to_qspi">
+*/
+/**************************************************************************************************************/
+int32_t flush_qspi_stream(void)
+{
+	if (g_unQSPIStreamStaged == 0)
+		return NAI_SUCCESS;
+
+	return program_staged_qspi(g_unQSPIStreamStaged);
+}
+
+/**************************************************************************************************************/
+/**
+\ingroup FlashUtils
+<summary>
+stream_to_qspi is responsible for writing data to flash as it arrives. Data is staged until it fills a flash page
+and every full page is programmed straight away with spi_flash_write; only a partial page is left staged for the
+next call (or flush_qspi_stream). Writes that do not continue where the previous one ended flush the stream first.
+Queued erases (see queue_erase_qspi) are performed just ahead of the page being programmed.
+</summary>
+<param name="unOffset"> : (Input) Offset into flash of where to write the data.</param>
+<param name="pucData"> : (Input) Data to write.</param>
+<param name="unLen"> : (Input) Length (in Bytes) of the data.</param>
+<returns>int32_t : Status
+	- 0  : SUCCESS
+	- Non-Zero : ERROR
+</returns>
+*/
+/**************************************************************************************************************/
+int32_t stream_to_qspi(uint32_t unOffset, const uint8_t *pucData, uint32_t unLen)
+{
+	int32_t nStatus = NAI_SUCCESS;
+	uint32_t unCopy = 0;
+	uint32_t unPageEnd = 0;
+
+	if (get_qspi_flash() == NULL)
+		return NAI_QSPI_NOT_FOUND;
+
+	/* Report (once) an erase that failed while we were idle */
+	if (g_nQSPIEraseStatus != NAI_SUCCESS)
+	{
+		nStatus = g_nQSPIEraseStatus;
+		g_nQSPIEraseStatus = NAI_SUCCESS;
+		return nStatus;
+	}
+
+	if (g_unQSPIStreamStaged > 0 && unOffset != (g_unQSPIStreamOffset + g_unQSPIStreamStaged))
+		nStatus = flush_qspi_stream();
+
+	if (g_unQSPIStreamStaged == 0)
+		g_unQSPIStreamOffset = unOffset;
+
+	while (nStatus == NAI_SUCCESS && unLen > 0)
+	{
+		unCopy = MIN(unLen, (QSPI_STREAM_BUF_BYTES - g_unQSPIStreamStaged));
+		memcpy(&g_ucQSPIStreamBuf[g_unQSPIStreamStaged], pucData, unCopy);
+		g_unQSPIStreamStaged += unCopy;
+		pucData += unCopy;
+		unLen -= unCopy;
+
+		/* Program every full flash page staged so far */
+		unPageEnd = (g_unQSPIStreamOffset + g_unQSPIStreamStaged);
+		unPageEnd -= (unPageEnd % g_ptQSPIFlash->page_size);
+		if (unPageEnd > g_unQSPIStreamOffset)
+			nStatus = program_staged_qspi(unPageEnd - g_unQSPIStreamOffset);
+		else if (g_unQSPIStreamStaged == QSPI_STREAM_BUF_BYTES)
+			nStatus = flush_qspi_stream();
+	}
+
+	return nStatus;
+}
+
+/**************************************************************************************************************/
+/**
+\ingroup FlashUtils
+<summary>
+queue_erase_qspi is responsible for erasing flash (or a portion thereof) without holding up the caller. With
+_QSPI_ERASE_AHEAD the range is only queued; its sectors are erased by stream_to_qspi just before they are written,
+by erase_qspi_ahead while the receiver is idle, or by sync_qspi. Without it the range is erased straight away.
+</summary>
+<param name="unOffset"> : (Input) Offset into flash from which to start erasing (must be sector aligned).</param>
+<param name="unLen"> : (Input) Length (in Bytes) of how much flash to erase.</param>
+<returns>int32_t : Status
+	- 0  : SUCCESS
+	- Non-Zero : ERROR
+</returns>
+*/
+/**************************************************************************************************************/
+int32_t queue_erase_qspi(uint32_t unOffset, uint32_t unLen)
+{
+	int32_t nStatus = NAI_SUCCESS;
+
+	if (get_qspi_flash() == NULL)
+		return NAI_QSPI_NOT_FOUND;
+
+	/* Anything staged for the range must land before the range is erased */
+	nStatus = flush_qspi_stream();
+
+	/* Only a range that continues the queued one can be merged with it */
+	if (nStatus == NAI_SUCCESS && g_unQSPIEraseNext != g_unQSPIEraseEnd && unOffset != g_unQSPIEraseEnd)
+		nStatus = erase_queued_qspi_sectors(g_unQSPIEraseEnd);
+
+	if (nStatus != NAI_SUCCESS)
+		return nStatus;
+
+	if (g_unQSPIEraseNext == g_unQSPIEraseEnd)
+		g_unQSPIEraseNext = unOffset;
+	g_unQSPIEraseEnd = unOffset + unLen;
+
+#ifndef _QSPI_ERASE_AHEAD
+	nStatus = sync_qspi();
+#endif
+	return nStatus;
+}
+
+/**************************************************************************************************************/
+/**
+\ingroup FlashUtils
+<summary>
+erase_qspi_ahead is responsible for erasing the next queued sector, if any. It is meant to be called while the
+receiver has nothing else to do, so the erase of the next sector overlaps with the reception of the next message.
+</summary>
+<returns>BOOL : Whether a sector was erased</returns>
+*/
+/**************************************************************************************************************/
+BOOL erase_qspi_ahead(void)
+{
+	if (g_ptQSPIFlash == NULL || g_unQSPIEraseNext == g_unQSPIEraseEnd)
+		return FALSE;
+
+	erase_queued_qspi_sectors(g_unQSPIEraseNext + 1);
+	return TRUE;
+}
+
+/**************************************************************************************************************/
+/**
+\ingroup FlashUtils
+<summary>
+sync_qspi is responsible for completing all outstanding QSPI work: the staged stream is programmed and every
+queued sector is erased. It must be called before the flash is read or handed to anything else.
+</summary>
+<returns>int32_t : Status
+	- 0  : SUCCESS
+	- Non-Zero : ERROR
+</returns>
+*/
+/**************************************************************************************************************/
+int32_t sync_qspi(void)
+{
+	int32_t nStatus = NAI_SUCCESS;
+
+	if (g_ptQSPIFlash == NULL)
+		return NAI_SUCCESS;
+
+	nStatus = flush_qspi_stream();
+	erase_queued_qspi_sectors(g_unQSPIEraseEnd);
+
+	if (nStatus == NAI_SUCCESS)
+		nStatus = g_nQSPIEraseStatus;
+	g_nQSPIEraseStatus = NAI_SUCCESS;
+
+	return nStatus;
+}
 #endif
 
 /**************************************************************************************************************/
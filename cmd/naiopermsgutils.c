@@ -48,6 +48,9 @@ extern uint8_t g_ucMsgUtilsInitialized;
 
 static int32_t nai_send_serdes_oper_msg(NAIOperMsg *ptNAIOperMsg);
 static int32_t nai_receive_serdes_oper_msg(NAIOperMsg *ptNAIOperMsg);
+static uint32_t nai_find_reg_op_run(NAIRegOp *ptOps, uint32_t unCount, uint8_t *pucStride);
+static int32_t nai_read_reg_op_run(uint8_t ucSlotID, uint32_t unModuleOffset, uint32_t unCount, uint8_t ucStride, uint32_t *punDataBuf);
+static int32_t nai_write_reg_op_run(uint8_t ucSlotID, uint32_t unModuleOffset, uint32_t unCount, uint8_t ucStride, uint32_t *punDataBuf);
 
 #ifdef _USE_MUTEX
 static int32_t initSERDES_Mutex(uint8_t ucSlotID);
@@ -1518,6 +1521,286 @@ int32_t nai_write_block32_by_slot_request(uint8_t ucSlotID, uint32_t unModuleOff
 }
 
 
+/**************************************************************************************************************/
+/**
+\ingroup SerdesMessageProcessing
+<summary>
+nai_batch_reg32_by_slot_request is responsible for performing a list of 32 bit register reads, writes and
+read-modify-writes on a single module while holding the slot's SERDES lock only once.
+Consecutive operations of the same type whose offsets are evenly spaced (stride a multiple of 4, up to 1020 bytes)
+are merged into a single block read or block write message of up to OPER_MAX_PAYLOAD_IN_WORDS/2 registers, so a
+script of register pokes costs one SERDES round trip per run instead of one per register.  A run of
+read-modify-writes is read as one block, modified and written back as one block.  Operations are performed in the
+order given.  A zero stride is only merged for reads and writes (repeated access to the same register).
+</summary>
+<param name="ucSlotID"> : (Input) Slot ID of module to access.</param>
+<param name="ptOps"> : (Input/Output) Operations to perform, unResult is filled in for NAI_REGOP_READ32 and NAI_REGOP_RMW32.</param>
+<param name="unCount"> : (Input) Number of operations in ptOps.</param>
+<param name="punOpsDone"> : (Output) Number of operations completed (may be NULL).  On error the operations from this
+index onwards were not (or not completely) performed.</param>
+<returns>int32_t : Status
+	- 0  : SUCCESS
+	- Non-Zero : ERROR
+</returns>
+<seealso cref="nai_read_reg_op_run">
+<seealso cref="nai_write_reg_op_run">
+*/
+/**************************************************************************************************************/
+int32_t nai_batch_reg32_by_slot_request(uint8_t ucSlotID, NAIRegOp *ptOps, uint32_t unCount, uint32_t *punOpsDone)
+{
+	int32_t nStatus = NAI_SUCCESS;
+	uint32_t unRunBuf[OPER_MAX_PAYLOAD_IN_WORDS/2];
+	uint32_t unOpsDone = 0;
+	uint32_t unRunLength = 0;
+	uint32_t i = 0;
+	uint8_t ucStride = 0;
+	NAIRegOp *ptRun = NULL;
+
+	if (punOpsDone != NULL)
+		*punOpsDone = 0;
+
+	if (ptOps == NULL && unCount > 0)
+		return NAI_INVALID_PARAMETER_VALUE;
+
+	/* Validate everything up front so a bad entry does not leave the module half configured */
+	for (i=0; i < unCount; i++)
+	{
+		if (ptOps[i].ucOp != NAI_REGOP_READ32 && ptOps[i].ucOp != NAI_REGOP_WRITE32 && ptOps[i].ucOp != NAI_REGOP_RMW32)
+			return NAI_INVALID_PARAMETER_VALUE;
+
+		/* SERDES uses 32 bit addressing */
+		if ((ptOps[i].unModuleOffset & 0x0003) != 0)
+			return NAI_MIS_ALIGNED_BYTE_ENABLE;
+	}
+
+#ifdef _USE_MUTEX
+	if (lockSERDES_Mutex(ucSlotID) != NAI_SUCCESS)
+		return NAI_UNABLE_TO_LOCK_MUTEX;
+#endif
+
+#ifdef _VERBOSE
+	printf("**************nai_batch_reg32_by_slot_request**************\r\n");
+#endif
+
+	while (unOpsDone < unCount && nStatus == NAI_SUCCESS)
+	{
+		ptRun = &ptOps[unOpsDone];
+		unRunLength = nai_find_reg_op_run(ptRun, (unCount - unOpsDone), &ucStride);
+
+		if (ptRun->ucOp != NAI_REGOP_WRITE32)
+		{
+			nStatus = nai_read_reg_op_run(ucSlotID, ptRun->unModuleOffset, unRunLength, ucStride, unRunBuf);
+
+			for (i=0; i < unRunLength && nStatus == NAI_SUCCESS; i++)
+				ptRun[i].unResult = unRunBuf[i];
+		}
+
+		if (ptRun->ucOp != NAI_REGOP_READ32 && nStatus == NAI_SUCCESS)
+		{
+			for (i=0; i < unRunLength; i++)
+			{
+				if (ptRun->ucOp == NAI_REGOP_RMW32)
+					unRunBuf[i] = ((unRunBuf[i] & ~ptRun[i].unMask) | (ptRun[i].unValue & ptRun[i].unMask));
+				else
+					unRunBuf[i] = ptRun[i].unValue;
+			}
+
+			nStatus = nai_write_reg_op_run(ucSlotID, ptRun->unModuleOffset, unRunLength, ucStride, unRunBuf);
+		}
+
+		if (nStatus == NAI_SUCCESS)
+			unOpsDone += unRunLength;
+	}
+
+#ifdef _VERBOSE
+	printf("**************END nai_batch_reg32_by_slot_request**************\r\n");
+#endif
+
+#ifdef _USE_MUTEX
+	if (unlockSERDES_Mutex(ucSlotID) != NAI_SUCCESS)
+	{
+		if (nStatus == NAI_SUCCESS)
+			nStatus = NAI_UNABLE_TO_UNLOCK_MUTEX;
+	}
+#endif
+
+	if (punOpsDone != NULL)
+		*punOpsDone = unOpsDone;
+
+	return nStatus;
+}
+
+/**************************************************************************************************************/
+/**
+\ingroup SerdesMessageProcessing
+<summary>
+nai_find_reg_op_run is responsible for determining how many of the leading operations in ptOps can be carried by a
+single block read / block write message.
+</summary>
+<param name="ptOps"> : (Input) Operations, the first one starts the run.</param>
+<param name="unCount"> : (Input) Number of operations available in ptOps (at least 1).</param>
+<param name="pucStride"> : (Output) Byte stride between the registers of the run.</param>
+<returns>uint32_t : Number of operations in the run (1 - OPER_MAX_PAYLOAD_IN_WORDS/2)</returns>
+*/
+/**************************************************************************************************************/
+static uint32_t nai_find_reg_op_run(NAIRegOp *ptOps, uint32_t unCount, uint8_t *pucStride)
+{
+	uint32_t unRunLength = 1;
+	uint32_t unStride = 0;
+
+	*pucStride = 0;
+	if (unCount < 2 || ptOps[1].ucOp != ptOps[0].ucOp)
+		return 1;
+
+	/* Only forward strides the block address increment (in 32 bit words, 8 bits wide) can express */
+	unStride = ptOps[1].unModuleOffset - ptOps[0].unModuleOffset;
+	if (unStride > (0xFF * 4))
+		return 1;
+
+	/* Each read-modify-write must see the result of the previous one, so never merge them onto one register */
+	if (unStride == 0 && ptOps[0].ucOp == NAI_REGOP_RMW32)
+		return 1;
+
+	unCount = MIN(unCount, (OPER_MAX_PAYLOAD_IN_WORDS/2));
+	while (unRunLength < unCount &&
+		   ptOps[unRunLength].ucOp == ptOps[0].ucOp &&
+		   ptOps[unRunLength].unModuleOffset == (ptOps[0].unModuleOffset + (unRunLength * unStride)))
+		unRunLength++;
+
+	*pucStride = (uint8_t)(unStride / 4);
+	return unRunLength;
+}
+
+/**************************************************************************************************************/
+/**
+\ingroup SerdesMessageProcessing
+<summary>
+nai_read_reg_op_run is responsible for reading a run of registers with a single SERDES block read.  The caller
+must hold the slot's SERDES lock.
+</summary>
+<param name="ucSlotID"> : (Input) Slot ID of module to read from.</param>
+<param name="unModuleOffset"> : (Input) Offset of the first register.</param>
+<param name="unCount"> : (Input) Number of registers to read (at most OPER_MAX_PAYLOAD_IN_WORDS/2).</param>
+<param name="ucStride"> : (Input) Block address increment in 32 bit words.</param>
+<param name="punDataBuf"> : (Output) Data values read.</param>
+<returns>int32_t : Status
+	- 0  : SUCCESS
+	- Non-Zero : ERROR
+</returns>
+<seealso cref="nai_send_serdes_oper_msg">
+<seealso cref="nai_receive_serdes_oper_msg">
+*/
+/**************************************************************************************************************/
+static int32_t nai_read_reg_op_run(uint8_t ucSlotID, uint32_t unModuleOffset, uint32_t unCount, uint8_t ucStride, uint32_t *punDataBuf)
+{
+	int32_t nStatus = NAI_SUCCESS;
+	FIFOValue tFIFOVal;
+	NAIOperMsg tNAIOperMsg;
+	uint8_t ucRequesterID = g_ucSlotID;
+	uint32_t ulTimer = 0;
+	uint16_t i = 0;
+
+	memset(&tNAIOperMsg.msg, 0, (TOTAL_SERDES_READWRITEREQ_HDR_IN_WORDS * sizeof(uint16_t)));
+	tNAIOperMsg.tSerdesHdr.ucType = SERDES_READREG;
+	tNAIOperMsg.tSerdesHdr.ucToHPS = 0;
+	tNAIOperMsg.tSerdesHdr.ucByteEnable = SERDES_32BITDATA;
+	tNAIOperMsg.tSerdesHdr.ucPayloadLength = (uint8_t)(unCount * 2); /* No Payload for making the request...but we must tell Keith how much data we are expecting! */
+	tNAIOperMsg.tSerdesHdr.ucBlockAddrIncrVal = ucStride;
+
+	tFIFOVal.unValue = unModuleOffset;
+	tNAIOperMsg.tSerdesHdr.usAddressLo = tFIFOVal.usLoWord;
+	tNAIOperMsg.tSerdesHdr.usAddressHi = tFIFOVal.usHiWord;
+
+	tNAIOperMsg.tSerdesHdr.ucRequesterID = ucRequesterID;
+	tNAIOperMsg.tSerdesHdr.ucCompleterID = ucSlotID;
+
+	/* Send request for data */
+	nStatus = nai_send_serdes_oper_msg(&tNAIOperMsg);
+	if (nStatus != NAI_SUCCESS)
+		return nStatus;
+
+	/* Wait for packet! */
+	ulTimer = nai_get_timer(0);
+	while (!nai_rx_fifo_pkt_ready(ucRequesterID, ucSlotID))
+	{
+		/* If FIFO did not get serviced within a reasonable amount of time..get out */
+		if (nai_get_timer(ulTimer) > COMPLETION_TIMEOUT)
+			return NAI_RX_FIFO_PKT_NOT_READY_TIMEOUT;
+	}
+
+	tNAIOperMsg.tSerdesHdr.ucRequesterID = ucRequesterID;
+	tNAIOperMsg.tSerdesHdr.ucCompleterID = ucSlotID;
+
+	/* Now receive the packet */
+	nStatus = nai_receive_serdes_oper_msg(&tNAIOperMsg);
+
+	if (nStatus == NAI_SUCCESS)
+	{
+		if (tNAIOperMsg.tSerdesHdr.ucPayloadLength < (unCount * 2))
+			return NAI_SERDES_UNEXPECTED_PAYLOAD_COUNT;
+
+		for (i=0; i < unCount; i++)
+		{
+			tFIFOVal.usLoWord = tNAIOperMsg.tSerdesPayLd.usData[(i * 2)];
+			tFIFOVal.usHiWord = tNAIOperMsg.tSerdesPayLd.usData[(i * 2) + 1];
+			punDataBuf[i] = (uint32_t)tFIFOVal.unValue;
+		}
+	}
+
+	return nStatus;
+}
+
+/**************************************************************************************************************/
+/**
+\ingroup SerdesMessageProcessing
+<summary>
+nai_write_reg_op_run is responsible for writing a run of registers with a single SERDES block write.  The caller
+must hold the slot's SERDES lock.
+</summary>
+<param name="ucSlotID"> : (Input) Slot ID of module to write to.</param>
+<param name="unModuleOffset"> : (Input) Offset of the first register.</param>
+<param name="unCount"> : (Input) Number of registers to write (at most OPER_MAX_PAYLOAD_IN_WORDS/2).</param>
+<param name="ucStride"> : (Input) Block address increment in 32 bit words.</param>
+<param name="punDataBuf"> : (Input) Data values to be written.</param>
+<returns>int32_t : Status
+	- 0  : SUCCESS
+	- Non-Zero : ERROR
+</returns>
+<seealso cref="nai_send_serdes_oper_msg">
+*/
+/**************************************************************************************************************/
+static int32_t nai_write_reg_op_run(uint8_t ucSlotID, uint32_t unModuleOffset, uint32_t unCount, uint8_t ucStride, uint32_t *punDataBuf)
+{
+	FIFOValue tFIFOVal;
+	NAIOperMsg tNAIOperMsg;
+	uint16_t i = 0;
+
+	memset(&tNAIOperMsg.msg, 0, (TOTAL_SERDES_READWRITEREQ_HDR_IN_WORDS * sizeof(uint16_t)));
+	tNAIOperMsg.tSerdesHdr.ucType = SERDES_WRITEREG;
+	tNAIOperMsg.tSerdesHdr.ucToHPS = 0;
+	tNAIOperMsg.tSerdesHdr.ucByteEnable = SERDES_32BITDATA;
+	tNAIOperMsg.tSerdesHdr.ucPayloadLength = (uint8_t)(unCount * 2);
+	tNAIOperMsg.tSerdesHdr.ucBlockAddrIncrVal = ucStride;
+
+	tFIFOVal.unValue = unModuleOffset;
+	tNAIOperMsg.tSerdesHdr.usAddressLo = tFIFOVal.usLoWord;
+	tNAIOperMsg.tSerdesHdr.usAddressHi = tFIFOVal.usHiWord;
+
+	tNAIOperMsg.tSerdesHdr.ucRequesterID = g_ucSlotID;
+	tNAIOperMsg.tSerdesHdr.ucCompleterID = ucSlotID;
+
+	/* Assign Payload */
+	for (i=0; i < unCount; i++)
+	{
+		tFIFOVal.unValue = punDataBuf[i];
+		tNAIOperMsg.tSerdesPayLd.usData[(i * 2)] = tFIFOVal.usLoWord;
+		tNAIOperMsg.tSerdesPayLd.usData[(i * 2) + 1] = tFIFOVal.usHiWord;
+	}
+
+	return nai_send_serdes_oper_msg(&tNAIOperMsg);
+}
+
+
 /*****************************************************************************/
 #ifdef _USE_MUTEX
 /**************************************************************************************************************/
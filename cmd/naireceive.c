@@ -117,7 +117,11 @@ int do_naireceive(cmd_tbl_t * cmdtp, int flag, int argc, char * const argv[])
 			if (serial_tstc() || g_bExitConfigMode)
 			{
 				/* Set handshake register to notify MB that module is no longer ready to accept messages */
-				nai_common_write32(MODULE_COMMON_HANDSHAKE_ADDR, 0x0);			
+				nai_common_write32(MODULE_COMMON_HANDSHAKE_ADDR, 0x0);
+#ifdef _QSPI_SUPPORT
+				/* Finish any flash erase still queued before leaving config mode */
+				sync_qspi();
+#endif			
 				break;
 			}
 			
@@ -147,6 +151,10 @@ int do_naireceive(cmd_tbl_t * cmdtp, int flag, int argc, char * const argv[])
 
 				delete_nai_msgs(&tMsgList);
 			}		
+#ifdef _QSPI_SUPPORT
+			else
+				erase_qspi_ahead(); /* Nothing to receive - erase the next queued flash sector while the MB prepares the next message */
+#endif
 		}
 
 		/* If user typed a char to exit receiver mode...eat the character so it does not get displayed on the console */
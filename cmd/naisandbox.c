@@ -0,0 +1,732 @@
+/*
+ * NAI SERDES sandbox emulation
+ *
+ * Emulates the motherboard view of the SERDES FIFO registers (PS2FPGA_MODULE_BASE_ADDRESS) with a loopback module
+ * behind every slot, so the nai* message paths can run (and be timed) on the sandbox. Requests are answered as
+ * soon as the TX packet ready register is written; responses are fed into the RX FIFO as room becomes available,
+ * just like a module that is faster than the link.
+ */
+#include <common.h>
+#include <malloc.h>
+#include <nai_mb_fpga_address.h>
+#include "NAIComms.h"
+#include "cmd_naimsgutils.h"
+#include "cmd_naiconfigmsgutils.h"
+
+#define SANDBOX_NAI_SLOTS				6
+#define SANDBOX_NAI_FIFO_WORDS			512		/* 32 bit words held by each TX and RX FIFO */
+#define SANDBOX_NAI_PKT_FIFO_WORDS		(MAX_SERDES_MSG_IN_WORDS / 2) /* 32 bit FIFO words of the largest packet */
+#define SANDBOX_NAI_JOBS				8		/* Responses a module can have pending */
+#define SANDBOX_NAI_WINDOW_BYTES		0x1000	/* Size of the decoded register window */
+#define SANDBOX_NAI_REG_BYTES			0x10000	/* Module register space (mirrored above this) */
+#define SANDBOX_NAI_FLASH_BYTES			0x800000
+#define SANDBOX_NAI_FLASH_PAGE_BYTES	0x10000
+#define SANDBOX_NAI_EEPROM_BYTES		0x100
+
+/* Register offsets from PS2FPGA_MODULE_BASE_ADDRESS (see nai_get_tx_fifo_address and friends) */
+#define SANDBOX_NAI_TX_FIFO				0x000
+#define SANDBOX_NAI_TX_PKT_READY		0x020
+#define SANDBOX_NAI_TX_EMPTY			0x040
+#define SANDBOX_NAI_RX_FIFO				0x080
+#define SANDBOX_NAI_RX_NUM_WORDS		0x0A0
+#define SANDBOX_NAI_RX_EMPTY			0x0C0
+#define SANDBOX_NAI_RX_PKT_READY		0x0E4
+#define SANDBOX_NAI_DETECT_STATUS		0x100
+
+/* Kinds of pending responses */
+#define SANDBOX_NAI_JOB_FINISHED		1		/* COMMAND_TYPECODE_REQUEST_FINISHED carrying nStatus */
+#define SANDBOX_NAI_JOB_READ			2		/* READFLASH / READEEPROM data, one packet at a time */
+#define SANDBOX_NAI_JOB_READREG			3		/* Operational SERDES_READREG data */
+
+typedef struct
+{
+	uint8_t ucKind;
+	uint8_t ucRequesterID;				/* Slot the response goes back to */
+	uint16_t usID;
+	uint16_t usCommandType;
+	uint16_t usChipID;
+	uint16_t usSequenceNum;				/* Sequence number of the last packet sent */
+	uint16_t usExpectedSequenceCount;
+	uint32_t unMsgLength;
+	uint32_t unOffset;					/* Offset of the next byte to read */
+	uint32_t unRequestOffset;
+	uint32_t unRequestLength;
+	uint32_t unBytesLeft;
+	int32_t nStatus;
+	SerdesHdr tRegHdr;					/* Operational read request being answered */
+} SandboxNaiJob;
+
+typedef struct
+{
+	uint32_t unTxFIFO[SANDBOX_NAI_FIFO_WORDS];
+	uint32_t unTxCount;
+	uint32_t unRxFIFO[SANDBOX_NAI_FIFO_WORDS];
+	uint32_t unRxHead;
+	uint32_t unRxCount;
+	SandboxNaiJob tJobs[SANDBOX_NAI_JOBS];
+	uint32_t unJobHead;
+	uint32_t unJobCount;
+	BOOL bWriting;						/* A multi packet write message is being received */
+	uint16_t usWriteID;
+	uint32_t unWriteOffset;
+	uint32_t unWriteWordsLeft;
+	int32_t nWriteStatus;
+	uint16_t usNextTranID;
+	uint32_t unRegs[SANDBOX_NAI_REG_BYTES / 4];
+	uint8_t *pucFlash;					/* Allocated on first use */
+	uint8_t ucEEPROM[2][SANDBOX_NAI_EEPROM_BYTES];
+	BOOL bEEPROMInitialized;
+} SandboxNaiSlot;
+
+static SandboxNaiSlot g_tSandboxNaiSlots[SANDBOX_NAI_SLOTS];
+static NAIMsg g_tSandboxNaiMsg; /* Scratch packet used to parse requests and build responses */
+
+static void sandbox_nai_fill_rx(uint8_t ucSlotID);
+
+static SandboxNaiSlot * sandbox_nai_get_slot(uint8_t ucSlotID)
+{
+	if (ucSlotID < MODULE_1_SLOT || ucSlotID > SANDBOX_NAI_SLOTS)
+		return NULL;
+
+	return &g_tSandboxNaiSlots[ucSlotID - 1];
+}
+
+/**************************************************************************************************************/
+/**
+\ingroup SandboxEmulation
+<summary>
+sandbox_nai_get_flash returns the emulated QSPI flash of a slot, allocating it (erased) on first use.
+</summary>
+<param name="ptSlot"> : (Input) Emulated slot.</param>
+<returns>uint8_t* : Flash contents (NULL if it could not be allocated)</returns>
+*/
+/**************************************************************************************************************/
+static uint8_t * sandbox_nai_get_flash(SandboxNaiSlot *ptSlot)
+{
+	if (ptSlot->pucFlash == NULL)
+	{
+		ptSlot->pucFlash = (uint8_t *)malloc(SANDBOX_NAI_FLASH_BYTES);
+		if (ptSlot->pucFlash != NULL)
+			memset(ptSlot->pucFlash, 0xFF, SANDBOX_NAI_FLASH_BYTES);
+	}
+
+	return ptSlot->pucFlash;
+}
+
+/**************************************************************************************************************/
+/**
+\ingroup SandboxEmulation
+<summary>
+sandbox_nai_get_eeprom returns the emulated EEPROM with the given I2C chip ID. The EEPROMs start out with a fixed
+pattern so reads of an untouched part return recognisable data.
+</summary>
+<param name="ptSlot"> : (Input) Emulated slot.</param>
+<param name="usChipID"> : (Input) I2C_INTERFACE_MODULE_EEPROM or I2C_FUNCTIONAL_MODULE_EEPROM.</param>
+<returns>uint8_t* : EEPROM contents (NULL if there is no such chip)</returns>
+*/
+/**************************************************************************************************************/
+static uint8_t * sandbox_nai_get_eeprom(SandboxNaiSlot *ptSlot, uint16_t usChipID)
+{
+	uint32_t i = 0;
+
+	if (!ptSlot->bEEPROMInitialized)
+	{
+		for (i = 0; i < SANDBOX_NAI_EEPROM_BYTES; i++)
+		{
+			ptSlot->ucEEPROM[0][i] = (uint8_t)i;
+			ptSlot->ucEEPROM[1][i] = (uint8_t)(~i);
+		}
+		ptSlot->bEEPROMInitialized = TRUE;
+	}
+
+	if (usChipID == I2C_INTERFACE_MODULE_EEPROM)
+		return ptSlot->ucEEPROM[0];
+	else if (usChipID == I2C_FUNCTIONAL_MODULE_EEPROM)
+		return ptSlot->ucEEPROM[1];
+
+	return NULL;
+}
+
+static SandboxNaiJob * sandbox_nai_queue_job(SandboxNaiSlot *ptSlot, uint8_t ucKind, uint8_t ucRequesterID)
+{
+	SandboxNaiJob *ptJob = NULL;
+
+	if (ptSlot->unJobCount == SANDBOX_NAI_JOBS)
+	{
+		printf("sandbox nai: response queue full, dropping response\n");
+		return NULL;
+	}
+
+	ptJob = &ptSlot->tJobs[(ptSlot->unJobHead + ptSlot->unJobCount) % SANDBOX_NAI_JOBS];
+	ptSlot->unJobCount++;
+
+	memset(ptJob, 0, sizeof(SandboxNaiJob));
+	ptJob->ucKind = ucKind;
+	ptJob->ucRequesterID = ucRequesterID;
+
+	return ptJob;
+}
+
+static void sandbox_nai_queue_finished(SandboxNaiSlot *ptSlot, SerdesHdr *ptSerdesHdr, uint16_t usID, int32_t nStatus)
+{
+	SandboxNaiJob *ptJob = sandbox_nai_queue_job(ptSlot, SANDBOX_NAI_JOB_FINISHED, ptSerdesHdr->ucRequesterID);
+
+	if (ptJob != NULL)
+	{
+		ptJob->usID = usID;
+		ptJob->nStatus = nStatus;
+	}
+}
+
+/**************************************************************************************************************/
+/**
+\ingroup SandboxEmulation
+<summary>
+sandbox_nai_rx_push_msg copies one packet (SERDES header plus ucPayloadLength words) into the RX FIFO of a slot. The
+caller must have checked there is room for a full packet.
+</summary>
+<param name="ptSlot"> : (Input) Emulated slot.</param>
+<param name="pusMsg"> : (Input) Packet to push.</param>
+<returns>VOID</returns>
+*/
+/**************************************************************************************************************/
+static void sandbox_nai_rx_push_msg(SandboxNaiSlot *ptSlot, const uint16_t *pusMsg)
+{
+	const SerdesHdr *ptSerdesHdr = (const SerdesHdr *)pusMsg;
+	uint32_t unWords = TOTAL_SERDES_READWRITEREQ_HDR_IN_WORDS + ptSerdesHdr->ucPayloadLength;
+	uint32_t unTail = 0;
+	FIFOValue tFIFOVal;
+	uint32_t i = 0;
+
+	for (i = 0; i < unWords; i += 2)
+	{
+		tFIFOVal.usLoWord = pusMsg[i];
+		tFIFOVal.usHiWord = ((i + 1) < unWords) ? pusMsg[i + 1] : 0;
+		unTail = (ptSlot->unRxHead + ptSlot->unRxCount) % SANDBOX_NAI_FIFO_WORDS;
+		ptSlot->unRxFIFO[unTail] = tFIFOVal.unValue;
+		ptSlot->unRxCount++;
+	}
+}
+
+static void sandbox_nai_init_response(NAIMsg *ptMsg, uint8_t ucSlotID, SandboxNaiJob *ptJob)
+{
+	memset(ptMsg, 0, sizeof(NAIMsg));
+
+	/* Module (slot) is the requester of a response, the original requester is the completer */
+	ptMsg->tSerdesHdr.ucType = 3;
+	ptMsg->tSerdesHdr.ucToHPS = 1;
+	ptMsg->tSerdesHdr.ucRequesterID = ucSlotID;
+	ptMsg->tSerdesHdr.ucCompleterID = ptJob->ucRequesterID;
+
+	/* The requests are sent without a CRC (_COMPUTE_CRC is off) and so are the responses */
+	ptMsg->tSerdesPayLd.tTransportHdr.usID = ptJob->usID;
+	ptMsg->tSerdesPayLd.tTransportHdr.unMsgLength = ptJob->unMsgLength;
+	ptMsg->tSerdesPayLd.tTransportHdr.usExpectedSequenceCount = ptJob->usExpectedSequenceCount;
+}
+
+/**************************************************************************************************************/
+/**
+\ingroup SandboxEmulation
+<summary>
+sandbox_nai_build_response turns the next packet of a pending response into a SERDES packet, following the layout
+the module side builds in nai_send_msg_finished_response, nai_read_from_flash and nai_read_from_eeprom.
+</summary>
+<param name="ucSlotID"> : (Input) Slot sending the response.</param>
+<param name="ptJob"> : (Input) Pending response.</param>
+<param name="ptMsg"> : (Output) Packet to push into the RX FIFO.</param>
+<returns>BOOL : TRUE once the last packet of the response has been built</returns>
+*/
+/**************************************************************************************************************/
+static BOOL sandbox_nai_build_response(uint8_t ucSlotID, SandboxNaiJob *ptJob, NAIMsg *ptMsg)
+{
+	SandboxNaiSlot *ptSlot = sandbox_nai_get_slot(ucSlotID);
+	CommandHdr *ptCommandHdr = &ptMsg->tSerdesPayLd.tTransportPayLd.tCommandHdr;
+	uint8_t *pucPayload = (uint8_t *)ptMsg->tSerdesPayLd.tTransportPayLd.tCommandPayLd.usData;
+	uint8_t *pucStorage = NULL;
+	uint32_t unStorageBytes = 0;
+	uint32_t unBytes = 0;
+	uint32_t unValue = 0;
+	uint32_t unAddress = 0;
+	FIFOValue tFIFOVal;
+	uint32_t i = 0;
+
+	if (ptJob->ucKind == SANDBOX_NAI_JOB_READREG)
+	{
+		/* The FPGA echoes the request header and appends one 32 bit register (2 words) per payload word pair */
+		memset(ptMsg, 0, sizeof(NAIOperMsg));
+		memcpy(&ptMsg->tSerdesHdr, &ptJob->tRegHdr, sizeof(SerdesHdr));
+		if (ptMsg->tSerdesHdr.ucPayloadLength > OPER_MAX_PAYLOAD_IN_WORDS)
+			ptMsg->tSerdesHdr.ucPayloadLength = OPER_MAX_PAYLOAD_IN_WORDS;
+		tFIFOVal.usLoWord = ptJob->tRegHdr.usAddressLo;
+		tFIFOVal.usHiWord = ptJob->tRegHdr.usAddressHi;
+		unAddress = tFIFOVal.unValue & ~0x3;
+
+		for (i = 0; (i + 1) < ptMsg->tSerdesHdr.ucPayloadLength; i += 2)
+		{
+			unValue = ptSlot->unRegs[(unAddress & (SANDBOX_NAI_REG_BYTES - 1)) >> 2];
+			tFIFOVal.unValue = unValue;
+			((NAIOperMsg *)ptMsg)->tSerdesPayLd.usData[i] = tFIFOVal.usLoWord;
+			((NAIOperMsg *)ptMsg)->tSerdesPayLd.usData[i + 1] = tFIFOVal.usHiWord;
+			unAddress += (ptJob->tRegHdr.ucBlockAddrIncrVal * 4);
+		}
+		return TRUE;
+	}
+
+	sandbox_nai_init_response(ptMsg, ucSlotID, ptJob);
+
+	if (ptJob->ucKind == SANDBOX_NAI_JOB_FINISHED)
+	{
+		ptMsg->tSerdesPayLd.tTransportHdr.unMsgLength = 2 + CONFIG_TOTAL_PKT_HDR_IN_WORDS;
+		ptMsg->tSerdesPayLd.tTransportHdr.usSequenceNum = 1;
+		ptMsg->tSerdesPayLd.tTransportHdr.usExpectedSequenceCount = 1;
+		ptMsg->tSerdesPayLd.tTransportHdr.usPacketPayLdLength = 2;
+		ptCommandHdr->usCommandType = COMMAND_TYPECODE_REQUEST_FINISHED;
+
+		tFIFOVal.unValue = (uint32_t)ptJob->nStatus;
+		ptMsg->tSerdesPayLd.tTransportPayLd.tCommandPayLd.usData[0] = tFIFOVal.usLoWord;
+		ptMsg->tSerdesPayLd.tTransportPayLd.tCommandPayLd.usData[1] = tFIFOVal.usHiWord;
+		ptMsg->tSerdesHdr.ucPayloadLength = (uint8_t)(2 + CONFIG_TOTAL_PKT_HDR_IN_WORDS - TOTAL_SERDES_READWRITEREQ_HDR_IN_WORDS);
+		return TRUE;
+	}
+
+	/* SANDBOX_NAI_JOB_READ - up to CONFIG_MAX_PAYLOAD_IN_WORDS of data per packet, unprogrammed space reads as 0xFF */
+	if (ptJob->usCommandType == COMMAND_TYPECODE_READFLASH)
+	{
+		pucStorage = sandbox_nai_get_flash(ptSlot);
+		unStorageBytes = SANDBOX_NAI_FLASH_BYTES;
+	}
+	else
+	{
+		pucStorage = sandbox_nai_get_eeprom(ptSlot, ptJob->usChipID);
+		unStorageBytes = SANDBOX_NAI_EEPROM_BYTES;
+	}
+
+	unBytes = MIN(ptJob->unBytesLeft, (CONFIG_MAX_PAYLOAD_IN_WORDS * 2));
+	for (i = 0; i < unBytes; i++)
+	{
+		if (pucStorage != NULL && (ptJob->unOffset + i) < unStorageBytes)
+			pucPayload[i] = pucStorage[ptJob->unOffset + i];
+		else
+			pucPayload[i] = 0xFF;
+	}
+
+	ptJob->usSequenceNum++;
+	ptJob->unOffset += unBytes;
+	ptJob->unBytesLeft -= unBytes;
+
+	ptMsg->tSerdesPayLd.tTransportHdr.usSequenceNum = ptJob->usSequenceNum;
+	ptMsg->tSerdesPayLd.tTransportHdr.usPacketPayLdLength = (uint16_t)unBytes;
+	ptCommandHdr->usCommandType = ptJob->usCommandType;
+	ptCommandHdr->usChipID = ptJob->usChipID;
+	ptCommandHdr->unOffset = ptJob->unRequestOffset;
+	ptCommandHdr->unPayLdRequestLength = ptJob->unRequestLength;
+	ptMsg->tSerdesHdr.ucPayloadLength = (uint8_t)(MIN((convert_bytes_to_words(unBytes) + CONFIG_TOTAL_PKT_HDR_IN_WORDS), MAX_SERDES_MSG_IN_WORDS) - TOTAL_SERDES_READWRITEREQ_HDR_IN_WORDS);
+
+	/* Serdes Payload length must be a multiple of 2 */
+	if ((ptMsg->tSerdesHdr.ucPayloadLength % 2) != 0)
+		ptMsg->tSerdesHdr.ucPayloadLength++;
+
+	return (ptJob->unBytesLeft == 0);
+}
+
+/**************************************************************************************************************/
+/**
+\ingroup SandboxEmulation
+<summary>
+sandbox_nai_fill_rx moves pending responses of a slot into its RX FIFO for as long as a full packet still fits.
+</summary>
+<param name="ucSlotID"> : (Input) Slot whose RX FIFO is topped up.</param>
+<returns>VOID</returns>
+*/
+/**************************************************************************************************************/
+static void sandbox_nai_fill_rx(uint8_t ucSlotID)
+{
+	SandboxNaiSlot *ptSlot = sandbox_nai_get_slot(ucSlotID);
+	SandboxNaiJob *ptJob = NULL;
+
+	while (ptSlot->unJobCount > 0 && (ptSlot->unRxCount + SANDBOX_NAI_PKT_FIFO_WORDS) <= SANDBOX_NAI_FIFO_WORDS)
+	{
+		ptJob = &ptSlot->tJobs[ptSlot->unJobHead];
+		if (sandbox_nai_build_response(ucSlotID, ptJob, &g_tSandboxNaiMsg))
+		{
+			ptSlot->unJobHead = (ptSlot->unJobHead + 1) % SANDBOX_NAI_JOBS;
+			ptSlot->unJobCount--;
+		}
+		sandbox_nai_rx_push_msg(ptSlot, g_tSandboxNaiMsg.msg);
+	}
+}
+
+/**************************************************************************************************************/
+/**
+\ingroup SandboxEmulation
+<summary>
+sandbox_nai_store writes one packet worth of payload into the emulated flash or EEPROM. Flash behaves like the
+real QSPI part: programming can only clear bits, so a missing erase shows up as a verify failure.
+</summary>
+<param name="ptSlot"> : (Input) Emulated slot.</param>
+<param name="ptCommandHdr"> : (Input) Command header of the write request.</param>
+<param name="unOffset"> : (Input) Offset the payload goes to.</param>
+<param name="pucData"> : (Input) Payload.</param>
+<param name="unLen"> : (Input) Payload length in bytes.</param>
+<returns>int32_t : Status reported back in the finished response
+	- 0  : SUCCESS
+	- Non-Zero : ERROR
+</returns>
+*/
+/**************************************************************************************************************/
+static int32_t sandbox_nai_store(SandboxNaiSlot *ptSlot, CommandHdr *ptCommandHdr, uint32_t unOffset, const uint8_t *pucData, uint32_t unLen)
+{
+	uint8_t *pucStorage = NULL;
+	uint32_t i = 0;
+
+	switch (ptCommandHdr->usCommandType)
+	{
+		case COMMAND_TYPECODE_WRITEFLASH :
+			pucStorage = sandbox_nai_get_flash(ptSlot);
+			if (pucStorage == NULL)
+				return NAI_QSPI_NOT_FOUND;
+			if (unOffset >= SANDBOX_NAI_FLASH_BYTES || unLen > (SANDBOX_NAI_FLASH_BYTES - unOffset))
+				return NAI_QSPI_WRITE_FAILED;
+			for (i = 0; i < unLen; i++)
+				pucStorage[unOffset + i] &= pucData[i];
+			break;
+
+		case COMMAND_TYPECODE_WRITEEEPROM :
+			pucStorage = sandbox_nai_get_eeprom(ptSlot, ptCommandHdr->usChipID);
+			if (pucStorage == NULL)
+				return NAI_I2C_DEVICE_NOT_FOUND;
+			if (unOffset >= SANDBOX_NAI_EEPROM_BYTES || unLen > (SANDBOX_NAI_EEPROM_BYTES - unOffset))
+				return NAI_INVALID_PARAMETER_VALUE;
+			memcpy(pucStorage + unOffset, pucData, unLen);
+			break;
+
+		default :
+			/* CONFIG_MICRO: the loopback module has no microcontroller */
+			return NAI_NOT_SUPPORTED;
+	}
+
+	return NAI_SUCCESS;
+}
+
+/**************************************************************************************************************/
+/**
+\ingroup SandboxEmulation
+<summary>
+sandbox_nai_process_config handles one configuration mode packet (ucToHPS set) sent to a slot.
+Write packets are applied as they arrive and answered once the last packet of the message (by word count, as
+nai_receive_msg_packet does) is in; reads and erases are answered straight away.
+</summary>
+<param name="ucSlotID"> : (Input) Slot the packet was sent to.</param>
+<param name="ptMsg"> : (Input) Packet.</param>
+<returns>VOID</returns>
+*/
+/**************************************************************************************************************/
+static void sandbox_nai_process_config(uint8_t ucSlotID, NAIMsg *ptMsg)
+{
+	SandboxNaiSlot *ptSlot = sandbox_nai_get_slot(ucSlotID);
+	TransportHdr *ptTransportHdr = &ptMsg->tSerdesPayLd.tTransportHdr;
+	CommandHdr *ptCommandHdr = &ptMsg->tSerdesPayLd.tTransportPayLd.tCommandHdr;
+	SandboxNaiJob *ptJob = NULL;
+	uint32_t unWords = TOTAL_SERDES_READWRITEREQ_HDR_IN_WORDS + ptMsg->tSerdesHdr.ucPayloadLength;
+	uint32_t unBytes = 0;
+	uint32_t unEraseOffset = 0;
+	uint32_t unEraseLen = 0;
+	uint8_t *pucFlash = NULL;
+	int32_t nStatus = NAI_SUCCESS;
+
+	switch (ptCommandHdr->usCommandType)
+	{
+		case COMMAND_TYPECODE_WRITEFLASH :
+		case COMMAND_TYPECODE_WRITEEEPROM :
+		case COMMAND_TYPECODE_CONFIG_MICRO :
+			/* Every packet of a write carries the start offset of the message; payloads follow each other */
+			if (!ptSlot->bWriting || ptSlot->usWriteID != ptTransportHdr->usID)
+			{
+				ptSlot->bWriting = TRUE;
+				ptSlot->usWriteID = ptTransportHdr->usID;
+				ptSlot->unWriteOffset = ptCommandHdr->unOffset;
+				ptSlot->unWriteWordsLeft = ptTransportHdr->unMsgLength;
+				ptSlot->nWriteStatus = NAI_SUCCESS;
+			}
+
+			unBytes = MIN(ptTransportHdr->usPacketPayLdLength, (CONFIG_MAX_PAYLOAD_IN_WORDS * 2));
+			if (ptSlot->nWriteStatus == NAI_SUCCESS)
+				ptSlot->nWriteStatus = sandbox_nai_store(ptSlot, ptCommandHdr, ptSlot->unWriteOffset,
+														 (uint8_t *)ptMsg->tSerdesPayLd.tTransportPayLd.tCommandPayLd.usData, unBytes);
+			ptSlot->unWriteOffset += unBytes;
+
+			if (unWords >= ptSlot->unWriteWordsLeft)
+			{
+				ptSlot->bWriting = FALSE;
+				sandbox_nai_queue_finished(ptSlot, &ptMsg->tSerdesHdr, ptTransportHdr->usID, ptSlot->nWriteStatus);
+			}
+			else
+				ptSlot->unWriteWordsLeft -= unWords;
+			break;
+
+		case COMMAND_TYPECODE_ERASEFLASH :
+			/* unPayLdRequestLength holds the number of pages (see nai_erase_flash) */
+			unEraseOffset = (ptCommandHdr->unOffset / SANDBOX_NAI_FLASH_PAGE_BYTES) * SANDBOX_NAI_FLASH_PAGE_BYTES;
+			unEraseLen = (uint8_t)ptCommandHdr->unPayLdRequestLength * SANDBOX_NAI_FLASH_PAGE_BYTES;
+			pucFlash = sandbox_nai_get_flash(ptSlot);
+			if (pucFlash == NULL)
+				nStatus = NAI_QSPI_NOT_FOUND;
+			else if (unEraseOffset >= SANDBOX_NAI_FLASH_BYTES || unEraseLen > (SANDBOX_NAI_FLASH_BYTES - unEraseOffset))
+				nStatus = NAI_QSPI_ERASE_FAILED;
+			else
+				memset(pucFlash + unEraseOffset, 0xFF, unEraseLen);
+			sandbox_nai_queue_finished(ptSlot, &ptMsg->tSerdesHdr, ptTransportHdr->usID, nStatus);
+			break;
+
+		case COMMAND_TYPECODE_READFLASH :
+		case COMMAND_TYPECODE_READEEPROM :
+			/* Same limits as nai_read_from_flash / nai_read_from_eeprom: nothing is sent for an empty or oversized read */
+			if (ptCommandHdr->unPayLdRequestLength == 0)
+				break;
+			if (ptCommandHdr->usCommandType == COMMAND_TYPECODE_READEEPROM &&
+				ptCommandHdr->unPayLdRequestLength > SANDBOX_NAI_EEPROM_BYTES)
+				break;
+
+			ptJob = sandbox_nai_queue_job(ptSlot, SANDBOX_NAI_JOB_READ, ptMsg->tSerdesHdr.ucRequesterID);
+			if (ptJob == NULL)
+				break;
+
+			ptJob->usID = ++ptSlot->usNextTranID;
+			ptJob->usCommandType = ptCommandHdr->usCommandType;
+			ptJob->usChipID = ptCommandHdr->usChipID;
+			ptJob->usExpectedSequenceCount = calculate_nai_expected_sequence_count(convert_bytes_to_words(ptCommandHdr->unPayLdRequestLength));
+			ptJob->unMsgLength = convert_bytes_to_words(ptCommandHdr->unPayLdRequestLength) + (ptJob->usExpectedSequenceCount * CONFIG_TOTAL_PKT_HDR_IN_WORDS);
+			ptJob->unOffset = ptCommandHdr->unOffset;
+			ptJob->unRequestOffset = ptCommandHdr->unOffset;
+			ptJob->unRequestLength = ptCommandHdr->unPayLdRequestLength;
+			ptJob->unBytesLeft = ptCommandHdr->unPayLdRequestLength;
+			break;
+
+		default :
+			/* ASSIGNSLOT, RETRIEVESLOT, EXIT_CONFIG_MODE, RESET_MODULE, GET_MICRO ... are not emulated */
+			break;
+	}
+}
+
+/**************************************************************************************************************/
+/**
+\ingroup SandboxEmulation
+<summary>
+sandbox_nai_process_oper handles one operational packet (register read or write) sent to a slot. Each 32 bit
+register takes two payload words; the address advances by ucBlockAddrIncrVal registers per value.
+</summary>
+<param name="ucSlotID"> : (Input) Slot the packet was sent to.</param>
+<param name="ptMsg"> : (Input) Packet.</param>
+<returns>VOID</returns>
+*/
+/**************************************************************************************************************/
+static void sandbox_nai_process_oper(uint8_t ucSlotID, NAIOperMsg *ptMsg)
+{
+	SandboxNaiSlot *ptSlot = sandbox_nai_get_slot(ucSlotID);
+	SerdesHdr *ptSerdesHdr = &ptMsg->tSerdesHdr;
+	SandboxNaiJob *ptJob = NULL;
+	uint32_t unAddress = 0;
+	uint32_t unMask = 0;
+	uint32_t *punReg = NULL;
+	FIFOValue tFIFOVal;
+	uint32_t i = 0;
+
+	if (ptSerdesHdr->ucType == SERDES_READREG)
+	{
+		ptJob = sandbox_nai_queue_job(ptSlot, SANDBOX_NAI_JOB_READREG, ptSerdesHdr->ucRequesterID);
+		if (ptJob != NULL)
+			memcpy(&ptJob->tRegHdr, ptSerdesHdr, sizeof(SerdesHdr));
+		return;
+	}
+
+	if (ptSerdesHdr->ucType != SERDES_WRITEREG)
+		return;
+
+	tFIFOVal.usLoWord = ptSerdesHdr->usAddressLo;
+	tFIFOVal.usHiWord = ptSerdesHdr->usAddressHi;
+	unAddress = tFIFOVal.unValue & ~0x3;
+
+	for (i = 0; i < 4; i++)
+	{
+		if (ptSerdesHdr->ucByteEnable & (1 << i))
+			unMask |= (0xFF << (i * 8));
+	}
+
+	for (i = 0; (i + 1) < ptSerdesHdr->ucPayloadLength; i += 2)
+	{
+		tFIFOVal.usLoWord = ptMsg->tSerdesPayLd.usData[i];
+		tFIFOVal.usHiWord = ptMsg->tSerdesPayLd.usData[i + 1];
+		punReg = &ptSlot->unRegs[(unAddress & (SANDBOX_NAI_REG_BYTES - 1)) >> 2];
+		*punReg = (*punReg & ~unMask) | (tFIFOVal.unValue & unMask);
+		unAddress += (ptSerdesHdr->ucBlockAddrIncrVal * 4);
+	}
+}
+
+/**************************************************************************************************************/
+/**
+\ingroup SandboxEmulation
+<summary>
+sandbox_nai_tx_pkt_ready is called when the TX packet ready register of a slot is written: the staged TX FIFO
+words are handed to the loopback module and the FIFO is emptied.
+</summary>
+<param name="ucSlotID"> : (Input) Slot the packet was sent to.</param>
+<returns>VOID</returns>
+*/
+/**************************************************************************************************************/
+static void sandbox_nai_tx_pkt_ready(uint8_t ucSlotID)
+{
+	SandboxNaiSlot *ptSlot = sandbox_nai_get_slot(ucSlotID);
+	FIFOValue tFIFOVal;
+	uint32_t i = 0;
+
+	if (ptSlot->unTxCount < (TOTAL_SERDES_READWRITEREQ_HDR_IN_WORDS / 2))
+	{
+		ptSlot->unTxCount = 0;
+		return;
+	}
+
+	memset(g_tSandboxNaiMsg.msg, 0, sizeof(g_tSandboxNaiMsg.msg));
+	for (i = 0; i < ptSlot->unTxCount && i < SANDBOX_NAI_PKT_FIFO_WORDS; i++)
+	{
+		tFIFOVal.unValue = ptSlot->unTxFIFO[i];
+		g_tSandboxNaiMsg.msg[(i * 2)] = tFIFOVal.usLoWord;
+		g_tSandboxNaiMsg.msg[(i * 2) + 1] = tFIFOVal.usHiWord;
+	}
+	ptSlot->unTxCount = 0;
+
+	if (g_tSandboxNaiMsg.tSerdesHdr.ucToHPS)
+		sandbox_nai_process_config(ucSlotID, &g_tSandboxNaiMsg);
+	else
+		sandbox_nai_process_oper(ucSlotID, (NAIOperMsg *)&g_tSandboxNaiMsg);
+
+	sandbox_nai_fill_rx(ucSlotID);
+}
+
+static uint32_t sandbox_nai_fifo_status(BOOL bTx, BOOL bEmpty)
+{
+	SandboxNaiSlot *ptSlot = NULL;
+	uint32_t unCount = 0;
+	uint32_t unStatus = 0;
+	uint8_t ucSlotID = 0;
+
+	for (ucSlotID = MODULE_1_SLOT; ucSlotID <= SANDBOX_NAI_SLOTS; ucSlotID++)
+	{
+		ptSlot = sandbox_nai_get_slot(ucSlotID);
+		if (!bTx)
+			sandbox_nai_fill_rx(ucSlotID);
+
+		unCount = bTx ? ptSlot->unTxCount : ptSlot->unRxCount;
+		if ((unCount == 0) == bEmpty)
+			unStatus |= (1 << (ucSlotID - 1));
+	}
+
+	return unStatus;
+}
+
+/**************************************************************************************************************/
+/**
+\ingroup SandboxEmulation
+<summary>
+sandbox_nai_serdes_read32 emulates a 32 bit read of the SERDES register window. Called by nai_read16 / nai_read32
+instead of dereferencing the bus address.
+</summary>
+<param name="unAddress"> : (Input) 32 Bit bus address (g_unBaseAddress + register offset).</param>
+<returns>uint32_t - 32 Bit register value (0 outside of the emulated registers)</returns>
+*/
+/**************************************************************************************************************/
+uint32_t sandbox_nai_serdes_read32(uint32_t unAddress)
+{
+	SandboxNaiSlot *ptSlot = NULL;
+	uint32_t unOffset = unAddress - PS2FPGA_MODULE_BASE_ADDRESS;
+	uint32_t unValue = 0;
+	uint8_t ucSlotID = 0;
+
+	if (unOffset >= SANDBOX_NAI_WINDOW_BYTES)
+		return 0;
+
+	if (unOffset >= SANDBOX_NAI_RX_FIFO && unOffset < (SANDBOX_NAI_RX_FIFO + (SANDBOX_NAI_SLOTS * 4)))
+	{
+		ucSlotID = (uint8_t)(((unOffset - SANDBOX_NAI_RX_FIFO) / 4) + 1);
+		ptSlot = sandbox_nai_get_slot(ucSlotID);
+		if (ptSlot->unRxCount == 0)
+			return 0;
+
+		unValue = ptSlot->unRxFIFO[ptSlot->unRxHead];
+		ptSlot->unRxHead = (ptSlot->unRxHead + 1) % SANDBOX_NAI_FIFO_WORDS;
+		ptSlot->unRxCount--;
+		sandbox_nai_fill_rx(ucSlotID);
+		return unValue;
+	}
+
+	if (unOffset >= SANDBOX_NAI_RX_NUM_WORDS && unOffset < (SANDBOX_NAI_RX_NUM_WORDS + (SANDBOX_NAI_SLOTS * 4)))
+	{
+		ucSlotID = (uint8_t)(((unOffset - SANDBOX_NAI_RX_NUM_WORDS) / 4) + 1);
+		sandbox_nai_fill_rx(ucSlotID);
+		return sandbox_nai_get_slot(ucSlotID)->unRxCount;
+	}
+
+	switch (unOffset)
+	{
+		case SANDBOX_NAI_TX_EMPTY :
+			unValue = sandbox_nai_fifo_status(TRUE, TRUE);
+			break;
+		case SANDBOX_NAI_RX_EMPTY :
+			unValue = sandbox_nai_fifo_status(FALSE, TRUE);
+			break;
+		case SANDBOX_NAI_RX_PKT_READY :
+			/* Only whole packets are ever pushed, so any data means a packet is ready */
+			unValue = sandbox_nai_fifo_status(FALSE, FALSE);
+			break;
+		case SANDBOX_NAI_DETECT_STATUS :
+			/* Detection done (bits 8 - 13) and a module present (bits 0 - 5) in every slot */
+			unValue = 0x3F3F;
+			break;
+		case COMMON_MBINFO_READY_ADDR :
+			unValue = 0xA5A5A5A5;
+			break;
+		default :
+			/* Module start addresses: one register space per slot, nothing behind the seventh entry */
+			if (unOffset >= COMMON_MBINFO_MODULESTART_ADDR && unOffset < (COMMON_MBINFO_MODULESTART_ADDR + (7 * 4)))
+			{
+				ucSlotID = (uint8_t)((unOffset - COMMON_MBINFO_MODULESTART_ADDR) / 4);
+				unValue = (ucSlotID < SANDBOX_NAI_SLOTS) ? (ucSlotID * SANDBOX_NAI_REG_BYTES) : 0xFFFFFFFF;
+			}
+			break;
+	}
+
+	return unValue;
+}
+
+/**************************************************************************************************************/
+/**
+\ingroup SandboxEmulation
+<summary>
+sandbox_nai_serdes_write32 emulates a 32 bit write to the SERDES register window. Called by nai_write16 /
+nai_write32 instead of dereferencing the bus address.
+</summary>
+<param name="unAddress"> : (Input) 32 Bit bus address (g_unBaseAddress + register offset).</param>
+<param name="unValue"> : (Input) 32 Bit value to be written.</param>
+<returns>VOID</returns>
+*/
+/**************************************************************************************************************/
+void sandbox_nai_serdes_write32(uint32_t unAddress, uint32_t unValue)
+{
+	SandboxNaiSlot *ptSlot = NULL;
+	uint32_t unOffset = unAddress - PS2FPGA_MODULE_BASE_ADDRESS;
+	uint8_t ucSlotID = 0;
+
+	if (unOffset < (SANDBOX_NAI_TX_FIFO + (SANDBOX_NAI_SLOTS * 4)))
+	{
+		ptSlot = sandbox_nai_get_slot((uint8_t)((unOffset / 4) + 1));
+		if (ptSlot->unTxCount < SANDBOX_NAI_FIFO_WORDS)
+			ptSlot->unTxFIFO[ptSlot->unTxCount++] = unValue;
+	}
+	else if (unOffset >= SANDBOX_NAI_TX_PKT_READY && unOffset < (SANDBOX_NAI_TX_PKT_READY + (SANDBOX_NAI_SLOTS * 4)))
+	{
+		ucSlotID = (uint8_t)(((unOffset - SANDBOX_NAI_TX_PKT_READY) / 4) + 1);
+		if (unValue & 0x1)
+			sandbox_nai_tx_pkt_ready(ucSlotID);
+	}
+
+	/* Clearing RX packet ready needs no action: the bit follows the RX FIFO contents */
+}
@@ -553,7 +553,7 @@ int do_naisend(cmd_tbl_t * cmdtp, int flag, int argc, char * const argv[])
 #ifdef _DANT	
 	uint32_t unPayload = 50;
 #endif
-	if (argc == 2)
+	if (argc >= 2)
 		ucTargetModuleSlot = (uint8_t)simple_strtoul (argv[1], NULL, 10);
 
 #ifdef _DANT
@@ -698,10 +698,20 @@ int do_naisend(cmd_tbl_t * cmdtp, int flag, int argc, char * const argv[])
 //	uint32_t unPrevBytesWritten = 0;
 	uint32_t unFailures = 0;
 	BOOL bMisMatch = FALSE;
+	MsgPoolStats tPoolStats;
+	MsgTxStats tTxStats;
+	uint32_t unBytesMoved = 0;
+	BOOL bWindowed = FALSE;
 
-	if (argc == 3)
+	if (argc >= 3)
 		nLoopCnt = (uint32_t)simple_strtoul (argv[2], NULL, 10);
 
+	if (argc >= 4)
+		bWindowed = (simple_strtoul (argv[3], NULL, 10) != 0);
+
+	nai_get_msg_pool_stats(NULL, TRUE); /* Start counting packet allocations from here */
+	nai_get_msg_tx_stats(NULL, TRUE);
+
 	for (i=0; i < nLoopCnt; i++)
 	{
 		memset(pTemp, 0, nLen);
@@ -727,8 +737,16 @@ int do_naisend(cmd_tbl_t * cmdtp, int flag, int argc, char * const argv[])
 //		unOffset = ((i%256) * nLen);
 //		unOffset += unPrevBytesWritten;
 
-		printf("nai_write_module_flash_request  [%d  of  %d]\r\n", i+1, nLoopCnt);
-		nStatus = nai_write_module_flash_request(MB_SLOT, ucTargetModuleSlot, unOffset, &(pTemp[0]), nLen);
+		if (bWindowed)
+		{
+			printf("nai_write_module_flash_windowed_request  [%d  of  %d]\r\n", i+1, nLoopCnt);
+			nStatus = nai_write_module_flash_windowed_request(MB_SLOT, ucTargetModuleSlot, unOffset, &(pTemp[0]), nLen);
+		}
+		else
+		{
+			printf("nai_write_module_flash_request  [%d  of  %d]\r\n", i+1, nLoopCnt);
+			nStatus = nai_write_module_flash_request(MB_SLOT, ucTargetModuleSlot, unOffset, &(pTemp[0]), nLen);
+		}
 	
 		if (nStatus != NAI_SUCCESS)
 		{
@@ -773,7 +791,18 @@ int do_naisend(cmd_tbl_t * cmdtp, int flag, int argc, char * const argv[])
 		printf("Total Number of Failures: %u\r\n", unFailures);
 		printf("-----------------------------------------------------\r\n");			
 
+		unBytesMoved += (nLen * 2); /* Written and read back */
 	}
+
+	nai_get_msg_pool_stats(&tPoolStats, FALSE);
+	printf("Msg Packets: %u from pool, %u from heap (%u heap allocations per MB), pool high water %u\r\n",
+		   tPoolStats.unPoolAcquires, tPoolStats.unHeapAllocs,
+		   (unBytesMoved >= 0x100000) ? (tPoolStats.unHeapAllocs / (unBytesMoved >> 20)) : tPoolStats.unHeapAllocs,
+		   tPoolStats.unHighWater);
+	nai_get_msg_tx_stats(&tTxStats, FALSE);
+	printf("TX FIFO: %u packets, %u words in %u us (%u KB/s)\r\n",
+		   tTxStats.unPackets, tTxStats.unWords, tTxStats.unMicroseconds,
+		   (tTxStats.unMicroseconds > 0) ? (uint32_t)(((uint64_t)tTxStats.unWords * 4 * 1000000) / tTxStats.unMicroseconds / 1024) : 0);
 	printf("END WRITE - READ - VERIFY FLASH\r\n");
 	printf("======================================================\r\n");	
 //#endif
@@ -876,6 +905,74 @@ int do_naireadreg32byslot(cmd_tbl_t * cmdtp, int flag, int argc, char * const ar
 	return 0;
 }
 
+int do_naibatchreg(cmd_tbl_t * cmdtp, int flag, int argc, char * const argv[])
+{
+	int32_t nStatus = NAI_SUCCESS;
+	uint8_t ucTargetModuleSlot = 1;
+	NAIRegOp *ptOps = NULL;
+	uint32_t unCount = 0;
+	uint32_t unOpsDone = 0;
+	uint32_t i = 0;
+	char *pcEnd = NULL;
+
+	if (argc < 3)
+		return CMD_RET_USAGE;
+
+	ucTargetModuleSlot = (uint8_t)simple_strtoul (argv[1], NULL, 16);
+	unCount = (uint32_t)(argc - 2);
+	ptOps = (NAIRegOp *)malloc(sizeof(NAIRegOp) * unCount);
+	if (ptOps == NULL)
+		return CMD_RET_FAILURE;
+	memset(ptOps, 0, sizeof(NAIRegOp) * unCount);
+
+	/* r:offset | w:offset=value | m:offset=value/mask (all HEX) */
+	for (i = 0; i < unCount; i++)
+	{
+		const char *pcArg = argv[i + 2];
+
+		if (pcArg[0] == 'r')
+			ptOps[i].ucOp = NAI_REGOP_READ32;
+		else if (pcArg[0] == 'w')
+			ptOps[i].ucOp = NAI_REGOP_WRITE32;
+		else if (pcArg[0] == 'm')
+			ptOps[i].ucOp = NAI_REGOP_RMW32;
+
+		if (ptOps[i].ucOp == 0 || pcArg[1] != ':')
+		{
+			printf("Bad operation '%s'\r\n", pcArg);
+			free(ptOps);
+			return CMD_RET_USAGE;
+		}
+
+		ptOps[i].unModuleOffset = (uint32_t)simple_strtoul (&pcArg[2], &pcEnd, 16);
+		if (ptOps[i].ucOp != NAI_REGOP_READ32)
+		{
+			if (*pcEnd == '=')
+				ptOps[i].unValue = (uint32_t)simple_strtoul (pcEnd + 1, &pcEnd, 16);
+			if (ptOps[i].ucOp == NAI_REGOP_RMW32)
+				ptOps[i].unMask = (*pcEnd == '/') ? (uint32_t)simple_strtoul (pcEnd + 1, NULL, 16) : 0xFFFFFFFF;
+		}
+	}
+
+	nai_init_msg_utils(MB_SLOT);
+	nStatus = nai_batch_reg32_by_slot_request(ucTargetModuleSlot, ptOps, unCount, &unOpsDone);
+
+	for (i = 0; i < unOpsDone; i++)
+	{
+		if (ptOps[i].ucOp == NAI_REGOP_READ32)
+			printf("0x%8.8x : 0x%8.8x\r\n", ptOps[i].unModuleOffset, ptOps[i].unResult);
+		else if (ptOps[i].ucOp == NAI_REGOP_RMW32)
+			printf("0x%8.8x : 0x%8.8x -> 0x%8.8x\r\n", ptOps[i].unModuleOffset, ptOps[i].unResult,
+				   ((ptOps[i].unResult & ~ptOps[i].unMask) | (ptOps[i].unValue & ptOps[i].unMask)));
+	}
+
+	if (nStatus != NAI_SUCCESS)
+		printf("Failed nai_batch_reg32_by_slot_request at operation %u - Status = %d\r\n", unOpsDone, nStatus);
+
+	free(ptOps);
+	return (nStatus == NAI_SUCCESS) ? CMD_RET_SUCCESS : CMD_RET_FAILURE;
+}
+
 int do_naiwritereg16(cmd_tbl_t * cmdtp, int flag, int argc, char * const argv[])
 {
 	int32_t nStatus = NAI_SUCCESS;
@@ -1754,7 +1851,7 @@ U_BOOT_CMD(
 U_BOOT_CMD(
 	naisend,	4,	1,	do_naisend,
 	"naisend utility command",
-	"[module slot number]"	
+	"[module slot number] [loop count] [windowed flash writes: 1=WINDOWED 0=STOP AND WAIT]"	
 );
 
 U_BOOT_CMD(
@@ -1781,6 +1878,13 @@ U_BOOT_CMD(
 	"[slot id(8bit HEX)] [module offset(32bitHEX)]"
 );
 
+U_BOOT_CMD(
+	naibatchreg, CONFIG_SYS_MAXARGS, 1, do_naibatchreg,
+	"performs several module register operations as one batch",
+	"[slot id(8bit HEX)] [op] [op] ...\n"
+	"    op: r:offset | w:offset=value | m:offset=value/mask (all HEX)"
+);
+
 U_BOOT_CMD(
 	naiwritereg16, 3, 1, do_naiwritereg16,
 	"naiwritereg utility command",
@@ -259,6 +259,12 @@ static int spi_flash_update(struct spi_flash *flash, u32 offset,
 	return 0;
 }
 
+/* Flash selected by the last "sf probe" (NULL if none), for callers that drive it directly */
+struct spi_flash *sf_selected_flash(void)
+{
+	return flash;
+}
+
 int do_spi_flash_read_write(int argc, char * const argv[])
 {
 	unsigned long addr;
@@ -0,0 +1,65 @@
+/*
+ * Zstandard uncompress command
+ *
+ * Made from cmd/lzmadec.c
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <command.h>
+#include <mapmem.h>
+
+/* zstd keeps the difference between pointers, so must not overflow it */
+static size_t zstddec_room(const void *buf)
+{
+	return min((ulong)LONG_MAX, ~0UL - (uintptr_t)buf);
+}
+
+static int do_zstddec(cmd_tbl_t *cmdtp, int flag, int argc, char *const argv[])
+{
+	unsigned long src, dst;
+	size_t dst_len = ~0UL;
+	void *src_buf, *dst_buf;
+	int ret;
+
+	switch (argc) {
+	case 4:
+		dst_len = simple_strtoul(argv[3], NULL, 16);
+		/* fall through */
+	case 3:
+		src = simple_strtoul(argv[1], NULL, 16);
+		dst = simple_strtoul(argv[2], NULL, 16);
+		break;
+	default:
+		return CMD_RET_USAGE;
+	}
+
+	/*
+	 * The source length is not known, so allow up to the end of memory
+	 * and stop after the last frame. Do the same for the destination if
+	 * no size is given.
+	 */
+	src_buf = map_sysmem(src, 0);
+	dst_buf = map_sysmem(dst, dst_len);
+	dst_len = min(dst_len, zstddec_room(dst_buf));
+	ret = zstd_decompress(src_buf, zstddec_room(src_buf), dst_buf,
+			      &dst_len);
+	unmap_sysmem(dst_buf);
+	unmap_sysmem(src_buf);
+	if (ret) {
+		printf("Error: zstd returned %d\n", ret);
+		return 1;
+	}
+	printf("Uncompressed size: %ld = %#lX\n", (ulong)dst_len,
+	       (ulong)dst_len);
+	env_set_hex("filesize", dst_len);
+
+	return 0;
+}
+
+U_BOOT_CMD(
+	zstddec,    4,    1,    do_zstddec,
+	"zstd uncompress a memory region",
+	"srcaddr dstaddr [dstsize]"
+);
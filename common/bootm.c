@@ -15,6 +15,7 @@
 #include <malloc.h>
 #include <mapmem.h>
 #include <asm/io.h>
+#include <asm/unaligned.h>
 #include <linux/lzo.h>
 #include <lzma/LzmaTypes.h>
 #include <lzma/LzmaDec.h>
@@ -48,24 +49,24 @@ static const void *boot_get_kernel(cmd_tbl_t *cmdtp, int flag, int argc,
 				   ulong *os_data, ulong *os_len);
 
 #ifdef CONFIG_LMB
-static void boot_start_lmb(bootm_headers_t *images)
+static void boot_start_lmb(struct lmb *lmb)
 {
 	ulong		mem_start;
 	phys_size_t	mem_size;
 
-	lmb_init(&images->lmb);
+	lmb_init(lmb);
 
 	mem_start = env_get_bootm_low();
 	mem_size = env_get_bootm_size();
 
-	lmb_add(&images->lmb, (phys_addr_t)mem_start, mem_size);
+	lmb_add(lmb, (phys_addr_t)mem_start, mem_size);
 
-	arch_lmb_reserve(&images->lmb);
-	board_lmb_reserve(&images->lmb);
+	arch_lmb_reserve(lmb);
+	board_lmb_reserve(lmb);
 }
 #else
 #define lmb_reserve(lmb, base, size)
-static inline void boot_start_lmb(bootm_headers_t *images) { }
+#define boot_start_lmb(lmb)
 #endif
 
 static int bootm_start(cmd_tbl_t *cmdtp, int flag, int argc,
@@ -74,7 +75,7 @@ static int bootm_start(cmd_tbl_t *cmdtp, int flag, int argc,
 	memset((void *)&images, 0, sizeof(images));
 	images.verify = env_get_yesno("verify");
 
-	boot_start_lmb(&images);
+	boot_start_lmb(&images.lmb);
 
 	bootstage_mark_name(BOOTSTAGE_ID_BOOTM_START, "bootm_start");
 	images.state = BOOTM_STATE_START;
@@ -410,6 +411,15 @@ int bootm_decomp_image(int comp, ulong load, ulong image_start, int type,
 		break;
 	}
 #endif /* CONFIG_LZ4 */
+#ifdef CONFIG_ZSTD
+	case IH_COMP_ZSTD: {
+		size_t size = unc_len;
+
+		ret = zstd_decompress(image_buf, image_len, load_buf, &size);
+		image_len = ret == -ENOBUFS ? unc_len : size;
+		break;
+	}
+#endif /* CONFIG_ZSTD */
 	default:
 		printf("Unimplemented compression type %d\n", comp);
 		return BOOTM_ERR_UNIMPLEMENTED;
@@ -425,6 +435,170 @@ int bootm_decomp_image(int comp, ulong load, ulong image_start, int type,
 }
 
 #ifndef USE_HOSTCC
+long bootm_inplace_margin(int comp, ulong unc_len)
+{
+	switch (comp) {
+	case IH_COMP_NONE:
+		return 0;
+	case IH_COMP_GZIP:
+	case IH_COMP_LZO:
+	case IH_COMP_LZ4:
+		/*
+		 * The margin Linux allows for its own in-place decompression
+		 * (see arch/x86/boot/header.S): incompressible data grows by
+		 * up to 1 byte in 256 with LZ4 and less with gzip and LZO,
+		 * and the output of a block can get up to 64KB ahead of its
+		 * input.
+		 */
+		return (unc_len >> 8) + 65536;
+	default:
+		return -EPROTONOSUPPORT;
+	}
+}
+
+int bootm_inplace_addr(int comp, ulong load, ulong unc_len, ulong comp_len,
+		       ulong *addrp)
+{
+	long margin = bootm_inplace_margin(comp, unc_len);
+	ulong addr, end;
+#ifdef CONFIG_LMB
+	struct lmb lmb;
+#endif
+
+	if (margin < 0)
+		return margin;
+
+	/* An uncompressed image at the load address is not even copied */
+	if (comp == IH_COMP_NONE)
+		addr = load;
+	else
+		addr = ALIGN(load + unc_len + margin - comp_len,
+			     ARCH_DMA_MINALIGN);
+	addr = max(addr, load);
+	end = max(addr + comp_len, load + unc_len);
+
+#ifdef CONFIG_LMB
+	/* All of it must be in memory that bootm may use */
+	boot_start_lmb(&lmb);
+	if (lmb_alloc_addr(&lmb, load, end - load) != load)
+		return -ENOSPC;
+#endif
+	*addrp = addr;
+
+	return 0;
+}
+
+/* Get the decompressed size of an image, or an upper bound for it */
+static int bootm_decomp_size(int comp, const void *image_buf, ulong image_len,
+			     ulong *sizep)
+{
+	switch (comp) {
+	case IH_COMP_NONE:
+		*sizep = image_len;
+		return 0;
+	case IH_COMP_GZIP:
+		/* The size modulo 2^32 is in the last four bytes */
+		if (image_len < 18)
+			return -EINVAL;
+		*sizep = get_unaligned_le32(image_buf + image_len - 4);
+		return 0;
+#ifdef CONFIG_LZO
+	case IH_COMP_LZO: {
+		size_t size;
+
+		if (lzop_get_size(image_buf, image_len, &size) != LZO_E_OK)
+			return -EINVAL;
+		*sizep = size;
+		return 0;
+	}
+#endif
+#ifdef CONFIG_LZ4
+	case IH_COMP_LZ4: {
+		size_t size;
+
+		if (ulz4fn_size(image_buf, image_len, &size))
+			return -EINVAL;
+		*sizep = size;
+		return 0;
+	}
+#endif
+	default:
+		return -EPROTONOSUPPORT;
+	}
+}
+
+/*
+ * When the image data lies in the area it is loaded to, it is decompressed
+ * or moved over itself. Check that this is safe: the data must end far
+ * enough beyond the end of the output, and the output must not reach the
+ * ramdisk or FDT. On success *unc_lenp is the space to decompress into,
+ * which is only as much as there is room for when decompressing in place.
+ *
+ * @return 0 if OK, -E2BIG if the image says it decompresses to more than
+ * CONFIG_SYS_BOOTM_LEN, -ENOSPC if the data does not end far enough beyond
+ * the output, -EXDEV if the output would overwrite the ramdisk or FDT
+ */
+static int bootm_check_inplace(bootm_headers_t *images, const void *image_buf,
+			       ulong *unc_lenp, bool *in_placep)
+{
+	image_info_t *os = &images->os;
+	ulong image_end = os->image_start + os->image_len;
+	ulong unc_len, end, ft;
+	long margin;
+
+	*unc_lenp = CONFIG_SYS_BOOTM_LEN;
+	*in_placep = false;
+	if (os->image_start < os->load ||
+	    os->image_start >= os->load + CONFIG_SYS_BOOTM_LEN ||
+	    (os->comp == IH_COMP_NONE && os->image_start == os->load))
+		return 0;
+
+	/* Leave other algorithms to the overlap check afterwards */
+	if (bootm_inplace_margin(os->comp, 0) < 0 ||
+	    bootm_decomp_size(os->comp, image_buf, os->image_len, &unc_len))
+		return 0;
+
+	/* A gzip trailer only holds the size modulo 2^32 */
+	if (unc_len > CONFIG_SYS_BOOTM_LEN) {
+		printf("ERROR: image decompresses to %#lx bytes, more than CONFIG_SYS_BOOTM_LEN\n",
+		       unc_len);
+		return -E2BIG;
+	}
+
+	margin = bootm_inplace_margin(os->comp, unc_len);
+	end = os->load + unc_len;
+	if (image_end < end + margin) {
+		printf("ERROR: image data must end at %08lx or later to be decompressed in place\n",
+		       end + margin);
+		return -ENOSPC;
+	}
+
+	ft = images->ft_addr ? map_to_sysmem(images->ft_addr) : 0;
+	if ((images->rd_end > images->rd_start &&
+	     images->rd_start < end && images->rd_end > os->load) ||
+	    (images->ft_len && ft < end && ft + images->ft_len > os->load)) {
+		puts("ERROR: decompressing in place would overwrite the ramdisk or FDT\n");
+		return -EXDEV;
+	}
+
+	debug("   decompressing in place, margin %#lx\n", margin);
+	*unc_lenp = unc_len;
+	*in_placep = true;
+
+	return 0;
+}
+
+/**
+ * bootm_load_os() - decompress or move the OS image to its load address
+ *
+ * @images:		Images being booted
+ * @load_end:		Returns the end of the loaded OS image
+ * @boot_progress:	Unused
+ * @return 0 if OK, BOOTM_ERR_... if decompressing failed or the image was
+ * overwritten, or the error from bootm_check_inplace() (-E2BIG, -ENOSPC or
+ * -EXDEV) if the image cannot be decompressed in place, in which case
+ * nothing has been written
+ */
 static int bootm_load_os(bootm_headers_t *images, unsigned long *load_end,
 			 int boot_progress)
 {
@@ -434,15 +608,19 @@ static int bootm_load_os(bootm_headers_t *images, unsigned long *load_end,
 	ulong blob_end = os.end;
 	ulong image_start = os.image_start;
 	ulong image_len = os.image_len;
-	bool no_overlap;
+	bool no_overlap, in_place;
 	void *load_buf, *image_buf;
+	ulong unc_len;
 	int err;
 
 	load_buf = map_sysmem(load, 0);
 	image_buf = map_sysmem(os.image_start, image_len);
+	err = bootm_check_inplace(images, image_buf, &unc_len, &in_place);
+	if (err)
+		return err;
 	err = bootm_decomp_image(os.comp, load, os.image_start, os.type,
-				 load_buf, image_buf, image_len,
-				 CONFIG_SYS_BOOTM_LEN, load_end);
+				 load_buf, image_buf, image_len, unc_len,
+				 load_end);
 	if (err) {
 		bootstage_error(BOOTSTAGE_ID_DECOMP_IMAGE);
 		return err;
@@ -452,7 +630,8 @@ static int bootm_load_os(bootm_headers_t *images, unsigned long *load_end,
 	debug("   kernel loaded at 0x%08lx, end = 0x%08lx\n", load, *load_end);
 	bootstage_mark(BOOTSTAGE_ID_KERNEL_LOADED);
 
-	no_overlap = (os.comp == IH_COMP_NONE && load == image_start);
+	no_overlap = (os.comp == IH_COMP_NONE && load == image_start) ||
+		in_place;
 
 	if (!no_overlap && (load < blob_end) && (*load_end > blob_start)) {
 		debug("images.os.start = 0x%lX, images.os.end = 0x%lx\n",
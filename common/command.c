@@ -482,6 +482,13 @@ void fixup_cmdtable(cmd_tbl_t *cmdtp, int size)
 }
 #endif
 
+static uint cmd_seq;
+
+uint cmd_get_seq(void)
+{
+	return cmd_seq;
+}
+
 /**
  * Call a command function. This should be the only route in U-Boot to call
  * a command, so that we can track whether we are waiting for input or
@@ -536,6 +543,7 @@ enum command_ret_t cmd_process(int flag, int argc, char * const argv[],
 	if (!rc) {
 		if (ticks)
 			*ticks = get_timer(0);
+		cmd_seq++;
 		rc = cmd_call(cmdtp, flag, argc, argv);
 		if (ticks)
 			*ticks = get_timer(*ticks);
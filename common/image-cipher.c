@@ -0,0 +1,181 @@
+/*
+ * Decrypt FIT subimages as they are loaded
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+/*
+ * An encrypted image has a cipher node next to its hash nodes:
+ *
+ *	kernel {
+ *		data = <encrypted data>;
+ *		data-size-unciphered = <real size>;	(optional)
+ *		cipher {
+ *			algo = "aes128";
+ *			key-name-hint = "dev";
+ *			iv = [16 bytes];
+ *		};
+ *	};
+ *
+ * The key is not in the FIT but in the U-Boot device tree:
+ *
+ *	cipher {
+ *		key-aes128-dev {
+ *			key = [16 bytes];
+ *		};
+ *	};
+ *
+ * fit_image_load() decrypts the data once it has been verified, straight
+ * to the load address when the image has one.
+ */
+
+#include <common.h>
+#include <errno.h>
+#include <image.h>
+#include <libfdt.h>
+#include <uboot_aes.h>
+
+DECLARE_GLOBAL_DATA_PTR;
+
+static void fit_cipher_aes128_cbc(const uint8_t *key, const uint8_t *iv,
+				  const void *src, void *dst, size_t len)
+{
+	u8 key_exp[AES_EXPAND_KEY_LENGTH];
+	u8 chain[AES_KEY_LENGTH];
+
+	aes_expand_key((u8 *)key, key_exp);
+	memcpy(chain, iv, sizeof(chain));
+	aes_cbc_decrypt(key_exp, chain, (u8 *)src, dst, len / AES_KEY_LENGTH);
+}
+
+static void fit_cipher_aes128_ctr(const uint8_t *key, const uint8_t *iv,
+				  const void *src, void *dst, size_t len)
+{
+	u8 key_exp[AES_EXPAND_KEY_LENGTH];
+	u8 ctr[AES_KEY_LENGTH];
+
+	aes_expand_key((u8 *)key, key_exp);
+	memcpy(ctr, iv, sizeof(ctr));
+	aes_ctr_crypt(key_exp, ctr, (u8 *)src, dst, len);
+}
+
+static struct cipher_algo cipher_algos[] = {
+	{
+		.name = "aes128",
+		.key_len = AES_KEY_LENGTH,
+		.iv_len = AES_KEY_LENGTH,
+		.block_len = AES_KEY_LENGTH,
+		.decrypt = fit_cipher_aes128_cbc,
+	},
+	{
+		.name = "aes128-ctr",
+		.key_len = AES_KEY_LENGTH,
+		.iv_len = AES_KEY_LENGTH,
+		.block_len = 1,
+		.decrypt = fit_cipher_aes128_ctr,
+	},
+};
+
+struct cipher_algo *image_get_cipher_algo(const char *name)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(cipher_algos); i++) {
+		if (!strcmp(cipher_algos[i].name, name))
+			return &cipher_algos[i];
+	}
+
+	return NULL;
+}
+
+int fit_image_is_ciphered(const void *fit, int noffset)
+{
+	return fdt_subnode_offset(fit, noffset, FIT_CIPHER_NODENAME) >= 0;
+}
+
+/* Find the key for a cipher node in the U-Boot device tree */
+static const uint8_t *fit_cipher_get_key(const struct cipher_algo *algo,
+					 const char *keyname)
+{
+	const void *blob = gd_fdt_blob();
+	const uint8_t *key;
+	char path[100];
+	int node, len;
+
+	snprintf(path, sizeof(path), "/%s/key-%s-%s", FIT_CIPHER_NODENAME,
+		 algo->name, keyname);
+	node = blob ? fdt_path_offset(blob, path) : -FDT_ERR_NOTFOUND;
+	if (node < 0) {
+		printf("No key %s in the U-Boot device tree\n", path);
+		return NULL;
+	}
+	key = fdt_getprop(blob, node, "key", &len);
+	if (!key || len != algo->key_len) {
+		printf("Key %s should have a %d-byte key property\n", path,
+		       algo->key_len);
+		return NULL;
+	}
+
+	return key;
+}
+
+int fit_image_decrypt(const void *fit, int noffset, const void *src,
+		      size_t size, void *dst, ulong *lenp)
+{
+	const struct cipher_algo *algo;
+	const char *algo_name, *keyname;
+	const uint8_t *key, *iv;
+	const fdt32_t *val;
+	int cipher_noffset;
+	ulong len = size;
+	int iv_len;
+
+	cipher_noffset = fdt_subnode_offset(fit, noffset, FIT_CIPHER_NODENAME);
+	if (cipher_noffset < 0)
+		return -ENOENT;
+
+	algo_name = fdt_getprop(fit, cipher_noffset, FIT_ALGO_PROP, NULL);
+	keyname = fdt_getprop(fit, cipher_noffset, FIT_KEY_HINT_PROP, NULL);
+	iv = fdt_getprop(fit, cipher_noffset, FIT_IV_PROP, &iv_len);
+	if (!algo_name || !keyname || !iv) {
+		puts("Cipher node needs algo, key-name-hint and iv\n");
+		return -EINVAL;
+	}
+
+	algo = image_get_cipher_algo(algo_name);
+	if (!algo) {
+		printf("Unsupported cipher '%s'\n", algo_name);
+		return -EPROTONOSUPPORT;
+	}
+	if (iv_len != algo->iv_len || size % algo->block_len) {
+		printf("Bad IV or data size for cipher '%s'\n", algo_name);
+		return -EINVAL;
+	}
+
+	val = fdt_getprop(fit, noffset, FIT_DATA_SIZE_UNCIPHERED_PROP, NULL);
+	if (val) {
+		len = fdt32_to_cpu(*val);
+		if (len > size) {
+			puts("Unciphered size is larger than the data\n");
+			return -EINVAL;
+		}
+	}
+
+	key = fit_cipher_get_key(algo, keyname);
+	if (!key)
+		return -ENOENT;
+
+	printf("   Decrypting %s with key '%s' ... ", algo->name, keyname);
+
+	/* The modes work in place or downwards, but not upwards */
+	if (dst > src && dst < src + size) {
+		memmove(dst, src, size);
+		src = dst;
+	}
+	algo->decrypt(key, iv, src, dst, size);
+	puts("OK\n");
+
+	*lenp = len;
+
+	return 0;
+}
@@ -0,0 +1,428 @@
+/*
+ * Cache of verified FIT image digests, keyed by where the images are stored
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+/*
+ * Loading and checking the same FIT from the same storage more than once,
+ * e.g. from a boot script that falls back to another configuration, hashes
+ * the same kernel and ramdisk each time, although nothing has written to
+ * them in between. This cache remembers, for each image that passed its
+ * hash check, the digest of the bytes at that place in storage, so that the
+ * next check can skip hashing them. The digest is still compared with the
+ * hash node, which the configuration signature covers, so only the hashing
+ * is saved.
+ *
+ * A place in storage is a block device (with its hardware partition), a
+ * partition, the path of the file that was loaded ("" for a raw read), the
+ * offset of the image data in that file or partition, and its size. A
+ * loader (fs_read(), 'mmc read') calls fit_cache_load_start() and
+ * fit_cache_load_end() around a read, which tells fit_image_check_hash()
+ * where image data in the loaded buffer came from. As in image-fit-stream.c,
+ * that is only believed in the command after the loader (normally bootm),
+ * and not after fit_cache_invalidate() says the buffer is being overwritten.
+ *
+ * Each block device has a generation counter, which blk_dwrite() and
+ * blk_derase() bump through fit_cache_invalidate_dev() before anything
+ * reaches the device. So fs_write, 'mmc write', 'mmc erase', DFU, fastboot
+ * and UMS all leave the cached digests for that device stale. A digest is
+ * tagged with the generation at which its bytes were read, and is only used
+ * for bytes read at that same generation.
+ *
+ * The device is also keyed by the identity of the medium in it (for MMC the
+ * manufacturer, name and serial number from the CID), and (re)initialising
+ * an MMC card bumps its generation, since another host may have written to
+ * it while it was out of the slot. Other devices which say that they are
+ * removable, and USB devices, which can be swapped without U-Boot seeing
+ * it, are not cached at all.
+ *
+ * Nothing U-Boot does not see can be trusted to bump the generation: the
+ * OS, or another boot, writes without going through blk_dwrite(). So the
+ * cache is only kept in RAM and starts empty on every boot; it saves the
+ * hashing when the same FIT is loaded and checked more than once before a
+ * reset.
+ */
+
+#include <common.h>
+#include <blk.h>
+#include <command.h>
+#include <errno.h>
+#include <image.h>
+
+#define FIT_CACHE_MAX_DEVS	8
+#define FIT_CACHE_PATH_LEN	64
+#define FIT_CACHE_ALGO_LEN	16
+
+/**
+ * struct fit_cache_dev - a block device that images were read from
+ *
+ * @if_type:	Interface type of the device
+ * @devnum:	Device number within the interface type
+ * @hwpart:	Hardware partition, e.g. an eMMC boot partition
+ * @vendor:	Vendor of the medium, with its serial number for MMC
+ * @product:	Product name of the medium
+ * @revision:	Product revision of the medium
+ * @generation:	Number of times the device was written to (or the medium
+ *		initialised) while it had cached digests; 0 if this slot is
+ *		free
+ */
+struct fit_cache_dev {
+	u16 if_type;
+	u16 devnum;
+	u8 hwpart;
+	char vendor[BLK_VEN_SIZE + 1];
+	char product[BLK_PRD_SIZE + 1];
+	char revision[BLK_REV_SIZE + 1];
+	u32 generation;
+};
+
+/**
+ * struct fit_cache_entry - the digest of some image data in storage
+ *
+ * @dev:	Device, with the generation at which the data was read
+ * @part:	Partition number, 0 for the whole device
+ * @size:	Size of the image data in bytes
+ * @offset:	Offset of the image data in the file or partition
+ * @stamp:	When the entry was last used, 0 if it is free
+ * @path:	File the data was read from, "" for a raw read
+ * @algo:	Hash algorithm
+ * @digest_len:	Size of @digest in bytes
+ * @digest:	Digest of the data
+ */
+struct fit_cache_entry {
+	struct fit_cache_dev dev;
+	u32 part;
+	u32 size;
+	u64 offset;
+	u32 stamp;
+	char path[FIT_CACHE_PATH_LEN];
+	char algo[FIT_CACHE_ALGO_LEN];
+	u32 digest_len;
+	u8 digest[FIT_MAX_HASH_LEN];
+};
+
+/* The cache itself */
+struct fit_cache_store {
+	u32 stamp;		/* Last stamp handed out */
+	struct fit_cache_dev devs[FIT_CACHE_MAX_DEVS];
+	struct fit_cache_entry entries[CONFIG_FIT_VERIFY_CACHE_ENTRIES];
+};
+
+/* Where the data in a buffer was loaded from */
+struct fit_cache_origin {
+	const uint8_t *buf;	/* NULL if not known */
+	ulong size;		/* Bytes loaded, 0 while loading */
+	bool loading;
+	uint seq;		/* Command in which loading ended */
+	struct fit_cache_dev dev;
+	u32 part;
+	u64 offset;		/* Offset in the file or partition of @buf */
+	char path[FIT_CACHE_PATH_LEN];
+};
+
+static struct {
+	struct fit_cache_store store;
+	struct fit_cache_origin origin;
+} fit_cache;
+
+static bool fit_cache_same_dev(const struct fit_cache_dev *a,
+			       const struct fit_cache_dev *b)
+{
+	return a->if_type == b->if_type && a->devnum == b->devnum &&
+	       a->hwpart == b->hwpart && !strcmp(a->vendor, b->vendor) &&
+	       !strcmp(a->product, b->product) &&
+	       !strcmp(a->revision, b->revision);
+}
+
+static void fit_cache_set_dev(struct fit_cache_dev *dev,
+			      struct blk_desc *desc)
+{
+	memset(dev, '\0', sizeof(*dev));
+	dev->if_type = desc->if_type;
+	dev->devnum = desc->devnum;
+	dev->hwpart = desc->hwpart;
+	strlcpy(dev->vendor, desc->vendor, sizeof(dev->vendor));
+	strlcpy(dev->product, desc->product, sizeof(dev->product));
+	strlcpy(dev->revision, desc->revision, sizeof(dev->revision));
+}
+
+/*
+ * Check whether the medium in a device can change without us seeing it.
+ * MMC marks every card removable, but a new card cannot be read until it
+ * is initialised, which bumps the generation.
+ */
+static bool fit_cache_removable(struct blk_desc *desc)
+{
+	if (desc->if_type == IF_TYPE_MMC)
+		return false;
+
+	return desc->removable || desc->if_type == IF_TYPE_USB;
+}
+
+/* Check whether any entry was read at the device's current generation */
+static bool fit_cache_dev_in_use(struct fit_cache_store *store,
+				 const struct fit_cache_dev *dev)
+{
+	struct fit_cache_entry *entry;
+	int i;
+
+	for (i = 0, entry = store->entries; i < ARRAY_SIZE(store->entries);
+	     i++, entry++) {
+		if (entry->stamp && fit_cache_same_dev(&entry->dev, dev) &&
+		    entry->dev.generation == dev->generation)
+			return true;
+	}
+
+	return false;
+}
+
+/* Forget a device and its entries */
+static void fit_cache_drop_dev(struct fit_cache_store *store,
+			       struct fit_cache_dev *dev)
+{
+	struct fit_cache_entry *entry;
+	int i;
+
+	for (i = 0, entry = store->entries; i < ARRAY_SIZE(store->entries);
+	     i++, entry++) {
+		if (fit_cache_same_dev(&entry->dev, dev))
+			entry->stamp = 0;
+	}
+	dev->generation = 0;
+}
+
+/*
+ * Find the slot for a device, adding it if @create. A full table gives up
+ * a device with no current entries, or else the first one. Either way its
+ * old entries go too, so that they cannot match once it comes back with
+ * its generation starting again.
+ */
+static struct fit_cache_dev *fit_cache_find_dev(struct fit_cache_store *store,
+						struct blk_desc *desc,
+						bool create)
+{
+	struct fit_cache_dev key, *dev, *slot = NULL;
+	int i;
+
+	fit_cache_set_dev(&key, desc);
+	for (i = 0, dev = store->devs; i < FIT_CACHE_MAX_DEVS; i++, dev++) {
+		if (!dev->generation) {
+			if (!slot)
+				slot = dev;
+		} else if (fit_cache_same_dev(dev, &key)) {
+			return dev;
+		}
+	}
+	if (!create)
+		return NULL;
+
+	for (i = 0, dev = store->devs; !slot && i < FIT_CACHE_MAX_DEVS;
+	     i++, dev++) {
+		if (!fit_cache_dev_in_use(store, dev)) {
+			slot = dev;
+			fit_cache_drop_dev(store, slot);
+		}
+	}
+	if (!slot) {
+		slot = store->devs;
+		fit_cache_drop_dev(store, slot);
+	}
+	key.generation = 1;
+	*slot = key;
+
+	return slot;
+}
+
+void fit_cache_invalidate_dev(struct blk_desc *desc)
+{
+	struct fit_cache_store *store = &fit_cache.store;
+	struct fit_cache_dev *dev;
+
+	dev = fit_cache_find_dev(store, desc, false);
+	if (!dev)
+		return;
+
+	if (!++dev->generation)
+		fit_cache_drop_dev(store, dev);
+}
+
+void fit_cache_load_start(const void *buf, struct blk_desc *desc, int part,
+			  const char *path, loff_t offset)
+{
+	struct fit_cache_origin *origin = &fit_cache.origin;
+	struct fit_cache_dev *dev;
+
+	origin->buf = NULL;
+	if (!path)
+		path = "";
+	if (!desc || fit_cache_removable(desc) || part < 0 ||
+	    strlen(path) >= sizeof(origin->path))
+		return;
+
+	/* Writes must bump the generation from now on */
+	dev = fit_cache_find_dev(&fit_cache.store, desc, true);
+
+	origin->buf = buf;
+	origin->size = 0;
+	origin->loading = true;
+	origin->seq = cmd_get_seq();
+	origin->dev = *dev;
+	origin->part = part;
+	origin->offset = offset;
+	strcpy(origin->path, path);
+}
+
+void fit_cache_load_end(ulong size)
+{
+	struct fit_cache_origin *origin = &fit_cache.origin;
+
+	if (!origin->buf || !origin->loading)
+		return;
+
+	origin->loading = false;
+	if (!size) {
+		origin->buf = NULL;
+		return;
+	}
+	origin->size = size;
+	origin->seq = cmd_get_seq();
+}
+
+void fit_cache_invalidate(const void *start, ulong len)
+{
+	struct fit_cache_origin *origin = &fit_cache.origin;
+	const uint8_t *end = (const uint8_t *)start + len;
+
+	if (origin->buf && end > origin->buf &&
+	    (const uint8_t *)start < origin->buf + origin->size)
+		origin->buf = NULL;
+}
+
+/*
+ * Work out where image data came from; while loading, only the FIT stream
+ * code asks, before the data has landed
+ */
+static int fit_cache_locate(const void *data, size_t size, u64 *offsetp)
+{
+	struct fit_cache_origin *origin = &fit_cache.origin;
+	const uint8_t *p = data;
+
+	if (!origin->buf || p < origin->buf || size > U32_MAX)
+		return -ENOENT;
+	if (origin->loading) {
+		if (origin->seq != cmd_get_seq())
+			return -ENOENT;
+	} else if (cmd_get_seq() - origin->seq > 1 || size > origin->size ||
+		   p - origin->buf > origin->size - size) {
+		return -ENOENT;
+	}
+	*offsetp = origin->offset + (p - origin->buf);
+
+	return 0;
+}
+
+static struct fit_cache_entry *fit_cache_find(struct fit_cache_store *store,
+					      u64 offset, size_t size,
+					      const char *algo)
+{
+	struct fit_cache_origin *origin = &fit_cache.origin;
+	struct fit_cache_entry *entry;
+	int i;
+
+	for (i = 0, entry = store->entries; i < ARRAY_SIZE(store->entries);
+	     i++, entry++) {
+		if (entry->stamp && entry->offset == offset &&
+		    entry->size == size &&
+		    fit_cache_same_dev(&entry->dev, &origin->dev) &&
+		    entry->dev.generation == origin->dev.generation &&
+		    entry->part == origin->part &&
+		    !strcmp(entry->path, origin->path) &&
+		    !strcmp(entry->algo, algo))
+			return entry;
+	}
+
+	return NULL;
+}
+
+int fit_cache_get_hash(const void *data, size_t size, const char *algo,
+		       uint8_t *value, int *value_len)
+{
+	struct fit_cache_store *store;
+	struct fit_cache_entry *entry;
+	u64 offset;
+
+	if (fit_cache_locate(data, size, &offset))
+		return -ENOENT;
+	store = &fit_cache.store;
+	entry = fit_cache_find(store, offset, size, algo);
+	if (!entry)
+		return -ENOENT;
+	if (!value)
+		return 0;
+
+	entry->stamp = ++store->stamp;
+	memcpy(value, entry->digest, entry->digest_len);
+	*value_len = entry->digest_len;
+
+	return 0;
+}
+
+void fit_cache_add(const void *data, size_t size, const char *algo,
+		   const uint8_t *value, int value_len)
+{
+	struct fit_cache_origin *origin = &fit_cache.origin;
+	struct fit_cache_entry *entry, *oldest;
+	struct fit_cache_store *store;
+	struct fit_cache_dev *dev;
+	u64 offset;
+	int i;
+
+	if (origin->loading || fit_cache_locate(data, size, &offset) ||
+	    strlen(algo) >= FIT_CACHE_ALGO_LEN || value_len > FIT_MAX_HASH_LEN)
+		return;
+
+	/* Storage written since the load no longer holds these bytes */
+	store = &fit_cache.store;
+	for (i = 0, dev = store->devs; i < FIT_CACHE_MAX_DEVS; i++, dev++) {
+		if (dev->generation && fit_cache_same_dev(dev, &origin->dev))
+			break;
+	}
+	if (i == FIT_CACHE_MAX_DEVS ||
+	    dev->generation != origin->dev.generation)
+		return;
+
+	entry = fit_cache_find(store, offset, size, algo);
+	if (entry && entry->digest_len == value_len &&
+	    !memcmp(entry->digest, value, value_len))
+		return;
+	if (!entry) {
+		oldest = store->entries;
+		for (i = 0, entry = store->entries;
+		     i < ARRAY_SIZE(store->entries); i++, entry++) {
+			if (entry->stamp < oldest->stamp)
+				oldest = entry;
+		}
+		entry = oldest;
+	}
+
+	memset(entry, '\0', sizeof(*entry));
+	entry->dev = origin->dev;
+	entry->part = origin->part;
+	entry->size = size;
+	entry->offset = offset;
+	strcpy(entry->path, origin->path);
+	strcpy(entry->algo, algo);
+	entry->digest_len = value_len;
+	memcpy(entry->digest, value, value_len);
+	entry->stamp = ++store->stamp;
+}
+
+void fit_cache_clear(void)
+{
+	struct fit_cache_store *store = &fit_cache.store;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(store->entries); i++)
+		store->entries[i].stamp = 0;
+}
@@ -0,0 +1,165 @@
+/*
+ * Hash the images of a FIT side by side
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+/*
+ * fit_image_verify() checks one image at a time, so verifying a
+ * configuration with a kernel, an FDT, a ramdisk and some loadables costs
+ * the sum of their hashing times. Once bootm has picked the configuration
+ * (or iminfo is about to check the whole FIT), fit_mb_hash_images() instead
+ * collects every image with a sha256 hash node and hashes them all at once
+ * with sha256_mb_hash(), which spreads them over SIMD lanes and CPUs.
+ * fit_image_check_hash() then picks the digests up with fit_mb_get_hash().
+ *
+ * Like the digests taken while loading (image-fit-stream.c), these are only
+ * used within the same command and only once each. Images that bootm moves
+ * another image over are dropped by fit_mb_invalidate().
+ */
+
+#include <common.h>
+#include <bootstage.h>
+#include <command.h>
+#include <errno.h>
+#include <image.h>
+#include <libfdt.h>
+#include <u-boot/sha256.h>
+
+#define FIT_MB_MAX_IMAGES	16
+
+/* Smaller images are quicker to hash than to hand around */
+#define FIT_MB_MIN_SIZE		4096
+
+static struct {
+	struct sha256_mb_job jobs[FIT_MB_MAX_IMAGES];
+	int count;
+	uint seq;		/* Command in which the images were hashed */
+} fit_mb;
+
+static void fit_mb_add(const void *fit, int image_noffset)
+{
+	struct sha256_mb_job *job;
+	const void *data;
+	size_t size;
+	char *algo;
+	int noffset, i;
+
+	if (fit_mb.count == FIT_MB_MAX_IMAGES ||
+	    fit_image_get_data(fit, image_noffset, &data, &size) ||
+	    size < FIT_MB_MIN_SIZE)
+		return;
+
+	/* Nothing to do if it was hashed while loaded, offloaded or before */
+	if (!fit_stream_get_hash(data, size, "sha256", NULL, NULL) ||
+	    !fit_offload_get_hash(data, size, "sha256", NULL, NULL) ||
+	    !fit_cache_get_hash(data, size, "sha256", NULL, NULL))
+		return;
+
+	/* A configuration may name an image more than once */
+	for (i = 0; i < fit_mb.count; i++) {
+		if (fit_mb.jobs[i].data == data)
+			return;
+	}
+
+	fdt_for_each_subnode(noffset, fit, image_noffset) {
+		if (strncmp(fit_get_name(fit, noffset, NULL),
+			    FIT_HASH_NODENAME, strlen(FIT_HASH_NODENAME)) ||
+		    fit_image_hash_get_algo(fit, noffset, &algo) ||
+		    strcmp(algo, "sha256"))
+			continue;
+
+		job = &fit_mb.jobs[fit_mb.count++];
+		job->data = data;
+		job->len = size;
+		return;
+	}
+}
+
+/* Add each image named by a property of the configuration */
+static void fit_mb_add_config(const void *fit, int images_noffset,
+			      int cfg_noffset)
+{
+	const char *list, *name;
+	int prop, len, noffset;
+
+	fdt_for_each_property_offset(prop, fit, cfg_noffset) {
+		list = fdt_getprop_by_offset(fit, prop, NULL, &len);
+		if (!list)
+			continue;
+		for (name = list; name < list + len;
+		     name += strnlen(name, list + len - name) + 1) {
+			noffset = fdt_subnode_offset_namelen(fit,
+					images_noffset, name,
+					strnlen(name, list + len - name));
+			if (noffset >= 0)
+				fit_mb_add(fit, noffset);
+		}
+	}
+}
+
+void fit_mb_hash_images(const void *fit, int cfg_noffset)
+{
+	int images_noffset, noffset;
+
+	fit_mb.count = 0;
+	fit_mb.seq = cmd_get_seq();
+
+	images_noffset = fdt_path_offset(fit, FIT_IMAGES_PATH);
+	if (images_noffset < 0)
+		return;
+
+	if (cfg_noffset < 0) {
+		fdt_for_each_subnode(noffset, fit, images_noffset)
+			fit_mb_add(fit, noffset);
+	} else {
+		fit_mb_add_config(fit, images_noffset, cfg_noffset);
+	}
+
+	/* One image is hashed just as quickly by fit_image_check_hash() */
+	if (fit_mb.count < 2) {
+		fit_mb.count = 0;
+		return;
+	}
+
+	debug("%s: hashing %d images\n", __func__, fit_mb.count);
+	bootstage_start(BOOTSTAGE_ID_ACCUM_HASH, "hash");
+	sha256_mb_hash(fit_mb.jobs, fit_mb.count);
+	bootstage_accum(BOOTSTAGE_ID_ACCUM_HASH);
+}
+
+int fit_mb_get_hash(const void *data, size_t size, const char *algo,
+		    uint8_t *value, int *value_len)
+{
+	struct sha256_mb_job *job;
+	int i;
+
+	if (fit_mb.seq != cmd_get_seq() || strcmp(algo, "sha256"))
+		return -ENOENT;
+
+	for (i = 0, job = fit_mb.jobs; i < fit_mb.count; i++, job++) {
+		if (job->data != data || job->len != size)
+			continue;
+
+		memcpy(value, job->digest, SHA256_SUM_LEN);
+		*value_len = SHA256_SUM_LEN;
+		/* Each digest vouches for one check only */
+		job->data = NULL;
+		return 0;
+	}
+
+	return -ENOENT;
+}
+
+void fit_mb_invalidate(const void *start, ulong len)
+{
+	const uint8_t *end = (const uint8_t *)start + len;
+	struct sha256_mb_job *job;
+	int i;
+
+	for (i = 0, job = fit_mb.jobs; i < fit_mb.count; i++, job++) {
+		if (job->data && job->data < end &&
+		    job->data + job->len > (const uint8_t *)start)
+			job->data = NULL;
+	}
+}
@@ -0,0 +1,200 @@
+/*
+ * Hash the images of a FIT on a crypto engine
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+/*
+ * Once bootm has picked a configuration (or iminfo is about to check the
+ * whole FIT), fit_offload_hash_images() submits a crypto job for each hash
+ * node of each image that a crypto engine will take. The engine works
+ * through them in the background while bootm goes on to check and load
+ * the images one by one; fit_image_check_hash() only waits for the image
+ * it is checking, through fit_offload_get_hash(). So the ramdisk and FDT
+ * are hashed while the kernel is being copied or decompressed.
+ *
+ * Like the digests in image-fit-stream.c and image-fit-mb.c, these are only
+ * used within the same command and only once each. Before bootm writes over
+ * memory that a job is still reading, fit_offload_invalidate() waits for
+ * the job and drops its result.
+ */
+
+#include <common.h>
+#include <command.h>
+#include <crypto.h>
+#include <errno.h>
+#include <image.h>
+#include <libfdt.h>
+
+#define FIT_OFFLOAD_MAX_JOBS	16
+
+/* Smaller images are quicker to hash than to hand to the engine */
+#define FIT_OFFLOAD_MIN_SIZE	4096
+
+struct fit_offload_job {
+	struct crypto_job job;
+	char algo[16];
+	uint8_t digest[FIT_MAX_HASH_LEN];
+	bool valid;		/* Digest not yet used or invalidated */
+};
+
+static struct {
+	struct fit_offload_job jobs[FIT_OFFLOAD_MAX_JOBS];
+	int count;
+	uint seq;		/* Command in which the jobs were submitted */
+} fit_offload;
+
+static struct fit_offload_job *fit_offload_find(const void *data, size_t size,
+						const char *algo)
+{
+	struct fit_offload_job *oj;
+	int i;
+
+	if (fit_offload.seq != cmd_get_seq())
+		return NULL;
+
+	for (i = 0, oj = fit_offload.jobs; i < fit_offload.count; i++, oj++) {
+		if (oj->valid && oj->job.in == data && oj->job.in_len == size &&
+		    !strcmp(oj->algo, algo))
+			return oj;
+	}
+
+	return NULL;
+}
+
+static void fit_offload_add(const void *fit, int image_noffset)
+{
+	struct fit_offload_job *oj;
+	const void *data;
+	size_t size;
+	char *algo;
+	int noffset;
+
+	if (fit_image_get_data(fit, image_noffset, &data, &size) ||
+	    size < FIT_OFFLOAD_MIN_SIZE)
+		return;
+
+	fdt_for_each_subnode(noffset, fit, image_noffset) {
+		if (fit_offload.count == FIT_OFFLOAD_MAX_JOBS)
+			return;
+		if (strncmp(fit_get_name(fit, noffset, NULL),
+			    FIT_HASH_NODENAME, strlen(FIT_HASH_NODENAME)) ||
+		    fit_image_hash_get_algo(fit, noffset, &algo) ||
+		    strlen(algo) >= sizeof(oj->algo))
+			continue;
+
+		/* Hashed while it was loaded or before, or named twice */
+		if (!fit_stream_get_hash(data, size, algo, NULL, NULL) ||
+		    !fit_cache_get_hash(data, size, algo, NULL, NULL) ||
+		    fit_offload_find(data, size, algo))
+			continue;
+
+		oj = &fit_offload.jobs[fit_offload.count];
+		strcpy(oj->algo, algo);
+		oj->job.type = CRYPTO_JOB_HASH;
+		oj->job.algo = oj->algo;
+		oj->job.in = data;
+		oj->job.in_len = size;
+		oj->job.out = oj->digest;
+		oj->job.out_len = sizeof(oj->digest);
+		if (crypto_submit(&oj->job))
+			continue;
+		oj->valid = true;
+		fit_offload.count++;
+	}
+}
+
+/* Add each image named by a property of the configuration */
+static void fit_offload_add_config(const void *fit, int images_noffset,
+				   int cfg_noffset)
+{
+	const char *list, *name;
+	int prop, len, noffset;
+
+	fdt_for_each_property_offset(prop, fit, cfg_noffset) {
+		list = fdt_getprop_by_offset(fit, prop, NULL, &len);
+		if (!list)
+			continue;
+		for (name = list; name < list + len;
+		     name += strnlen(name, list + len - name) + 1) {
+			noffset = fdt_subnode_offset_namelen(fit,
+					images_noffset, name,
+					strnlen(name, list + len - name));
+			if (noffset >= 0)
+				fit_offload_add(fit, noffset);
+		}
+	}
+}
+
+/* Wait for all jobs, which may be reading memory about to be reused */
+static void fit_offload_drain(void)
+{
+	int i;
+
+	for (i = 0; i < fit_offload.count; i++) {
+		crypto_wait(&fit_offload.jobs[i].job);
+		fit_offload.jobs[i].valid = false;
+	}
+	fit_offload.count = 0;
+}
+
+void fit_offload_hash_images(const void *fit, int cfg_noffset)
+{
+	int images_noffset, noffset;
+
+	fit_offload_drain();
+	fit_offload.seq = cmd_get_seq();
+
+	images_noffset = fdt_path_offset(fit, FIT_IMAGES_PATH);
+	if (images_noffset < 0)
+		return;
+
+	if (cfg_noffset < 0) {
+		fdt_for_each_subnode(noffset, fit, images_noffset)
+			fit_offload_add(fit, noffset);
+	} else {
+		fit_offload_add_config(fit, images_noffset, cfg_noffset);
+	}
+	debug("%s: submitted %d jobs\n", __func__, fit_offload.count);
+}
+
+int fit_offload_get_hash(const void *data, size_t size, const char *algo,
+			 uint8_t *value, int *value_len)
+{
+	struct fit_offload_job *oj;
+	int ret;
+
+	oj = fit_offload_find(data, size, algo);
+	if (!oj)
+		return -ENOENT;
+	if (!value)
+		return 0;
+
+	/* Each digest vouches for one check only */
+	oj->valid = false;
+	ret = crypto_wait(&oj->job);
+	if (ret) {
+		debug("%s: job failed: %d\n", __func__, ret);
+		return -ENOENT;
+	}
+	memcpy(value, oj->digest, oj->job.out_len);
+	*value_len = oj->job.out_len;
+
+	return 0;
+}
+
+void fit_offload_invalidate(const void *start, ulong len)
+{
+	const uint8_t *end = (const uint8_t *)start + len;
+	struct fit_offload_job *oj;
+	int i;
+
+	for (i = 0, oj = fit_offload.jobs; i < fit_offload.count; i++, oj++) {
+		if ((const uint8_t *)oj->job.in < end &&
+		    (const uint8_t *)oj->job.in + oj->job.in_len >
+		    (const uint8_t *)start) {
+			crypto_wait(&oj->job);
+			oj->valid = false;
+		}
+	}
+}
@@ -0,0 +1,339 @@
+/*
+ * Hash FIT subimages while the FIT is being read into memory
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+/*
+ * A loader (fs_read(), tftp, 'mmc read') calls fit_stream_start() with its
+ * destination and fit_stream_end() when it is done. In between, the layers
+ * underneath report each chunk that has landed in memory with
+ * fit_stream_update(). The FDT structure block is walked as it arrives and
+ * every large property of an image node (that is, the 'data' of each
+ * subimage) is hashed piece by piece, so the bytes are hashed while they are
+ * still warm in the cache and, for tftp, while the next packet is on the
+ * wire.
+ *
+ * fit_image_check_hash() then asks fit_stream_get_hash() for the digest
+ * instead of hashing the data a second time. The digests are only handed
+ * out in the command after the loader (normally bootm) and only once each,
+ * so anything that changes memory in between (mw, another load) simply
+ * makes verification fall back to hashing the data again.
+ *
+ * Chunks which do not follow on from what has already landed, e.g. when a
+ * filesystem copies the tail of a file out of a bounce buffer, are not
+ * hashed as they arrive; fit_stream_end() catches up on them instead. A
+ * chunk which rewrites anything that has already landed may change bytes
+ * that are hashed already, so the stream is dropped and verification hashes
+ * the whole image again. Writes which do not go through a loader, such as
+ * fit_image_load() moving a subimage to its load address, are reported with
+ * fit_stream_invalidate(), which drops the hashes of the data they cover.
+ */
+
+#include <common.h>
+#include <bootstage.h>
+#include <command.h>
+#include <errno.h>
+#include <hash.h>
+#include <image.h>
+#include <libfdt.h>
+
+/* Only properties this large are worth hashing as they land */
+#define FIT_STREAM_MIN_SIZE	4096
+#define FIT_STREAM_MAX_HASHES	16
+
+/* Depth of the properties of /images/<image> */
+#define FIT_STREAM_IMAGE_DEPTH	3
+
+struct fit_stream_hash {
+	ulong offset;		/* Offset of the property value in the FIT */
+	ulong size;		/* Size of the property value */
+	uint8_t value[HASH_MAX_DIGEST_SIZE];
+};
+
+struct fit_stream {
+	struct hash_algo *algo;
+	const uint8_t *buf;	/* Start of the FIT, NULL if not loading one */
+	ulong landed;		/* Bytes from @buf which are in memory */
+	ulong pos;		/* Next FDT token, 0 until the header landed */
+	ulong end;		/* End of the FDT structure block */
+	int depth;		/* Node depth at @pos */
+	bool parsed;		/* Reached FDT_END */
+	bool complete;		/* Loading ended, @hashes can be used */
+	uint seq;		/* Command in which loading ended */
+
+	/* Property value being hashed, if @ctx is not NULL */
+	void *ctx;
+	ulong prop_done;
+	ulong prop_end;
+
+	struct fit_stream_hash hashes[FIT_STREAM_MAX_HASHES];
+	int count;
+};
+
+static struct fit_stream fit_stream;
+
+static void fit_stream_abort(struct fit_stream *s)
+{
+	uint8_t value[HASH_MAX_DIGEST_SIZE];
+
+	/* hash_finish() is the only way to free a hash context */
+	if (s->ctx)
+		s->algo->hash_finish(s->algo, s->ctx, value, sizeof(value));
+	s->ctx = NULL;
+	s->buf = NULL;
+	s->count = 0;
+	s->complete = false;
+}
+
+static int fit_stream_finish_prop(struct fit_stream *s)
+{
+	struct fit_stream_hash *hash = &s->hashes[s->count];
+	void *ctx = s->ctx;
+
+	s->ctx = NULL;
+	if (s->algo->hash_finish(s->algo, ctx, hash->value,
+				 sizeof(hash->value)))
+		return -EINVAL;
+
+	/* Match calculate_hash(), which stores crc32 big-endian */
+	if (!strcmp(s->algo->name, "crc32"))
+		*(uint32_t *)hash->value =
+			cpu_to_uimage(*(uint32_t *)hash->value);
+	s->count++;
+
+	return 0;
+}
+
+/*
+ * Look at the next FDT token, if it has landed
+ *
+ * @return 1 if a token was consumed, 0 if more data is needed, -ve on
+ * anything that does not look like a FIT we can follow
+ */
+static int fit_stream_next_token(struct fit_stream *s)
+{
+	const struct fdt_header *hdr;
+	const fdt32_t *p;
+	const char *name, *nul;
+	ulong len;
+
+	if (!s->pos) {
+		if (s->landed < sizeof(*hdr))
+			return 0;
+		hdr = (const struct fdt_header *)s->buf;
+		if (fdt_magic(hdr) != FDT_MAGIC || fdt_version(hdr) < 17 ||
+		    fdt_off_dt_struct(hdr) < sizeof(*hdr) ||
+		    fdt_off_dt_struct(hdr) + fdt_size_dt_struct(hdr) >
+		    fdt_totalsize(hdr))
+			return -EINVAL;
+		s->pos = fdt_off_dt_struct(hdr);
+		s->end = s->pos + fdt_size_dt_struct(hdr);
+		return 1;
+	}
+
+	if (s->pos + FDT_TAGSIZE > s->end)
+		return -EINVAL;
+	if (s->pos + FDT_TAGSIZE > s->landed)
+		return 0;
+	p = (const fdt32_t *)(s->buf + s->pos);
+
+	switch (fdt32_to_cpu(p[0])) {
+	case FDT_BEGIN_NODE:
+		name = (const char *)(p + 1);
+		nul = memchr(name, '\0', s->buf + s->landed - (uint8_t *)name);
+		if (!nul)
+			return s->landed < s->end ? 0 : -EINVAL;
+		s->pos = ALIGN((uint8_t *)nul + 1 - s->buf, FDT_TAGSIZE);
+		s->depth++;
+		break;
+	case FDT_END_NODE:
+		if (!s->depth--)
+			return -EINVAL;
+		s->pos += FDT_TAGSIZE;
+		break;
+	case FDT_PROP:
+		if (s->pos + sizeof(struct fdt_property) > s->end)
+			return -EINVAL;
+		if (s->pos + sizeof(struct fdt_property) > s->landed)
+			return 0;
+		len = fdt32_to_cpu(p[1]);
+		s->pos += sizeof(struct fdt_property);
+		if (len > s->end - s->pos)
+			return -EINVAL;
+		/* Data whose digest is in the cache need not be hashed */
+		if (s->depth == FIT_STREAM_IMAGE_DEPTH &&
+		    len >= FIT_STREAM_MIN_SIZE &&
+		    s->count < FIT_STREAM_MAX_HASHES &&
+		    fit_cache_get_hash(s->buf + s->pos, len, s->algo->name,
+				       NULL, NULL)) {
+			if (s->algo->hash_init(s->algo, &s->ctx))
+				return -ENOMEM;
+			s->hashes[s->count].offset = s->pos;
+			s->hashes[s->count].size = len;
+			s->prop_done = s->pos;
+			s->prop_end = s->pos + len;
+		}
+		s->pos = ALIGN(s->pos + len, FDT_TAGSIZE);
+		break;
+	case FDT_NOP:
+		s->pos += FDT_TAGSIZE;
+		break;
+	case FDT_END:
+		if (s->depth)
+			return -EINVAL;
+		s->parsed = true;
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	return 1;
+}
+
+/* Hash and parse as far as the landed data allows */
+static void fit_stream_process(struct fit_stream *s)
+{
+	ulong upto;
+	int ret;
+
+	while (s->buf && !s->parsed) {
+		if (s->ctx) {
+			upto = min(s->landed, s->prop_end);
+			if (upto > s->prop_done) {
+				ret = s->algo->hash_update(s->algo, s->ctx,
+						s->buf + s->prop_done,
+						upto - s->prop_done,
+						upto == s->prop_end);
+				if (ret) {
+					/* hash_update() freed the context */
+					s->ctx = NULL;
+					break;
+				}
+				s->prop_done = upto;
+			}
+			if (upto < s->prop_end)
+				return;
+			ret = fit_stream_finish_prop(s);
+		} else {
+			ret = fit_stream_next_token(s);
+			if (!ret)
+				return;
+		}
+		if (ret < 0)
+			break;
+	}
+
+	if (!s->parsed) {
+		debug("%s: not following this FIT\n", __func__);
+		fit_stream_abort(s);
+	}
+}
+
+void fit_stream_start(const void *buf)
+{
+	struct fit_stream *s = &fit_stream;
+
+	fit_stream_abort(s);
+	memset(s, '\0', sizeof(*s));
+	if (hash_progressive_lookup_algo(CONFIG_FIT_STREAM_VERIFY_ALGO,
+					 &s->algo))
+		return;
+	s->buf = buf;
+}
+
+void fit_stream_update(const void *data, ulong len)
+{
+	struct fit_stream *s = &fit_stream;
+	const uint8_t *p = data;
+
+	if (!s->buf)
+		return;
+	if (p < s->buf + s->landed && p + len > s->buf) {
+		debug("%s: %p rewrites landed data\n", __func__, data);
+		fit_stream_abort(s);
+		return;
+	}
+	if (s->complete || p != s->buf + s->landed)
+		return;
+
+	bootstage_start(BOOTSTAGE_ID_ACCUM_LOAD_HASH, "load_hash");
+	s->landed += len;
+	fit_stream_process(s);
+	bootstage_accum(BOOTSTAGE_ID_ACCUM_LOAD_HASH);
+}
+
+void fit_stream_end(ulong size)
+{
+	struct fit_stream *s = &fit_stream;
+
+	if (!s->buf || s->complete)
+		return;
+
+	if (size) {
+		bootstage_start(BOOTSTAGE_ID_ACCUM_LOAD_HASH, "load_hash");
+		s->landed = max(s->landed, size);
+		fit_stream_process(s);
+		bootstage_accum(BOOTSTAGE_ID_ACCUM_LOAD_HASH);
+	}
+	if (!size || !s->parsed || s->ctx) {
+		fit_stream_abort(s);
+		return;
+	}
+
+	debug("%s: %d %s hashes taken while loading\n", __func__, s->count,
+	      s->algo->name);
+	s->complete = true;
+	s->seq = cmd_get_seq();
+}
+
+int fit_stream_get_hash(const void *data, size_t size, const char *algo,
+			uint8_t *value, int *value_len)
+{
+	struct fit_stream *s = &fit_stream;
+	struct fit_stream_hash *hash;
+	ulong offset;
+	int i;
+
+	if (!s->complete || cmd_get_seq() - s->seq > 1 ||
+	    strcmp(algo, s->algo->name))
+		return -ENOENT;
+
+	offset = (const uint8_t *)data - s->buf;
+	for (i = 0, hash = s->hashes; i < s->count; i++, hash++) {
+		if (hash->offset != offset || hash->size != size)
+			continue;
+
+		if (!value)
+			return 0;
+		memcpy(value, hash->value, s->algo->digest_size);
+		*value_len = s->algo->digest_size;
+		/* Each digest vouches for one check only */
+		hash->size = 0;
+		return 0;
+	}
+
+	return -ENOENT;
+}
+
+void fit_stream_invalidate(const void *start, ulong len)
+{
+	struct fit_stream *s = &fit_stream;
+	const uint8_t *end = (const uint8_t *)start + len;
+	struct fit_stream_hash *hash;
+	int i;
+
+	if (!s->buf)
+		return;
+	if (!s->complete) {
+		if ((const uint8_t *)start < s->buf + s->landed && end > s->buf)
+			fit_stream_abort(s);
+		return;
+	}
+
+	for (i = 0, hash = s->hashes; i < s->count; i++, hash++) {
+		if (hash->size && s->buf + hash->offset < end &&
+		    s->buf + hash->offset + hash->size > (const uint8_t *)start)
+			hash->size = 0;
+	}
+}
@@ -16,6 +16,7 @@
 #include <linux/compiler.h>
 #include <linux/kconfig.h>
 #include <common.h>
+#include <crypto.h>
 #include <errno.h>
 #include <mapmem.h>
 #include <asm/io.h>
@@ -29,6 +30,7 @@ DECLARE_GLOBAL_DATA_PTR;
 #include <u-boot/md5.h>
 #include <u-boot/sha1.h>
 #include <u-boot/sha256.h>
+#include <u-boot/sha512.h>
 
 /*****************************************************************************/
 /* New uImage format routines */
@@ -311,6 +313,25 @@ static void fit_image_print_data(const void *fit, int noffset, const char *p,
 	}
 }
 
+/**
+ * fit_image_print_cipher() - prints out the cipher node details
+ * @fit: pointer to the FIT format image header
+ * @noffset: offset of the cipher node
+ * @p: pointer to prefix string
+ */
+static void fit_image_print_cipher(const void *fit, int noffset,
+				   const char *p)
+{
+	const char *algo, *keyname;
+
+	algo = fdt_getprop(fit, noffset, FIT_ALGO_PROP, NULL);
+	keyname = fdt_getprop(fit, noffset, FIT_KEY_HINT_PROP, NULL);
+	printf("%s  Cipher algo:  %s", p, algo ? algo : "invalid");
+	if (keyname)
+		printf(":%s", keyname);
+	printf("\n");
+}
+
 /**
  * fit_image_print_verification_data() - prints out the hash/signature details
  * @fit: pointer to the FIT format image header
@@ -338,6 +359,8 @@ static void fit_image_print_verification_data(const void *fit, int noffset,
 	} else if (!strncmp(name, FIT_SIG_NODENAME,
 				strlen(FIT_SIG_NODENAME))) {
 		fit_image_print_data(fit, noffset, p, "Sign");
+	} else if (!strcmp(name, FIT_CIPHER_NODENAME)) {
+		fit_image_print_cipher(fit, noffset, p);
 	}
 }
 
@@ -987,7 +1010,7 @@ int fit_set_timestamp(void *fit, int noffset, time_t timestamp)
  * value_len: length of the calculated hash
  *
  * calculate_hash() computes input data hash according to the requested
- * algorithm.
+ * algorithm, on a crypto engine if there is one for it.
  * Resulting hash value is placed in caller provided 'value' buffer, length
  * of the calculated hash is returned via value_len pointer argument.
  *
@@ -998,6 +1021,11 @@ int fit_set_timestamp(void *fit, int noffset, time_t timestamp)
 int calculate_hash(const void *data, int data_len, const char *algo,
 			uint8_t *value, int *value_len)
 {
+#if defined(CONFIG_DM_CRYPTO) && !defined(USE_HOSTCC)
+	*value_len = FIT_MAX_HASH_LEN;
+	if (!crypto_hash(algo, data, data_len, value, value_len))
+		return 0;
+#endif
 	if (IMAGE_ENABLE_CRC32 && strcmp(algo, "crc32") == 0) {
 		*((uint32_t *)value) = crc32_wd(0, data, data_len,
 							CHUNKSZ_CRC32);
@@ -1011,6 +1039,14 @@ int calculate_hash(const void *data, int data_len, const char *algo,
 		sha256_csum_wd((unsigned char *)data, data_len,
 			       (unsigned char *)value, CHUNKSZ_SHA256);
 		*value_len = SHA256_SUM_LEN;
+	} else if (IMAGE_ENABLE_SHA384 && strcmp(algo, "sha384") == 0) {
+		sha384_csum_wd((unsigned char *)data, data_len,
+			       (unsigned char *)value, CHUNKSZ_SHA384);
+		*value_len = SHA384_SUM_LEN;
+	} else if (IMAGE_ENABLE_SHA512 && strcmp(algo, "sha512") == 0) {
+		sha512_csum_wd((unsigned char *)data, data_len,
+			       (unsigned char *)value, CHUNKSZ_SHA512);
+		*value_len = SHA512_SUM_LEN;
 	} else if (IMAGE_ENABLE_MD5 && strcmp(algo, "md5") == 0) {
 		md5_wd((unsigned char *)data, data_len, value, CHUNKSZ_MD5);
 		*value_len = 16;
@@ -1030,6 +1066,7 @@ static int fit_image_check_hash(const void *fit, int noffset, const void *data,
 	uint8_t *fit_value;
 	int fit_value_len;
 	int ignore;
+	int ret;
 
 	*err_msgp = NULL;
 
@@ -1053,9 +1090,21 @@ static int fit_image_check_hash(const void *fit, int noffset, const void *data,
 		return -1;
 	}
 
-	if (calculate_hash(data, size, algo, value, &value_len)) {
-		*err_msgp = "Unsupported hash algorithm";
-		return -1;
+	/* A FIT rewritten behind the cache's back is simply hashed again */
+	if (!fit_cache_get_hash(data, size, algo, value, &value_len) &&
+	    value_len == fit_value_len && !memcmp(value, fit_value, value_len))
+		return 0;
+
+	if (fit_stream_get_hash(data, size, algo, value, &value_len) &&
+	    fit_offload_get_hash(data, size, algo, value, &value_len) &&
+	    fit_mb_get_hash(data, size, algo, value, &value_len)) {
+		bootstage_start(BOOTSTAGE_ID_ACCUM_HASH, "hash");
+		ret = calculate_hash(data, size, algo, value, &value_len);
+		bootstage_accum(BOOTSTAGE_ID_ACCUM_HASH);
+		if (ret) {
+			*err_msgp = "Unsupported hash algorithm";
+			return -1;
+		}
 	}
 
 	if (value_len != fit_value_len) {
@@ -1065,6 +1114,7 @@ static int fit_image_check_hash(const void *fit, int noffset, const void *data,
 		*err_msgp = "Bad hash value";
 		return -1;
 	}
+	fit_cache_add(data, size, algo, value, value_len);
 
 	return 0;
 }
@@ -1182,6 +1232,8 @@ int fit_all_image_verify(const void *fit)
 	/* Process all image subnodes, check hashes for each */
 	printf("## Checking hash(es) for FIT Image at %08lx ...\n",
 	       (ulong)fit);
+	fit_offload_hash_images(fit, -1);
+	fit_mb_hash_images(fit, -1);
 	for (ndepth = 0, count = 0,
 	     noffset = fdt_next_node(fit, images_noffset, &ndepth);
 			(noffset >= 0) && (ndepth > 0);
@@ -1720,6 +1772,7 @@ int fit_image_load(bootm_headers_t *images, ulong addr,
 	const void *buf;
 	size_t size;
 	int type_ok, os_ok;
+	int ciphered, decrypted = 0;
 	ulong load, data, len;
 	uint8_t os;
 #ifndef USE_HOSTCC
@@ -1779,6 +1832,8 @@ int fit_image_load(bootm_headers_t *images, ulong addr,
 					return -EACCES;
 				}
 				puts("OK\n");
+				fit_offload_hash_images(fit, cfg_noffset);
+				fit_mb_hash_images(fit, cfg_noffset);
 			}
 			bootstage_mark(BOOTSTAGE_ID_FIT_CONFIG);
 		}
@@ -1863,9 +1918,11 @@ int fit_image_load(bootm_headers_t *images, ulong addr,
 #endif
 
 	len = (ulong)size;
+	ciphered = fit_image_is_ciphered(fit, noffset);
 
 	/* verify that image data is a proper FDT blob */
-	if (image_type == IH_TYPE_FLATDT && fdt_check_header(buf)) {
+	if (image_type == IH_TYPE_FLATDT && !ciphered &&
+	    fdt_check_header(buf)) {
 		puts("Subimage data is not a FDT");
 		return -ENOEXEC;
 	}
@@ -1915,9 +1972,43 @@ int fit_image_load(bootm_headers_t *images, ulong addr,
 		       prop_name, data, load);
 
 		dst = map_sysmem(load, len);
-		memmove(dst, buf, len);
+		fit_stream_invalidate(dst, len);
+		fit_offload_invalidate(dst, len);
+		fit_mb_invalidate(dst, len);
+		fit_cache_invalidate(dst, len);
+		if (ciphered) {
+			/* decrypt on the way to the load address */
+			ret = fit_image_decrypt(fit, noffset, buf, size, dst,
+						&len);
+			if (ret)
+				return ret;
+			decrypted = 1;
+		} else {
+			memmove(dst, buf, len);
+		}
 		data = load;
 	}
+
+	if (ciphered && !decrypted) {
+		/* not loaded anywhere, so decrypt into a new buffer */
+		void *dst = malloc(size);
+
+		if (!dst) {
+			printf("No memory to decrypt %s\n", prop_name);
+			return -ENOMEM;
+		}
+		ret = fit_image_decrypt(fit, noffset, buf, size, dst, &len);
+		if (ret) {
+			free(dst);
+			return ret;
+		}
+		data = map_to_sysmem(dst);
+	}
+	if (ciphered && image_type == IH_TYPE_FLATDT &&
+	    fdt_check_header(map_sysmem(data, len))) {
+		puts("Subimage data is not a FDT");
+		return -ENOEXEC;
+	}
 	bootstage_mark(bootstage_id + BOOTSTAGE_SUB_LOAD);
 
 	*datap = data;
@@ -9,7 +9,12 @@
 #include <errno.h>
 #include <image.h>
 #include <libfdt.h>
+#include <malloc.h>
+#include <memalign.h>
 #include <spl.h>
+#include <lzma/LzmaTypes.h>
+#include <lzma/LzmaDec.h>
+#include <lzma/LzmaTools.h>
 
 #ifndef CONFIG_SYS_BOOTM_LEN
 #define CONFIG_SYS_BOOTM_LEN	(64 << 20)
@@ -141,6 +146,66 @@ static int get_aligned_image_size(struct spl_load_info *info, int data_size,
 	return (data_size + info->bl_len - 1) / info->bl_len;
 }
 
+/* Size of each read of external LZMA data */
+#define SPL_FIT_LZMA_CHUNK	0x4000
+
+/**
+ * spl_fit_read_lzma(): read and decompress external LZMA data
+ *
+ * The data is decompressed as it is read, a chunk at a time, so neither the
+ * compressed image nor a buffer for all of it is needed.
+ *
+ * @info:	points to information about the device to load data from
+ * @sector:	the start sector of the FIT image on the device
+ * @offset:	offset of the data from the start of the FIT image
+ * @length:	size of the compressed data
+ * @load_addr:	where to decompress to
+ * @unc_lenp:	returns the size of the decompressed data
+ *
+ * Return:	0 on success or a negative error number.
+ */
+static int spl_fit_read_lzma(struct spl_load_info *info, ulong sector,
+			     int offset, ulong length, ulong load_addr,
+			     ulong *unc_lenp)
+{
+	/* A filesystem reads bytes, a raw device blocks */
+	ulong unit = info->filename ? 1 : info->bl_len;
+	ulong chunk = roundup(SPL_FIT_LZMA_CHUNK, unit);
+	ulong skip = get_aligned_image_overhead(info, offset);
+	struct lzma_stream *ls;
+	ulong bytes, count;
+	void *buf;
+	int ret = 0, err;
+
+	buf = malloc_cache_aligned(chunk);
+	if (!buf)
+		return -ENOMEM;
+	ls = lzma_stream_start((void *)load_addr, CONFIG_SYS_BOOTM_LEN, NULL,
+			       NULL);
+	if (!ls) {
+		free(buf);
+		return -ENOMEM;
+	}
+
+	sector += get_aligned_image_offset(info, offset);
+	while (!ret && length && !lzma_stream_done(ls)) {
+		bytes = min(chunk, skip + length);
+		count = DIV_ROUND_UP(bytes, unit);
+		if (info->read(info, sector, count, buf) != count) {
+			ret = -EIO;
+			break;
+		}
+		ret = lzma_stream_write(ls, buf + skip, bytes - skip);
+		sector += count;
+		length -= bytes - skip;
+		skip = 0;
+	}
+	err = lzma_stream_finish(ls, unc_lenp);
+	free(buf);
+
+	return ret ?: err;
+}
+
 /**
  * spl_load_fit_image(): load the image described in a certain FIT node
  * @info:	points to information about the device to load data from
@@ -175,7 +240,9 @@ static int spl_load_fit_image(struct spl_load_info *info, ulong sector,
 	const void *data;
 	bool external_data = false;
 
-	if (IS_ENABLED(CONFIG_SPL_OS_BOOT) && IS_ENABLED(CONFIG_SPL_GZIP)) {
+	if (IS_ENABLED(CONFIG_SPL_OS_BOOT) &&
+	    (IS_ENABLED(CONFIG_SPL_GZIP) || IS_ENABLED(CONFIG_SPL_ZSTD) ||
+	     IS_ENABLED(CONFIG_SPL_LZMA))) {
 		if (fit_image_get_comp(fit, node, &image_comp))
 			puts("Cannot get image compression format.\n");
 		else
@@ -202,6 +269,20 @@ static int spl_load_fit_image(struct spl_load_info *info, ulong sector,
 		if (fit_image_get_data_size(fit, node, &len))
 			return -ENOENT;
 
+		if (IS_ENABLED(CONFIG_SPL_OS_BOOT)	&&
+		    IS_ENABLED(CONFIG_SPL_LZMA)		&&
+		    !IS_ENABLED(CONFIG_SPL_FIT_IMAGE_POST_PROCESS) &&
+		    image_comp == IH_COMP_LZMA		&&
+		    type == IH_TYPE_KERNEL) {
+			if (spl_fit_read_lzma(info, sector, offset, len,
+					      load_addr, &size)) {
+				puts("Uncompressing error\n");
+				return -EIO;
+			}
+			length = size;
+			goto done;
+		}
+
 		load_ptr = (load_addr + align_len) & ~align_len;
 		length = len;
 
@@ -242,10 +323,34 @@ static int spl_load_fit_image(struct spl_load_info *info, ulong sector,
 			return -EIO;
 		}
 		length = size;
+	} else if (IS_ENABLED(CONFIG_SPL_OS_BOOT)	&&
+		   IS_ENABLED(CONFIG_SPL_ZSTD)		&&
+		   image_comp == IH_COMP_ZSTD		&&
+		   type == IH_TYPE_KERNEL) {
+		size_t unc_len = CONFIG_SYS_BOOTM_LEN;
+
+		if (zstd_decompress(src, length, (void *)load_addr, &unc_len)) {
+			puts("Uncompressing error\n");
+			return -EIO;
+		}
+		length = unc_len;
+	} else if (IS_ENABLED(CONFIG_SPL_OS_BOOT)	&&
+		   IS_ENABLED(CONFIG_SPL_LZMA)		&&
+		   image_comp == IH_COMP_LZMA		&&
+		   type == IH_TYPE_KERNEL) {
+		SizeT unc_len = CONFIG_SYS_BOOTM_LEN;
+
+		if (lzmaBuffToBuffDecompress((void *)load_addr, &unc_len, src,
+					     length)) {
+			puts("Uncompressing error\n");
+			return -EIO;
+		}
+		length = unc_len;
 	} else {
 		memcpy((void *)load_addr, src, length);
 	}
 
+done:
 	if (image_info) {
 		image_info->load_addr = load_addr;
 		image_info->size = length;
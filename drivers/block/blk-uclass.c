@@ -433,6 +433,7 @@ unsigned long blk_dwrite(struct blk_desc *block_dev, lbaint_t start,
 		return -ENOSYS;
 
 	blkcache_invalidate(block_dev->if_type, block_dev->devnum);
+	fit_cache_invalidate_dev(block_dev);
 	return ops->write(dev, start, blkcnt, buffer);
 }
 
@@ -446,6 +447,7 @@ unsigned long blk_derase(struct blk_desc *block_dev, lbaint_t start,
 		return -ENOSYS;
 
 	blkcache_invalidate(block_dev->if_type, block_dev->devnum);
+	fit_cache_invalidate_dev(block_dev);
 	return ops->erase(dev, start, blkcnt);
 }
 
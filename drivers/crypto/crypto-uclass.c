@@ -0,0 +1,189 @@
+/*
+ * Crypto offload uclass
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <crypto.h>
+#include <dm.h>
+#include <errno.h>
+#include <hash.h>
+#include <watchdog.h>
+#include <dm/device-internal.h>
+
+/* Long enough for a large image on a slow engine */
+#define CRYPTO_TIMEOUT_MS	10000
+
+/**
+ * struct crypto_uc_priv - uclass information about each crypto device
+ *
+ * @queue:	Jobs submitted to the device and not yet finished, in order
+ */
+struct crypto_uc_priv {
+	struct list_head queue;
+};
+
+struct list_head *crypto_get_queue(struct udevice *dev)
+{
+	struct crypto_uc_priv *uc_priv = dev_get_uclass_priv(dev);
+
+	return &uc_priv->queue;
+}
+
+void crypto_job_done(struct crypto_job *job, int ret)
+{
+	if (!job->busy)
+		return;
+	list_del(&job->node);
+	job->ret = ret;
+	job->busy = false;
+}
+
+/* Find the device that gives the job the highest priority */
+static int crypto_find_dev(struct crypto_job *job, struct udevice **devp)
+{
+	struct udevice *dev, *best = NULL;
+	int prio, best_prio = 0;
+	struct uclass *uc;
+	int ret;
+
+	ret = uclass_get(UCLASS_CRYPTO, &uc);
+	if (ret)
+		return ret;
+	uclass_foreach_dev(dev, uc) {
+		struct crypto_ops *ops = crypto_get_ops(dev);
+
+		if (!ops->get_priority || !ops->submit)
+			continue;
+		prio = ops->get_priority(dev, job);
+		if (prio > best_prio) {
+			best = dev;
+			best_prio = prio;
+		}
+	}
+	if (!best)
+		return -ENODEV;
+
+	ret = device_probe(best);
+	if (ret)
+		return ret;
+	*devp = best;
+
+	return 0;
+}
+
+int crypto_submit(struct crypto_job *job)
+{
+	struct udevice *dev;
+	int ret;
+
+	job->busy = false;
+	ret = crypto_find_dev(job, &dev);
+	if (ret)
+		return ret;
+
+	job->dev = dev;
+	job->ret = 0;
+	job->priv = NULL;
+	job->busy = true;
+	list_add_tail(&job->node, crypto_get_queue(dev));
+	ret = crypto_get_ops(dev)->submit(dev, job);
+	if (ret) {
+		debug("%s: %s refused job: %d\n", __func__, dev->name, ret);
+		crypto_job_done(job, ret);
+		return ret;
+	}
+
+	return 0;
+}
+
+int crypto_poll(struct crypto_job *job)
+{
+	struct crypto_ops *ops;
+
+	if (!job->busy)
+		return job->ret;
+
+	ops = crypto_get_ops(job->dev);
+	if (ops->poll)
+		ops->poll(job->dev);
+
+	return job->busy ? -EBUSY : job->ret;
+}
+
+int crypto_wait(struct crypto_job *job)
+{
+	ulong start = get_timer(0);
+	int ret;
+
+	while ((ret = crypto_poll(job)) == -EBUSY) {
+		if (get_timer(start) > CRYPTO_TIMEOUT_MS) {
+			printf("%s: job timed out\n", job->dev->name);
+			crypto_job_done(job, -ETIMEDOUT);
+			return -ETIMEDOUT;
+		}
+		WATCHDOG_RESET();
+	}
+
+	return ret;
+}
+
+int crypto_run(struct crypto_job *job)
+{
+	int ret;
+
+	ret = crypto_submit(job);
+	if (ret)
+		return ret;
+
+	return crypto_wait(job);
+}
+
+int crypto_hash(const char *algo_name, const void *data, uint len,
+		uint8_t *output, int *output_size)
+{
+	struct crypto_job job = {
+		.type = CRYPTO_JOB_HASH,
+		.algo = algo_name,
+		.in = data,
+		.in_len = len,
+		.out = output,
+		.out_len = output_size ? *output_size : HASH_MAX_DIGEST_SIZE,
+	};
+	int ret;
+
+	ret = crypto_run(&job);
+	if (ret)
+		return ret;
+	if (output_size)
+		*output_size = job.out_len;
+
+	return 0;
+}
+
+static int crypto_pre_probe(struct udevice *dev)
+{
+	INIT_LIST_HEAD(crypto_get_queue(dev));
+
+	return 0;
+}
+
+/* Jobs cannot outlive their device */
+static int crypto_pre_remove(struct udevice *dev)
+{
+	struct crypto_job *job, *next;
+
+	list_for_each_entry_safe(job, next, crypto_get_queue(dev), node)
+		crypto_job_done(job, -ENODEV);
+
+	return 0;
+}
+
+UCLASS_DRIVER(crypto) = {
+	.id		= UCLASS_CRYPTO,
+	.name		= "crypto",
+	.pre_probe	= crypto_pre_probe,
+	.pre_remove	= crypto_pre_remove,
+	.per_device_auto_alloc_size = sizeof(struct crypto_uc_priv),
+};
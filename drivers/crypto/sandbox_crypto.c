@@ -0,0 +1,209 @@
+/*
+ * Sandbox crypto engine, done in software
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+/*
+ * This behaves like a hardware engine with a job ring: jobs are run in the
+ * order they are submitted, and each poll() moves the work on by a limited
+ * number of bytes, so callers see jobs that are still busy. Tests may
+ * change that amount, or stop the engine altogether by setting it to 0.
+ */
+
+#include <common.h>
+#include <crypto.h>
+#include <dm.h>
+#include <errno.h>
+#include <hash.h>
+#include <asm/test.h>
+#include <u-boot/rsa-mod-exp.h>
+
+#define SANDBOX_CRYPTO_CHUNK	(64 * 1024)
+
+/**
+ * struct sandbox_crypto - state of the engine
+ *
+ * @chunk:	Number of bytes to hash on each poll()
+ * @job:	Job that is being hashed
+ * @algo:	Algorithm of that job
+ * @ctx:	Hash context of that job, or NULL if not started
+ * @done:	Number of bytes of that job hashed so far
+ * @count:	Number of jobs finished since the device was probed
+ */
+struct sandbox_crypto {
+	uint chunk;
+	struct crypto_job *job;
+	struct hash_algo *algo;
+	void *ctx;
+	uint done;
+	int count;
+};
+
+static int sandbox_crypto_get_priority(struct udevice *dev,
+				       const struct crypto_job *job)
+{
+	struct hash_algo *algo;
+
+	switch (job->type) {
+	case CRYPTO_JOB_HASH:
+		/* The progressive crc32 gives a different byte order */
+		if (strncmp(job->algo, "sha", 3) ||
+		    hash_progressive_lookup_algo(job->algo, &algo))
+			return -ENOSYS;
+		return CRYPTO_PRIO_FAST;
+#ifdef CONFIG_RSA
+	case CRYPTO_JOB_MOD_EXP:
+		return CRYPTO_PRIO_FAST;
+#endif
+	default:
+		return -ENOSYS;
+	}
+}
+
+static int sandbox_crypto_submit(struct udevice *dev, struct crypto_job *job)
+{
+	struct hash_algo *algo;
+
+	if (job->type != CRYPTO_JOB_HASH)
+		return 0;
+	if (hash_progressive_lookup_algo(job->algo, &algo))
+		return -EPROTONOSUPPORT;
+	if (job->out_len < algo->digest_size)
+		return -ENOSPC;
+
+	return 0;
+}
+
+/* Drop a hash that was given up part way, e.g. after a time-out */
+static void sandbox_crypto_drop(struct sandbox_crypto *priv)
+{
+	uint8_t digest[HASH_MAX_DIGEST_SIZE];
+
+	if (priv->ctx)
+		priv->algo->hash_finish(priv->algo, priv->ctx, digest,
+					sizeof(digest));
+	priv->ctx = NULL;
+	priv->done = 0;
+}
+
+static void sandbox_crypto_finish(struct sandbox_crypto *priv,
+				  struct crypto_job *job, int ret)
+{
+	priv->ctx = NULL;
+	priv->done = 0;
+	priv->count++;
+	crypto_job_done(job, ret);
+}
+
+/* Move the job at the head of the queue on by up to @budget bytes */
+static uint sandbox_crypto_step(struct sandbox_crypto *priv,
+				struct crypto_job *job, uint budget)
+{
+	struct hash_algo *algo;
+	uint len;
+	int ret;
+
+#ifdef CONFIG_RSA
+	if (job->type == CRYPTO_JOB_MOD_EXP) {
+		ret = rsa_mod_exp_sw(job->in, job->in_len, job->prop, job->out);
+		sandbox_crypto_finish(priv, job, ret);
+		return job->in_len;
+	}
+#endif
+
+	if (priv->ctx && priv->job != job)
+		sandbox_crypto_drop(priv);
+	if (!priv->ctx) {
+		hash_progressive_lookup_algo(job->algo, &algo);
+		ret = algo->hash_init(algo, &priv->ctx);
+		if (ret) {
+			sandbox_crypto_finish(priv, job, -ENOMEM);
+			return 0;
+		}
+		priv->job = job;
+		priv->algo = algo;
+	}
+
+	len = min(budget, job->in_len - priv->done);
+	algo = priv->algo;
+	ret = algo->hash_update(algo, priv->ctx, job->in + priv->done, len,
+				priv->done + len == job->in_len);
+	priv->done += len;
+	if (ret) {
+		/* hash_update() frees the context on error */
+		sandbox_crypto_finish(priv, job, -EIO);
+	} else if (priv->done == job->in_len) {
+		ret = algo->hash_finish(algo, priv->ctx, job->out,
+					job->out_len);
+		job->out_len = algo->digest_size;
+		sandbox_crypto_finish(priv, job, ret ? -EIO : 0);
+	}
+
+	return len;
+}
+
+static void sandbox_crypto_poll(struct udevice *dev)
+{
+	struct sandbox_crypto *priv = dev_get_priv(dev);
+	struct list_head *queue = crypto_get_queue(dev);
+	uint budget = priv->chunk;
+	struct crypto_job *job;
+
+	while (budget && !list_empty(queue)) {
+		job = list_first_entry(queue, struct crypto_job, node);
+		budget -= min(budget, sandbox_crypto_step(priv, job, budget));
+	}
+}
+
+void sandbox_crypto_set_chunk(struct udevice *dev, uint chunk)
+{
+	struct sandbox_crypto *priv = dev_get_priv(dev);
+
+	priv->chunk = chunk;
+}
+
+int sandbox_crypto_get_count(struct udevice *dev)
+{
+	struct sandbox_crypto *priv = dev_get_priv(dev);
+
+	return priv->count;
+}
+
+static int sandbox_crypto_probe(struct udevice *dev)
+{
+	struct sandbox_crypto *priv = dev_get_priv(dev);
+
+	priv->chunk = SANDBOX_CRYPTO_CHUNK;
+
+	return 0;
+}
+
+/* The uclass has failed any jobs left, but a hash may be half done */
+static int sandbox_crypto_remove(struct udevice *dev)
+{
+	sandbox_crypto_drop(dev_get_priv(dev));
+
+	return 0;
+}
+
+static const struct crypto_ops sandbox_crypto_ops = {
+	.get_priority	= sandbox_crypto_get_priority,
+	.submit		= sandbox_crypto_submit,
+	.poll		= sandbox_crypto_poll,
+};
+
+static const struct udevice_id sandbox_crypto_ids[] = {
+	{ .compatible = "sandbox,crypto" },
+	{ }
+};
+
+U_BOOT_DRIVER(sandbox_crypto) = {
+	.name		= "sandbox_crypto",
+	.id		= UCLASS_CRYPTO,
+	.of_match	= sandbox_crypto_ids,
+	.probe		= sandbox_crypto_probe,
+	.remove		= sandbox_crypto_remove,
+	.priv_auto_alloc_size = sizeof(struct sandbox_crypto),
+	.ops		= &sandbox_crypto_ops,
+};
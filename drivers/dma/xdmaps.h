@@ -324,6 +324,12 @@ XDmaPs_Config *XDmaPs_LookupConfig(u16 DeviceId);
  */
 int XDmaPs_SelfTest(XDmaPs *InstPtr);
 
+/*NAI_ADDED*/
+/*
+ * polled single channel transfer in xdmaps_cmd.c
+ */
+int XDmaPs_FifoTransfer(u32 Src, u32 Dst, int Len, u8 isSrcFIFO, u8 isDestFIFO);
+/*END NAI_ADDED*/
 
 #ifdef __cplusplus
 }
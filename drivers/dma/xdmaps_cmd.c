@@ -238,6 +238,68 @@ static void DmaDoneHandler(unsigned int Channel, XDmaPs_Cmd *DmaCmd,
 	Checked[Channel] = Status;
 }
 
+/*NAI_ADDED*/
+/*
+ * Quiet single channel transfer for callers outside of the xdma command
+ * (e.g. the NAI SERDES TX FIFO path). The controller is only looked up and
+ * initialised on first use so back to back transfers do not pay for it.
+ */
+int XDmaPs_FifoTransfer(u32 Src, u32 Dst, int Len, u8 isSrcFIFO, u8 isDestFIFO)
+{
+	static int Initialized;
+	unsigned int Channel = XDMAPS_PL_CHANNEL_START;
+	int Status;
+	int TimeOutCnt = 0;
+	volatile int Checked[XDMAPS_CHANNELS_PER_DEV];
+	XDmaPs_Config *DmaCfg;
+	XDmaPs *DmaInst = &DmaInstance;
+	XDmaPs_Cmd DmaCmd;
+
+	if (!Initialized) {
+		DmaCfg = XDmaPs_LookupConfig(DMA_DEVICE_ID);
+		if (DmaCfg == NULL)
+			return XST_FAILURE;
+
+		Status = XDmaPs_CfgInitialize(DmaInst, DmaCfg,
+					      DmaCfg->BaseAddress);
+		if (Status != XST_SUCCESS)
+			return XST_FAILURE;
+
+		Initialized = 1;
+	}
+
+	memset(&DmaCmd, 0, sizeof(XDmaPs_Cmd));
+
+	DmaCmd.ChanCtrl.SrcBurstSize = 4;
+	DmaCmd.ChanCtrl.SrcBurstLen = 4;
+	DmaCmd.ChanCtrl.SrcInc = isSrcFIFO ? 0 : 1;
+	DmaCmd.ChanCtrl.DstBurstSize = 4;
+	DmaCmd.ChanCtrl.DstBurstLen = 4;
+	DmaCmd.ChanCtrl.DstInc = isDestFIFO ? 0 : 1;
+	DmaCmd.BD.SrcAddr = Src;
+	DmaCmd.BD.DstAddr = Dst;
+	DmaCmd.BD.Length = Len;
+
+	Checked[Channel] = 0;
+	XDmaPs_SetDoneHandler(DmaInst, Channel, DmaDoneHandler,
+			      (void *)Checked);
+
+	Status = XDmaPs_Start(DmaInst, Channel, &DmaCmd, 0);
+	if (Status != XST_SUCCESS)
+		return XST_FAILURE;
+
+	while (!Checked[Channel] && TimeOutCnt < TIMEOUT_LIMIT) {
+		if (!XDmaPs_PollStatus(DmaInst))
+			TimeOutCnt++;
+	}
+
+	if (TimeOutCnt >= TIMEOUT_LIMIT || Checked[Channel] < 0)
+		return XST_FAILURE;
+
+	return XST_SUCCESS;
+}
+/*END NAI_ADDED*/
+
 static int do_xdma(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[]) {
 	int rc = 0;
 	ulong src;
@@ -310,6 +310,7 @@ ulong mmc_bread(struct blk_desc *block_dev, lbaint_t start, lbaint_t blkcnt,
 			debug("%s: Failed to read blocks\n", __func__);
 			return 0;
 		}
+		fit_stream_update(dst, cur * mmc->read_bl_len);
 		blocks_todo -= cur;
 		start += cur;
 		dst += cur * mmc->read_bl_len;
@@ -1874,6 +1875,8 @@ static int mmc_startup(struct mmc *mmc)
 		(mmc->cid[2] >> 24) & 0xff);
 	sprintf(bdesc->revision, "%d.%d", (mmc->cid[2] >> 20) & 0xf,
 		(mmc->cid[2] >> 16) & 0xf);
+	/* The card may have been written elsewhere while it was out */
+	fit_cache_invalidate_dev(bdesc);
 #else
 	bdesc->vendor[0] = 0;
 	bdesc->product[0] = 0;
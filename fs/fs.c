@@ -402,7 +402,13 @@ int fs_read(const char *filename, ulong addr, loff_t offset, loff_t len,
 	 * means read the whole file.
 	 */
 	buf = map_sysmem(addr, len);
+	if (!offset)
+		fit_stream_start(buf);
+	fit_cache_load_start(buf, fs_dev_desc, fs_dev_part, filename, offset);
 	ret = info->read(filename, buf, offset, len, actread);
+	fit_cache_load_end(ret ? 0 : *actread);
+	if (!offset)
+		fit_stream_end(ret ? 0 : *actread);
 	unmap_sysmem(buf);
 
 	/* If we requested a specific number of bytes, check we got it */
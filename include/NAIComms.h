@@ -30,6 +30,17 @@
 /** \def Maximum number of words that can comprise the payload when in configuration mode **/
 #define CONFIG_MAX_PAYLOAD_IN_WORDS    236
 
+/** \def Size in bytes of the static region used to hand out MsgPacket structs (enough for a full 64K flash page message plus responses) **/
+#define NAI_MSG_PACKET_POOL_BYTES	(160 * ((MAX_SERDES_MSG_IN_WORDS * 2) + 16))
+
+/** \def Number of MsgPacketList structs kept in the static list pool **/
+#define NAI_MSG_PACKET_LIST_POOL_COUNT	16
+
+/*MsgPacket ownership flags (where the packet storage came from and who must release it)*/
+#define NAI_MSG_PACKET_FROM_HEAP	0x00
+#define NAI_MSG_PACKET_FROM_POOL	0x01
+#define NAI_MSG_PACKET_CALLER_OWNED	0x02
+
 
 /*Command Types (implemented this way since enum will force use of 4 bytes which is a waste of space)*/
 /** \def READ EEPROM command : used to read from the EEPROM storage **/
@@ -188,6 +199,8 @@ struct _MsgPacket
    NAIMsg tNAIMsg;
    /** Pointer to the Next message packet */
    struct _MsgPacket *ptNext;
+   /** Ownership of this packet's storage (NAI_MSG_PACKET_FROM_HEAP, NAI_MSG_PACKET_FROM_POOL or NAI_MSG_PACKET_CALLER_OWNED) */
+   uint8_t ucOwner;
 }  __attribute__ ((packed,aligned(1)))  ;
 
 typedef struct _MsgPacket MsgPacket;
@@ -210,6 +223,12 @@ struct _MsgPacketList
    MsgPacket *ptEnd;
     /** Pointer to the Next message */
    struct _MsgPacketList *ptNext;
+   /** Ownership of this list's storage (NAI_MSG_PACKET_FROM_HEAP or NAI_MSG_PACKET_FROM_POOL) */
+   uint8_t ucOwner;
+   /** Running CRC of the packets from ptStart up to and including ptCRCEnd */
+   uint32_t unCRC;
+   /** Last packet folded into unCRC (NULL if none) */
+   MsgPacket *ptCRCEnd;
 }   __attribute__ ((packed,aligned(1)))  ;
 
 typedef struct _MsgPacketList MsgPacketList;
@@ -231,4 +250,38 @@ typedef struct
    MsgPacketList *ptEnd;
 }   __attribute__ ((packed,aligned(1)))   MsgList;
 
+//**************************************************************************************************************
+/**
+\struct MsgPoolStats
+This struct holds the usage counters of the MsgPacket pool so callers can see how often the heap is still hit.
+*/
+//**************************************************************************************************************
+typedef struct
+{
+   /** Number of packets handed out from the static pool */
+   uint32_t unPoolAcquires;
+   /** Number of packets that had to fall back to the heap because the pool was exhausted */
+   uint32_t unHeapAllocs;
+   /** Number of pool packets currently handed out */
+   uint32_t unInUse;
+   /** Highest number of pool packets handed out at the same time */
+   uint32_t unHighWater;
+} MsgPoolStats;
+
+//**************************************************************************************************************
+/**
+\struct MsgTxStats
+This struct holds the TX FIFO throughput counters maintained by nai_send_msg.
+*/
+//**************************************************************************************************************
+typedef struct
+{
+   /** Number of packets pushed into a TX FIFO */
+   uint32_t unPackets;
+   /** Number of 32 bit words pushed into a TX FIFO */
+   uint32_t unWords;
+   /** Microseconds spent in the transmit loop (including waiting for the TX FIFO to drain) */
+   uint32_t unMicroseconds;
+} MsgTxStats;
+
 #endif /* __NAICOMMS_H__ */
@@ -16,8 +16,15 @@
 
 #define _QSPI_SUPPORT 1
 //#define _PERFORM_QSPI_ERASE_ON_FLASH_WRITE 1
+#define _QSPI_ERASE_AHEAD 1 /* Queue flash erases and run them just ahead of the write cursor or while the receiver is idle (comment out to erase synchronously) */
+#define QSPI_STREAM_BUF_BYTES 2048 /* Staging buffer for stream_to_qspi (should hold at least 2 flash pages) */
 #define _IGNORE_MISSING_TOP_MODULE 1
 #define COMPLETION_TIMEOUT 5000  /*In milliseconds*/
+#define _BURST_FIFO_TX 1 /* Stage whole packets as 32 bit FIFO words and push them to the TX FIFO in one burst (comment out for the original word by word loop) */
+//#define _DMA_FIFO_TX 1 /* Let the Zynq PL330 push staged packets into the TX FIFO (requires _BURST_FIFO_TX and CONFIG_ZYNQ_DMA) */
+#define DMA_FIFO_TX_MIN_WORDS 32 /* Packets smaller than this (in 32 bit words) are cheaper to push with the CPU than to hand to the DMA */
+#define SERDES_TX_WINDOW 4 /* Max number of write requests in flight at once for the windowed requests (1 = stop and wait) */
+#define SERDES_WINDOW_CHUNK_BYTES 0x4000 /* Bytes per write request for the windowed requests (must not exceed the module's MAX_FLASH_PAGE_BYTES) */
 
 /*#define __EXTERNAL_PROCESSOR 1*/ /*Define __EXTERNAL_PROCESSOR if building for a processor other than the processor for the HPS. */
 
@@ -76,6 +83,11 @@
 #define SERDES_READREG  0x0002
 #define SERDES_WRITEREG 0x0003
 
+/*Batched Register Operation Types (see nai_batch_reg32_by_slot_request)*/
+#define NAI_REGOP_READ32	0x01
+#define NAI_REGOP_WRITE32	0x02
+#define NAI_REGOP_RMW32		0x03
+
 /*SERDES Byte Enable*/
 #define SERDES_32BITDATA 0x0F
 
@@ -113,6 +125,10 @@
 #define NAI_RESPONSE_COMMAND_MISMATCH		-8229
 #define NAI_COMMAND_FAILED				    -8230
 #define NAI_NOT_SUPPORTED					-8231
+#define NAI_TX_FIFO_DMA_FAILED				-8232
+#define NAI_QSPI_NOT_FOUND					-8233
+#define NAI_QSPI_ERASE_FAILED				-8234
+#define NAI_QSPI_WRITE_FAILED				-8235
 
 /*Misc*/
 #define MB_SLOT								0x00
@@ -452,5 +468,25 @@ typedef union
 
 #endif
 
+//**************************************************************************************************************
+/**
+\struct NAIRegOp
+This struct describes a single register operation handed to nai_batch_reg32_by_slot_request.
+*/
+//**************************************************************************************************************
+typedef struct
+{
+   /** Operation type: NAI_REGOP_READ32, NAI_REGOP_WRITE32 or NAI_REGOP_RMW32 */
+   uint8_t ucOp;
+   /** Offset into module address space (must be 32 bit aligned) */
+   uint32_t unModuleOffset;
+   /** Value to write (WRITE32) or new value of the bits selected by unMask (RMW32) */
+   uint32_t unValue;
+   /** Bits replaced by a RMW32: (Old & ~unMask) | (unValue & unMask) */
+   uint32_t unMask;
+   /** Value read (READ32) or value before modification (RMW32) */
+   uint32_t unResult;
+} NAIRegOp;
+
 #endif /* __NAISERDES_H__ */
 
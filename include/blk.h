@@ -197,6 +197,19 @@ static inline void blkcache_invalidate(int iftype, int dev) {}
 
 #endif
 
+#if defined(CONFIG_FIT_VERIFY_CACHE) && !defined(CONFIG_SPL_BUILD)
+/**
+ * fit_cache_invalidate_dev() - make verified FIT image digests stale
+ * because the device is about to be written or erased, or its medium
+ * has just been (re)initialised.
+ *
+ * @param desc - block device being written
+ */
+void fit_cache_invalidate_dev(struct blk_desc *desc);
+#else
+static inline void fit_cache_invalidate_dev(struct blk_desc *desc) {}
+#endif
+
 #if CONFIG_IS_ENABLED(BLK)
 struct udevice;
 
@@ -440,6 +453,7 @@ static inline ulong blk_dwrite(struct blk_desc *block_dev, lbaint_t start,
 			       lbaint_t blkcnt, const void *buffer)
 {
 	blkcache_invalidate(block_dev->if_type, block_dev->devnum);
+	fit_cache_invalidate_dev(block_dev);
 	return block_dev->block_write(block_dev, start, blkcnt, buffer);
 }
 
@@ -447,6 +461,7 @@ static inline ulong blk_derase(struct blk_desc *block_dev, lbaint_t start,
 			       lbaint_t blkcnt)
 {
 	blkcache_invalidate(block_dev->if_type, block_dev->devnum);
+	fit_cache_invalidate_dev(block_dev);
 	return block_dev->block_erase(block_dev, start, blkcnt);
 }
 
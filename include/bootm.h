@@ -73,4 +73,35 @@ int bootm_decomp_image(int comp, ulong load, ulong image_start, int type,
 		       void *load_buf, void *image_buf, ulong image_len,
 		       uint unc_len, ulong *load_end);
 
+/**
+ * bootm_inplace_margin() - get the margin to decompress in place
+ *
+ * An image can be decompressed over itself if its compressed data ends at
+ * least this far beyond the end of the decompressed data.
+ *
+ * @comp:	Compression algorithm that is used (IH_COMP_...)
+ * @unc_len:	Decompressed size of the image
+ * @return margin in bytes, or -EPROTONOSUPPORT if the algorithm cannot
+ * decompress in place
+ */
+long bootm_inplace_margin(int comp, ulong unc_len);
+
+/**
+ * bootm_inplace_addr() - find where to load an image to decompress in place
+ *
+ * This avoids copying the image out of the way before it is decompressed,
+ * and the memory needed for the copy. The area used, from @load to the end
+ * of the image data or of the decompressed data, must be free for bootm.
+ *
+ * @comp:	Compression algorithm that is used (IH_COMP_...)
+ * @load:	Load address of the image
+ * @unc_len:	Decompressed size of the image
+ * @comp_len:	Size of the (compressed) image data
+ * @addrp:	Returns the address to put the image data at
+ * @return 0 if OK, -EPROTONOSUPPORT if the algorithm cannot decompress in
+ * place, -ENOSPC if the area is not free
+ */
+int bootm_inplace_addr(int comp, ulong load, ulong unc_len, ulong comp_len,
+		       ulong *addrp);
+
 #endif
@@ -9,6 +9,12 @@
 
 #define _MICROCONTROLLER 1
 
+/* MessagePool */
+MsgPacket * acquire_nai_msg_packet(void);
+void release_nai_msg_packet(MsgPacket *ptMsgPacket);
+void free_nai_msg_packet_list(MsgPacketList *ptMsgPacketList);
+void nai_get_msg_pool_stats(MsgPoolStats *ptStats, BOOL bReset);
+
 /* MessageCreation */
 MsgPacket * create_nai_msg_packet(uint16_t* pusData);
 MsgPacket * clone_nai_msg_packet_sans_payload(MsgPacket *ptMsgPacket);
@@ -16,8 +22,12 @@ MsgPacketList * create_nai_msg_packet_list(void);
 MsgPacketList * find_nai_msg_packet_list(MsgList *ptMsgList, uint16_t usTranID);
 void init_nai_msgs(MsgList *ptMsgList);
 void create_and_append_nai_msg_packet(MsgPacketList *ptMsgPacketList, uint16_t* pusData);
+void append_nai_msg_packet(MsgPacketList *ptMsgPacketList, MsgPacket *ptNewMsgPacket);
+/* Links ptMsgPacket in place: it must stay untouched until the list is deleted */
+void attach_nai_msg_packet(MsgPacketList *ptMsgPacketList, MsgPacket *ptMsgPacket);
 void delete_nai_msg_packets(MsgPacketList *ptMsgPacketList);
 void add_nai_msg(MsgList *ptMsgList, MsgPacketList *ptMsgPacketList);
+BOOL remove_nai_msg(MsgList *ptMsgList, MsgPacketList *ptMsgPacketList);
 void delete_nai_msgs(MsgList *ptMsgList);
 
 /* PrintMessage */
@@ -28,6 +38,7 @@ void print_nai_msg_payload(MsgPacket *ptMsgPacket);
 /* MessageValidation */
 uint32_t compute_nai_msg_crc(MsgPacketList *ptMsgPacketList);
 uint32_t compute_crc_and_update_packet_list(MsgPacketList *ptMsgPacketList);
+void reset_nai_msg_crc(MsgPacketList *ptMsgPacketList);
 int32_t validate_nai_msgs(MsgList *ptMsgList);
 int32_t validate_nai_msg(MsgPacketList *ptMsgPacketList);
 
@@ -37,6 +48,7 @@ int32_t nai_send_msg_finished_response(MsgPacketList *ptMsgPacketList, int32_t n
 int32_t deal_with_nai_msg(MsgPacketList *ptMsgPacketList);
 int32_t nai_send_msgs(MsgList *ptMsgList);
 int32_t nai_send_msg(MsgPacketList *ptMsgPackets);
+void nai_get_msg_tx_stats(MsgTxStats *ptStats, BOOL bReset);
 int32_t nai_receive_msg_packet(uint8_t ucRequesterID, uint8_t ucCompleterID, MsgList *ptMsgList);
 uint8_t nai_get_serdes_completer_id(MsgPacket *ptMsgPacket);
 uint8_t nai_get_serdes_requester_id(MsgPacket *ptMsgPacket);
@@ -63,6 +75,7 @@ int32_t nai_write_module_eeprom_request(uint16_t usChipID, uint8_t ucRequesterID
 int32_t nai_erase_flash_request(uint8_t ucRequesterID, uint8_t ucCompleterID, uint32_t unFlashOffset, uint8_t ucNumPages);
 int32_t nai_read_module_flash_request(uint8_t ucRequesterID, uint8_t ucCompleterID, uint32_t unFlashOffset, uint8_t *pucBuf, int32_t nLen);
 int32_t nai_write_module_flash_request(uint8_t ucRequesterID, uint8_t ucCompleterID, uint32_t unFlashOffset, uint8_t *pucBuf, int32_t nLen);
+int32_t nai_write_module_flash_windowed_request(uint8_t ucRequesterID, uint8_t ucCompleterID, uint32_t unFlashOffset, uint8_t *pucBuf, int32_t nLen);
 int32_t nai_exit_module_config_mode_request(uint8_t ucSlotID);
 int32_t nai_reset_module_request(uint8_t ucSlotID);
 
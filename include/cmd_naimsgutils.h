@@ -22,6 +22,13 @@ void nai_write16(uint32_t unAddress, uint16_t usValue);
 uint16_t nai_read16(uint32_t unAddress);
 void nai_write32(uint32_t unAddress, uint32_t unValue);
 uint32_t nai_read32(uint32_t unAddress);
+int32_t nai_write32_fifo(uint32_t unAddress, const uint32_t *punValues, uint32_t unCount);
+
+#ifdef CONFIG_NAI_SERDES_SANDBOX
+/* SandboxEmulation (cmd/naisandbox.c) - register accesses of nai_read* / nai_write* land here on sandbox */
+uint32_t sandbox_nai_serdes_read32(uint32_t unAddress);
+void sandbox_nai_serdes_write32(uint32_t unAddress, uint32_t unValue);
+#endif
 
 #if defined(__UBOOT) || defined(__BAREMETAL)
 void nai_common_write32(uint32_t unAddress, uint32_t unValue);
@@ -47,8 +54,13 @@ void nai_rx_fifo_clear_pkt_ready(uint8_t ucRequesterID, uint8_t ucCompleterID);
 #ifdef __UBOOT
 int32_t probe_qspi(void);
 int32_t erase_qspi(uint32_t ulOffset, uint32_t ulLen);
-int32_t write_to_qspi( uint32_t ulAddr, uint32_t ulOffset, uint32_t ulLen);
-int32_t read_from_qspi( uint32_t ulAddr, uint32_t ulOffset, uint32_t ulLen);
+int32_t write_to_qspi( ulong ulAddr, uint32_t ulOffset, uint32_t ulLen);
+int32_t read_from_qspi( ulong ulAddr, uint32_t ulOffset, uint32_t ulLen);
+int32_t stream_to_qspi(uint32_t unOffset, const uint8_t *pucData, uint32_t unLen);
+int32_t flush_qspi_stream(void);
+int32_t queue_erase_qspi(uint32_t unOffset, uint32_t unLen);
+BOOL erase_qspi_ahead(void);
+int32_t sync_qspi(void);
 #endif
 
 #if defined(__UBOOT) || defined(__BAREMETAL)
@@ -57,6 +69,7 @@ int32_t write_at24c(uint8_t chip, uint32_t addr, uint8_t *buf, int32_t len);
 #endif
 
 #ifndef __UBOOT
+/* U-Boot builds use lib/crc32.c; the others have their own copy in naimsgutils.c */
 uint32_t crc32(uint32_t crc, const void *buf, size_t size);
 #endif
 
@@ -37,5 +37,7 @@ int32_t nai_write_block16_by_slot_request(uint8_t ucSlotID, uint32_t unModuleOff
 int32_t nai_read_block32_by_slot_request(uint8_t ucSlotID, uint32_t unModuleOffsetStart, uint32_t usCount, uint8_t ucStride, uint32_t *punDataBuf);
 int32_t nai_write_block32_by_slot_request(uint8_t ucSlotID, uint32_t unModuleOffsetStart, uint32_t usCount, uint8_t ucStride, uint32_t *punDataBuf);
 
+int32_t nai_batch_reg32_by_slot_request(uint8_t ucSlotID, NAIRegOp *ptOps, uint32_t unCount, uint32_t *punOpsDone);
+
 #endif /* __NAIOPERMSGUTILS_H__ */
 
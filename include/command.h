@@ -144,6 +144,18 @@ enum command_ret_t {
 int cmd_process(int flag, int argc, char * const argv[],
 			       int *repeatable, unsigned long *ticks);
 
+/**
+ * cmd_get_seq() - Get the sequence number of the current command
+ *
+ * This goes up by one each time cmd_process() runs a command, so it tells
+ * whether state cached by an earlier call is from the same command, e.g.
+ * before trusting something in memory which another command could have
+ * changed.
+ *
+ * @return sequence number of the command being run
+ */
+uint cmd_get_seq(void);
+
 void fixup_cmdtable(cmd_tbl_t *cmdtp, int size);
 
 /**
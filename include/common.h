@@ -573,6 +573,105 @@ int gunzip(void *, int, unsigned char *, unsigned long *);
 int zunzip(void *dst, int dstlen, unsigned char *src, unsigned long *lenp,
 						int stoponerr, int offset);
 
+/**
+ * Streaming decompression
+ *
+ * A gzip_stream inflates data as it arrives, e.g. from a network or a
+ * filesystem read in chunks, so that decompression overlaps loading and the
+ * whole compressed image need not be staged first. All state is in the
+ * stream, so several may be in use at once.
+ *
+ * Output goes either straight to one buffer (no sink) or, a buffer-full at
+ * a time, to a sink callback, e.g. to write it to a block device.
+ */
+struct gzip_stream;
+
+#define GZIP_STREAM_RAW	(1 << 0)	/* Raw deflate, no gzip header */
+
+/**
+ * gzip_sink_t - receive decompressed data, in order
+ *
+ * @priv:	Private data passed to gzip_stream_start()
+ * @buf:	Decompressed data
+ * @len:	Number of bytes in @buf; only the last call may be short
+ * @return 0 if OK, -ve to stop decompressing
+ */
+typedef int (*gzip_sink_t)(void *priv, const void *buf, ulong len);
+
+/**
+ * gzip_source_t - supply compressed data for gunzip_stream()
+ *
+ * @priv:	Private data passed to gunzip_stream()
+ * @buf:	Buffer to fill
+ * @size:	Size of @buf
+ * @return number of bytes read, 0 at the end of the data, -ve on error
+ */
+typedef long (*gzip_source_t)(void *priv, void *buf, ulong size);
+
+/**
+ * gzip_stream_start() - start decompressing a stream
+ *
+ * @out:	Output buffer: the destination if @sink is NULL, else a
+ *		buffer that is passed to @sink each time it fills (NULL to
+ *		allocate one)
+ * @out_size:	Size of @out in bytes
+ * @sink:	Where to send the output, or NULL
+ * @priv:	Private data for @sink
+ * @flags:	GZIP_STREAM_... flags
+ * @return new stream, or NULL if out of memory
+ */
+struct gzip_stream *gzip_stream_start(void *out, ulong out_size,
+				      gzip_sink_t sink, void *priv, uint flags);
+
+/**
+ * gzip_stream_write() - decompress the next piece of a stream
+ *
+ * Data after the end of the stream is ignored.
+ *
+ * @gs:		Stream
+ * @in:		Compressed data
+ * @len:	Number of bytes in @in
+ * @return 0 if OK, -EBADMSG if the data is corrupt, -ENOSPC if the output
+ *	buffer is full, or the error returned by the sink. An error sticks.
+ */
+int gzip_stream_write(struct gzip_stream *gs, const void *in, ulong len);
+
+/**
+ * gzip_stream_done() - check whether the end of a stream has been seen
+ *
+ * @gs:		Stream
+ * @return true if the whole stream has been decompressed and checked
+ */
+bool gzip_stream_done(struct gzip_stream *gs);
+
+/**
+ * gzip_stream_finish() - finish decompressing and free a stream
+ *
+ * This passes any output still in the buffer to the sink. It may also be
+ * used to give up on a stream.
+ *
+ * @gs:		Stream
+ * @lenp:	Returns the number of bytes decompressed, if not NULL
+ * @return 0 if the stream was complete, -EBADMSG if it was cut short, or
+ *	the error from gzip_stream_write()
+ */
+int gzip_stream_finish(struct gzip_stream *gs, ulong *lenp);
+
+/**
+ * gunzip_stream() - decompress data read through a callback
+ *
+ * @source:	Supplies the compressed data
+ * @sink:	Receives the decompressed data
+ * @priv:	Private data for @source and @sink
+ * @chunk:	Size of each read from @source and write to @sink
+ * @flags:	GZIP_STREAM_... flags
+ * @lenp:	Returns the number of bytes decompressed, if not NULL
+ * @return 0 if OK, -ve on error as for gzip_stream_finish(), or an error
+ *	from @source
+ */
+int gunzip_stream(gzip_source_t source, gzip_sink_t sink, void *priv,
+		  ulong chunk, uint flags, ulong *lenp);
+
 /**
  * gzwrite progress indicators: defined weak to allow board-specific
  * overrides:
@@ -615,6 +714,54 @@ int gzwrite(unsigned char *src, int len,
 /* lib/lz4_wrapper.c */
 int ulz4fn(const void *src, size_t srcn, void *dst, size_t *dstn);
 
+/**
+ * ulz4fn_cpus() - Decompress an LZ4 frame on up to a given number of CPUs
+ *
+ * This is ulz4fn() with the number of CPUs chosen by the caller rather than
+ * from the input size. Runs of blocks that no secondary CPU could be started
+ * for are decompressed by this CPU. The result is always the same as from
+ * ulz4fn().
+ *
+ * @src:	Compressed frame
+ * @srcn:	Size of compressed frame
+ * @dst:	Buffer for decompressed data
+ * @dstn:	Size of @dst on entry, number of bytes decompressed on exit
+ * @cpus:	Number of CPUs to use, 1 to decompress one block after another
+ * @return 0 if OK, -ve on error, as ulz4fn()
+ */
+int ulz4fn_cpus(const void *src, size_t srcn, void *dst, size_t *dstn,
+		int cpus);
+
+/**
+ * ulz4fn_size() - Get the decompressed size of an LZ4 frame
+ *
+ * This uses the content size if the frame has one. Otherwise it adds up the
+ * sizes of the stored blocks and the maximum block size for the others, so
+ * may be larger than the actual size.
+ *
+ * @src:	Compressed frame
+ * @srcn:	Size of compressed frame
+ * @sizep:	Returns the decompressed size, or an upper bound for it
+ * @return 0 if OK, -ve on error
+ */
+int ulz4fn_size(const void *src, size_t srcn, size_t *sizep);
+
+/* lib/zstd/zstd.c */
+/**
+ * zstd_decompress() - Decompress one or more Zstandard frames
+ *
+ * Anything after the last frame is ignored, so @srcn may be larger than the
+ * compressed data.
+ *
+ * @src:	Compressed data
+ * @srcn:	Size of compressed data
+ * @dst:	Buffer for decompressed data
+ * @dstn:	Size of @dst on entry, number of bytes decompressed on exit
+ * @return 0 if OK, -ENOBUFS if @dst is too small, -ENOMEM if out of memory,
+ *	-EINVAL if the data is corrupt
+ */
+int zstd_decompress(const void *src, size_t srcn, void *dst, size_t *dstn);
+
 /* lib/qsort.c */
 void qsort(void *base, size_t nmemb, size_t size,
 	   int(*compar)(const void *, const void *));
@@ -160,6 +160,7 @@
 /* NAI SERDES Functionality */
 #define CONFIG_NAI_SERDES
 #define CONFIG_NAI_SEND
+#define CONFIG_CMD_NAIBENCH
 
 /* EEPROM */
 #define CONFIG_ZYNQ_EEPROM
@@ -49,6 +49,9 @@
 
 #define CONFIG_I2C_EDID
 
+/* NAI serdes - base of the register window emulated by cmd/naisandbox.c */
+#define PS2FPGA_BASE_ADDRESS		0x43C00000
+
 /* Memory things - we don't really want a memory test */
 #define CONFIG_SYS_LOAD_ADDR		0x00000000
 #define CONFIG_SYS_MEMTEST_START	0x00100000
@@ -0,0 +1,194 @@
+/*
+ * Crypto offload engines
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#ifndef _CRYPTO_H_
+#define _CRYPTO_H_
+
+#include <linux/list.h>
+
+struct key_prop;
+struct udevice;
+
+/*
+ * A crypto device runs hash and RSA jobs for the CPU. Callers fill in a
+ * struct crypto_job and hand it to crypto_submit(), which queues it on the
+ * fastest device that can run it. The caller is then free to do other work,
+ * e.g. load the next image, and collects the result with crypto_poll() or
+ * crypto_wait(). crypto_run() does both for callers that just want the
+ * answer.
+ *
+ * Software is the fallback: when no device claims a job, crypto_submit()
+ * returns -ENODEV and the caller uses its own code as before.
+ */
+
+/**
+ * enum crypto_job_type - what a job does
+ *
+ * @CRYPTO_JOB_HASH:	Hash @in into @out, with the hash_algo named @algo;
+ *			the result is as for hash_block()
+ * @CRYPTO_JOB_MOD_EXP:	RSA public key operation as for rsa_mod_exp():
+ *			@out = @in ^ exponent % modulus, with the key in @prop
+ */
+enum crypto_job_type {
+	CRYPTO_JOB_HASH,
+	CRYPTO_JOB_MOD_EXP,
+};
+
+/* Priority a device gives a job it can run; software counts as 0 */
+#define CRYPTO_PRIO_SLOW	10	/* Slower than the CPU, but frees it */
+#define CRYPTO_PRIO_FAST	100	/* Faster than the CPU */
+
+/**
+ * struct crypto_job - a piece of work for a crypto device
+ *
+ * The caller fills in the first group of fields. The job, and the buffers
+ * it points to, must stay in place until the job is finished.
+ *
+ * @type:	Type of job
+ * @algo:	Hash algorithm name, e.g. "sha256" (CRYPTO_JOB_HASH only)
+ * @prop:	RSA public key (CRYPTO_JOB_MOD_EXP only)
+ * @in:		Input data
+ * @in_len:	Length of the input data in bytes
+ * @out:	Buffer for the result: a digest, or @in_len bytes for mod_exp
+ * @out_len:	Size of @out in bytes; set to the size of a digest when done
+ *
+ * @dev:	Device running the job, set by crypto_submit()
+ * @node:	Entry in the device's queue, in submission order
+ * @busy:	true from crypto_submit() until the job finishes
+ * @ret:	Result of the job once it is finished: 0 or -ve error
+ * @priv:	For use by the driver while the job is queued
+ */
+struct crypto_job {
+	enum crypto_job_type type;
+	const char *algo;
+	struct key_prop *prop;
+	const void *in;
+	uint in_len;
+	void *out;
+	int out_len;
+
+	struct udevice *dev;
+	struct list_head node;
+	bool busy;
+	int ret;
+	void *priv;
+};
+
+/**
+ * struct crypto_ops - Driver model crypto operations
+ *
+ * A driver that does its work synchronously may finish each job in
+ * submit() and leave out poll().
+ */
+struct crypto_ops {
+	/**
+	 * get_priority() - Say whether the device can run a job
+	 *
+	 * This is called before the device is probed.
+	 *
+	 * @dev:	Crypto device
+	 * @job:	Job to look at; only the caller's fields are set
+	 * @return priority (CRYPTO_PRIO_...) if the device can run the job,
+	 *	-ENOSYS if not
+	 */
+	int (*get_priority)(struct udevice *dev, const struct crypto_job *job);
+
+	/**
+	 * submit() - Start a job
+	 *
+	 * The uclass has already added the job to the end of the device's
+	 * queue. The driver calls crypto_job_done() when it has finished,
+	 * which may be straight away.
+	 *
+	 * @dev:	Crypto device
+	 * @job:	Job to start
+	 * @return 0 if OK, -ve on error, in which case the job is dropped
+	 */
+	int (*submit)(struct udevice *dev, struct crypto_job *job);
+
+	/**
+	 * poll() - Check on the jobs that are running
+	 *
+	 * This collects any jobs that have finished, calling crypto_job_done()
+	 * for each, and keeps the device busy.
+	 *
+	 * @dev:	Crypto device
+	 */
+	void (*poll)(struct udevice *dev);
+};
+
+#define crypto_get_ops(dev)	((struct crypto_ops *)(dev)->driver->ops)
+
+/**
+ * crypto_submit() - Queue a job on the fastest device that can run it
+ *
+ * @job:	Job to run
+ * @return 0 if queued (or already finished), -ENODEV if no device can run
+ *	it, other -ve on error
+ */
+int crypto_submit(struct crypto_job *job);
+
+/**
+ * crypto_poll() - Check whether a job has finished
+ *
+ * @job:	Job passed to crypto_submit()
+ * @return -EBUSY if it is still running, else the result of the job
+ */
+int crypto_poll(struct crypto_job *job);
+
+/**
+ * crypto_wait() - Wait for a job to finish
+ *
+ * @job:	Job passed to crypto_submit()
+ * @return the result of the job, or -ETIMEDOUT if the device did not
+ *	finish it
+ */
+int crypto_wait(struct crypto_job *job);
+
+/**
+ * crypto_run() - Run a job on a device and wait for it
+ *
+ * @job:	Job to run
+ * @return as for crypto_submit() if the job cannot be queued, else as for
+ *	crypto_wait()
+ */
+int crypto_run(struct crypto_job *job);
+
+/**
+ * crypto_hash() - Hash a buffer with a crypto device
+ *
+ * @algo_name:	Hash algorithm, e.g. "sha256"
+ * @data:	Data to hash
+ * @len:	Length of the data in bytes
+ * @output:	Returns the digest
+ * @output_size: Size of @output; returns the size of the digest
+ * @return 0 if OK, -ENODEV if no device can do it, other -ve on error
+ */
+int crypto_hash(const char *algo_name, const void *data, uint len,
+		uint8_t *output, int *output_size);
+
+/**
+ * crypto_job_done() - Tell the uclass that a job is finished
+ *
+ * This is for drivers: it takes the job off the device's queue.
+ *
+ * @job:	Finished job
+ * @ret:	Result of the job: 0 or -ve error
+ */
+void crypto_job_done(struct crypto_job *job, int ret);
+
+/**
+ * crypto_get_queue() - Get a device's queue of unfinished jobs
+ *
+ * This is for drivers, which may walk the list with list_for_each_entry()
+ * over the jobs' @node fields.
+ *
+ * @dev:	Crypto device
+ * @return list of jobs, oldest first
+ */
+struct list_head *crypto_get_queue(struct udevice *dev);
+
+#endif /* _CRYPTO_H_ */
@@ -30,8 +30,12 @@ struct lmb;
 #define IMAGE_ENABLE_OF_LIBFDT	1
 #define CONFIG_FIT_VERBOSE	1 /* enable fit_format_{error,warning}() */
 #define CONFIG_FIT_ENABLE_SHA256_SUPPORT
+#define CONFIG_FIT_ENABLE_SHA384_SUPPORT
+#define CONFIG_FIT_ENABLE_SHA512_SUPPORT
 #define CONFIG_SHA1
 #define CONFIG_SHA256
+#define CONFIG_SHA384
+#define CONFIG_SHA512
 
 #define IMAGE_ENABLE_IGNORE	0
 #define IMAGE_INDENT_STRING	""
@@ -91,6 +95,18 @@ struct lmb;
 #define IMAGE_ENABLE_SHA256	0
 #endif
 
+#if defined(CONFIG_FIT_ENABLE_SHA384_SUPPORT)
+#define IMAGE_ENABLE_SHA384	1
+#else
+#define IMAGE_ENABLE_SHA384	0
+#endif
+
+#if defined(CONFIG_FIT_ENABLE_SHA512_SUPPORT)
+#define IMAGE_ENABLE_SHA512	1
+#else
+#define IMAGE_ENABLE_SHA512	0
+#endif
+
 #endif /* IMAGE_ENABLE_FIT */
 
 #ifdef CONFIG_SYS_BOOT_GET_CMDLINE
@@ -288,6 +304,7 @@ enum {
 	IH_COMP_LZMA,			/* lzma  Compression Used	*/
 	IH_COMP_LZO,			/* lzo   Compression Used	*/
 	IH_COMP_LZ4,			/* lz4   Compression Used	*/
+	IH_COMP_ZSTD,			/* zstd  Compression Used	*/
 
 	IH_COMP_COUNT,
 };
@@ -885,11 +902,17 @@ int bootz_setup(ulong image, ulong *start, ulong *end);
 #define FIT_IGNORE_PROP		"uboot-ignore"
 #define FIT_SIG_NODENAME	"signature"
 
+/* cipher node */
+#define FIT_CIPHER_NODENAME	"cipher"
+#define FIT_KEY_HINT_PROP	"key-name-hint"
+#define FIT_IV_PROP		"iv"
+
 /* image node */
 #define FIT_DATA_PROP		"data"
 #define FIT_DATA_POSITION_PROP	"data-position"
 #define FIT_DATA_OFFSET_PROP	"data-offset"
 #define FIT_DATA_SIZE_PROP	"data-size"
+#define FIT_DATA_SIZE_UNCIPHERED_PROP	"data-size-unciphered"
 #define FIT_TIMESTAMP_PROP	"timestamp"
 #define FIT_DESC_PROP		"description"
 #define FIT_ARCH_PROP		"arch"
@@ -1038,6 +1061,337 @@ int fit_check_ramdisk(const void *fit, int os_noffset,
 int calculate_hash(const void *data, int data_len, const char *algo,
 			uint8_t *value, int *value_len);
 
+#if defined(CONFIG_FIT_STREAM_VERIFY) && !defined(CONFIG_SPL_BUILD) && \
+	!defined(USE_HOSTCC)
+/**
+ * fit_stream_start() - Start hashing a FIT while it is loaded
+ *
+ * Called by a loader before it reads an image to @buf. Nothing is done if
+ * the image turns out not to be a FIT.
+ *
+ * @buf:	Where the image is being loaded
+ */
+void fit_stream_start(const void *buf);
+
+/**
+ * fit_stream_update() - Report data which has landed in memory
+ *
+ * Called by the layers under a loader (block drivers, tftp) for each chunk
+ * they have read. Chunks which are not at the end of what has landed so far
+ * (including those for other buffers) are ignored, except that a chunk which
+ * rewrites data that has already landed drops the hashes taken so far.
+ *
+ * @data:	Chunk that has been read
+ * @len:	Size of the chunk in bytes
+ */
+void fit_stream_update(const void *data, ulong len);
+
+/**
+ * fit_stream_end() - Finish hashing a FIT while it is loaded
+ *
+ * @size:	Number of bytes loaded to the buffer given to
+ *		fit_stream_start(), or 0 if loading failed
+ */
+void fit_stream_end(ulong size);
+
+/**
+ * fit_stream_get_hash() - Get a hash taken while the FIT was loaded
+ *
+ * This only succeeds in the command that loaded the FIT or the one after it,
+ * and only once for each subimage.
+ *
+ * @data:	Subimage data within the FIT
+ * @size:	Size of the subimage data
+ * @algo:	Hash algorithm name, as for calculate_hash()
+ * @value:	Returns the hash, or NULL to only check whether it is there
+ *		without using it up
+ * @value_len:	Returns the length of the hash in bytes
+ * @return 0 if OK, -ENOENT if there is no such hash
+ */
+int fit_stream_get_hash(const void *data, size_t size, const char *algo,
+			uint8_t *value, int *value_len);
+
+/**
+ * fit_stream_invalidate() - Drop hashes of images that are being overwritten
+ *
+ * @start:	Start of the memory being written
+ * @len:	Number of bytes being written
+ */
+void fit_stream_invalidate(const void *start, ulong len);
+#else
+static inline void fit_stream_start(const void *buf) {}
+static inline void fit_stream_update(const void *data, ulong len) {}
+static inline void fit_stream_end(ulong size) {}
+static inline int fit_stream_get_hash(const void *data, size_t size,
+				      const char *algo, uint8_t *value,
+				      int *value_len)
+{
+	return -ENOENT;
+}
+static inline void fit_stream_invalidate(const void *start, ulong len) {}
+#endif
+
+#if defined(CONFIG_FIT_HASH_MB) && !defined(CONFIG_SPL_BUILD) && \
+	!defined(USE_HOSTCC)
+/**
+ * fit_mb_hash_images() - Hash several images of a FIT at once
+ *
+ * This hashes the data of each image with a sha256 hash node in one go
+ * with sha256_mb_hash(), for fit_image_check_hash() to pick up through
+ * fit_mb_get_hash().
+ *
+ * @fit:	FIT to look at
+ * @cfg_noffset: Configuration whose images to hash, or -1 for all images
+ */
+void fit_mb_hash_images(const void *fit, int cfg_noffset);
+
+/**
+ * fit_mb_get_hash() - Get a hash taken by fit_mb_hash_images()
+ *
+ * This only succeeds in the command that called fit_mb_hash_images(), and
+ * only once for each image.
+ *
+ * @data:	Image data within the FIT
+ * @size:	Size of the image data
+ * @algo:	Hash algorithm name, as for calculate_hash()
+ * @value:	Returns the hash
+ * @value_len:	Returns the length of the hash in bytes
+ * @return 0 if OK, -ENOENT if there is no such hash
+ */
+int fit_mb_get_hash(const void *data, size_t size, const char *algo,
+		    uint8_t *value, int *value_len);
+
+/**
+ * fit_mb_invalidate() - Drop hashes of images that are being overwritten
+ *
+ * @start:	Start of the memory being written
+ * @len:	Number of bytes being written
+ */
+void fit_mb_invalidate(const void *start, ulong len);
+#else
+static inline void fit_mb_hash_images(const void *fit, int cfg_noffset) {}
+static inline int fit_mb_get_hash(const void *data, size_t size,
+				  const char *algo, uint8_t *value,
+				  int *value_len)
+{
+	return -ENOENT;
+}
+static inline void fit_mb_invalidate(const void *start, ulong len) {}
+#endif
+
+#if defined(CONFIG_FIT_HASH_OFFLOAD) && !defined(CONFIG_SPL_BUILD) && \
+	!defined(USE_HOSTCC)
+/**
+ * fit_offload_hash_images() - Start hashing the images of a FIT
+ *
+ * This submits a crypto job for each hash node of each image, where a
+ * crypto engine will take it, for fit_image_check_hash() to pick up through
+ * fit_offload_get_hash(). Any jobs from before are waited for first.
+ *
+ * @fit:	FIT to look at
+ * @cfg_noffset: Configuration whose images to hash, or -1 for all images
+ */
+void fit_offload_hash_images(const void *fit, int cfg_noffset);
+
+/**
+ * fit_offload_get_hash() - Get a hash from fit_offload_hash_images()
+ *
+ * This waits for the job if it is still running. It only succeeds in the
+ * command that called fit_offload_hash_images(), and only once for each
+ * image and algorithm.
+ *
+ * @data:	Image data within the FIT
+ * @size:	Size of the image data
+ * @algo:	Hash algorithm name, as for calculate_hash()
+ * @value:	Returns the hash, or NULL to just check that there is a job
+ * @value_len:	Returns the length of the hash in bytes
+ * @return 0 if OK, -ENOENT if there is no such hash
+ */
+int fit_offload_get_hash(const void *data, size_t size, const char *algo,
+			 uint8_t *value, int *value_len);
+
+/**
+ * fit_offload_invalidate() - Drop hashes of images that are being overwritten
+ *
+ * This waits for any job still reading the memory.
+ *
+ * @start:	Start of the memory being written
+ * @len:	Number of bytes being written
+ */
+void fit_offload_invalidate(const void *start, ulong len);
+#else
+static inline void fit_offload_hash_images(const void *fit, int cfg_noffset)
+{
+}
+static inline int fit_offload_get_hash(const void *data, size_t size,
+				       const char *algo, uint8_t *value,
+				       int *value_len)
+{
+	return -ENOENT;
+}
+static inline void fit_offload_invalidate(const void *start, ulong len) {}
+#endif
+
+struct blk_desc;
+
+#if defined(CONFIG_FIT_VERIFY_CACHE) && !defined(CONFIG_SPL_BUILD) && \
+	!defined(USE_HOSTCC)
+/**
+ * fit_cache_load_start() - Note where a loader is reading a FIT from
+ *
+ * Called by a loader before it reads from a block device to @buf. This is
+ * harmless if the data turns out not to be a FIT.
+ *
+ * @buf:	Buffer being loaded
+ * @desc:	Block device being read
+ * @part:	Partition number, 0 for the whole device
+ * @path:	File being read, or NULL for a raw read
+ * @offset:	Offset in the file or partition of the first byte read
+ */
+void fit_cache_load_start(const void *buf, struct blk_desc *desc, int part,
+			  const char *path, loff_t offset);
+
+/**
+ * fit_cache_load_end() - Finish reading a FIT from a block device
+ *
+ * @size:	Number of bytes read to the buffer passed to
+ *		fit_cache_load_start(), or 0 if loading failed
+ */
+void fit_cache_load_end(ulong size);
+
+/**
+ * fit_cache_get_hash() - Get a cached hash of image data
+ *
+ * This only succeeds in the command after the one that loaded the FIT,
+ * while nothing has written to the storage the image data came from.
+ *
+ * @data:	Image data within the FIT
+ * @size:	Size of the image data
+ * @algo:	Hash algorithm name, as for calculate_hash()
+ * @value:	Returns the hash, or NULL to just check that there is one
+ * @value_len:	Returns the length of the hash in bytes
+ * @return 0 if OK, -ENOENT if there is no such hash
+ */
+int fit_cache_get_hash(const void *data, size_t size, const char *algo,
+		       uint8_t *value, int *value_len);
+
+/**
+ * fit_cache_add() - Remember the hash of image data that was checked
+ *
+ * Nothing is added unless it is known where the data was loaded from.
+ *
+ * @data:	Image data within the FIT
+ * @size:	Size of the image data
+ * @algo:	Hash algorithm name
+ * @value:	Hash, which matched the image's hash node
+ * @value_len:	Length of the hash in bytes
+ */
+void fit_cache_add(const void *data, size_t size, const char *algo,
+		   const uint8_t *value, int value_len);
+
+/**
+ * fit_cache_invalidate() - Forget where memory being overwritten came from
+ *
+ * @start:	Start of the memory being written
+ * @len:	Number of bytes being written
+ */
+void fit_cache_invalidate(const void *start, ulong len);
+
+/**
+ * fit_cache_clear() - Drop all cached hashes
+ */
+void fit_cache_clear(void);
+
+#else
+static inline void fit_cache_load_start(const void *buf,
+					struct blk_desc *desc, int part,
+					const char *path, loff_t offset) {}
+static inline void fit_cache_load_end(ulong size) {}
+static inline int fit_cache_get_hash(const void *data, size_t size,
+				     const char *algo, uint8_t *value,
+				     int *value_len)
+{
+	return -ENOENT;
+}
+static inline void fit_cache_add(const void *data, size_t size,
+				 const char *algo, const uint8_t *value,
+				 int value_len) {}
+static inline void fit_cache_invalidate(const void *start, ulong len) {}
+#endif
+
+#if defined(CONFIG_FIT_CIPHER) && !defined(CONFIG_SPL_BUILD) && \
+	!defined(USE_HOSTCC)
+struct cipher_algo {
+	const char *name;	/* Name of algorithm, e.g. "aes128" */
+	int key_len;		/* Key length in bytes */
+	int iv_len;		/* IV or initial counter length in bytes */
+	int block_len;		/* Ciphertext is a multiple of this */
+
+	/**
+	 * decrypt() - Decrypt image data
+	 *
+	 * @key:	Key, key_len bytes
+	 * @iv:		IV or initial counter, iv_len bytes
+	 * @src:	Data to decrypt
+	 * @dst:	Buffer for the result, which may be @src
+	 * @len:	Number of bytes to decrypt
+	 */
+	void (*decrypt)(const uint8_t *key, const uint8_t *iv,
+			const void *src, void *dst, size_t len);
+};
+
+/**
+ * image_get_cipher_algo() - Look up a cipher algorithm
+ *
+ * @name:	Name of algorithm, e.g. "aes128"
+ * @return pointer to algorithm information, or NULL if not found
+ */
+struct cipher_algo *image_get_cipher_algo(const char *name);
+
+/**
+ * fit_image_decrypt() - Decrypt the data of an image with a cipher node
+ *
+ * The image's cipher node gives the algorithm, the name of the key and the
+ * IV. The key itself is in the U-Boot device tree, as the "key" property
+ * of /cipher/key-<algo>-<key-name-hint>. The data is checked against the
+ * image's hashes and signatures before it is decrypted, so those are taken
+ * over the encrypted data.
+ *
+ * @fit:	FIT containing the image
+ * @noffset:	Image node
+ * @src:	Encrypted image data
+ * @size:	Size of @src in bytes
+ * @dst:	Buffer for the decrypted data, at least @size bytes, which may
+ *		be @src or overlap it
+ * @lenp:	Returns the length of the decrypted data, which is smaller
+ *		than @size if the image has a data-size-unciphered property
+ * @return 0 if OK, -ve on error
+ */
+int fit_image_decrypt(const void *fit, int noffset, const void *src,
+		      size_t size, void *dst, ulong *lenp);
+
+/**
+ * fit_image_is_ciphered() - Check whether an image has a cipher node
+ *
+ * @fit:	FIT containing the image
+ * @noffset:	Image node
+ * @return 1 if the image data must be decrypted, else 0
+ */
+int fit_image_is_ciphered(const void *fit, int noffset);
+#else
+static inline int fit_image_is_ciphered(const void *fit, int noffset)
+{
+	return 0;
+}
+
+static inline int fit_image_decrypt(const void *fit, int noffset,
+				    const void *src, size_t size, void *dst,
+				    ulong *lenp)
+{
+	return -ENOSYS;
+}
+#endif
+
 /*
  * At present we only support signing on the host, and verification on the
  * device
@@ -122,6 +122,12 @@ typedef struct {
  */
 #define UART_FIFO_TIMEOUT       10  // 10 ms (it takes < 1 ms to send 64 bytes at MAX baud rate)
 
+#ifdef CONFIG_NAI_ZYNQ_SLAVE_PIPELINE_DEPTH
+#define SLAVE_PIPELINE_DEPTH    CONFIG_NAI_ZYNQ_SLAVE_PIPELINE_DEPTH
+#else
+#define SLAVE_PIPELINE_DEPTH    2   // read requests in flight (each request frame is < 32 bytes)
+#endif
+
 #ifndef TRUE
     #define TRUE		1
 #endif
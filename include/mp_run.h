@@ -0,0 +1,67 @@
+/*
+ * Run functions on secondary CPUs
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#ifndef __MP_RUN_H
+#define __MP_RUN_H
+
+#include <linux/errno.h>
+
+#if defined(CONFIG_MP_RUN) && !defined(CONFIG_SPL_BUILD)
+/**
+ * mp_run_count() - Get the number of CPUs which can run functions
+ *
+ * @return number of CPUs including the one running U-Boot, so 1 if there
+ * are no secondary CPUs that can be used
+ */
+int mp_run_count(void);
+
+/**
+ * mp_run_start() - Start a function on a secondary CPU
+ *
+ * The function runs with U-Boot's memory map and global data, but only on a
+ * small stack and without the watchdog, console, malloc() or any driver,
+ * none of which may be used from two CPUs at once. So it should only
+ * compute on memory it has been given. Each call must be followed by
+ * mp_run_wait() for the same CPU.
+ *
+ * @cpu:	CPU to use, from 1 to mp_run_count() - 1
+ * @func:	Function to run
+ * @arg:	Argument to pass to @func
+ * @return 0 if OK, -ve on error, in which case @func has not been started
+ */
+int mp_run_start(int cpu, void (*func)(void *arg), void *arg);
+
+/**
+ * mp_run_wait() - Wait for a function started on a secondary CPU to return
+ *
+ * The CPU is given four times as long as passed between mp_run_start() and
+ * this call, and at least a second, so callers should do their own share of
+ * the work before waiting. A CPU which does not start or finish in time is
+ * not used again, and the caller should do its work itself.
+ *
+ * @cpu:	CPU passed to mp_run_start()
+ * @return 0 if OK, -ETIMEDOUT if the CPU did not start running the function
+ * or did not return from it in time
+ */
+int mp_run_wait(int cpu);
+#else
+static inline int mp_run_count(void)
+{
+	return 1;
+}
+
+static inline int mp_run_start(int cpu, void (*func)(void *arg), void *arg)
+{
+	return -ENOSYS;
+}
+
+static inline int mp_run_wait(int cpu)
+{
+	return -ENOSYS;
+}
+#endif
+
+#endif /* __MP_RUN_H */
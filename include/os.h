@@ -330,4 +330,36 @@ int os_spl_to_uboot(const char *fname);
  */
 void os_localtime(struct rtc_time *rt);
 
+/**
+ * os_get_cpu_count() - Get the number of CPUs the host has online
+ *
+ * @return number of CPUs, at least 1
+ */
+int os_get_cpu_count(void);
+
+/* Number of threads that can be running at once, see os_thread_start() */
+#define OS_MAX_THREADS	8
+
+/**
+ * os_thread_start() - Run a function in a new host thread
+ *
+ * The function must not call anything in sandbox which is not thread-safe,
+ * which is nearly everything but plain computation on memory.
+ *
+ * @id:		Thread slot to use, 0 to OS_MAX_THREADS - 1
+ * @func:	Function to run
+ * @arg:	Argument to pass to @func
+ * @return 0 if OK, -EINVAL if the slot is invalid or busy, -EAGAIN if the
+ * thread could not be created
+ */
+int os_thread_start(int id, void (*func)(void *arg), void *arg);
+
+/**
+ * os_thread_join() - Wait for a thread started by os_thread_start()
+ *
+ * @id:		Thread slot passed to os_thread_start()
+ * @return 0 if OK, -EINVAL if no thread is running in that slot
+ */
+int os_thread_join(int id);
+
 #endif
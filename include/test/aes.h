@@ -0,0 +1,13 @@
+/*
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#ifndef __TEST_AES_H__
+#define __TEST_AES_H__
+
+#include <test/test.h>
+
+/* Declare a new AES test */
+#define AES_TEST(_name, _flags)	UNIT_TEST(_name, _flags, aes_test)
+
+#endif /* __TEST_AES_H__ */
@@ -0,0 +1,13 @@
+/*
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#ifndef __TEST_CRC32_H__
+#define __TEST_CRC32_H__
+
+#include <test/test.h>
+
+/* Declare a new CRC32 test */
+#define CRC32_TEST(_name, _flags)	UNIT_TEST(_name, _flags, crc32_test)
+
+#endif /* __TEST_CRC32_H__ */
@@ -0,0 +1,13 @@
+/*
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#ifndef __TEST_ECDSA_H__
+#define __TEST_ECDSA_H__
+
+#include <test/test.h>
+
+/* Declare a new ECDSA test */
+#define ECDSA_TEST(_name, _flags)	UNIT_TEST(_name, _flags, ecdsa_test)
+
+#endif /* __TEST_ECDSA_H__ */
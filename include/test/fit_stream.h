@@ -0,0 +1,14 @@
+/*
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#ifndef __TEST_FIT_STREAM_H__
+#define __TEST_FIT_STREAM_H__
+
+#include <test/test.h>
+
+/* Declare a new test for hashing FIT images while they are loaded */
+#define FIT_STREAM_TEST(_name, _flags) \
+	UNIT_TEST(_name, _flags, fit_stream_test)
+
+#endif /* __TEST_FIT_STREAM_H__ */
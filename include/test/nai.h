@@ -0,0 +1,13 @@
+/*
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#ifndef __TEST_NAI_H__
+#define __TEST_NAI_H__
+
+#include <test/test.h>
+
+/* Declare a new NAI serdes test */
+#define NAI_TEST(_name, _flags)	UNIT_TEST(_name, _flags, nai_test)
+
+#endif /* __TEST_NAI_H__ */
@@ -0,0 +1,13 @@
+/*
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#ifndef __TEST_RSA_H__
+#define __TEST_RSA_H__
+
+#include <test/test.h>
+
+/* Declare a new RSA test */
+#define RSA_TEST(_name, _flags)	UNIT_TEST(_name, _flags, rsa_test)
+
+#endif /* __TEST_RSA_H__ */
@@ -0,0 +1,13 @@
+/*
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#ifndef __TEST_SHA256_H__
+#define __TEST_SHA256_H__
+
+#include <test/test.h>
+
+/* Declare a new SHA256 test */
+#define SHA256_TEST(_name, _flags)	UNIT_TEST(_name, _flags, sha256_test)
+
+#endif /* __TEST_SHA256_H__ */
@@ -0,0 +1,13 @@
+/*
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#ifndef __TEST_SHA512_H__
+#define __TEST_SHA512_H__
+
+#include <test/test.h>
+
+/* Declare a new SHA512 test */
+#define SHA512_TEST(_name, _flags)	UNIT_TEST(_name, _flags, sha512_test)
+
+#endif /* __TEST_SHA512_H__ */
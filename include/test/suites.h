@@ -28,6 +28,15 @@ int do_ut_dm(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[]);
 int do_ut_env(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[]);
 int do_ut_overlay(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[]);
 int do_ut_time(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[]);
+int do_ut_crc32(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[]);
+int do_ut_sha256(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[]);
+int do_ut_sha512(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[]);
+int do_ut_rsa(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[]);
+int do_ut_ecdsa(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[]);
+int do_ut_aes(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[]);
+int do_ut_fit_stream(cmd_tbl_t *cmdtp, int flag, int argc,
+		     char * const argv[]);
+int do_ut_nai(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[]);
 int do_ut_compression(cmd_tbl_t *cmdtp, int flag, int argc, char *const argv[]);
 
 #endif /* __TEST_SUITES_H__ */
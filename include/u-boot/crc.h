@@ -17,6 +17,54 @@ uint32_t crc32 (uint32_t, const unsigned char *, uint);
 uint32_t crc32_wd (uint32_t, const unsigned char *, uint, uint);
 uint32_t crc32_no_comp (uint32_t, const unsigned char *, uint);
 
+/**
+ * enum crc32_engine - CRC32 implementations available in lib/crc32.c
+ *
+ * crc32() and crc32_no_comp() always use the fastest one present; these
+ * are only needed to compare them against each other.
+ *
+ * @CRC32_ENGINE_TABLE:		one crc_table lookup per byte
+ * @CRC32_ENGINE_SLICE8:	slice-by-8 tables (CONFIG_CRC32_SLICE_BY_8)
+ * @CRC32_ENGINE_ARMV8:		ARMv8 CRC32 instructions (CONFIG_CRC32_ARMV8)
+ * @CRC32_ENGINE_PMULL:		ARMv8 PMULL folding (CONFIG_CRC32_PMULL)
+ * @CRC32_ENGINE_PCLMUL:	x86 PCLMULQDQ folding in sandbox
+ *				(CONFIG_CRC32_PCLMUL)
+ */
+enum crc32_engine {
+	CRC32_ENGINE_TABLE,
+	CRC32_ENGINE_SLICE8,
+	CRC32_ENGINE_ARMV8,
+	CRC32_ENGINE_PMULL,
+	CRC32_ENGINE_PCLMUL,
+
+	CRC32_ENGINE_COUNT,
+};
+
+/**
+ * crc32_engine_supported - Check whether a CRC32 engine can be used
+ *
+ * This applies to crc32c_engine() as well.
+ *
+ * @engine:	Engine to check
+ * @return 1 if it is built in and the CPU supports it, else 0
+ */
+int crc32_engine_supported(enum crc32_engine engine);
+
+/**
+ * crc32_engine - Calculate a CRC32 with a specific engine
+ *
+ * This gives the same result as crc32(). An engine that is not supported
+ * falls back to CRC32_ENGINE_TABLE.
+ *
+ * @engine:	Engine to use
+ * @crc:	Starting CRC (0, or the result of a previous call)
+ * @buf:	Data to checksum
+ * @len:	Number of bytes in @buf
+ * @return updated CRC
+ */
+uint32_t crc32_engine(enum crc32_engine engine, uint32_t crc,
+		      const unsigned char *buf, uint len);
+
 /**
  * crc32_wd_buf - Perform CRC32 on a buffer and return result in buffer
  *
@@ -28,8 +76,66 @@ uint32_t crc32_no_comp (uint32_t, const unsigned char *, uint);
 void crc32_wd_buf(const unsigned char *input, uint ilen,
 		    unsigned char *output, uint chunk_sz);
 
+/**
+ * struct crc32_fold_consts - Constants for carry-less multiply folding
+ *
+ * Each is a power of x modulo the CRC polynomial P, bit-reflected to match
+ * the data. The layout is shared with the arch code.
+ *
+ * @fold4:	x^(512 + 32) and x^(512 - 32), to fold four lanes by 64 bytes
+ * @fold1:	x^(128 + 32) and x^(128 - 32), to fold one lane by 16 bytes
+ * @fold32:	x^64, to reduce 96 bits to 64; the second word is 0
+ * @barrett:	P and x^64 / P, for the final Barrett reduction
+ */
+struct crc32_fold_consts {
+	uint64_t fold4[2];
+	uint64_t fold1[2];
+	uint64_t fold32[2];
+	uint64_t barrett[2];
+};
+
+/*
+ * Folding from arch code, for lib/crc32.c and lib/crc32c.c. @crc has no
+ * ones complement and @len is a multiple of 16, at least 64.
+ */
+uint32_t crc32_pmull_fold(uint32_t crc, const unsigned char *buf, size_t len,
+			  const struct crc32_fold_consts *consts);
+uint32_t crc32_pclmul_fold(uint32_t crc, const unsigned char *buf, size_t len,
+			   const struct crc32_fold_consts *consts);
+
 /* lib/crc32c.c */
 void crc32c_init(uint32_t *, uint32_t);
-uint32_t crc32c_cal(uint32_t, const char *, int, uint32_t *);
+
+/**
+ * crc32c_cal - Calculate a CRC32C without ones complement
+ *
+ * If @crc32c_table is the Castagnoli table from crc32c_init(), the fastest
+ * CRC32C engine is used and the table is not read. Any other table is used
+ * a byte at a time.
+ *
+ * @crc:	Starting CRC
+ * @data:	Data to checksum
+ * @length:	Number of bytes in @data
+ * @crc32c_table: Table from crc32c_init()
+ * @return updated CRC
+ */
+uint32_t crc32c_cal(uint32_t crc, const char *data, int length,
+		    uint32_t *crc32c_table);
+
+/**
+ * crc32c_engine - Calculate a CRC32C with a specific engine
+ *
+ * This gives the same result as crc32c_cal() with the Castagnoli table, so
+ * also has no ones complement. An engine that is not supported falls back
+ * to CRC32_ENGINE_TABLE.
+ *
+ * @engine:	Engine to use
+ * @crc:	Starting CRC
+ * @buf:	Data to checksum
+ * @len:	Number of bytes in @buf
+ * @return updated CRC
+ */
+uint32_t crc32c_engine(enum crc32_engine engine, uint32_t crc,
+		       const unsigned char *buf, uint len);
 
 #endif /* _UBOOT_CRC_H */
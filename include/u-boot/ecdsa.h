@@ -0,0 +1,111 @@
+/*
+ * ECDSA signing and verification of FIT images
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#ifndef _ECDSA_H
+#define _ECDSA_H
+
+#include <errno.h>
+#include <image.h>
+
+/* Signatures are r and s, each as a big endian 32-byte number */
+#define ECDSA256_BYTES	(2 * 256 / 8)
+
+#ifdef USE_HOSTCC
+# define IMAGE_ENABLE_ECDSA	IMAGE_ENABLE_VERIFY
+#else
+# define IMAGE_ENABLE_ECDSA	(IMAGE_ENABLE_VERIFY && CONFIG_IS_ENABLED(ECDSA))
+#endif
+
+struct image_sign_info;
+
+#if IMAGE_ENABLE_SIGN
+/**
+ * ecdsa_sign() - Calculate and return signature for given input data
+ *
+ * @info:	Specifies key and FIT information
+ * @data:	Pointer to the input data
+ * @data_len:	Data length
+ * @sigp:	Set to an allocated buffer holding the signature
+ * @sig_len:	Set to length of the calculated hash
+ *
+ * This computes the hash of the data with the checksum algorithm and signs
+ * it with the private key in <keydir>/<keyname>.key. The signature is r
+ * followed by s, ECDSA256_BYTES in all. The caller should free *sigp.
+ *
+ * @return: 0, on success, -ve on error
+ */
+int ecdsa_sign(struct image_sign_info *info,
+	       const struct image_region region[],
+	       int region_count, uint8_t **sigp, uint *sig_len);
+
+/**
+ * ecdsa_add_verify_data() - Add verification information to FDT
+ *
+ * Add public key information to the FDT node, suitable for verification at
+ * run-time. The key is taken from the same file as ecdsa_sign() uses.
+ *
+ * @info:	Specifies key and FIT information
+ * @keydest:	Destination FDT blob for public key data
+ * @return: 0, on success, -ENOSPC if the keydest FDT blob ran out of space,
+		other -ve value on error
+*/
+int ecdsa_add_verify_data(struct image_sign_info *info, void *keydest);
+#else
+static inline int ecdsa_sign(struct image_sign_info *info,
+		const struct image_region region[], int region_count,
+		uint8_t **sigp, uint *sig_len)
+{
+	return -ENXIO;
+}
+
+static inline int ecdsa_add_verify_data(struct image_sign_info *info,
+					void *keydest)
+{
+	return -ENXIO;
+}
+#endif
+
+#if IMAGE_ENABLE_ECDSA
+/**
+ * ecdsa_verify() - Verify a signature against some data
+ *
+ * Verify an ECDSA P-256 signature against an expected hash, with the keys
+ * in the FDT that have an "ecdsa,curve" of "prime256v1".
+ *
+ * @info:	Specifies key and FIT information
+ * @data:	Pointer to the input data
+ * @data_len:	Data length
+ * @sig:	Signature
+ * @sig_len:	Number of bytes in signature
+ * @return 0 if verified, -ve on error
+ */
+int ecdsa_verify(struct image_sign_info *info,
+		 const struct image_region region[], int region_count,
+		 uint8_t *sig, uint sig_len);
+
+/**
+ * p256_ecdsa_verify() - Check an ECDSA signature on the P-256 curve
+ *
+ * @hash:	Hash of the signed data
+ * @hash_len:	Length of @hash in bytes; only the first 32 are used
+ * @qx:		x coordinate of the public key, big endian, 32 bytes
+ * @qy:		y coordinate of the public key, big endian, 32 bytes
+ * @sig:	Signature, r then s, ECDSA256_BYTES in all
+ * @return 0 if the signature is good, -EACCES if it is not, -EINVAL if
+ * the key or signature is not valid at all
+ */
+int p256_ecdsa_verify(const uint8_t *hash, int hash_len, const uint8_t *qx,
+		      const uint8_t *qy, const uint8_t *sig);
+#else
+static inline int ecdsa_verify(struct image_sign_info *info,
+		const struct image_region region[], int region_count,
+		uint8_t *sig, uint sig_len)
+{
+	return -ENXIO;
+}
+#endif
+
+#endif
@@ -27,11 +27,22 @@ struct key_prop {
 	uint32_t exp_len;	/* Exponent length in number of uint8_t */
 };
 
+/* Software implementations of rsa_mod_exp_sw() */
+enum rsa_mod_exp_engine {
+	RSA_MOD_EXP_ENGINE_BASIC,	/* 32-bit words, bit by bit */
+	RSA_MOD_EXP_ENGINE_FAST,	/* Native words, sliding window */
+
+	RSA_MOD_EXP_ENGINE_COUNT,
+};
+
 /**
  * rsa_mod_exp_sw() - Perform RSA Modular Exponentiation in sw
  *
  * Operation: out[] = sig ^ exponent % modulus
  *
+ * This uses the fast engine for any key that is a whole number of its
+ * words long, which covers all key sizes that mkimage produces.
+ *
  * @sig:	RSA PKCS1.5 signature
  * @sig_len:	Length of signature in number of bytes
  * @node:	Node with RSA key elements like modulus, exponent, R^2, n0inv
@@ -40,6 +51,24 @@ struct key_prop {
 int rsa_mod_exp_sw(const uint8_t *sig, uint32_t sig_len,
 		struct key_prop *node, uint8_t *out);
 
+/**
+ * rsa_mod_exp_sw_engine() - Perform RSA Modular Exponentiation with an engine
+ *
+ * This is rsa_mod_exp_sw() with the choice of engine left to the caller, so
+ * that tests can compare them.
+ *
+ * @engine:	Engine to use
+ * @sig:	RSA PKCS1.5 signature
+ * @sig_len:	Length of signature in number of bytes
+ * @node:	Node with RSA key elements like modulus, exponent, R^2, n0inv
+ * @out:	Result in form of byte array of len equal to sig_len
+ * @return 0 if OK, -EINVAL if the fast engine cannot handle the key's
+ * length, other -ve value on error
+ */
+int rsa_mod_exp_sw_engine(enum rsa_mod_exp_engine engine, const uint8_t *sig,
+			  uint32_t sig_len, struct key_prop *node,
+			  uint8_t *out);
+
 int rsa_mod_exp(struct udevice *dev, const uint8_t *sig, uint32_t sig_len,
 		struct key_prop *node, uint8_t *out);
 
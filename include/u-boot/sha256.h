@@ -19,7 +19,112 @@ void sha256_starts(sha256_context * ctx);
 void sha256_update(sha256_context *ctx, const uint8_t *input, uint32_t length);
 void sha256_finish(sha256_context * ctx, uint8_t digest[SHA256_SUM_LEN]);
 
+/**
+ * enum sha256_engine - SHA-256 block implementations in lib/sha256.c
+ *
+ * sha256_update() always uses the fastest one present; these are only
+ * needed to compare them against each other.
+ *
+ * @SHA256_ENGINE_C:		portable C rounds
+ * @SHA256_ENGINE_ARMV8_CE:	ARMv8 Crypto Extensions (CONFIG_SHA256_ARMV8_CE)
+ * @SHA256_ENGINE_SHA_NI:	x86 SHA extensions, sandbox only
+ *				(CONFIG_SHA256_SHA_NI)
+ */
+enum sha256_engine {
+	SHA256_ENGINE_C,
+	SHA256_ENGINE_ARMV8_CE,
+	SHA256_ENGINE_SHA_NI,
+
+	SHA256_ENGINE_COUNT,
+};
+
+/**
+ * sha256_engine_supported - Check whether a SHA-256 engine can be used
+ *
+ * @engine:	Engine to check
+ * @return 1 if it is built in and the CPU supports it, else 0
+ */
+int sha256_engine_supported(enum sha256_engine engine);
+
+/**
+ * sha256_engine_update - Hash more data with a specific engine
+ *
+ * This is sha256_update() with the engine chosen by the caller. Engines
+ * may be mixed on one context. An engine that is not supported falls back
+ * to SHA256_ENGINE_C.
+ *
+ * @engine:	Engine to use
+ * @ctx:	Context from sha256_starts()
+ * @input:	Data to hash
+ * @length:	Number of bytes in @input
+ */
+void sha256_engine_update(enum sha256_engine engine, sha256_context *ctx,
+			  const uint8_t *input, uint32_t length);
+
 void sha256_csum_wd(const unsigned char *input, unsigned int ilen,
 		unsigned char *output, unsigned int chunk_sz);
 
+/**
+ * struct sha256_mb_job - One buffer for sha256_mb_hash()
+ *
+ * @data:	Data to hash
+ * @len:	Number of bytes in @data
+ * @digest:	Returns the SHA-256 of @data
+ */
+struct sha256_mb_job {
+	const uint8_t *data;
+	uint32_t len;
+	uint8_t digest[SHA256_SUM_LEN];
+};
+
+/**
+ * enum sha256_mb_engine - Ways of hashing several buffers in lib/sha256_mb.c
+ *
+ * @SHA256_MB_ENGINE_SERIAL:	one buffer after the other, with the fastest
+ *				sha256_engine
+ * @SHA256_MB_ENGINE_LANES:	four buffers at once in the lanes of vector
+ *				registers, with the C rounds
+ * @SHA256_MB_ENGINE_MP:	buffers spread over all CPUs (CONFIG_MP_RUN),
+ *				each using SERIAL or LANES
+ */
+enum sha256_mb_engine {
+	SHA256_MB_ENGINE_SERIAL,
+	SHA256_MB_ENGINE_LANES,
+	SHA256_MB_ENGINE_MP,
+
+	SHA256_MB_ENGINE_COUNT,
+};
+
+/**
+ * sha256_mb_engine_supported - Check whether a multi-buffer engine can be used
+ *
+ * @engine:	Engine to check
+ * @return 1 if it is built in and usable on this system, else 0
+ */
+int sha256_mb_engine_supported(enum sha256_mb_engine engine);
+
+/**
+ * sha256_mb_engine_hash - Hash several buffers with a specific engine
+ *
+ * An engine that is not supported falls back to SHA256_MB_ENGINE_SERIAL.
+ *
+ * @engine:	Engine to use
+ * @jobs:	Buffers to hash, each gets its digest filled in
+ * @count:	Number of entries in @jobs
+ */
+void sha256_mb_engine_hash(enum sha256_mb_engine engine,
+			   struct sha256_mb_job *jobs, int count);
+
+/**
+ * sha256_mb_hash - Hash several independent buffers
+ *
+ * This gives the same digests as hashing each buffer on its own, but picks
+ * the engine which gets through the whole set fastest, so that the time
+ * taken is closer to that of the largest buffer than to the sum of them.
+ *
+ * @jobs:	Buffers to hash, each gets its digest filled in
+ * @count:	Number of entries in @jobs
+ */
+void sha256_mb_hash(struct sha256_mb_job *jobs, int count);
+
 #endif /* _SHA256_H */
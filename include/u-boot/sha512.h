@@ -0,0 +1,80 @@
+#ifndef _SHA512_H
+#define _SHA512_H
+
+#define SHA384_SUM_LEN	48
+#define SHA384_DER_LEN	19
+#define SHA512_SUM_LEN	64
+#define SHA512_DER_LEN	19
+#define SHA512_BLOCK_SIZE	128
+
+extern const uint8_t sha384_der_prefix[];
+extern const uint8_t sha512_der_prefix[];
+
+/* Reset watchdog each time we process this many bytes */
+#define CHUNKSZ_SHA384	(16 * 1024)
+#define CHUNKSZ_SHA512	(16 * 1024)
+
+typedef struct {
+	uint64_t state[8];
+	uint64_t count[2];
+	uint8_t buf[SHA512_BLOCK_SIZE];
+} sha512_context;
+
+/* SHA384 is SHA512 with other initial values and a truncated digest */
+#define sha384_context	sha512_context
+
+void sha512_starts(sha512_context *ctx);
+void sha512_update(sha512_context *ctx, const uint8_t *input, uint32_t length);
+void sha512_finish(sha512_context *ctx, uint8_t digest[SHA512_SUM_LEN]);
+
+void sha512_csum_wd(const unsigned char *input, unsigned int ilen,
+		unsigned char *output, unsigned int chunk_sz);
+
+void sha384_starts(sha512_context *ctx);
+void sha384_update(sha512_context *ctx, const uint8_t *input, uint32_t length);
+void sha384_finish(sha512_context *ctx, uint8_t digest[SHA384_SUM_LEN]);
+
+void sha384_csum_wd(const unsigned char *input, unsigned int ilen,
+		unsigned char *output, unsigned int chunk_sz);
+
+/**
+ * enum sha512_engine - SHA512 block implementations in lib/sha512.c
+ *
+ * sha512_update() and sha384_update() always use the fastest one present;
+ * these are only needed to compare them against each other.
+ *
+ * @SHA512_ENGINE_C:		portable C rounds on 64-bit words
+ * @SHA512_ENGINE_ARMV8_CE:	ARMv8.2 SHA512 instructions
+ *				(CONFIG_SHA512_ARMV8_CE)
+ */
+enum sha512_engine {
+	SHA512_ENGINE_C,
+	SHA512_ENGINE_ARMV8_CE,
+
+	SHA512_ENGINE_COUNT,
+};
+
+/**
+ * sha512_engine_supported - Check whether a SHA512 engine can be used
+ *
+ * @engine:	Engine to check
+ * @return 1 if it is built in and the CPU supports it, else 0
+ */
+int sha512_engine_supported(enum sha512_engine engine);
+
+/**
+ * sha512_engine_update - Hash more data with a specific engine
+ *
+ * This is sha512_update() with the engine chosen by the caller, for either
+ * a SHA512 or a SHA384 context. Engines may be mixed on one context. An
+ * engine that is not supported falls back to SHA512_ENGINE_C.
+ *
+ * @engine:	Engine to use
+ * @ctx:	Context from sha512_starts() or sha384_starts()
+ * @input:	Data to hash
+ * @length:	Number of bytes in @input
+ */
+void sha512_engine_update(enum sha512_engine engine, sha512_context *ctx,
+			  const uint8_t *input, uint32_t length);
+
+#endif /* _SHA512_H */
@@ -91,6 +91,91 @@ void aes_cbc_encrypt_blocks(u8 *key_exp, u8 *src, u8 *dst, u32 num_aes_blocks);
  */
 void aes_cbc_decrypt_blocks(u8 *key_exp, u8 *src, u8 *dst, u32 num_aes_blocks);
 
+/**
+ * aes_cbc_encrypt() - Encrypt multiple blocks with AES CBC and a given IV
+ *
+ * This is aes_cbc_encrypt_blocks() with an IV, using the fastest engine.
+ *
+ * @key_exp		Expanded key to use
+ * @iv			IV, AES_KEY_LENGTH bytes. This is updated to the last
+ *			block written, so a following call carries on the chain
+ * @src			Source data to encrypt
+ * @dst			Destination buffer, which may be @src
+ * @num_aes_blocks	Number of AES blocks to encrypt
+ */
+void aes_cbc_encrypt(u8 *key_exp, u8 *iv, u8 *src, u8 *dst,
+		     u32 num_aes_blocks);
+
+/**
+ * aes_cbc_decrypt() - Decrypt multiple blocks with AES CBC and a given IV
+ *
+ * @key_exp		Expanded key to use
+ * @iv			IV, AES_KEY_LENGTH bytes. This is updated to the last
+ *			block read, so a following call carries on the chain
+ * @src			Source data to decrypt
+ * @dst			Destination buffer, which may be @src
+ * @num_aes_blocks	Number of AES blocks to decrypt
+ */
+void aes_cbc_decrypt(u8 *key_exp, u8 *iv, u8 *src, u8 *dst,
+		     u32 num_aes_blocks);
+
+/**
+ * aes_ctr_crypt() - Encrypt or decrypt data with AES CTR
+ *
+ * The counter block is a 128-bit big-endian number, incremented once for
+ * each block. A partial last block uses the start of its key stream.
+ *
+ * @key_exp		Expanded key to use
+ * @ctr			Counter block, AES_KEY_LENGTH bytes. This is updated to
+ *			the next unused counter
+ * @src			Source data
+ * @dst			Destination buffer, which may be @src
+ * @len			Number of bytes to process, which need not be a
+ *			multiple of AES_KEY_LENGTH
+ */
+void aes_ctr_crypt(u8 *key_exp, u8 *ctr, u8 *src, u8 *dst, u32 len);
+
+/**
+ * enum aes_engine - AES implementations in lib/aes.c
+ *
+ * The functions above always use the fastest one present; these are only
+ * needed to compare them against each other.
+ *
+ * @AES_ENGINE_BYTE:		byte-wise C rounds, the original code
+ * @AES_ENGINE_TTABLE:		C rounds using 32-bit lookup tables
+ * @AES_ENGINE_ARMV8_CE:	ARMv8 Crypto Extensions (CONFIG_AES_ARMV8_CE)
+ * @AES_ENGINE_AES_NI:		x86 AES instructions, sandbox only
+ *				(CONFIG_AES_NI)
+ */
+enum aes_engine {
+	AES_ENGINE_BYTE,
+	AES_ENGINE_TTABLE,
+	AES_ENGINE_ARMV8_CE,
+	AES_ENGINE_AES_NI,
+
+	AES_ENGINE_COUNT,
+};
+
+/**
+ * aes_engine_supported() - Check whether an AES engine can be used
+ *
+ * @engine	Engine to check
+ * @return 1 if it is built in and the CPU supports it, else 0
+ */
+int aes_engine_supported(enum aes_engine engine);
+
+/*
+ * As aes_cbc_encrypt(), aes_cbc_decrypt() and aes_ctr_crypt(), with the
+ * engine chosen by the caller. An engine that is not supported falls back
+ * to AES_ENGINE_TTABLE.
+ */
+void aes_engine_cbc_encrypt(enum aes_engine engine, u8 *key_exp, u8 *iv,
+			    u8 *src, u8 *dst, u32 num_aes_blocks);
+void aes_engine_cbc_decrypt(enum aes_engine engine, u8 *key_exp, u8 *iv,
+			    u8 *src, u8 *dst, u32 num_aes_blocks);
+void aes_engine_ctr_crypt(enum aes_engine engine, u8 *key_exp, u8 *ctr,
+			  u8 *src, u8 *dst, u32 len);
+
 /**
  * Decrypt the image using hw engine.
  *
@@ -173,10 +173,36 @@ const uint32_t * ZEXPORT get_crc_table()
 
 /* ========================================================================= */
 
+/*
+ * Pick the CRC engines to build. The slice-by-8 tables assume the CRC is
+ * kept in host byte order, so they are only used on little-endian hosts;
+ * big-endian ones keep the word-at-a-time loop below.
+ */
+#if !defined(USE_HOSTCC) && !defined(DYNAMIC_CRC_TABLE) && \
+	__BYTE_ORDER == __LITTLE_ENDIAN
+#if CONFIG_IS_ENABLED(CRC32_SLICE_BY_8)
+#define CRC32_SLICE_BY_8
+#include "crc32table.h"
+#endif
+#if defined(CONFIG_ARM64) && defined(CONFIG_CRC32_ARMV8)
+#define CRC32_ARMV8
+#endif
+#if defined(CONFIG_ARM64) && defined(CONFIG_CRC32_PMULL)
+#define CRC32_PMULL
+#endif
+#if defined(CONFIG_SANDBOX) && defined(CONFIG_CRC32_PCLMUL) && \
+	defined(__x86_64__)
+#define CRC32_PCLMUL
+#endif
+#endif
+
+/* Shorter buffers are not worth setting up the folding for */
+#define CRC32_FOLD_MIN	64
+
 /* No ones complement version. JFFS2 (and other things ?)
  * don't use ones compliment in their CRC calculations.
  */
-uint32_t ZEXPORT crc32_no_comp(uint32_t crc, const Bytef *buf, uInt len)
+local uint32_t crc32_table_no_comp(uint32_t crc, const Bytef *buf, uInt len)
 {
     const uint32_t *tab = crc_table;
     const uint32_t *b =(const uint32_t *)buf;
@@ -218,6 +244,263 @@ uint32_t ZEXPORT crc32_no_comp(uint32_t crc, const Bytef *buf, uInt len)
 }
 #undef DO_CRC
 
+#ifdef CRC32_SLICE_BY_8
+/*
+ * Slice-by-8: fold eight bytes per iteration with one lookup in each of
+ * eight tables, instead of eight dependent lookups in crc_table.
+ */
+local uint32_t crc32_slice8_no_comp(uint32_t crc, const Bytef *buf, uInt len)
+{
+    const uint32_t *b;
+    uint32_t one, two;
+
+    /* Align it */
+    while (len && ((uintptr_t)buf & 3)) {
+	 crc = crc_table[(crc ^ *buf++) & 255] ^ (crc >> 8);
+	 len--;
+    }
+
+    b = (const uint32_t *)buf;
+    for (; len >= 8; len -= 8) {
+	 one = *b++ ^ crc;
+	 two = *b++;
+	 crc = crc_table_slice[6][one & 255] ^
+	       crc_table_slice[5][(one >> 8) & 255] ^
+	       crc_table_slice[4][(one >> 16) & 255] ^
+	       crc_table_slice[3][one >> 24] ^
+	       crc_table_slice[2][two & 255] ^
+	       crc_table_slice[1][(two >> 8) & 255] ^
+	       crc_table_slice[0][(two >> 16) & 255] ^
+	       crc_table[two >> 24];
+    }
+
+    /* And the last few bytes */
+    buf = (const Bytef *)b;
+    while (len--)
+	 crc = crc_table[(crc ^ *buf++) & 255] ^ (crc >> 8);
+
+    return crc;
+}
+#endif
+
+#ifdef CRC32_ARMV8
+/*
+ * The ARMv8 CRC32 instructions use the same reflected polynomial as
+ * crc_table and no ones complement, so they are a drop-in replacement for
+ * the table loop. They are optional in ARMv8.0, so check ID_AA64ISAR0_EL1
+ * rather than assuming them; the check is a single register read, which
+ * keeps it usable before relocation.
+ */
+#define CRC32_ARMV8_INSN(insn, crc, val) \
+	asm(".arch_extension crc\n\t" insn : "+r" (crc) : "r" (val))
+
+local int crc32_armv8_present(void)
+{
+    uint64_t isar0;
+
+    asm volatile("mrs %0, id_aa64isar0_el1" : "=r" (isar0));
+
+    return ((isar0 >> 16) & 0xf) != 0;
+}
+
+local uint32_t crc32_armv8_no_comp(uint32_t crc, const Bytef *buf, uInt len)
+{
+    /* Align it */
+    while (len && ((uintptr_t)buf & 7)) {
+	 CRC32_ARMV8_INSN("crc32b %w0, %w0, %w1", crc, (uint32_t)*buf++);
+	 len--;
+    }
+
+    for (; len >= 8; len -= 8, buf += 8)
+	 CRC32_ARMV8_INSN("crc32x %w0, %w0, %x1", crc,
+			  *(const uint64_t *)buf);
+
+    /* And the last few bytes */
+    if (len & 4) {
+	 CRC32_ARMV8_INSN("crc32w %w0, %w0, %w1", crc, *(const uint32_t *)buf);
+	 buf += 4;
+    }
+    if (len & 2) {
+	 CRC32_ARMV8_INSN("crc32h %w0, %w0, %w1", crc,
+			  (uint32_t)*(const uint16_t *)buf);
+	 buf += 2;
+    }
+    if (len & 1)
+	 CRC32_ARMV8_INSN("crc32b %w0, %w0, %w1", crc, (uint32_t)*buf);
+
+    return crc;
+}
+#endif
+
+/* The fastest engine that needs nothing from the CPU */
+local uint32_t crc32_soft_no_comp(uint32_t crc, const Bytef *buf, uInt len)
+{
+#ifdef CRC32_SLICE_BY_8
+    return crc32_slice8_no_comp(crc, buf, len);
+#else
+    return crc32_table_no_comp(crc, buf, len);
+#endif
+}
+
+#if defined(CRC32_PMULL) || defined(CRC32_PCLMUL)
+/* Constants for the reflected polynomial 0xedb88320 */
+local const struct crc32_fold_consts crc32_fold_consts = {
+    .fold4	= { 0x154442bd4ULL, 0x1c6e41596ULL },
+    .fold1	= { 0x1751997d0ULL, 0x0ccaa009eULL },
+    .fold32	= { 0x163cd6124ULL, 0 },
+    .barrett	= { 0x1db710641ULL, 0x1f7011641ULL },
+};
+#endif
+
+#ifdef CRC32_PMULL
+/*
+ * PMULL folds 64 bytes in a handful of instructions, so beats even the CRC32
+ * instructions on long buffers; those still do the last few bytes if
+ * present. PMULL is optional in the ARMv8.0 Crypto Extensions.
+ */
+local int crc32_pmull_present(void)
+{
+    uint64_t isar0;
+
+    asm volatile("mrs %0, id_aa64isar0_el1" : "=r" (isar0));
+
+    return ((isar0 >> 4) & 0xf) >= 2;
+}
+
+local uint32_t crc32_pmull_no_comp(uint32_t crc, const Bytef *buf, uInt len)
+{
+    uInt bulk = len & ~15;
+
+    if (bulk >= CRC32_FOLD_MIN) {
+	 crc = crc32_pmull_fold(crc, buf, bulk, &crc32_fold_consts);
+	 buf += bulk;
+	 len -= bulk;
+    }
+#ifdef CRC32_ARMV8
+    if (crc32_armv8_present())
+	 return crc32_armv8_no_comp(crc, buf, len);
+#endif
+    return crc32_soft_no_comp(crc, buf, len);
+}
+#endif
+
+#ifdef CRC32_PCLMUL
+/* CPUID traps to the hypervisor when running in a VM, so only ask once */
+local int crc32_pclmul_present(void)
+{
+    static int present = -1;
+    uint32_t eax, ebx, ecx, edx;
+
+    if (present < 0) {
+	 asm volatile("cpuid"
+		      : "=a" (eax), "=b" (ebx), "=c" (ecx), "=d" (edx)
+		      : "a" (1), "c" (0));
+	 present = !!(ecx & (1 << 1));
+    }
+
+    return present;
+}
+
+local uint32_t crc32_pclmul_no_comp(uint32_t crc, const Bytef *buf, uInt len)
+{
+    uInt bulk = len & ~15;
+
+    if (bulk >= CRC32_FOLD_MIN) {
+	 crc = crc32_pclmul_fold(crc, buf, bulk, &crc32_fold_consts);
+	 buf += bulk;
+	 len -= bulk;
+    }
+
+    return crc32_soft_no_comp(crc, buf, len);
+}
+#endif
+
+int crc32_engine_supported(enum crc32_engine engine)
+{
+    switch (engine) {
+    case CRC32_ENGINE_TABLE:
+	 return 1;
+#ifdef CRC32_SLICE_BY_8
+    case CRC32_ENGINE_SLICE8:
+	 return 1;
+#endif
+#ifdef CRC32_ARMV8
+    case CRC32_ENGINE_ARMV8:
+	 return crc32_armv8_present();
+#endif
+#ifdef CRC32_PMULL
+    case CRC32_ENGINE_PMULL:
+	 return crc32_pmull_present();
+#endif
+#ifdef CRC32_PCLMUL
+    case CRC32_ENGINE_PCLMUL:
+	 return crc32_pclmul_present();
+#endif
+    default:
+	 return 0;
+    }
+}
+
+uint32_t crc32_engine(enum crc32_engine engine, uint32_t crc,
+		      const unsigned char *buf, uint len)
+{
+    crc ^= 0xffffffffL;
+
+    switch (engine) {
+#ifdef CRC32_SLICE_BY_8
+    case CRC32_ENGINE_SLICE8:
+	 crc = crc32_slice8_no_comp(crc, buf, len);
+	 break;
+#endif
+#ifdef CRC32_ARMV8
+    case CRC32_ENGINE_ARMV8:
+	 if (crc32_armv8_present()) {
+	      crc = crc32_armv8_no_comp(crc, buf, len);
+	      break;
+	 }
+	 /* fall through */
+#endif
+#ifdef CRC32_PMULL
+    case CRC32_ENGINE_PMULL:
+	 if (crc32_pmull_present()) {
+	      crc = crc32_pmull_no_comp(crc, buf, len);
+	      break;
+	 }
+	 /* fall through */
+#endif
+#ifdef CRC32_PCLMUL
+    case CRC32_ENGINE_PCLMUL:
+	 if (crc32_pclmul_present()) {
+	      crc = crc32_pclmul_no_comp(crc, buf, len);
+	      break;
+	 }
+	 /* fall through */
+#endif
+    default:
+	 crc = crc32_table_no_comp(crc, buf, len);
+	 break;
+    }
+
+    return crc ^ 0xffffffffL;
+}
+
+uint32_t ZEXPORT crc32_no_comp(uint32_t crc, const Bytef *buf, uInt len)
+{
+#ifdef CRC32_PMULL
+    if (crc32_pmull_present())
+	 return crc32_pmull_no_comp(crc, buf, len);
+#endif
+#ifdef CRC32_ARMV8
+    if (crc32_armv8_present())
+	 return crc32_armv8_no_comp(crc, buf, len);
+#endif
+#ifdef CRC32_PCLMUL
+    if (crc32_pclmul_present())
+	 return crc32_pclmul_no_comp(crc, buf, len);
+#endif
+    return crc32_soft_no_comp(crc, buf, len);
+}
+
 uint32_t ZEXPORT crc32 (uint32_t crc, const Bytef *p, uInt len)
 {
      return crc32_no_comp(crc ^ 0xffffffffL, p, len) ^ 0xffffffffL;
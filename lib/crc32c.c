@@ -12,12 +12,202 @@
 
 #include <common.h>
 #include <compiler.h>
+#include <u-boot/crc.h>
+
+/*
+ * The engines are those of lib/crc32.c, with the same config options, and
+ * crc32_engine_supported() says which the CPU has. Callers still pass the
+ * table they built, but crc32c_cal() only reads it for other polynomials.
+ */
+#if __BYTE_ORDER == __LITTLE_ENDIAN
+#if CONFIG_IS_ENABLED(CRC32_SLICE_BY_8)
+#define CRC32C_SLICE_BY_8
+#endif
+#if defined(CONFIG_ARM64) && defined(CONFIG_CRC32_ARMV8)
+#define CRC32C_ARMV8
+#endif
+#endif
+#if defined(CONFIG_ARM64) && defined(CONFIG_CRC32_PMULL)
+#define CRC32C_PMULL
+#endif
+#if defined(CONFIG_SANDBOX) && defined(CONFIG_CRC32_PCLMUL) && \
+	defined(__x86_64__)
+#define CRC32C_PCLMUL
+#endif
+
+#include "crc32ctable.h"
+
+/* Bit-reflected CRC32C polynomial, which crc32c_init() puts in entry 128 */
+#define CRC32C_POLY	0x82f63b78
+
+/* Shorter buffers are not worth setting up the folding for */
+#define CRC32C_FOLD_MIN	64
+
+static uint32_t crc32c_table_no_comp(uint32_t crc, const u8 *buf, uint len)
+{
+	while (len--)
+		crc = crc32c_table[(crc ^ *buf++) & 255] ^ (crc >> 8);
+
+	return crc;
+}
+
+#ifdef CRC32C_SLICE_BY_8
+/* As crc32_slice8_no_comp(), with the CRC32C tables */
+static uint32_t crc32c_slice8_no_comp(uint32_t crc, const u8 *buf, uint len)
+{
+	const uint32_t *b;
+	uint32_t one, two;
+
+	while (len && ((uintptr_t)buf & 3)) {
+		crc = crc32c_table[(crc ^ *buf++) & 255] ^ (crc >> 8);
+		len--;
+	}
+
+	b = (const uint32_t *)buf;
+	for (; len >= 8; len -= 8) {
+		one = *b++ ^ crc;
+		two = *b++;
+		crc = crc32c_table_slice[6][one & 255] ^
+		      crc32c_table_slice[5][(one >> 8) & 255] ^
+		      crc32c_table_slice[4][(one >> 16) & 255] ^
+		      crc32c_table_slice[3][one >> 24] ^
+		      crc32c_table_slice[2][two & 255] ^
+		      crc32c_table_slice[1][(two >> 8) & 255] ^
+		      crc32c_table_slice[0][(two >> 16) & 255] ^
+		      crc32c_table[two >> 24];
+	}
+
+	return crc32c_table_no_comp(crc, (const u8 *)b, len);
+}
+#endif
+
+#ifdef CRC32C_ARMV8
+/* The CRC32 feature in ID_AA64ISAR0_EL1 covers the CRC32C instructions */
+#define CRC32C_ARMV8_INSN(insn, crc, val) \
+	asm(".arch_extension crc\n\t" insn : "+r" (crc) : "r" (val))
+
+static uint32_t crc32c_armv8_no_comp(uint32_t crc, const u8 *buf, uint len)
+{
+	while (len && ((uintptr_t)buf & 7)) {
+		CRC32C_ARMV8_INSN("crc32cb %w0, %w0, %w1", crc,
+				  (uint32_t)*buf++);
+		len--;
+	}
+
+	for (; len >= 8; len -= 8, buf += 8)
+		CRC32C_ARMV8_INSN("crc32cx %w0, %w0, %x1", crc,
+				  *(const uint64_t *)buf);
+
+	for (; len; len--)
+		CRC32C_ARMV8_INSN("crc32cb %w0, %w0, %w1", crc,
+				  (uint32_t)*buf++);
+
+	return crc;
+}
+#endif
+
+/* The fastest engine that needs nothing from the CPU */
+static uint32_t crc32c_soft_no_comp(uint32_t crc, const u8 *buf, uint len)
+{
+#ifdef CRC32C_SLICE_BY_8
+	return crc32c_slice8_no_comp(crc, buf, len);
+#else
+	return crc32c_table_no_comp(crc, buf, len);
+#endif
+}
+
+#if defined(CRC32C_PMULL) || defined(CRC32C_PCLMUL)
+/* Constants for the reflected polynomial 0x82f63b78 */
+static const struct crc32_fold_consts crc32c_fold_consts = {
+	.fold4		= { 0x0740eef02ULL, 0x09e4addf8ULL },
+	.fold1		= { 0x0f20c0dfeULL, 0x14cd00bd6ULL },
+	.fold32		= { 0x0dd45aab8ULL, 0 },
+	.barrett	= { 0x105ec76f1ULL, 0x0dea713f1ULL },
+};
+
+/* Fold the whole 16-byte blocks with @fold, then finish in software */
+static uint32_t crc32c_fold_no_comp(enum crc32_engine engine, uint32_t crc,
+				    const u8 *buf, uint len)
+{
+	uint bulk = len & ~15;
+
+	if (bulk >= CRC32C_FOLD_MIN) {
+#ifdef CRC32C_PMULL
+		if (engine == CRC32_ENGINE_PMULL)
+			crc = crc32_pmull_fold(crc, buf, bulk,
+					       &crc32c_fold_consts);
+#endif
+#ifdef CRC32C_PCLMUL
+		if (engine == CRC32_ENGINE_PCLMUL)
+			crc = crc32_pclmul_fold(crc, buf, bulk,
+						&crc32c_fold_consts);
+#endif
+		buf += bulk;
+		len -= bulk;
+	}
+#ifdef CRC32C_ARMV8
+	if (crc32_engine_supported(CRC32_ENGINE_ARMV8))
+		return crc32c_armv8_no_comp(crc, buf, len);
+#endif
+
+	return crc32c_soft_no_comp(crc, buf, len);
+}
+#endif
+
+uint32_t crc32c_engine(enum crc32_engine engine, uint32_t crc,
+		       const unsigned char *buf, uint len)
+{
+	if (!crc32_engine_supported(engine))
+		engine = CRC32_ENGINE_TABLE;
+
+	switch (engine) {
+#ifdef CRC32C_SLICE_BY_8
+	case CRC32_ENGINE_SLICE8:
+		return crc32c_slice8_no_comp(crc, buf, len);
+#endif
+#ifdef CRC32C_ARMV8
+	case CRC32_ENGINE_ARMV8:
+		return crc32c_armv8_no_comp(crc, buf, len);
+#endif
+#ifdef CRC32C_PMULL
+	case CRC32_ENGINE_PMULL:
+		return crc32c_fold_no_comp(engine, crc, buf, len);
+#endif
+#ifdef CRC32C_PCLMUL
+	case CRC32_ENGINE_PCLMUL:
+		return crc32c_fold_no_comp(engine, crc, buf, len);
+#endif
+	default:
+		return crc32c_table_no_comp(crc, buf, len);
+	}
+}
+
+/* Same order of preference as crc32_no_comp() */
+static uint32_t crc32c_no_comp(uint32_t crc, const u8 *buf, uint len)
+{
+#ifdef CRC32C_PMULL
+	if (crc32_engine_supported(CRC32_ENGINE_PMULL))
+		return crc32c_fold_no_comp(CRC32_ENGINE_PMULL, crc, buf, len);
+#endif
+#ifdef CRC32C_ARMV8
+	if (crc32_engine_supported(CRC32_ENGINE_ARMV8))
+		return crc32c_armv8_no_comp(crc, buf, len);
+#endif
+#ifdef CRC32C_PCLMUL
+	if (crc32_engine_supported(CRC32_ENGINE_PCLMUL))
+		return crc32c_fold_no_comp(CRC32_ENGINE_PCLMUL, crc, buf, len);
+#endif
+	return crc32c_soft_no_comp(crc, buf, len);
+}
 
 uint32_t crc32c_cal(uint32_t crc, const char *data, int length,
-		    uint32_t *crc32c_table)
+		    uint32_t *table)
 {
+	if (table[128] == CRC32C_POLY)
+		return crc32c_no_comp(crc, (const u8 *)data, length);
+
 	while (length--)
-		crc = crc32c_table[(u8)(crc ^ *data++)] ^ (crc >> 8);
+		crc = table[(u8)(crc ^ *data++)] ^ (crc >> 8);
 
 	return crc;
 }
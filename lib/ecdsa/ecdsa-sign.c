@@ -0,0 +1,324 @@
+/*
+ * Sign FIT images with ECDSA, using OpenSSL
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include "mkimage.h"
+#include <stdio.h>
+#include <string.h>
+#include <image.h>
+#include <openssl/bn.h>
+#include <openssl/ec.h>
+#include <openssl/ecdsa.h>
+#include <openssl/err.h>
+#include <openssl/evp.h>
+#include <openssl/objects.h>
+#include <openssl/pem.h>
+#include <u-boot/ecdsa.h>
+
+#if OPENSSL_VERSION_NUMBER < 0x10100000L
+static void ECDSA_SIG_get0(const ECDSA_SIG *sig, const BIGNUM **pr,
+			   const BIGNUM **ps)
+{
+	if (pr != NULL)
+		*pr = sig->r;
+	if (ps != NULL)
+		*ps = sig->s;
+}
+
+#define EVP_MD_CTX_new		EVP_MD_CTX_create
+#define EVP_MD_CTX_free		EVP_MD_CTX_destroy
+#endif
+
+#if OPENSSL_VERSION_NUMBER < 0x10101000L
+#define EC_POINT_get_affine_coordinates EC_POINT_get_affine_coordinates_GFp
+#endif
+
+static int ecdsa_err(const char *msg)
+{
+	unsigned long sslErr = ERR_get_error();
+
+	fprintf(stderr, "%s", msg);
+	fprintf(stderr, ": %s\n",
+		ERR_error_string(sslErr, 0));
+
+	return -1;
+}
+
+/* Write a number as a big endian array of @len bytes */
+static int ecdsa_bn2bin(const BIGNUM *num, uint8_t *buf, int len)
+{
+	int size = BN_num_bytes(num);
+
+	if (size > len)
+		return -EINVAL;
+	memset(buf, '\0', len - size);
+	BN_bn2bin(num, buf + len - size);
+
+	return 0;
+}
+
+/**
+ * ecdsa_pem_get_key() - read a P-256 private key from a .key file
+ *
+ * @keydir:	Directory containing the key
+ * @name	Name of key file (will have a .key extension)
+ * @pkeyp	Returns key object, or NULL on failure
+ * @return 0 if ok, -ve on error (in which case *pkeyp will be set to NULL)
+ */
+static int ecdsa_pem_get_key(const char *keydir, const char *name,
+			     EVP_PKEY **pkeyp)
+{
+	char path[1024];
+	const EC_GROUP *group;
+	EVP_PKEY *pkey;
+	EC_KEY *ec;
+	FILE *f;
+
+	*pkeyp = NULL;
+	snprintf(path, sizeof(path), "%s/%s.key", keydir, name);
+	f = fopen(path, "r");
+	if (!f) {
+		fprintf(stderr, "Couldn't open ECDSA private key: '%s': %s\n",
+			path, strerror(errno));
+		return -ENOENT;
+	}
+
+	pkey = PEM_read_PrivateKey(f, NULL, NULL, path);
+	fclose(f);
+	if (!pkey) {
+		ecdsa_err("Failure reading private key");
+		return -EPROTO;
+	}
+
+	ec = EVP_PKEY_get1_EC_KEY(pkey);
+	group = ec ? EC_KEY_get0_group(ec) : NULL;
+	if (!group || EC_GROUP_get_curve_name(group) != NID_X9_62_prime256v1) {
+		fprintf(stderr, "Key '%s' is not an ECDSA prime256v1 key\n",
+			path);
+		EC_KEY_free(ec);
+		EVP_PKEY_free(pkey);
+		return -EINVAL;
+	}
+	EC_KEY_free(ec);
+	*pkeyp = pkey;
+
+	return 0;
+}
+
+static int ecdsa_sign_with_key(EVP_PKEY *pkey,
+			       struct checksum_algo *checksum_algo,
+			       const struct image_region region[],
+			       int region_count, uint8_t **sigp, uint *sig_len)
+{
+	const BIGNUM *r, *s;
+	const uint8_t *ptr;
+	EVP_MD_CTX *context;
+	ECDSA_SIG *ecsig;
+	uint8_t *der, *sig;
+	size_t der_len;
+	int ret = 0;
+	int i;
+
+	der_len = EVP_PKEY_size(pkey);
+	der = malloc(der_len);
+	sig = malloc(ECDSA256_BYTES);
+	if (!der || !sig) {
+		fprintf(stderr, "Out of memory for signature\n");
+		ret = -ENOMEM;
+		goto err_alloc;
+	}
+
+	context = EVP_MD_CTX_new();
+	if (!context) {
+		ret = ecdsa_err("EVP context creation failed");
+		goto err_alloc;
+	}
+	if (!EVP_DigestSignInit(context, NULL, checksum_algo->calculate_sign(),
+				NULL, pkey)) {
+		ret = ecdsa_err("Signer setup failed");
+		goto err_sign;
+	}
+
+	for (i = 0; i < region_count; i++) {
+		if (!EVP_DigestSignUpdate(context, region[i].data,
+					  region[i].size)) {
+			ret = ecdsa_err("Signing data failed");
+			goto err_sign;
+		}
+	}
+
+	if (!EVP_DigestSignFinal(context, der, &der_len)) {
+		ret = ecdsa_err("Could not obtain signature");
+		goto err_sign;
+	}
+
+	/* OpenSSL gives a DER sequence of r and s, we store them raw */
+	ptr = der;
+	ecsig = d2i_ECDSA_SIG(NULL, &ptr, der_len);
+	if (!ecsig) {
+		ret = ecdsa_err("Could not decode signature");
+		goto err_sign;
+	}
+	ECDSA_SIG_get0(ecsig, &r, &s);
+	if (ecdsa_bn2bin(r, sig, ECDSA256_BYTES / 2) ||
+	    ecdsa_bn2bin(s, sig + ECDSA256_BYTES / 2, ECDSA256_BYTES / 2)) {
+		fprintf(stderr, "Signature is too long\n");
+		ret = -EINVAL;
+	}
+	ECDSA_SIG_free(ecsig);
+	if (ret)
+		goto err_sign;
+
+	EVP_MD_CTX_free(context);
+	free(der);
+	*sigp = sig;
+	*sig_len = ECDSA256_BYTES;
+
+	return 0;
+
+err_sign:
+	EVP_MD_CTX_free(context);
+err_alloc:
+	free(sig);
+	free(der);
+	return ret;
+}
+
+int ecdsa_sign(struct image_sign_info *info,
+	       const struct image_region region[], int region_count,
+	       uint8_t **sigp, uint *sig_len)
+{
+	EVP_PKEY *pkey;
+	int ret;
+
+	if (info->engine_id) {
+		fprintf(stderr, "ECDSA signing does not support engines\n");
+		return -ENOTSUP;
+	}
+
+	ret = ecdsa_pem_get_key(info->keydir, info->keyname, &pkey);
+	if (ret)
+		return ret;
+	ret = ecdsa_sign_with_key(pkey, info->checksum, region, region_count,
+				  sigp, sig_len);
+	EVP_PKEY_free(pkey);
+
+	return ret;
+}
+
+/* Get the public point of the key as two big endian 32-byte numbers */
+static int ecdsa_get_point(EVP_PKEY *pkey, uint8_t *x, uint8_t *y)
+{
+	const EC_GROUP *group;
+	const EC_POINT *point;
+	BIGNUM *bn_x, *bn_y;
+	EC_KEY *ec;
+	int ret = -EINVAL;
+
+	ec = EVP_PKEY_get1_EC_KEY(pkey);
+	bn_x = BN_new();
+	bn_y = BN_new();
+	if (!ec || !bn_x || !bn_y) {
+		ret = ecdsa_err("Could not get public key");
+		goto done;
+	}
+
+	group = EC_KEY_get0_group(ec);
+	point = EC_KEY_get0_public_key(ec);
+	if (!point ||
+	    !EC_POINT_get_affine_coordinates(group, point, bn_x, bn_y, NULL)) {
+		ret = ecdsa_err("Could not get public key coordinates");
+		goto done;
+	}
+	if (!ecdsa_bn2bin(bn_x, x, ECDSA256_BYTES / 2) &&
+	    !ecdsa_bn2bin(bn_y, y, ECDSA256_BYTES / 2))
+		ret = 0;
+
+done:
+	BN_free(bn_y);
+	BN_free(bn_x);
+	EC_KEY_free(ec);
+
+	return ret;
+}
+
+int ecdsa_add_verify_data(struct image_sign_info *info, void *keydest)
+{
+	uint8_t x[ECDSA256_BYTES / 2], y[ECDSA256_BYTES / 2];
+	int parent, node;
+	char name[100];
+	EVP_PKEY *pkey;
+	int ret;
+
+	debug("%s: Getting verification data\n", __func__);
+	if (info->engine_id) {
+		fprintf(stderr, "ECDSA signing does not support engines\n");
+		return -ENOTSUP;
+	}
+	ret = ecdsa_pem_get_key(info->keydir, info->keyname, &pkey);
+	if (ret)
+		return ret;
+	ret = ecdsa_get_point(pkey, x, y);
+	EVP_PKEY_free(pkey);
+	if (ret)
+		return ret;
+
+	parent = fdt_subnode_offset(keydest, 0, FIT_SIG_NODENAME);
+	if (parent == -FDT_ERR_NOTFOUND) {
+		parent = fdt_add_subnode(keydest, 0, FIT_SIG_NODENAME);
+		if (parent < 0) {
+			ret = parent;
+			if (ret != -FDT_ERR_NOSPACE) {
+				fprintf(stderr, "Couldn't create signature node: %s\n",
+					fdt_strerror(parent));
+			}
+		}
+	}
+	if (ret)
+		goto done;
+
+	/* Either create or overwrite the named key node */
+	snprintf(name, sizeof(name), "key-%s", info->keyname);
+	node = fdt_subnode_offset(keydest, parent, name);
+	if (node == -FDT_ERR_NOTFOUND) {
+		node = fdt_add_subnode(keydest, parent, name);
+		if (node < 0) {
+			ret = node;
+			if (ret != -FDT_ERR_NOSPACE) {
+				fprintf(stderr, "Could not create key subnode: %s\n",
+					fdt_strerror(node));
+			}
+		}
+	} else if (node < 0) {
+		fprintf(stderr, "Cannot select keys parent: %s\n",
+			fdt_strerror(node));
+		ret = node;
+	}
+
+	if (!ret) {
+		ret = fdt_setprop_string(keydest, node, "key-name-hint",
+					 info->keyname);
+	}
+	if (!ret)
+		ret = fdt_setprop_string(keydest, node, "ecdsa,curve",
+					 "prime256v1");
+	if (!ret)
+		ret = fdt_setprop(keydest, node, "ecdsa,x-point", x, sizeof(x));
+	if (!ret)
+		ret = fdt_setprop(keydest, node, "ecdsa,y-point", y, sizeof(y));
+	if (!ret) {
+		ret = fdt_setprop_string(keydest, node, FIT_ALGO_PROP,
+					 info->name);
+	}
+	if (!ret && info->require_keys) {
+		ret = fdt_setprop_string(keydest, node, "required",
+					 info->require_keys);
+	}
+done:
+	if (ret)
+		ret = ret == -FDT_ERR_NOSPACE ? -ENOSPC : -EIO;
+
+	return ret;
+}
@@ -0,0 +1,431 @@
+/*
+ * ECDSA signature verification on the NIST P-256 curve
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+/*
+ * Numbers are eight 32-bit words, least significant first, and are kept in
+ * Montgomery form (x R mod m, R = 2^256) both modulo the field prime p and
+ * modulo the group order n. The field arithmetic never branches on or
+ * indexes by the values it works on: carries and borrows are turned into
+ * masks, and inverses are taken as a^(m - 2) with a fixed chain. The point
+ * arithmetic above it only handles public values (the key and signature)
+ * and does take shortcuts for the point at infinity.
+ */
+
+#ifndef USE_HOSTCC
+#include <common.h>
+#include <linux/errno.h>
+#else
+#include "mkimage.h"
+#endif
+#include <u-boot/ecdsa.h>
+
+#define P256_WORDS	8
+
+struct p256_mod {
+	uint32_t m[P256_WORDS];
+	uint32_t rr[P256_WORDS];	/* R^2 mod m */
+	uint32_t n0inv;			/* -1 / m mod 2^32 */
+};
+
+/* Jacobian coordinates: (X / Z^2, Y / Z^3), Z = 0 for the point at infinity */
+struct p256_point {
+	uint32_t x[P256_WORDS];
+	uint32_t y[P256_WORDS];
+	uint32_t z[P256_WORDS];
+};
+
+static const struct p256_mod p256_p = {
+	.m = {
+		0xffffffff, 0xffffffff, 0xffffffff, 0x00000000,
+		0x00000000, 0x00000000, 0x00000001, 0xffffffff,
+	},
+	.rr = {
+		0x00000003, 0x00000000, 0xffffffff, 0xfffffffb,
+		0xfffffffe, 0xffffffff, 0xfffffffd, 0x00000004,
+	},
+	.n0inv = 0x00000001,
+};
+
+static const struct p256_mod p256_n = {
+	.m = {
+		0xfc632551, 0xf3b9cac2, 0xa7179e84, 0xbce6faad,
+		0xffffffff, 0xffffffff, 0x00000000, 0xffffffff,
+	},
+	.rr = {
+		0xbe79eea2, 0x83244c95, 0x49bd6fa6, 0x4699799c,
+		0x2b6bec59, 0x2845b239, 0xf3d95620, 0x66e12d94,
+	},
+	.n0inv = 0xee00bc4f,
+};
+
+/* The curve's b and base point G, in Montgomery form modulo p */
+static const uint32_t p256_b[P256_WORDS] = {
+	0x29c4bddf, 0xd89cdf62, 0x78843090, 0xacf005cd,
+	0xf7212ed6, 0xe5a220ab, 0x04874834, 0xdc30061d,
+};
+
+static const struct p256_point p256_g = {
+	.x = {
+		0x18a9143c, 0x79e730d4, 0x5fedb601, 0x75ba95fc,
+		0x77622510, 0x79fb732b, 0xa53755c6, 0x18905f76,
+	},
+	.y = {
+		0xce95560a, 0xddf25357, 0xba19e45c, 0x8b4ab8e4,
+		0xdd21f325, 0xd2e88688, 0x25885d85, 0x8571ff18,
+	},
+	.z = {		/* R mod p */
+		0x00000001, 0x00000000, 0x00000000, 0xffffffff,
+		0xffffffff, 0xffffffff, 0xfffffffe, 0x00000000,
+	},
+};
+
+static void p256_from_be(uint32_t r[], const uint8_t *src)
+{
+	int i;
+
+	for (i = 0; i < P256_WORDS; i++, src += 4)
+		r[P256_WORDS - 1 - i] = (uint32_t)src[0] << 24 |
+					(uint32_t)src[1] << 16 |
+					(uint32_t)src[2] << 8 | src[3];
+}
+
+/* r = a - b, returning the borrow */
+static uint32_t p256_sub_words(uint32_t r[], const uint32_t a[],
+			       const uint32_t b[])
+{
+	int64_t acc = 0;
+	int i;
+
+	for (i = 0; i < P256_WORDS; i++) {
+		acc += (uint64_t)a[i] - b[i];
+		r[i] = (uint32_t)acc;
+		acc >>= 32;
+	}
+
+	return (uint32_t)acc & 1;
+}
+
+/* r = mask ? a : b */
+static void p256_select(uint32_t r[], uint32_t mask, const uint32_t a[],
+			const uint32_t b[])
+{
+	int i;
+
+	for (i = 0; i < P256_WORDS; i++)
+		r[i] = (a[i] & mask) | (b[i] & ~mask);
+}
+
+/* r = a if a < m, else a - m, where a < 2m is @top:a[] */
+static void p256_reduce_once(const struct p256_mod *mod, uint32_t r[],
+			     uint32_t top, const uint32_t a[])
+{
+	uint32_t diff[P256_WORDS];
+	uint32_t borrow;
+
+	borrow = p256_sub_words(diff, a, mod->m);
+	p256_select(r, -(uint32_t)(borrow & ~top), a, diff);
+}
+
+static void p256_add(const struct p256_mod *mod, uint32_t r[],
+		     const uint32_t a[], const uint32_t b[])
+{
+	uint64_t acc = 0;
+	int i;
+
+	for (i = 0; i < P256_WORDS; i++) {
+		acc += (uint64_t)a[i] + b[i];
+		r[i] = (uint32_t)acc;
+		acc >>= 32;
+	}
+	p256_reduce_once(mod, r, (uint32_t)acc, r);
+}
+
+static void p256_sub(const struct p256_mod *mod, uint32_t r[],
+		     const uint32_t a[], const uint32_t b[])
+{
+	uint32_t mask, fix[P256_WORDS];
+	uint64_t acc = 0;
+	int i;
+
+	mask = -p256_sub_words(r, a, b);
+	for (i = 0; i < P256_WORDS; i++) {
+		acc += (uint64_t)r[i] + (mod->m[i] & mask);
+		fix[i] = (uint32_t)acc;
+		acc >>= 32;
+	}
+	memcpy(r, fix, sizeof(fix));
+}
+
+/* r = a * b / R mod m, for a * b < m * R; r may be a or b */
+static void p256_mul(const struct p256_mod *mod, uint32_t r[],
+		     const uint32_t a[], const uint32_t b[])
+{
+	uint32_t t[P256_WORDS + 2] = { 0 };
+	uint64_t acc;
+	uint32_t d;
+	int i, j;
+
+	for (i = 0; i < P256_WORDS; i++) {
+		for (j = 0, acc = 0; j < P256_WORDS; j++) {
+			acc += (uint64_t)a[i] * b[j] + t[j];
+			t[j] = (uint32_t)acc;
+			acc >>= 32;
+		}
+		acc += t[P256_WORDS];
+		t[P256_WORDS] = (uint32_t)acc;
+		t[P256_WORDS + 1] = (uint32_t)(acc >> 32);
+
+		d = t[0] * mod->n0inv;
+		acc = ((uint64_t)d * mod->m[0] + t[0]) >> 32;
+		for (j = 1; j < P256_WORDS; j++) {
+			acc += (uint64_t)d * mod->m[j] + t[j];
+			t[j - 1] = (uint32_t)acc;
+			acc >>= 32;
+		}
+		acc += t[P256_WORDS];
+		t[P256_WORDS - 1] = (uint32_t)acc;
+		t[P256_WORDS] = t[P256_WORDS + 1] + (uint32_t)(acc >> 32);
+	}
+	p256_reduce_once(mod, r, t[P256_WORDS], t);
+}
+
+static void p256_to_mont(const struct p256_mod *mod, uint32_t r[],
+			 const uint32_t a[])
+{
+	p256_mul(mod, r, a, mod->rr);
+}
+
+static void p256_from_mont(const struct p256_mod *mod, uint32_t r[],
+			   const uint32_t a[])
+{
+	static const uint32_t one[P256_WORDS] = { 1 };
+
+	p256_mul(mod, r, a, one);
+}
+
+/* r = a^(m - 2) = 1 / a mod m, as m is prime */
+static void p256_inv(const struct p256_mod *mod, uint32_t r[],
+		     const uint32_t a[])
+{
+	static const uint32_t two[P256_WORDS] = { 2 };
+	uint32_t e[P256_WORDS], acc[P256_WORDS];
+	int i;
+
+	p256_sub_words(e, mod->m, two);
+	memcpy(acc, a, sizeof(acc));
+	/* The top bit of m - 2 is set for both p and n */
+	for (i = P256_WORDS * 32 - 2; i >= 0; i--) {
+		p256_mul(mod, acc, acc, acc);
+		if (e[i / 32] >> (i % 32) & 1)
+			p256_mul(mod, acc, acc, a);
+	}
+	memcpy(r, acc, sizeof(acc));
+}
+
+static bool p256_is_zero(const uint32_t a[])
+{
+	uint32_t acc = 0;
+	int i;
+
+	for (i = 0; i < P256_WORDS; i++)
+		acc |= a[i];
+
+	return !acc;
+}
+
+static bool p256_equal(const uint32_t a[], const uint32_t b[])
+{
+	uint32_t acc = 0;
+	int i;
+
+	for (i = 0; i < P256_WORDS; i++)
+		acc |= a[i] ^ b[i];
+
+	return !acc;
+}
+
+/* Is 0 < a < m? */
+static bool p256_in_range(const struct p256_mod *mod, const uint32_t a[])
+{
+	uint32_t diff[P256_WORDS];
+
+	return !p256_is_zero(a) && p256_sub_words(diff, a, mod->m);
+}
+
+/* r = 2 * a, with a = -3 as for all NIST curves (dbl-2001-b) */
+static void p256_point_double(struct p256_point *r,
+			      const struct p256_point *a)
+{
+	const struct p256_mod *p = &p256_p;
+	uint32_t delta[P256_WORDS], gamma[P256_WORDS], beta[P256_WORDS];
+	uint32_t alpha[P256_WORDS], t[P256_WORDS];
+
+	p256_mul(p, delta, a->z, a->z);
+	p256_mul(p, gamma, a->y, a->y);
+	p256_mul(p, beta, a->x, gamma);
+
+	p256_sub(p, t, a->x, delta);
+	p256_add(p, alpha, a->x, delta);
+	p256_mul(p, alpha, alpha, t);
+	p256_add(p, t, alpha, alpha);
+	p256_add(p, alpha, alpha, t);
+
+	p256_add(p, t, a->y, a->z);
+	p256_mul(p, r->z, t, t);
+	p256_sub(p, r->z, r->z, gamma);
+	p256_sub(p, r->z, r->z, delta);
+
+	p256_add(p, beta, beta, beta);
+	p256_add(p, beta, beta, beta);
+	p256_mul(p, r->x, alpha, alpha);
+	p256_add(p, t, beta, beta);
+	p256_sub(p, r->x, r->x, t);
+
+	p256_sub(p, t, beta, r->x);
+	p256_mul(p, r->y, alpha, t);
+	p256_mul(p, gamma, gamma, gamma);
+	p256_add(p, gamma, gamma, gamma);
+	p256_add(p, gamma, gamma, gamma);
+	p256_add(p, gamma, gamma, gamma);
+	p256_sub(p, r->y, r->y, gamma);
+}
+
+/* r = a + b (add-1998-cmo-2); r may be a or b */
+static void p256_point_add(struct p256_point *r, const struct p256_point *a,
+			   const struct p256_point *b)
+{
+	const struct p256_mod *p = &p256_p;
+	uint32_t u1[P256_WORDS], u2[P256_WORDS], s1[P256_WORDS];
+	uint32_t s2[P256_WORDS], h[P256_WORDS], hh[P256_WORDS];
+	uint32_t t[P256_WORDS];
+
+	if (p256_is_zero(a->z)) {
+		*r = *b;
+		return;
+	}
+	if (p256_is_zero(b->z)) {
+		*r = *a;
+		return;
+	}
+
+	p256_mul(p, t, b->z, b->z);
+	p256_mul(p, u1, a->x, t);
+	p256_mul(p, t, t, b->z);
+	p256_mul(p, s1, a->y, t);
+	p256_mul(p, t, a->z, a->z);
+	p256_mul(p, u2, b->x, t);
+	p256_mul(p, t, t, a->z);
+	p256_mul(p, s2, b->y, t);
+
+	p256_sub(p, h, u2, u1);
+	p256_sub(p, s2, s2, s1);		/* s2 is now R */
+	if (p256_is_zero(h)) {
+		if (p256_is_zero(s2))
+			p256_point_double(r, a);
+		else
+			memset(r->z, '\0', sizeof(r->z));
+		return;
+	}
+
+	p256_mul(p, r->z, a->z, b->z);
+	p256_mul(p, r->z, r->z, h);
+
+	p256_mul(p, hh, h, h);
+	p256_mul(p, h, hh, h);			/* h is now H^3 */
+	p256_mul(p, u1, u1, hh);		/* u1 is now U1 H^2 */
+	p256_mul(p, r->x, s2, s2);
+	p256_sub(p, r->x, r->x, h);
+	p256_sub(p, r->x, r->x, u1);
+	p256_sub(p, r->x, r->x, u1);
+
+	p256_sub(p, t, u1, r->x);
+	p256_mul(p, r->y, s2, t);
+	p256_mul(p, t, s1, h);
+	p256_sub(p, r->y, r->y, t);
+}
+
+/* Is (x, y), in Montgomery form, on the curve y^2 = x^3 - 3x + b? */
+static bool p256_on_curve(const uint32_t x[], const uint32_t y[])
+{
+	const struct p256_mod *p = &p256_p;
+	uint32_t lhs[P256_WORDS], rhs[P256_WORDS], t[P256_WORDS];
+
+	p256_mul(p, lhs, y, y);
+	p256_mul(p, rhs, x, x);
+	p256_mul(p, rhs, rhs, x);
+	p256_add(p, t, x, x);
+	p256_add(p, t, t, x);
+	p256_sub(p, rhs, rhs, t);
+	p256_add(p, rhs, rhs, p256_b);
+
+	return p256_equal(lhs, rhs);
+}
+
+int p256_ecdsa_verify(const uint8_t *hash, int hash_len, const uint8_t *qx,
+		      const uint8_t *qy, const uint8_t *sig)
+{
+	uint32_t r[P256_WORDS], s[P256_WORDS], e[P256_WORDS];
+	uint32_t u1[P256_WORDS], u2[P256_WORDS], t[P256_WORDS];
+	struct p256_point q, gq, acc;
+	const struct p256_point *table[4] = { NULL, &p256_g, &q, &gq };
+	uint8_t ebuf[ECDSA256_BYTES / 2];
+	int i, bits;
+
+	/* The hash is truncated to the bit length of n */
+	memset(ebuf, '\0', sizeof(ebuf));
+	if (hash_len > sizeof(ebuf))
+		hash_len = sizeof(ebuf);
+	memcpy(ebuf + sizeof(ebuf) - hash_len, hash, hash_len);
+	p256_from_be(e, ebuf);
+
+	p256_from_be(r, sig);
+	p256_from_be(s, sig + ECDSA256_BYTES / 2);
+	if (!p256_in_range(&p256_n, r) || !p256_in_range(&p256_n, s))
+		return -EINVAL;
+
+	/* The key must be a point on the curve */
+	p256_from_be(q.x, qx);
+	p256_from_be(q.y, qy);
+	if (!p256_in_range(&p256_p, q.x) || !p256_in_range(&p256_p, q.y))
+		return -EINVAL;
+	p256_to_mont(&p256_p, q.x, q.x);
+	p256_to_mont(&p256_p, q.y, q.y);
+	memcpy(q.z, p256_g.z, sizeof(q.z));
+	if (!p256_on_curve(q.x, q.y))
+		return -EINVAL;
+
+	/* u1 = e / s mod n, u2 = r / s mod n */
+	p256_to_mont(&p256_n, t, s);
+	p256_inv(&p256_n, t, t);
+	p256_to_mont(&p256_n, e, e);
+	p256_mul(&p256_n, u1, e, t);
+	p256_from_mont(&p256_n, u1, u1);
+	p256_to_mont(&p256_n, u2, r);
+	p256_mul(&p256_n, u2, u2, t);
+	p256_from_mont(&p256_n, u2, u2);
+
+	/* acc = u1 G + u2 Q, a bit of each at a time (Shamir's trick) */
+	p256_point_add(&gq, &p256_g, &q);
+	memset(&acc, '\0', sizeof(acc));
+	for (i = P256_WORDS * 32 - 1; i >= 0; i--) {
+		p256_point_double(&acc, &acc);
+		bits = (u1[i / 32] >> (i % 32) & 1) |
+		       (u2[i / 32] >> (i % 32) & 1) << 1;
+		if (bits)
+			p256_point_add(&acc, &acc, table[bits]);
+	}
+	if (p256_is_zero(acc.z))
+		return -EACCES;
+
+	/* Accept if the affine x of acc, taken mod n, is r */
+	p256_inv(&p256_p, t, acc.z);
+	p256_mul(&p256_p, t, t, t);
+	p256_mul(&p256_p, t, acc.x, t);
+	p256_from_mont(&p256_p, t, t);
+	p256_reduce_once(&p256_n, t, 0, t);
+
+	return p256_equal(t, r) ? 0 : -EACCES;
+}
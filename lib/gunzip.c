@@ -80,6 +80,193 @@ int gunzip(void *dst, int dstlen, unsigned char *src, unsigned long *lenp)
 	return zunzip(dst, dstlen, src, lenp, 1, offset);
 }
 
+/**
+ * struct gzip_stream - state of a streaming decompression
+ *
+ * @zs:		zlib state; zs.next_out is where the next output goes
+ * @out:	Output buffer
+ * @out_size:	Size of @out
+ * @sink:	Receives each full @out, or NULL if @out is the destination
+ * @priv:	Private data for @sink
+ * @own_out:	@out was allocated here
+ * @done:	The end of the stream has been seen
+ * @err:	First error, which every later call returns
+ */
+struct gzip_stream {
+	z_stream zs;
+	unsigned char *out;
+	ulong out_size;
+	gzip_sink_t sink;
+	void *priv;
+	bool own_out;
+	bool done;
+	int err;
+};
+
+struct gzip_stream *gzip_stream_start(void *out, ulong out_size,
+				      gzip_sink_t sink, void *priv, uint flags)
+{
+	struct gzip_stream *gs;
+	int r;
+
+	gs = calloc(1, sizeof(*gs));
+	if (!gs)
+		return NULL;
+	if (!out && sink) {
+		out = malloc_cache_aligned(out_size);
+		if (!out)
+			goto err;
+		gs->own_out = true;
+	}
+	gs->out = out;
+	gs->out_size = out_size;
+	gs->sink = sink;
+	gs->priv = priv;
+
+	gs->zs.zalloc = gzalloc;
+	gs->zs.zfree = gzfree;
+	/* zlib reads the gzip header and checks the trailer itself */
+	r = inflateInit2(&gs->zs, flags & GZIP_STREAM_RAW ? -MAX_WBITS :
+			 16 + MAX_WBITS);
+	if (r != Z_OK) {
+		printf("Error: inflateInit2() returned %d\n", r);
+		goto err;
+	}
+	gs->zs.next_out = gs->out;
+	gs->zs.avail_out = out_size;
+
+	return gs;
+err:
+	if (gs->own_out)
+		free(out);
+	free(gs);
+
+	return NULL;
+}
+
+/* Pass what is in the output buffer to the sink */
+static int gzip_stream_flush(struct gzip_stream *gs)
+{
+	ulong len = gs->zs.next_out - gs->out;
+	int ret;
+
+	if (!gs->sink || !len)
+		return 0;
+	ret = gs->sink(gs->priv, gs->out, len);
+	gs->zs.next_out = gs->out;
+	gs->zs.avail_out = gs->out_size;
+
+	return ret;
+}
+
+int gzip_stream_write(struct gzip_stream *gs, const void *in, ulong len)
+{
+	int r;
+
+	if (gs->err || gs->done)
+		return gs->err;
+
+	gs->zs.next_in = (unsigned char *)in;
+	gs->zs.avail_in = len;
+	for (;;) {
+		if (!gs->zs.avail_out) {
+			gs->err = gzip_stream_flush(gs);
+			if (gs->err)
+				break;
+		}
+		r = inflate(&gs->zs, Z_NO_FLUSH);
+		if (r == Z_STREAM_END) {
+			gs->done = true;
+			break;
+		} else if (r == Z_BUF_ERROR) {
+			/* No progress: either more input or more room needed */
+			if (gs->zs.avail_in)
+				gs->err = -ENOSPC;
+			break;
+		} else if (r != Z_OK) {
+			debug("%s: inflate() returned %d\n", __func__, r);
+			gs->err = r == Z_MEM_ERROR ? -ENOMEM : -EBADMSG;
+			break;
+		}
+		/* Output may still be pending when the buffer is full */
+		if (!gs->zs.avail_in && gs->zs.avail_out)
+			break;
+		WATCHDOG_RESET();
+	}
+
+	return gs->err;
+}
+
+bool gzip_stream_done(struct gzip_stream *gs)
+{
+	return gs->done;
+}
+
+/*
+ * With the output buffer full and no more input, check whether the stream
+ * was cut short or the buffer is too small
+ */
+static bool gzip_stream_wants_room(struct gzip_stream *gs)
+{
+	unsigned char byte;
+
+	gs->zs.next_out = &byte;
+	gs->zs.avail_out = 1;
+	inflate(&gs->zs, Z_NO_FLUSH);
+
+	return !gs->zs.avail_out;
+}
+
+int gzip_stream_finish(struct gzip_stream *gs, ulong *lenp)
+{
+	int ret = gs->err;
+
+	if (lenp)
+		*lenp = gs->zs.total_out;
+	if (!ret) {
+		if (gs->done)
+			ret = gzip_stream_flush(gs);
+		else if (!gs->sink && !gs->zs.avail_out &&
+			 gzip_stream_wants_room(gs))
+			ret = -ENOSPC;
+		else
+			ret = -EBADMSG;
+	}
+	inflateEnd(&gs->zs);
+	if (gs->own_out)
+		free(gs->out);
+	free(gs);
+
+	return ret;
+}
+
+int gunzip_stream(gzip_source_t source, gzip_sink_t sink, void *priv,
+		  ulong chunk, uint flags, ulong *lenp)
+{
+	struct gzip_stream *gs;
+	int ret, err;
+	void *buf;
+	long len;
+
+	buf = malloc(chunk);
+	if (!buf)
+		return -ENOMEM;
+	gs = gzip_stream_start(NULL, chunk, sink, priv, flags);
+	if (!gs) {
+		free(buf);
+		return -ENOMEM;
+	}
+
+	do {
+		len = source(priv, buf, chunk);
+		ret = len < 0 ? len : gzip_stream_write(gs, buf, len);
+	} while (!ret && len && !gzip_stream_done(gs));
+	err = gzip_stream_finish(gs, lenp);
+	free(buf);
+
+	return ret ?: err;
+}
+
 #ifdef CONFIG_CMD_UNZIP
 __weak
 void gzwrite_progress_init(u64 expectedsize)
@@ -114,22 +301,61 @@ void gzwrite_progress_finish(int returnval,
 	}
 }
 
+/* Where gzwrite() has got to */
+struct gzwrite_state {
+	struct blk_desc *dev;
+	unsigned char *writebuf;
+	unsigned long szwritebuf;
+	lbaint_t blksperbuf;
+	lbaint_t outblock;
+	u32 crc;
+	u64 totalfilled;
+	u64 szexpected;
+	int iteration;
+};
+
+static int gzwrite_sink(void *priv, const void *buf, ulong numfilled)
+{
+	struct gzwrite_state *st = priv;
+	struct blk_desc *dev = st->dev;
+	unsigned long blocks_written;
+	lbaint_t writeblocks;
+
+	st->crc = crc32(st->crc, buf, numfilled);
+	st->totalfilled += numfilled;
+	if (numfilled < st->szwritebuf) {
+		writeblocks = (numfilled + dev->blksz - 1) / dev->blksz;
+		memset(st->writebuf + numfilled, 0,
+		       dev->blksz - (numfilled % dev->blksz));
+	} else {
+		writeblocks = st->blksperbuf;
+	}
+
+	gzwrite_progress(st->iteration++, st->totalfilled, st->szexpected);
+	blocks_written = blk_dwrite(dev, st->outblock, writeblocks,
+				    st->writebuf);
+	st->outblock += blocks_written;
+	if (ctrlc()) {
+		puts("abort\n");
+		return -EINTR;
+	}
+	WATCHDOG_RESET();
+
+	return 0;
+}
+
 int gzwrite(unsigned char *src, int len,
 	    struct blk_desc *dev,
 	    unsigned long szwritebuf,
 	    u64 startoffs,
 	    u64 szexpected)
 {
+	struct gzwrite_state st;
+	struct gzip_stream *gs;
 	int i, flags;
-	z_stream s;
 	int r = 0;
-	unsigned char *writebuf;
-	unsigned crc = 0;
-	u64 totalfilled = 0;
-	lbaint_t blksperbuf, outblock;
 	u32 expected_crc;
 	u32 payload_size;
-	int iteration = 0;
 
 	if (!szwritebuf ||
 	    (szwritebuf % dev->blksz) ||
@@ -145,8 +371,11 @@ int gzwrite(unsigned char *src, int len,
 		return -1;
 	}
 
-	blksperbuf = szwritebuf / dev->blksz;
-	outblock = lldiv(startoffs, dev->blksz);
+	memset(&st, '\0', sizeof(st));
+	st.dev = dev;
+	st.szwritebuf = szwritebuf;
+	st.blksperbuf = szwritebuf / dev->blksz;
+	st.outblock = lldiv(startoffs, dev->blksz);
 
 	/* skip header */
 	i = 10;
@@ -184,87 +413,40 @@ int gzwrite(unsigned char *src, int len,
 		       szexpected, szuncompressed);
 		return -1;
 	}
-	if (lldiv(szexpected, dev->blksz) > (dev->lba - outblock)) {
+	if (lldiv(szexpected, dev->blksz) > (dev->lba - st.outblock)) {
 		printf("%s: uncompressed size %llu exceeds device size\n",
 		       __func__, szexpected);
 		return -1;
 	}
+	st.szexpected = szexpected;
 
 	gzwrite_progress_init(szexpected);
 
-	s.zalloc = gzalloc;
-	s.zfree = gzfree;
-
-	r = inflateInit2(&s, -MAX_WBITS);
-	if (r != Z_OK) {
-		printf("Error: inflateInit2() returned %d\n", r);
+	st.writebuf = (unsigned char *)malloc_cache_aligned(szwritebuf);
+	if (!st.writebuf) {
+		printf("%s: no memory for write buffer\n", __func__);
+		return -1;
+	}
+	/* the header is parsed above, so the stream is raw deflate */
+	gs = gzip_stream_start(st.writebuf, szwritebuf, gzwrite_sink, &st,
+			       GZIP_STREAM_RAW);
+	if (!gs) {
+		free(st.writebuf);
 		return -1;
 	}
 
-	s.next_in = src + i;
-	s.avail_in = payload_size+8;
-	writebuf = (unsigned char *)malloc_cache_aligned(szwritebuf);
+	gzip_stream_write(gs, src + i, payload_size + 8);
+	r = gzip_stream_finish(gs, NULL);
+	if (r && r != -EINTR)
+		printf("Error: decompression failed (err=%d)\n", r);
 
-	/* decompress until deflate stream ends or end of file */
-	do {
-		if (s.avail_in == 0) {
-			printf("%s: weird termination with result %d\n",
-			       __func__, r);
-			break;
-		}
-
-		/* run inflate() on input until output buffer not full */
-		do {
-			unsigned long blocks_written;
-			int numfilled;
-			lbaint_t writeblocks;
-
-			s.avail_out = szwritebuf;
-			s.next_out = writebuf;
-			r = inflate(&s, Z_SYNC_FLUSH);
-			if ((r != Z_OK) &&
-			    (r != Z_STREAM_END)) {
-				printf("Error: inflate() returned %d\n", r);
-				goto out;
-			}
-			numfilled = szwritebuf - s.avail_out;
-			crc = crc32(crc, writebuf, numfilled);
-			totalfilled += numfilled;
-			if (numfilled < szwritebuf) {
-				writeblocks = (numfilled+dev->blksz-1)
-						/ dev->blksz;
-				memset(writebuf+numfilled, 0,
-				       dev->blksz-(numfilled%dev->blksz));
-			} else {
-				writeblocks = blksperbuf;
-			}
-
-			gzwrite_progress(iteration++,
-					 totalfilled,
-					 szexpected);
-			blocks_written = blk_dwrite(dev, outblock,
-						    writeblocks, writebuf);
-			outblock += blocks_written;
-			if (ctrlc()) {
-				puts("abort\n");
-				goto out;
-			}
-			WATCHDOG_RESET();
-		} while (s.avail_out == 0);
-		/* done when inflate() says it's done */
-	} while (r != Z_STREAM_END);
-
-	if ((szexpected != totalfilled) ||
-	    (crc != expected_crc))
+	if (r || (szexpected != st.totalfilled) ||
+	    (st.crc != expected_crc))
 		r = -1;
-	else
-		r = 0;
 
-out:
-	gzwrite_progress_finish(r, totalfilled, szexpected,
-				expected_crc, crc);
-	free(writebuf);
-	inflateEnd(&s);
+	gzwrite_progress_finish(r, st.totalfilled, szexpected,
+				expected_crc, st.crc);
+	free(st.writebuf);
 
 	return r;
 }
@@ -252,6 +252,27 @@ static long lmb_overlaps_region(struct lmb_region *rgn, phys_addr_t base,
 	return (i < rgn->cnt) ? i : -1;
 }
 
+/*
+ * Try to allocate a specific address range: it must lie within one memory
+ * region and must not overlap anything reserved
+ */
+phys_addr_t lmb_alloc_addr(struct lmb *lmb, phys_addr_t base, phys_size_t size)
+{
+	long rgn;
+
+	rgn = lmb_overlaps_region(&lmb->memory, base, size);
+	if (rgn < 0 || base < lmb->memory.region[rgn].base ||
+	    base + size > lmb->memory.region[rgn].base +
+			  lmb->memory.region[rgn].size)
+		return 0;
+	if (lmb_overlaps_region(&lmb->reserved, base, size) >= 0)
+		return 0;
+	if (lmb_add_region(&lmb->reserved, base, size) < 0)
+		return 0;
+
+	return base;
+}
+
 phys_addr_t lmb_alloc(struct lmb *lmb, phys_size_t size, ulong align)
 {
 	return lmb_alloc_base(lmb, size, align, LMB_ALLOC_ANYWHERE);
@@ -6,8 +6,10 @@
 
 #include <common.h>
 #include <compiler.h>
+#include <mp_run.h>
 #include <linux/kernel.h>
 #include <linux/types.h>
+#include <asm/unaligned.h>
 
 static u16 LZ4_readLE16(const void *src) { return le16_to_cpu(*(u16 *)src); }
 static void LZ4_copy4(void *dst, const void *src) { *(u32 *)dst = *(u32 *)src; }
@@ -63,7 +65,176 @@ struct lz4_block_header {
 	/* + u32 block_checksum iff has_block_checksum is set */
 } __packed;
 
-int ulz4fn(const void *src, size_t srcn, void *dst, size_t *dstn)
+/* constant folding essential, do not touch params! */
+static int lz4_decode_block(const void *in, void *out, u32 size, size_t room)
+{
+	return LZ4_decompress_generic(in, out, size, room, endOnInputSize,
+				      full, 0, noDict, out, NULL, 0);
+}
+
+/*
+ * The blocks of a frame are independent, and all but the last decompress to
+ * exactly the maximum block size when the frame comes from the lz4 tool. So
+ * block n can be decompressed to n times that size, on any CPU. Each CPU is
+ * given a run of consecutive blocks with about the same amount of input. If
+ * any block turns out not to be full, or anything else is wrong, the frame
+ * is decompressed again one block after another, so that the result is
+ * always the same as from the sequential code.
+ */
+
+#define LZ4_MP_MAX_CPUS		8
+
+/* Starting secondary CPUs is not worth it for less input than this */
+#define LZ4_MP_MIN		(1024 * 1024)
+
+struct lz4_mp_part {
+	const void *in;		/* Header of the first block */
+	int blocks;		/* Number of blocks */
+	void *out;		/* Where the first block goes */
+	const void *end;	/* End of the output buffer */
+	size_t block_max;	/* Output size of each block but the last */
+	bool has_block_checksum;
+	bool last;		/* Holds the last block of the frame */
+	size_t last_len;	/* Output size of the last block */
+	int ret;		/* 0 if OK, -ve if the frame must be redone */
+};
+
+static void lz4_mp_decode(void *arg)
+{
+	struct lz4_mp_part *part = arg;
+	const void *in = part->in;
+	void *out = part->out;
+	size_t len, room;
+	int i, ret = 0;
+
+	for (i = 0; i < part->blocks; i++) {
+		struct lz4_block_header b;
+
+		b.raw = le32_to_cpu(*(u32 *)in);
+		in += sizeof(struct lz4_block_header);
+		room = min((ptrdiff_t)part->block_max, part->end - out);
+
+		if (b.not_compressed) {
+			if (b.size > room) {
+				ret = -ENOBUFS;
+				break;
+			}
+			memcpy(out, in, b.size);
+			len = b.size;
+		} else {
+			ret = lz4_decode_block(in, out, b.size, room);
+			if (ret < 0) {
+				ret = -EPROTO;
+				break;
+			}
+			len = ret;
+			ret = 0;
+		}
+		if (len != part->block_max &&
+		    (!part->last || i != part->blocks - 1)) {
+			ret = -EAGAIN;	/* not where we assumed */
+			break;
+		}
+
+		in += b.size;
+		if (part->has_block_checksum)
+			in += sizeof(u32);
+		out += part->block_max;
+		part->last_len = len;
+	}
+	part->ret = ret;
+}
+
+/* Size of a block including its header and checksum, or 0 at the end mark */
+static size_t lz4_block_span(const void *in, bool has_block_checksum)
+{
+	struct lz4_block_header b;
+
+	b.raw = le32_to_cpu(*(u32 *)in);
+	if (!b.size)
+		return 0;
+
+	return sizeof(b) + b.size + (has_block_checksum ? sizeof(u32) : 0);
+}
+
+/*
+ * Decompress the blocks from @in on up to @cpus CPUs. Returns -EAGAIN if the
+ * frame must be decompressed sequentially instead.
+ */
+static int lz4_mp(const void *src, size_t srcn, const void *in,
+		  bool has_block_checksum, size_t block_max, void *dst,
+		  const void *end, size_t *dstn, int cpus)
+{
+	struct lz4_mp_part part[LZ4_MP_MAX_CPUS];
+	bool started[LZ4_MP_MAX_CPUS] = { false };
+	const void *first = in;
+	size_t span, total = 0, done;
+	int i, cpu, parts, blocks = 0;
+
+	/* Input and output must not overlap, as they do in place */
+	if (dst < src + srcn && src < end)
+		return -EAGAIN;
+
+	/* Check that every block is within the input and count them */
+	while (1) {
+		if (in - src + sizeof(u32) > srcn)
+			return -EAGAIN;
+		span = lz4_block_span(in, has_block_checksum);
+		if (!span)
+			break;
+		if (in - src + span > srcn)
+			return -EAGAIN;
+		in += span;
+		total += span;
+		blocks++;
+	}
+	if (blocks < 2 || (blocks - 1) * block_max >= (size_t)(end - dst))
+		return -EAGAIN;
+
+	/* Give each CPU a run of blocks with about the same input size */
+	cpus = min(cpus, LZ4_MP_MAX_CPUS);
+	in = first;
+	for (parts = 0, i = 0, done = 0; i < blocks; parts++) {
+		part[parts] = (struct lz4_mp_part){
+			.in = in,
+			.out = dst + i * block_max,
+			.end = end,
+			.block_max = block_max,
+			.has_block_checksum = has_block_checksum,
+		};
+		while (i < blocks && (!part[parts].blocks ||
+				      parts == cpus - 1 ||
+				      done < total / cpus * (parts + 1))) {
+			span = lz4_block_span(in, has_block_checksum);
+			in += span;
+			done += span;
+			part[parts].blocks++;
+			i++;
+		}
+	}
+	part[parts - 1].last = true;
+
+	for (cpu = 1; cpu < parts; cpu++)
+		started[cpu] = !mp_run_start(cpu, lz4_mp_decode, &part[cpu]);
+	lz4_mp_decode(&part[0]);
+	for (cpu = 1; cpu < parts; cpu++) {
+		if (started[cpu] && !mp_run_wait(cpu))
+			continue;
+		/* Do the work ourselves if the CPU could not */
+		lz4_mp_decode(&part[cpu]);
+	}
+
+	for (cpu = 0; cpu < parts; cpu++) {
+		if (part[cpu].ret)
+			return -EAGAIN;
+	}
+	*dstn = (blocks - 1) * block_max + part[parts - 1].last_len;
+
+	return 0;
+}
+
+int ulz4fn_cpus(const void *src, size_t srcn, void *dst, size_t *dstn,
+		int cpus)
 {
 	const void *end = dst + *dstn;
 	const void *in = src;
@@ -91,6 +262,13 @@ int ulz4fn(const void *src, size_t srcn, void *dst, size_t *dstn)
 		if (h->has_content_size)
 			in += sizeof(u64);
 		in += sizeof(u8);
+
+		/* 64KB, 256KB, 1MB or 4MB; lower values are reserved */
+		if (cpus > 1 && h->max_block_size >= 4 &&
+		    !lz4_mp(src, srcn, in, has_block_checksum,
+			    1 << (2 * h->max_block_size + 8), dst, end, dstn,
+			    cpus))
+			return 0;
 	}
 
 	while (1) {
@@ -111,17 +289,14 @@ int ulz4fn(const void *src, size_t srcn, void *dst, size_t *dstn)
 
 		if (b.not_compressed) {
 			size_t size = min((ptrdiff_t)b.size, end - out);
-			memcpy(out, in, size);
+			memmove(out, in, size);	/* may be in place */
 			out += size;
 			if (size < b.size) {
 				ret = -ENOBUFS;	/* output overrun */
 				break;
 			}
 		} else {
-			/* constant folding essential, do not touch params! */
-			ret = LZ4_decompress_generic(in, out, b.size,
-					end - out, endOnInputSize,
-					full, 0, noDict, out, NULL, 0);
+			ret = lz4_decode_block(in, out, b.size, end - out);
 			if (ret < 0) {
 				ret = -EPROTO;	/* decompression error */
 				break;
@@ -137,3 +312,45 @@ int ulz4fn(const void *src, size_t srcn, void *dst, size_t *dstn)
 	*dstn = out - dst;
 	return ret;
 }
+
+int ulz4fn(const void *src, size_t srcn, void *dst, size_t *dstn)
+{
+	int cpus = srcn >= LZ4_MP_MIN ? mp_run_count() : 1;
+
+	return ulz4fn_cpus(src, srcn, dst, dstn, cpus);
+}
+
+int ulz4fn_size(const void *src, size_t srcn, size_t *sizep)
+{
+	const struct lz4_frame_header *h = src;
+	const void *in = src + sizeof(*h);
+	size_t span, size = 0;
+	struct lz4_block_header b;
+
+	if (srcn < sizeof(*h) + sizeof(u64) + sizeof(u8))
+		return -EINVAL;
+	if (le32_to_cpu(h->magic) != LZ4F_MAGIC || h->version != 1)
+		return -EPROTONOSUPPORT;
+	if (h->has_content_size) {
+		*sizep = le64_to_cpu(get_unaligned((u64 *)in));
+		return 0;
+	}
+	if (h->max_block_size < 4)
+		return -EINVAL;
+	in += sizeof(u8);
+
+	/* Stored blocks give their size, others at most the maximum */
+	while (in - src + sizeof(u32) <= srcn) {
+		span = lz4_block_span(in, h->has_block_checksum);
+		if (!span) {
+			*sizep = size;
+			return 0;
+		}
+		b.raw = le32_to_cpu(*(u32 *)in);
+		size += b.not_compressed ? b.size :
+			1 << (2 * h->max_block_size + 8);
+		in += span;
+	}
+
+	return -EINVAL;
+}
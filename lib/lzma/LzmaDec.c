@@ -47,6 +47,23 @@
   i -= 0x40; }
 #endif
 
+/* A literal is always 8 bits, so its tree is decoded without a loop */
+#ifdef _LZMA_SIZE_OPT
+#define LITER_DECODE(probs, i) \
+  { i = 1; do { TREE_GET_BIT(probs, i); } while (i < 0x100); }
+#else
+#define LITER_DECODE(probs, i) \
+  { i = 1; \
+  TREE_GET_BIT(probs, i); \
+  TREE_GET_BIT(probs, i); \
+  TREE_GET_BIT(probs, i); \
+  TREE_GET_BIT(probs, i); \
+  TREE_GET_BIT(probs, i); \
+  TREE_GET_BIT(probs, i); \
+  TREE_GET_BIT(probs, i); \
+  TREE_GET_BIT(probs, i); }
+#endif
+
 #define NORMALIZE_CHECK if (range < kTopValue) { if (buf >= bufLimit) return DUMMY_ERROR; range <<= 8; code = (code << 8) | (*buf++); }
 
 #define IF_BIT_0_CHECK(p) ttt = *(p); NORMALIZE_CHECK; bound = (range >> kNumBitModelTotalBits) * ttt; if (code < bound)
@@ -118,6 +135,12 @@ StopCompilingDueBUG
 
 #define LZMA_DIC_MIN (1 << 12)
 
+/*
+ * The decode loop does not reset the watchdog itself, which would cost a
+ * call per symbol; it is run for at most this much output at a time
+ */
+#define LZMA_WATCHDOG_CHUNK (1 << 16)
+
 /* First LZMA-symbol is always decoded.
 And it decodes new LZMA-symbols while (buf < bufLimit), but "buf" is without last normalization
 Out:
@@ -153,8 +176,6 @@ static int MY_FAST_CALL LzmaDec_DecodeReal(CLzmaDec *p, SizeT limit, const Byte
   UInt32 range = p->range;
   UInt32 code = p->code;
 
-  WATCHDOG_RESET();
-
   do
   {
     CLzmaProb *prob;
@@ -175,11 +196,7 @@ static int MY_FAST_CALL LzmaDec_DecodeReal(CLzmaDec *p, SizeT limit, const Byte
       if (state < kNumLitStates)
       {
         state -= (state < 4) ? state : 3;
-        symbol = 1;
-
-        WATCHDOG_RESET();
-
-        do { GET_BIT(prob + symbol, symbol) } while (symbol < 0x100);
+        LITER_DECODE(prob, symbol);
       }
       else
       {
@@ -188,16 +205,20 @@ static int MY_FAST_CALL LzmaDec_DecodeReal(CLzmaDec *p, SizeT limit, const Byte
         state -= (state < 10) ? 3 : 6;
         symbol = 1;
 
-        WATCHDOG_RESET();
-
+        /*
+         * offs keeps 0x100 while the decoded bits match matchByte and
+         * drops to 0 at the first mismatch; the masks pick the probs for
+         * either case without a branch on the match bit
+         */
         do
         {
           unsigned bit;
           CLzmaProb *probLit;
-          matchByte <<= 1;
-          bit = (matchByte & offs);
-          probLit = prob + offs + bit + symbol;
-          GET_BIT2(probLit, symbol, offs &= ~bit, offs &= bit)
+          matchByte += matchByte;
+          bit = offs;
+          offs &= matchByte;
+          probLit = prob + (offs + bit + symbol);
+          GET_BIT2(probLit, symbol, offs ^= bit, ;)
         }
         while (symbol < 0x100);
       }
@@ -321,8 +342,6 @@ static int MY_FAST_CALL LzmaDec_DecodeReal(CLzmaDec *p, SizeT limit, const Byte
               UInt32 mask = 1;
               unsigned i = 1;
 
-              WATCHDOG_RESET();
-
               do
               {
                 GET_BIT2(prob + i, i, ; , distance |= mask);
@@ -335,8 +354,6 @@ static int MY_FAST_CALL LzmaDec_DecodeReal(CLzmaDec *p, SizeT limit, const Byte
           {
             numDirectBits -= kNumAlignBits;
 
-            WATCHDOG_RESET();
-
             do
             {
               NORMALIZE
@@ -409,17 +426,16 @@ static int MY_FAST_CALL LzmaDec_DecodeReal(CLzmaDec *p, SizeT limit, const Byte
           const Byte *lim = dest + curLen;
           dicPos += curLen;
 
-          WATCHDOG_RESET();
-
-          do
-            *(dest) = (Byte)*(dest + src);
-          while (++dest != lim);
+          /* Most long matches do not overlap their own output */
+          if (curLen >= 16 && (src < 0 ? -src : src) >= (ptrdiff_t)curLen)
+            memcpy(dest, dest + src, curLen);
+          else
+            do
+              *(dest) = (Byte)*(dest + src);
+            while (++dest != lim);
         }
         else
         {
-
-          WATCHDOG_RESET();
-
           do
           {
             dic[dicPos++] = dic[pos];
@@ -433,8 +449,6 @@ static int MY_FAST_CALL LzmaDec_DecodeReal(CLzmaDec *p, SizeT limit, const Byte
   }
   while (dicPos < limit && buf < bufLimit);
 
-  WATCHDOG_RESET();
-
   NORMALIZE;
   p->buf = buf;
   p->range = range;
@@ -482,12 +496,15 @@ static int MY_FAST_CALL LzmaDec_DecodeReal2(CLzmaDec *p, SizeT limit, const Byte
   do
   {
     SizeT limit2 = limit;
+    if (limit2 - p->dicPos > LZMA_WATCHDOG_CHUNK)
+      limit2 = p->dicPos + LZMA_WATCHDOG_CHUNK;
     if (p->checkDicSize == 0)
     {
       UInt32 rem = p->prop.dicSize - p->processedPos;
-      if (limit - p->dicPos > rem)
+      if (limit2 - p->dicPos > rem)
         limit2 = p->dicPos + rem;
     }
+    WATCHDOG_RESET();
     RINOK(LzmaDec_DecodeReal(p, limit2, bufLimit));
     if (p->processedPos >= p->prop.dicSize)
       p->checkDicSize = p->prop.dicSize;
@@ -21,8 +21,9 @@
 #include <config.h>
 #include <common.h>
 #include <watchdog.h>
+#include <asm/unaligned.h>
 
-#ifdef CONFIG_LZMA
+#if CONFIG_IS_ENABLED(LZMA)
 
 #define LZMA_PROPERTIES_OFFSET 0
 #define LZMA_SIZE_OFFSET       LZMA_PROPS_SIZE
@@ -31,18 +32,58 @@
 #include "LzmaTools.h"
 #include "LzmaDec.h"
 
-#include <linux/string.h>
+#include <errno.h>
 #include <malloc.h>
+#include <linux/string.h>
+
+DECLARE_GLOBAL_DATA_PTR;
 
 static void *SzAlloc(void *p, size_t size) { return malloc(size); }
 static void SzFree(void *p, void *address) { free(address); }
 
+static ISzAlloc lzma_alloc = { SzAlloc, SzFree };
+
+/*
+ * The probability model of the last decoder, about 32KB for the usual
+ * lc=3, lp=0. A boot often decompresses several images, so it is kept for
+ * the next decoder rather than freed.
+ */
+static CLzmaProb *lzma_pool_probs;
+static UInt32 lzma_pool_num_probs;
+
+/* .bss cannot be used before relocation in U-Boot proper */
+static bool lzma_can_pool(void)
+{
+	return IS_ENABLED(CONFIG_SPL_BUILD) || (gd->flags & GD_FLG_RELOC);
+}
+
+static void lzma_dec_construct(CLzmaDec *p)
+{
+	LzmaDec_Construct(p);
+	if (lzma_can_pool()) {
+		/* LzmaDec_AllocateProbs() keeps it if it is the right size */
+		p->probs = lzma_pool_probs;
+		p->numProbs = lzma_pool_num_probs;
+		lzma_pool_probs = NULL;
+	}
+}
+
+static void lzma_dec_free_probs(CLzmaDec *p)
+{
+	if (lzma_can_pool() && !lzma_pool_probs) {
+		lzma_pool_probs = p->probs;
+		lzma_pool_num_probs = p->numProbs;
+		p->probs = NULL;
+	}
+	LzmaDec_FreeProbs(p, &lzma_alloc);
+}
+
 int lzmaBuffToBuffDecompress (unsigned char *outStream, SizeT *uncompressedSize,
                   unsigned char *inStream,  SizeT  length)
 {
     int res = SZ_ERROR_DATA;
     int i;
-    ISzAlloc g_Alloc;
+    CLzmaDec dec;
 
     SizeT outSizeFull = 0xFFFFFFFF; /* 4GBytes limit */
     SizeT outProcessed;
@@ -94,9 +135,6 @@ int lzmaBuffToBuffDecompress (unsigned char *outStream, SizeT *uncompressedSize,
     debug("LZMA: Uncompresed size............ 0x%zx\n", outSizeFull);
     debug("LZMA: Compresed size.............. 0x%zx\n", compressedSize);
 
-    g_Alloc.Alloc = SzAlloc;
-    g_Alloc.Free = SzFree;
-
     /* Short-circuit early if we know the buffer can't hold the results. */
     if (outSizeFull != (SizeT)-1 && *uncompressedSize < outSizeFull)
         return SZ_ERROR_OUTPUT_EOF;
@@ -106,10 +144,23 @@ int lzmaBuffToBuffDecompress (unsigned char *outStream, SizeT *uncompressedSize,
 
     WATCHDOG_RESET();
 
-    res = LzmaDecode(
-        outStream, &outProcessed,
-        inStream + LZMA_DATA_OFFSET, &compressedSize,
-        inStream, LZMA_PROPS_SIZE, LZMA_FINISH_END, &state, &g_Alloc);
+    /* As LzmaDecode(), but with the probabilities from the pool */
+    lzma_dec_construct(&dec);
+    res = LzmaDec_AllocateProbs(&dec, inStream, LZMA_PROPS_SIZE, &lzma_alloc);
+    if (res == SZ_OK) {
+        dec.dic = outStream;
+        dec.dicBufSize = outProcessed;
+        LzmaDec_Init(&dec);
+        res = LzmaDec_DecodeToDic(&dec, outProcessed,
+                                  inStream + LZMA_DATA_OFFSET, &compressedSize,
+                                  LZMA_FINISH_END, &state);
+        if (res == SZ_OK && state == LZMA_STATUS_NEEDS_MORE_INPUT)
+            res = SZ_ERROR_INPUT_EOF;
+        outProcessed = dec.dicPos;
+    } else {
+        outProcessed = 0;
+    }
+    lzma_dec_free_probs(&dec);
     *uncompressedSize = outProcessed;
 
     debug("LZMA: Uncompressed ............... 0x%zx\n", outProcessed);
@@ -121,4 +172,192 @@ int lzmaBuffToBuffDecompress (unsigned char *outStream, SizeT *uncompressedSize,
     return res;
 }
 
+#define LZMA_HEADER_SIZE	LZMA_DATA_OFFSET
+#define LZMA_SIZE_UNKNOWN	(~0ULL)
+
+/**
+ * struct lzma_stream - state of a streaming decompression
+ *
+ * @dec:	LZMA decoder; dec.dic is the dictionary, which is the
+ *		destination when there is no sink
+ * @header:	Stream header, collected until it is complete
+ * @header_len:	Number of header bytes seen so far
+ * @size:	Decompressed size from the header, or LZMA_SIZE_UNKNOWN
+ * @total:	Number of bytes decompressed so far
+ * @out:	Destination or dictionary buffer, or NULL
+ * @out_size:	Size of @out
+ * @sink:	Receives the dictionary as it fills, or NULL
+ * @priv:	Private data for @sink
+ * @own_dic:	The dictionary was allocated here
+ * @done:	The end of the stream has been seen
+ * @err:	First error, which every later call returns
+ */
+struct lzma_stream {
+	CLzmaDec dec;
+	unsigned char header[LZMA_HEADER_SIZE];
+	uint header_len;
+	u64 size;
+	u64 total;
+	void *out;
+	ulong out_size;
+	lzma_sink_t sink;
+	void *priv;
+	bool own_dic;
+	bool done;
+	int err;
+};
+
+struct lzma_stream *lzma_stream_start(void *out, ulong out_size,
+				      lzma_sink_t sink, void *priv)
+{
+	struct lzma_stream *ls;
+
+	ls = calloc(1, sizeof(*ls));
+	if (!ls)
+		return NULL;
+	lzma_dec_construct(&ls->dec);
+	ls->out = out;
+	ls->out_size = out_size;
+	ls->sink = sink;
+	ls->priv = priv;
+
+	return ls;
+}
+
+/* Set up the decoder and dictionary once the header is complete */
+static int lzma_stream_setup(struct lzma_stream *ls)
+{
+	CLzmaDec *dec = &ls->dec;
+	ulong dic_size;
+	SRes res;
+
+	res = LzmaDec_AllocateProbs(dec, ls->header, LZMA_PROPS_SIZE,
+				    &lzma_alloc);
+	if (res != SZ_OK)
+		return res == SZ_ERROR_MEM ? -ENOMEM : -EBADMSG;
+	ls->size = get_unaligned_le64(ls->header + LZMA_SIZE_OFFSET);
+
+	if (!ls->sink) {
+		if (ls->size != LZMA_SIZE_UNKNOWN && ls->size > ls->out_size)
+			return -ENOSPC;
+		dic_size = ls->out_size;
+	} else {
+		/* Matches reach back at most this far */
+		dic_size = dec->prop.dicSize;
+		if (ls->size < dic_size)
+			dic_size = max_t(ulong, ls->size, 1);
+		if (ls->out && ls->out_size < dic_size)
+			return -ENOSPC;
+	}
+	if (!ls->out) {
+		ls->out = malloc(dic_size);
+		if (!ls->out)
+			return -ENOMEM;
+		ls->own_dic = true;
+	}
+	dec->dic = ls->out;
+	dec->dicBufSize = dic_size;
+	LzmaDec_Init(dec);
+
+	return 0;
+}
+
+/* Pass what is in the dictionary to the sink, and start it again */
+static int lzma_stream_flush(struct lzma_stream *ls)
+{
+	CLzmaDec *dec = &ls->dec;
+	int ret;
+
+	if (!ls->sink || !dec->dicPos)
+		return 0;
+	ret = ls->sink(ls->priv, dec->dic, dec->dicPos);
+	dec->dicPos = 0;
+
+	return ret;
+}
+
+/* Check whether a stream of unknown size has filled the output buffer */
+static bool lzma_stream_full(struct lzma_stream *ls)
+{
+	return !ls->sink && ls->size == LZMA_SIZE_UNKNOWN &&
+		ls->dec.dicPos == ls->dec.dicBufSize;
+}
+
+int lzma_stream_write(struct lzma_stream *ls, const void *in, ulong len)
+{
+	CLzmaDec *dec = &ls->dec;
+	const unsigned char *src = in;
+
+	if (ls->err || ls->done)
+		return ls->err;
+
+	if (ls->header_len < LZMA_HEADER_SIZE) {
+		ulong n = min(len, (ulong)(LZMA_HEADER_SIZE - ls->header_len));
+
+		memcpy(ls->header + ls->header_len, src, n);
+		ls->header_len += n;
+		src += n;
+		len -= n;
+		if (ls->header_len < LZMA_HEADER_SIZE)
+			return 0;
+		ls->err = lzma_stream_setup(ls);
+	}
+
+	while (!ls->err && !ls->done) {
+		ELzmaFinishMode finish = LZMA_FINISH_ANY;
+		SizeT limit = dec->dicBufSize;
+		SizeT in_len = len;
+		SizeT pos = dec->dicPos;
+		ELzmaStatus status;
+
+		if (pos == dec->dicBufSize && ls->sink) {
+			ls->err = lzma_stream_flush(ls);
+			continue;
+		}
+		if (ls->size - ls->total <= limit - pos) {
+			limit = pos + (ls->size - ls->total);
+			finish = LZMA_FINISH_END;
+		} else if (!ls->sink) {
+			/* The stream must end by the end of the buffer */
+			finish = LZMA_FINISH_END;
+		}
+		if (LzmaDec_DecodeToDic(dec, limit, src, &in_len, finish,
+					&status) != SZ_OK)
+			ls->err = lzma_stream_full(ls) ? -ENOSPC : -EBADMSG;
+		ls->total += dec->dicPos - pos;
+		src += in_len;
+		len -= in_len;
+
+		if (status == LZMA_STATUS_FINISHED_WITH_MARK ||
+		    (status == LZMA_STATUS_MAYBE_FINISHED_WITHOUT_MARK &&
+		     ls->total == ls->size))
+			ls->done = !ls->err;
+		else if (status != LZMA_STATUS_NOT_FINISHED)
+			break;
+	}
+
+	return ls->err;
+}
+
+bool lzma_stream_done(struct lzma_stream *ls)
+{
+	return ls->done;
+}
+
+int lzma_stream_finish(struct lzma_stream *ls, ulong *lenp)
+{
+	int ret = ls->err;
+
+	if (lenp)
+		*lenp = ls->total;
+	if (!ret)
+		ret = ls->done ? lzma_stream_flush(ls) : -EBADMSG;
+	lzma_dec_free_probs(&ls->dec);
+	if (ls->own_dic)
+		free(ls->out);
+	free(ls);
+
+	return ret;
+}
+
 #endif
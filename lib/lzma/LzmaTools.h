@@ -16,4 +16,79 @@
 
 extern int lzmaBuffToBuffDecompress (unsigned char *outStream, SizeT *uncompressedSize,
 			      unsigned char *inStream,  SizeT  length);
+
+/**
+ * Streaming decompression
+ *
+ * An lzma_stream decompresses LZMA_Alone data (as made by 'lzma' or
+ * 'xz --format=lzma') as it arrives, e.g. a few sectors at a time from
+ * storage, so that the compressed image need not be staged in memory
+ * first.
+ *
+ * Output goes either straight to one buffer (no sink) or, a dictionary-full
+ * at a time, to a sink callback. In the second case the dictionary, which
+ * is as large as the image was compressed with or the whole output if that
+ * is smaller, is the only large buffer needed.
+ */
+struct lzma_stream;
+
+/**
+ * lzma_sink_t - receive decompressed data, in order
+ *
+ * @priv:	Private data passed to lzma_stream_start()
+ * @buf:	Decompressed data
+ * @len:	Number of bytes in @buf; only the last call may be short
+ * @return 0 if OK, -ve to stop decompressing
+ */
+typedef int (*lzma_sink_t)(void *priv, const void *buf, ulong len);
+
+/**
+ * lzma_stream_start() - start decompressing a stream
+ *
+ * @out:	The destination if @sink is NULL, else a buffer for the
+ *		dictionary (NULL to allocate one)
+ * @out_size:	Size of @out in bytes
+ * @sink:	Where to send the output, or NULL
+ * @priv:	Private data for @sink
+ * @return new stream, or NULL if out of memory
+ */
+struct lzma_stream *lzma_stream_start(void *out, ulong out_size,
+				      lzma_sink_t sink, void *priv);
+
+/**
+ * lzma_stream_write() - decompress the next piece of a stream
+ *
+ * Data after the end of the stream is ignored.
+ *
+ * @ls:		Stream
+ * @in:		Compressed data
+ * @len:	Number of bytes in @in
+ * @return 0 if OK, -EBADMSG if the data is corrupt, -ENOSPC if the output
+ *	buffer or dictionary buffer is too small, -ENOMEM if the dictionary
+ *	cannot be allocated, or the error returned by the sink. An error
+ *	sticks.
+ */
+int lzma_stream_write(struct lzma_stream *ls, const void *in, ulong len);
+
+/**
+ * lzma_stream_done() - check whether the end of a stream has been seen
+ *
+ * @ls:		Stream
+ * @return true if the whole stream has been decompressed
+ */
+bool lzma_stream_done(struct lzma_stream *ls);
+
+/**
+ * lzma_stream_finish() - finish decompressing and free a stream
+ *
+ * This passes any output still in the dictionary to the sink. It may also
+ * be used to give up on a stream.
+ *
+ * @ls:		Stream
+ * @lenp:	Returns the number of bytes decompressed, if not NULL
+ * @return 0 if the stream was complete, -EBADMSG if it was cut short, or
+ *	the error from lzma_stream_write()
+ */
+int lzma_stream_finish(struct lzma_stream *ls, ulong *lenp);
+
 #endif
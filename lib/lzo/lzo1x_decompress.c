@@ -75,6 +75,32 @@ static inline const unsigned char *parse_header(const unsigned char *src)
 	return src;
 }
 
+int lzop_get_size(const unsigned char *src, size_t src_len, size_t *dst_len)
+{
+	const unsigned char *send = src + src_len;
+	size_t size = 0;
+	u32 dlen;
+
+	src = parse_header(src);
+	if (!src)
+		return LZO_E_ERROR;
+
+	/* add up the uncompressed block sizes, as lzop_decompress() */
+	while (src + 4 <= send) {
+		dlen = get_unaligned_be32(src);
+		if (dlen == 0) {
+			*dst_len = size;
+			return LZO_E_OK;
+		}
+		if (src + 12 > send)
+			break;
+		size += dlen;
+		src += 12 + get_unaligned_be32(src + 4);
+	}
+
+	return LZO_E_INPUT_OVERRUN;
+}
+
 int lzop_decompress(const unsigned char *src, size_t src_len,
 		    unsigned char *dst, size_t *dst_len)
 {
@@ -112,10 +138,10 @@ int lzop_decompress(const unsigned char *src, size_t src_len,
 			return LZO_E_OUTPUT_OVERRUN;
 
 		/* When the input data is not compressed at all,
-		 * lzo1x_decompress_safe will fail, so call memcpy()
-		 * instead */
+		 * lzo1x_decompress_safe will fail, so call memmove()
+		 * instead, which also works when decompressing in place */
 		if (dlen == slen) {
-			memcpy(dst, src, slen);
+			memmove(dst, src, slen);
 		} else {
 			/* decompress */
 			tmp = dlen;
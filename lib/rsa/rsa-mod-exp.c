@@ -163,7 +163,7 @@ static int num_public_exponent_bits(const struct rsa_public_key *key,
 static int is_public_exponent_bit_set(const struct rsa_public_key *key,
 		int pos)
 {
-	return key->exponent & (1ULL << pos);
+	return !!(key->exponent & (1ULL << pos));
 }
 
 /**
@@ -247,8 +247,8 @@ static void rsa_convert_big_endian(uint32_t *dst, const uint32_t *src, int len)
 		dst[i] = fdt32_to_cpu(src[len - 1 - i]);
 }
 
-int rsa_mod_exp_sw(const uint8_t *sig, uint32_t sig_len,
-		struct key_prop *prop, uint8_t *out)
+static int rsa_mod_exp_basic(const uint8_t *sig, uint32_t sig_len,
+			     struct key_prop *prop, uint8_t *out)
 {
 	struct rsa_public_key key;
 	int ret;
@@ -302,6 +302,322 @@ int rsa_mod_exp_sw(const uint8_t *sig, uint32_t sig_len,
 	return 0;
 }
 
+/*
+ * The fast engine below works on limbs of the widest type the compiler can
+ * multiply into a double-width product, i.e. 64-bit limbs wherever there is
+ * a 128-bit type, which quarters the number of multiply-add steps of the
+ * 32-bit code above. Since R is 2^num_bits (that is what rsa,r-squared
+ * holds), the key must be a whole number of limbs; others are left to the
+ * code above.
+ */
+#ifdef __SIZEOF_INT128__
+typedef uint64_t rsa_limb;
+typedef unsigned __int128 rsa_dlimb;
+#else
+typedef uint32_t rsa_limb;
+typedef uint64_t rsa_dlimb;
+#endif
+
+#define RSA_LIMB_BITS		(sizeof(rsa_limb) * 8)
+#define RSA_MAX_LIMBS		(RSA_MAX_KEY_BITS / RSA_LIMB_BITS)
+
+/* Largest window of the exponentiation, needing 2^(n - 1) odd powers */
+#define RSA_MAX_WINDOW		4
+
+/**
+ * struct rsa_mont_key - RSA key prepared for the fast engine
+ *
+ * @len:	Number of limbs in the modulus
+ * @n0inv:	-1 / modulus[0] mod 2^RSA_LIMB_BITS
+ * @exponent:	Public exponent
+ * @modulus:	Modulus as little endian limb array
+ * @rr:		R^2 mod modulus as little endian limb array
+ */
+struct rsa_mont_key {
+	uint len;
+	rsa_limb n0inv;
+	uint64_t exponent;
+	rsa_limb modulus[RSA_MAX_LIMBS];
+	rsa_limb rr[RSA_MAX_LIMBS];
+};
+
+static rsa_limb rsa_get_limb_be(const uint8_t *src, uint len, uint i)
+{
+	const uint8_t *ptr = src + (len - 1 - i) * sizeof(rsa_limb);
+	rsa_limb val = 0;
+	uint j;
+
+	for (j = 0; j < sizeof(rsa_limb); j++)
+		val = val << 8 | ptr[j];
+
+	return val;
+}
+
+static void rsa_put_limb_be(rsa_limb val, uint8_t *dst, uint len, uint i)
+{
+	uint8_t *ptr = dst + (len - i) * sizeof(rsa_limb);
+	uint j;
+
+	for (j = 0; j < sizeof(rsa_limb); j++, val >>= 8)
+		*--ptr = (uint8_t)val;
+}
+
+static void rsa_mont_sub_modulus(const struct rsa_mont_key *key,
+				 rsa_limb num[])
+{
+	rsa_dlimb acc;
+	rsa_limb borrow = 0;
+	uint i;
+
+	for (i = 0; i < key->len; i++) {
+		acc = (rsa_dlimb)num[i] - key->modulus[i] - borrow;
+		num[i] = (rsa_limb)acc;
+		borrow = (rsa_limb)(acc >> RSA_LIMB_BITS) & 1;
+	}
+}
+
+static int rsa_mont_ge_modulus(const struct rsa_mont_key *key,
+			       const rsa_limb num[])
+{
+	int i;
+
+	for (i = (int)key->len - 1; i >= 0; i--) {
+		if (num[i] != key->modulus[i])
+			return num[i] > key->modulus[i];
+	}
+
+	return 1;  /* equal */
+}
+
+/**
+ * rsa_mont_mul() - Montgomery multiply with full-width limbs
+ *
+ * Operation: result[] = a[] * b[] / R % modulus, as montgomery_mul() but one
+ * limb of @a at a time. @result must not overlap @a or @b.
+ *
+ * @key:	Prepared RSA key
+ * @result:	Place to put result, as little endian limb array
+ * @a:		Multiplier, as little endian limb array
+ * @b:		Multiplicand, as little endian limb array
+ */
+static void rsa_mont_mul(const struct rsa_mont_key *key, rsa_limb result[],
+			 const rsa_limb a[], const rsa_limb b[])
+{
+	rsa_dlimb acc_a, acc_b;
+	rsa_limb d0;
+	uint i, j;
+
+	memset(result, '\0', key->len * sizeof(rsa_limb));
+	for (j = 0; j < key->len; j++) {
+		acc_a = (rsa_dlimb)a[j] * b[0] + result[0];
+		d0 = (rsa_limb)acc_a * key->n0inv;
+		acc_b = (rsa_dlimb)d0 * key->modulus[0] + (rsa_limb)acc_a;
+		for (i = 1; i < key->len; i++) {
+			acc_a = (acc_a >> RSA_LIMB_BITS) +
+				(rsa_dlimb)a[j] * b[i] + result[i];
+			acc_b = (acc_b >> RSA_LIMB_BITS) +
+				(rsa_dlimb)d0 * key->modulus[i] +
+				(rsa_limb)acc_a;
+			result[i - 1] = (rsa_limb)acc_b;
+		}
+
+		acc_a = (acc_a >> RSA_LIMB_BITS) + (acc_b >> RSA_LIMB_BITS);
+		result[i - 1] = (rsa_limb)acc_a;
+		if (acc_a >> RSA_LIMB_BITS)
+			rsa_mont_sub_modulus(key, result);
+	}
+}
+
+/**
+ * rsa_mont_pow() - Sliding-window public exponentiation
+ *
+ * F4 (65537) and 3 have only two bits set, so one multiply per set bit is
+ * already as few as possible and they go bit by bit like pow_mod(). Longer
+ * exponents are taken in windows of up to RSA_MAX_WINDOW bits ending in a
+ * set bit, each costing one multiply by a precomputed odd power.
+ *
+ * @key:	Prepared RSA key
+ * @sig:	Value as big endian byte array of @key->len limbs
+ * @out:	Result as big endian byte array of @key->len limbs
+ */
+static int rsa_mont_pow(const struct rsa_mont_key *key, const uint8_t *sig,
+			uint8_t *out)
+{
+	uint64_t exp = key->exponent;
+	int bits, ones, window, count, bit, low, win, j;
+	rsa_limb *acc, *tmp, *swap;
+	uint i;
+
+	for (bits = 0, ones = 0; bits < 64 && exp >> bits; bits++)
+		ones += exp >> bits & 1;
+
+	if (bits < 2) {
+		debug("Public exponent is too short (%d bits, minimum 2)\n",
+		      bits);
+		return -EINVAL;
+	}
+
+	if (!(exp & 1)) {
+		debug("LSB of RSA public exponent must be set.\n");
+		return -EINVAL;
+	}
+
+	if (ones <= 2)
+		window = 1;
+	else if (bits > 32)
+		window = RSA_MAX_WINDOW;
+	else
+		window = bits > 8 ? 3 : 2;
+	count = 1 << (window - 1);
+
+	rsa_limb val[key->len], buf1[key->len], buf2[key->len];
+	rsa_limb table[count][key->len];
+
+	for (i = 0; i < key->len; i++)
+		val[i] = rsa_get_limb_be(sig, key->len, i);
+
+	/* table[n] = val^(2n + 1) * R mod modulus */
+	rsa_mont_mul(key, table[0], val, key->rr);
+	if (count > 1) {
+		rsa_mont_mul(key, val, table[0], table[0]);
+		for (j = 1; j < count; j++)
+			rsa_mont_mul(key, table[j], table[j - 1], val);
+	}
+
+	/* The top bit is set, so the first window starts the result */
+	acc = buf1;
+	tmp = buf2;
+	for (bit = bits - 1; bit >= 0; bit = low - 1) {
+		if (!(exp >> bit & 1)) {
+			rsa_mont_mul(key, tmp, acc, acc);
+			swap = acc, acc = tmp, tmp = swap;
+			low = bit;
+			continue;
+		}
+
+		low = bit >= window ? bit - window + 1 : 0;
+		while (!(exp >> low & 1))
+			low++;
+		win = (exp >> low) & ((1 << (bit - low + 1)) - 1);
+
+		if (bit == bits - 1) {
+			memcpy(acc, table[win >> 1],
+			       key->len * sizeof(rsa_limb));
+			continue;
+		}
+		for (j = bit; j >= low; j--) {
+			rsa_mont_mul(key, tmp, acc, acc);
+			swap = acc, acc = tmp, tmp = swap;
+		}
+		rsa_mont_mul(key, tmp, acc, table[win >> 1]);
+		swap = acc, acc = tmp, tmp = swap;
+	}
+
+	/* Multiply by 1 to leave the Montgomery domain */
+	memset(val, '\0', key->len * sizeof(rsa_limb));
+	val[0] = 1;
+	rsa_mont_mul(key, tmp, acc, val);
+
+	/* Make sure result < mod; result is at most 1x mod too large. */
+	if (rsa_mont_ge_modulus(key, tmp))
+		rsa_mont_sub_modulus(key, tmp);
+
+	for (i = 0; i < key->len; i++)
+		rsa_put_limb_be(tmp[i], out, key->len, i);
+
+	return 0;
+}
+
+static uint64_t rsa_get_exponent(const struct key_prop *prop)
+{
+	if (!prop->public_exponent)
+		return RSA_DEFAULT_PUBEXP;
+
+	return fdt64_to_cpu(*((uint64_t *)(prop->public_exponent)));
+}
+
+static int rsa_mont_prepare(struct rsa_mont_key *key,
+			    const struct key_prop *prop)
+{
+	rsa_limb inv;
+	uint i;
+
+	key->len = prop->num_bits / RSA_LIMB_BITS;
+	key->exponent = rsa_get_exponent(prop);
+	for (i = 0; i < key->len; i++) {
+		key->modulus[i] = rsa_get_limb_be(prop->modulus, key->len, i);
+		key->rr[i] = rsa_get_limb_be(prop->rr, key->len, i);
+	}
+
+	if (!(key->modulus[0] & 1)) {
+		debug("%s: RSA modulus is even\n", __func__);
+		return -EINVAL;
+	}
+
+	/*
+	 * Widen the inverse rather than trusting rsa,n0-inverse to match:
+	 * each Newton step doubles the number of correct low bits, starting
+	 * from the three that any odd number has as its own inverse.
+	 */
+	for (inv = key->modulus[0], i = 3; i < RSA_LIMB_BITS; i *= 2)
+		inv *= 2 - key->modulus[0] * inv;
+	key->n0inv = -inv;
+
+	return 0;
+}
+
+static int rsa_mod_exp_fast(const uint8_t *sig, uint32_t sig_len,
+			    struct key_prop *prop, uint8_t *out)
+{
+	struct rsa_mont_key key;
+	int ret;
+
+	if (!prop) {
+		debug("%s: Skipping invalid prop", __func__);
+		return -EBADF;
+	}
+	if (!prop->num_bits || !prop->modulus || !prop->rr) {
+		debug("%s: Missing RSA key info", __func__);
+		return -EFAULT;
+	}
+	if (prop->num_bits > RSA_MAX_KEY_BITS ||
+	    prop->num_bits < RSA_MIN_KEY_BITS) {
+		debug("RSA key bits %u outside allowed range %d..%d\n",
+		      prop->num_bits, RSA_MIN_KEY_BITS, RSA_MAX_KEY_BITS);
+		return -EFAULT;
+	}
+	if (prop->num_bits % RSA_LIMB_BITS || sig_len * 8 != prop->num_bits)
+		return -EINVAL;
+
+	ret = rsa_mont_prepare(&key, prop);
+	if (ret)
+		return ret;
+
+	return rsa_mont_pow(&key, sig, out);
+}
+
+int rsa_mod_exp_sw_engine(enum rsa_mod_exp_engine engine, const uint8_t *sig,
+			  uint32_t sig_len, struct key_prop *prop, uint8_t *out)
+{
+	switch (engine) {
+	case RSA_MOD_EXP_ENGINE_BASIC:
+		return rsa_mod_exp_basic(sig, sig_len, prop, out);
+	case RSA_MOD_EXP_ENGINE_FAST:
+		return rsa_mod_exp_fast(sig, sig_len, prop, out);
+	default:
+		return -EINVAL;
+	}
+}
+
+int rsa_mod_exp_sw(const uint8_t *sig, uint32_t sig_len,
+		struct key_prop *prop, uint8_t *out)
+{
+	if (prop && !(prop->num_bits % RSA_LIMB_BITS))
+		return rsa_mod_exp_fast(sig, sig_len, prop, out);
+
+	return rsa_mod_exp_basic(sig, sig_len, prop, out);
+}
+
 /**
  * zynq_pow_mod() - in-place public exponentiation
  *
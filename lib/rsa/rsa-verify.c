@@ -6,6 +6,7 @@
 
 #ifndef USE_HOSTCC
 #include <common.h>
+#include <crypto.h>
 #include <fdtdec.h>
 #include <asm/types.h>
 #include <asm/byteorder.h>
@@ -58,6 +59,30 @@ static int rsa_verify_padding(const uint8_t *msg, const int pad_len,
 	return ret;
 }
 
+#if defined(CONFIG_DM_CRYPTO) && !defined(USE_HOSTCC)
+/* Run the mod_exp on a crypto engine, if there is one for it */
+static int rsa_mod_exp_offload(const uint8_t *sig, uint32_t sig_len,
+			       struct key_prop *prop, uint8_t *out)
+{
+	struct crypto_job job = {
+		.type = CRYPTO_JOB_MOD_EXP,
+		.prop = prop,
+		.in = sig,
+		.in_len = sig_len,
+		.out = out,
+		.out_len = sig_len,
+	};
+
+	return crypto_run(&job);
+}
+#else
+static int rsa_mod_exp_offload(const uint8_t *sig, uint32_t sig_len,
+			       struct key_prop *prop, uint8_t *out)
+{
+	return -ENODEV;
+}
+#endif
+
 /**
  * rsa_verify_key() - Verify a signature against some data using RSA Key
  *
@@ -102,13 +127,16 @@ static int rsa_verify_key(struct key_prop *prop, const uint8_t *sig,
 	uint8_t buf[sig_len];
 
 #if !defined(USE_HOSTCC)
-	ret = uclass_get_device(UCLASS_MOD_EXP, 0, &mod_exp_dev);
-	if (ret) {
-		printf("RSA: Can't find Modular Exp implementation\n");
-		return -EINVAL;
-	}
+	ret = rsa_mod_exp_offload(sig, sig_len, prop, buf);
+	if (ret == -ENODEV) {
+		ret = uclass_get_device(UCLASS_MOD_EXP, 0, &mod_exp_dev);
+		if (ret) {
+			printf("RSA: Can't find Modular Exp implementation\n");
+			return -EINVAL;
+		}
 
-	ret = rsa_mod_exp(mod_exp_dev, sig, sig_len, prop, buf);
+		ret = rsa_mod_exp(mod_exp_dev, sig, sig_len, prop, buf);
+	}
 #else
 	ret = rsa_mod_exp_sw(sig, sig_len, prop, buf);
 #endif
@@ -15,6 +15,29 @@
 #include <watchdog.h>
 #include <u-boot/sha256.h>
 
+/*
+ * Pick the SHA-256 engines to build. The accelerated ones are only used in
+ * U-Boot itself; host tools always get the C rounds.
+ */
+#ifndef USE_HOSTCC
+#if defined(CONFIG_ARM64) && defined(CONFIG_SHA256_ARMV8_CE)
+#define SHA256_ARMV8_CE
+#endif
+#if defined(CONFIG_SANDBOX) && defined(CONFIG_SHA256_SHA_NI) && \
+	defined(__x86_64__)
+#define SHA256_SHA_NI
+#endif
+#endif
+
+/*
+ * Block functions from arch code. Each hashes @blocks whole 64-byte blocks
+ * into @state, which is laid out as in sha256_context.
+ */
+void sha256_ce_transform(uint32_t state[8], const uint8_t *data,
+			 uint32_t blocks);
+void sha256_ni_transform(uint32_t state[8], const uint8_t *data,
+			 uint32_t blocks);
+
 const uint8_t sha256_der_prefix[SHA256_DER_LEN] = {
 	0x30, 0x31, 0x30, 0x0d, 0x06, 0x09, 0x60, 0x86,
 	0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x01, 0x05,
@@ -187,7 +210,111 @@ static void sha256_process(sha256_context *ctx, const uint8_t data[64])
 	ctx->state[7] += H;
 }
 
-void sha256_update(sha256_context *ctx, const uint8_t *input, uint32_t length)
+#ifdef SHA256_ARMV8_CE
+/*
+ * The SHA-256 instructions are optional in the ARMv8.0 Crypto Extensions,
+ * so check ID_AA64ISAR0_EL1 rather than assuming them. This is a single
+ * register read, which keeps it usable before relocation.
+ */
+static int sha256_armv8_ce_present(void)
+{
+	uint64_t isar0;
+
+	asm volatile("mrs %0, id_aa64isar0_el1" : "=r" (isar0));
+
+	return ((isar0 >> 12) & 0xf) != 0;
+}
+#endif
+
+#ifdef SHA256_SHA_NI
+static void sha256_cpuid(uint32_t leaf, uint32_t regs[4])
+{
+	asm volatile("cpuid"
+		     : "=a" (regs[0]), "=b" (regs[1]), "=c" (regs[2]),
+		       "=d" (regs[3])
+		     : "a" (leaf), "c" (0));
+}
+
+/*
+ * The SHA extensions code also uses SSSE3 and SSE4.1 instructions. CPUID
+ * traps to the hypervisor when running in a VM, so only ask once.
+ */
+static int sha256_sha_ni_present(void)
+{
+	static int present = -1;
+	uint32_t regs[4];
+
+	if (present < 0) {
+		present = 0;
+		sha256_cpuid(0, regs);
+		if (regs[0] >= 7) {
+			sha256_cpuid(1, regs);
+			if ((regs[2] & (1 << 9)) && (regs[2] & (1 << 19))) {
+				sha256_cpuid(7, regs);
+				present = !!(regs[1] & (1 << 29));
+			}
+		}
+	}
+
+	return present;
+}
+#endif
+
+int sha256_engine_supported(enum sha256_engine engine)
+{
+	switch (engine) {
+	case SHA256_ENGINE_C:
+		return 1;
+#ifdef SHA256_ARMV8_CE
+	case SHA256_ENGINE_ARMV8_CE:
+		return sha256_armv8_ce_present();
+#endif
+#ifdef SHA256_SHA_NI
+	case SHA256_ENGINE_SHA_NI:
+		return sha256_sha_ni_present();
+#endif
+	default:
+		return 0;
+	}
+}
+
+/* The fastest engine this CPU supports */
+static enum sha256_engine sha256_best_engine(void)
+{
+#ifdef SHA256_ARMV8_CE
+	if (sha256_armv8_ce_present())
+		return SHA256_ENGINE_ARMV8_CE;
+#endif
+#ifdef SHA256_SHA_NI
+	if (sha256_sha_ni_present())
+		return SHA256_ENGINE_SHA_NI;
+#endif
+	return SHA256_ENGINE_C;
+}
+
+static void sha256_blocks(enum sha256_engine engine, sha256_context *ctx,
+			  const uint8_t *data, uint32_t blocks)
+{
+	switch (engine) {
+#ifdef SHA256_ARMV8_CE
+	case SHA256_ENGINE_ARMV8_CE:
+		sha256_ce_transform(ctx->state, data, blocks);
+		break;
+#endif
+#ifdef SHA256_SHA_NI
+	case SHA256_ENGINE_SHA_NI:
+		sha256_ni_transform(ctx->state, data, blocks);
+		break;
+#endif
+	default:
+		for (; blocks; blocks--, data += 64)
+			sha256_process(ctx, data);
+		break;
+	}
+}
+
+void sha256_engine_update(enum sha256_engine engine, sha256_context *ctx,
+			  const uint8_t *input, uint32_t length)
 {
 	uint32_t left, fill;
 
@@ -203,24 +330,32 @@ void sha256_update(sha256_context *ctx, const uint8_t *input, uint32_t length)
 	if (ctx->total[0] < length)
 		ctx->total[1]++;
 
+	if (!sha256_engine_supported(engine))
+		engine = SHA256_ENGINE_C;
+
 	if (left && length >= fill) {
 		memcpy((void *) (ctx->buffer + left), (void *) input, fill);
-		sha256_process(ctx, ctx->buffer);
+		sha256_blocks(engine, ctx, ctx->buffer, 1);
 		length -= fill;
 		input += fill;
 		left = 0;
 	}
 
-	while (length >= 64) {
-		sha256_process(ctx, input);
-		length -= 64;
-		input += 64;
+	if (length >= 64) {
+		sha256_blocks(engine, ctx, input, length / 64);
+		input += length & ~0x3F;
+		length &= 0x3F;
 	}
 
 	if (length)
 		memcpy((void *) (ctx->buffer + left), (void *) input, length);
 }
 
+void sha256_update(sha256_context *ctx, const uint8_t *input, uint32_t length)
+{
+	sha256_engine_update(sha256_best_engine(), ctx, input, length);
+}
+
 static uint8_t sha256_padding[64] = {
 	0x80, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
 	   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
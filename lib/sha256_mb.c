@@ -0,0 +1,436 @@
+/*
+ * Multi-buffer SHA-256
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+/*
+ * SHA-256 is a chain of dependent rounds, so a single stream keeps only a
+ * small part of a CPU busy. Independent buffers, such as the subimages of a
+ * FIT, can instead be hashed side by side:
+ *
+ * - LANES runs the C rounds on vectors of four 32-bit words, each lane
+ *   carrying a different buffer. When a buffer is done its lane is given the
+ *   next one, and the last buffer standing is finished off on its own with
+ *   sha256_update(). The vectors are GCC vector extensions, so this becomes
+ *   NEON on ARMv8 and SSE2 in sandbox, and plain integer code elsewhere.
+ * - MP hands out the buffers, largest first, to whichever CPU has the least
+ *   to do, with the primary CPU doing its share.
+ *
+ * With the ARMv8 Crypto Extensions or the x86 SHA extensions a single stream
+ * is already faster than four lanes of C, so each CPU then hashes its
+ * buffers one after the other.
+ */
+
+#include <common.h>
+#include <mp_run.h>
+#include <watchdog.h>
+#include <asm/unaligned.h>
+#include <u-boot/sha256.h>
+
+#define SHA256_MB_LANES		4
+
+/* Largest number of buffers spread over the CPUs in one go */
+#define SHA256_MB_BATCH		32
+#define SHA256_MB_MAX_CPUS	8
+
+/* Starting secondary CPUs is not worth it for less than this in total */
+#define SHA256_MB_MP_MIN	(256 * 1024)
+
+/* Reset the watchdog each time each lane has hashed this many blocks */
+#define SHA256_MB_WD_BLOCKS	(CHUNKSZ_SHA256 / 64)
+
+typedef uint32_t sha256_mb_vec __attribute__((vector_size(4 * SHA256_MB_LANES)));
+
+static const uint32_t sha256_mb_k[64] = {
+	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+	0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+	0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+	0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+	0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+	0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+	0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+	0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+	0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+	0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+	0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+	0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+	0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+	0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+	0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+static const uint32_t sha256_mb_iv[8] = {
+	0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+	0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+};
+
+/*
+ * Buffers still to be hashed by one CPU: the entries of @jobs whose @owner
+ * is @cpu, or all of them if @owner is NULL
+ */
+struct sha256_mb_queue {
+	struct sha256_mb_job *jobs;
+	int count;
+	const uint8_t *owner;
+	int cpu;
+	int next;
+	bool primary;		/* Running on the CPU that owns the watchdog */
+};
+
+struct sha256_mb_lane {
+	struct sha256_mb_job *job;	/* NULL if the lane is idle */
+	const uint8_t *data;		/* Next block to hash */
+	uint32_t blocks;		/* Blocks left at @data */
+	bool tail;			/* @data points into @pad */
+	uint8_t pad[128];		/* Last partial block and padding */
+};
+
+/* Check whether there are any buffers left in the queue */
+static bool sha256_mb_more(struct sha256_mb_queue *q)
+{
+	while (q->next < q->count && q->owner && q->owner[q->next] != q->cpu)
+		q->next++;
+
+	return q->next < q->count;
+}
+
+static struct sha256_mb_job *sha256_mb_next(struct sha256_mb_queue *q)
+{
+	return sha256_mb_more(q) ? &q->jobs[q->next++] : NULL;
+}
+
+static bool sha256_mb_have_hw(void)
+{
+	int engine;
+
+	for (engine = SHA256_ENGINE_C + 1; engine < SHA256_ENGINE_COUNT;
+	     engine++) {
+		if (sha256_engine_supported(engine))
+			return true;
+	}
+
+	return false;
+}
+
+static void sha256_mb_serial(struct sha256_mb_queue *q)
+{
+	struct sha256_mb_job *job;
+	sha256_context ctx;
+
+	while ((job = sha256_mb_next(q))) {
+		if (q->primary) {
+			sha256_csum_wd(job->data, job->len, job->digest,
+				       CHUNKSZ_SHA256);
+		} else {
+			sha256_starts(&ctx);
+			sha256_update(&ctx, job->data, job->len);
+			sha256_finish(&ctx, job->digest);
+		}
+	}
+}
+
+#define MB_ROR(x, n)	(((x) >> (n)) | ((x) << (32 - (n))))
+#define MB_S0(x)	(MB_ROR(x, 7) ^ MB_ROR(x, 18) ^ ((x) >> 3))
+#define MB_S1(x)	(MB_ROR(x, 17) ^ MB_ROR(x, 19) ^ ((x) >> 10))
+#define MB_S2(x)	(MB_ROR(x, 2) ^ MB_ROR(x, 13) ^ MB_ROR(x, 22))
+#define MB_S3(x)	(MB_ROR(x, 6) ^ MB_ROR(x, 11) ^ MB_ROR(x, 25))
+
+/* Hash one 64-byte block in each lane */
+static void sha256_mb_block(sha256_mb_vec state[8],
+			    const uint8_t *const data[SHA256_MB_LANES])
+{
+	sha256_mb_vec w[16], s[8], t1, t2;
+	int i;
+
+	for (i = 0; i < 16; i++) {
+		w[i] = (sha256_mb_vec){
+			get_unaligned_be32(data[0] + 4 * i),
+			get_unaligned_be32(data[1] + 4 * i),
+			get_unaligned_be32(data[2] + 4 * i),
+			get_unaligned_be32(data[3] + 4 * i),
+		};
+	}
+
+	for (i = 0; i < 8; i++)
+		s[i] = state[i];
+
+	for (i = 0; i < 64; i++) {
+		if (i >= 16)
+			w[i & 15] += MB_S1(w[(i - 2) & 15]) + w[(i - 7) & 15] +
+				     MB_S0(w[(i - 15) & 15]);
+		t1 = s[7] + MB_S3(s[4]) + ((s[4] & s[5]) ^ (~s[4] & s[6])) +
+		     sha256_mb_k[i] + w[i & 15];
+		t2 = MB_S2(s[0]) + ((s[0] & s[1]) | (s[2] & (s[0] | s[1])));
+		s[7] = s[6];
+		s[6] = s[5];
+		s[5] = s[4];
+		s[4] = s[3] + t1;
+		s[3] = s[2];
+		s[2] = s[1];
+		s[1] = s[0];
+		s[0] = t1 + t2;
+	}
+
+	for (i = 0; i < 8; i++)
+		state[i] += s[i];
+}
+
+/* Put the last partial block of the lane's job and the padding in @pad */
+static void sha256_mb_lane_tail(struct sha256_mb_lane *lane)
+{
+	uint32_t len = lane->job->len;
+	uint32_t rem = len % 64;
+	uint64_t bits = (uint64_t)len << 3;
+	int end;
+
+	memcpy(lane->pad, lane->job->data + len - rem, rem);
+	memset(lane->pad + rem, '\0', sizeof(lane->pad) - rem);
+	lane->pad[rem] = 0x80;
+	lane->blocks = rem < 56 ? 1 : 2;
+	end = lane->blocks * 64;
+	put_unaligned_be32(bits >> 32, lane->pad + end - 8);
+	put_unaligned_be32(bits, lane->pad + end - 4);
+	lane->data = lane->pad;
+	lane->tail = true;
+}
+
+static void sha256_mb_lane_start(struct sha256_mb_lane *lane,
+				 sha256_mb_vec state[8], int l,
+				 struct sha256_mb_job *job)
+{
+	int i;
+
+	lane->job = job;
+	if (!job)
+		return;
+
+	for (i = 0; i < 8; i++)
+		state[i][l] = sha256_mb_iv[i];
+	lane->data = job->data;
+	lane->blocks = job->len / 64;
+	lane->tail = false;
+	if (!lane->blocks)
+		sha256_mb_lane_tail(lane);
+}
+
+/* Finish the last busy lane with the fastest single-stream code */
+static void sha256_mb_lane_finish(struct sha256_mb_queue *q,
+				  struct sha256_mb_lane *lane,
+				  sha256_mb_vec state[8], int l)
+{
+	struct sha256_mb_job *job = lane->job;
+	uint32_t done = lane->data - job->data;
+	uint32_t chunk;
+	sha256_context ctx;
+	int i;
+
+	ctx.total[0] = done;
+	ctx.total[1] = 0;
+	for (i = 0; i < 8; i++)
+		ctx.state[i] = state[i][l];
+	for (; done < job->len; done += chunk) {
+		chunk = min_t(uint32_t, job->len - done, CHUNKSZ_SHA256);
+		sha256_update(&ctx, job->data + done, chunk);
+		if (q->primary)
+			WATCHDOG_RESET();
+	}
+	sha256_finish(&ctx, job->digest);
+	lane->job = NULL;
+}
+
+static void sha256_mb_lanes(struct sha256_mb_queue *q)
+{
+	static const uint8_t idle[64];
+	struct sha256_mb_lane lane[SHA256_MB_LANES];
+	const uint8_t *data[SHA256_MB_LANES];
+	sha256_mb_vec state[8];
+	uint rounds = 0;
+	int active, l, i;
+
+	memset(state, '\0', sizeof(state));
+	for (l = 0, active = 0; l < SHA256_MB_LANES; l++) {
+		sha256_mb_lane_start(&lane[l], state, l, sha256_mb_next(q));
+		if (lane[l].job)
+			active++;
+	}
+
+	while (active) {
+		/* One buffer left: no point in hashing three idle lanes */
+		if (active == 1 && !sha256_mb_more(q)) {
+			for (l = 0; !lane[l].job; l++)
+				;
+			if (!lane[l].tail) {
+				sha256_mb_lane_finish(q, &lane[l], state, l);
+				break;
+			}
+		}
+
+		for (l = 0; l < SHA256_MB_LANES; l++)
+			data[l] = lane[l].job ? lane[l].data : idle;
+		sha256_mb_block(state, data);
+		if (q->primary && !(++rounds % SHA256_MB_WD_BLOCKS))
+			WATCHDOG_RESET();
+
+		for (l = 0; l < SHA256_MB_LANES; l++) {
+			struct sha256_mb_lane *ln = &lane[l];
+
+			if (!ln->job)
+				continue;
+			ln->data += 64;
+			if (--ln->blocks)
+				continue;
+			if (!ln->tail) {
+				sha256_mb_lane_tail(ln);
+				continue;
+			}
+
+			for (i = 0; i < 8; i++)
+				put_unaligned_be32(state[i][l],
+						   ln->job->digest + 4 * i);
+			sha256_mb_lane_start(ln, state, l, sha256_mb_next(q));
+			if (!ln->job)
+				active--;
+		}
+	}
+}
+
+/* Hash a queue on the CPU we are running on */
+static void sha256_mb_local(void *arg)
+{
+	struct sha256_mb_queue *q = arg;
+
+	if (sha256_mb_have_hw())
+		sha256_mb_serial(q);
+	else
+		sha256_mb_lanes(q);
+}
+
+/*
+ * Give each buffer to the CPU with the least work so far, largest buffer
+ * first, then let the secondary CPUs and this one loose on their queues
+ */
+static void sha256_mb_mp_batch(struct sha256_mb_job *jobs, int count,
+			       int cpus)
+{
+	struct sha256_mb_queue queue[SHA256_MB_MAX_CPUS];
+	uint64_t load[SHA256_MB_MAX_CPUS] = { 0 };
+	uint8_t owner[SHA256_MB_BATCH];
+	bool started[SHA256_MB_MAX_CPUS] = { false };
+	int i, j, cpu, largest;
+
+	memset(owner, 0xff, sizeof(owner));
+	for (i = 0; i < count; i++) {
+		largest = -1;
+		for (j = 0; j < count; j++) {
+			if (owner[j] == 0xff &&
+			    (largest < 0 || jobs[j].len > jobs[largest].len))
+				largest = j;
+		}
+		for (cpu = 0, j = 1; j < cpus; j++) {
+			if (load[j] < load[cpu])
+				cpu = j;
+		}
+		owner[largest] = cpu;
+		load[cpu] += jobs[largest].len;
+	}
+
+	for (cpu = 0; cpu < cpus; cpu++) {
+		queue[cpu] = (struct sha256_mb_queue){
+			.jobs = jobs,
+			.count = count,
+			.owner = owner,
+			.cpu = cpu,
+			.primary = true,
+		};
+		if (cpu && load[cpu]) {
+			queue[cpu].primary = false;
+			started[cpu] = !mp_run_start(cpu, sha256_mb_local,
+						     &queue[cpu]);
+		}
+	}
+
+	sha256_mb_local(&queue[0]);
+	for (cpu = 1; cpu < cpus; cpu++) {
+		if (started[cpu] && !mp_run_wait(cpu))
+			continue;
+		if (!load[cpu])
+			continue;
+		/* Do the work ourselves if the CPU could not */
+		debug("%s: CPU %d not available\n", __func__, cpu);
+		queue[cpu].next = 0;
+		queue[cpu].primary = true;
+		sha256_mb_local(&queue[cpu]);
+	}
+}
+
+static void sha256_mb_mp(struct sha256_mb_job *jobs, int count)
+{
+	int cpus = min(mp_run_count(), SHA256_MB_MAX_CPUS);
+	int i;
+
+	/* Make sure the engine checks have been done before CPUs share them */
+	sha256_mb_have_hw();
+	for (i = 0; i < count; i += SHA256_MB_BATCH)
+		sha256_mb_mp_batch(jobs + i, min(count - i, SHA256_MB_BATCH),
+				   cpus);
+}
+
+int sha256_mb_engine_supported(enum sha256_mb_engine engine)
+{
+	switch (engine) {
+	case SHA256_MB_ENGINE_SERIAL:
+	case SHA256_MB_ENGINE_LANES:
+		return 1;
+	case SHA256_MB_ENGINE_MP:
+		return mp_run_count() > 1;
+	default:
+		return 0;
+	}
+}
+
+void sha256_mb_engine_hash(enum sha256_mb_engine engine,
+			   struct sha256_mb_job *jobs, int count)
+{
+	struct sha256_mb_queue q = {
+		.jobs = jobs,
+		.count = count,
+		.primary = true,
+	};
+
+	if (!sha256_mb_engine_supported(engine))
+		engine = SHA256_MB_ENGINE_SERIAL;
+
+	switch (engine) {
+	case SHA256_MB_ENGINE_LANES:
+		sha256_mb_lanes(&q);
+		break;
+	case SHA256_MB_ENGINE_MP:
+		sha256_mb_mp(jobs, count);
+		break;
+	default:
+		sha256_mb_serial(&q);
+		break;
+	}
+}
+
+void sha256_mb_hash(struct sha256_mb_job *jobs, int count)
+{
+	struct sha256_mb_queue q = {
+		.jobs = jobs,
+		.count = count,
+		.primary = true,
+	};
+	uint64_t total = 0;
+	int i;
+
+	for (i = 0; i < count; i++)
+		total += jobs[i].len;
+
+	if (count > 1 && total >= SHA256_MB_MP_MIN &&
+	    sha256_mb_engine_supported(SHA256_MB_ENGINE_MP))
+		sha256_mb_mp(jobs, count);
+	else
+		sha256_mb_local(&q);
+}
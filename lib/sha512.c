@@ -0,0 +1,396 @@
+/*
+ * FIPS-180-2 compliant SHA-384/512 implementation
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#ifndef USE_HOSTCC
+#include <common.h>
+#include <linux/string.h>
+#else
+#include <string.h>
+#endif /* USE_HOSTCC */
+#include <watchdog.h>
+#include <u-boot/sha512.h>
+
+/*
+ * Pick the SHA512 engines to build. The accelerated one is only used in
+ * U-Boot itself; host tools always get the C rounds.
+ */
+#ifndef USE_HOSTCC
+#if defined(CONFIG_ARM64) && defined(CONFIG_SHA512_ARMV8_CE)
+#define SHA512_ARMV8_CE
+#endif
+#endif
+
+/*
+ * Block function from arch code. It hashes @blocks whole 128-byte blocks
+ * into @state, which is laid out as in sha512_context.
+ */
+void sha512_ce_transform(uint64_t state[8], const uint8_t *data,
+			 uint32_t blocks);
+
+const uint8_t sha384_der_prefix[SHA384_DER_LEN] = {
+	0x30, 0x41, 0x30, 0x0d, 0x06, 0x09, 0x60, 0x86,
+	0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x02, 0x05,
+	0x00, 0x04, 0x30
+};
+
+const uint8_t sha512_der_prefix[SHA512_DER_LEN] = {
+	0x30, 0x51, 0x30, 0x0d, 0x06, 0x09, 0x60, 0x86,
+	0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x03, 0x05,
+	0x00, 0x04, 0x40
+};
+
+/*
+ * 64-bit integer manipulation macros (big endian)
+ */
+#define GET_UINT64_BE(n, b, i) {			\
+	(n) = ((uint64_t)(b)[(i)    ] << 56)		\
+	    | ((uint64_t)(b)[(i) + 1] << 48)		\
+	    | ((uint64_t)(b)[(i) + 2] << 40)		\
+	    | ((uint64_t)(b)[(i) + 3] << 32)		\
+	    | ((uint64_t)(b)[(i) + 4] << 24)		\
+	    | ((uint64_t)(b)[(i) + 5] << 16)		\
+	    | ((uint64_t)(b)[(i) + 6] <<  8)		\
+	    | ((uint64_t)(b)[(i) + 7]      );		\
+}
+
+#define PUT_UINT64_BE(n, b, i) {			\
+	(b)[(i)    ] = (uint8_t)((n) >> 56);		\
+	(b)[(i) + 1] = (uint8_t)((n) >> 48);		\
+	(b)[(i) + 2] = (uint8_t)((n) >> 40);		\
+	(b)[(i) + 3] = (uint8_t)((n) >> 32);		\
+	(b)[(i) + 4] = (uint8_t)((n) >> 24);		\
+	(b)[(i) + 5] = (uint8_t)((n) >> 16);		\
+	(b)[(i) + 6] = (uint8_t)((n) >>  8);		\
+	(b)[(i) + 7] = (uint8_t)((n)      );		\
+}
+
+static const uint64_t sha512_k[80] = {
+	0x428a2f98d728ae22ULL, 0x7137449123ef65cdULL, 0xb5c0fbcfec4d3b2fULL,
+	0xe9b5dba58189dbbcULL, 0x3956c25bf348b538ULL, 0x59f111f1b605d019ULL,
+	0x923f82a4af194f9bULL, 0xab1c5ed5da6d8118ULL, 0xd807aa98a3030242ULL,
+	0x12835b0145706fbeULL, 0x243185be4ee4b28cULL, 0x550c7dc3d5ffb4e2ULL,
+	0x72be5d74f27b896fULL, 0x80deb1fe3b1696b1ULL, 0x9bdc06a725c71235ULL,
+	0xc19bf174cf692694ULL, 0xe49b69c19ef14ad2ULL, 0xefbe4786384f25e3ULL,
+	0x0fc19dc68b8cd5b5ULL, 0x240ca1cc77ac9c65ULL, 0x2de92c6f592b0275ULL,
+	0x4a7484aa6ea6e483ULL, 0x5cb0a9dcbd41fbd4ULL, 0x76f988da831153b5ULL,
+	0x983e5152ee66dfabULL, 0xa831c66d2db43210ULL, 0xb00327c898fb213fULL,
+	0xbf597fc7beef0ee4ULL, 0xc6e00bf33da88fc2ULL, 0xd5a79147930aa725ULL,
+	0x06ca6351e003826fULL, 0x142929670a0e6e70ULL, 0x27b70a8546d22ffcULL,
+	0x2e1b21385c26c926ULL, 0x4d2c6dfc5ac42aedULL, 0x53380d139d95b3dfULL,
+	0x650a73548baf63deULL, 0x766a0abb3c77b2a8ULL, 0x81c2c92e47edaee6ULL,
+	0x92722c851482353bULL, 0xa2bfe8a14cf10364ULL, 0xa81a664bbc423001ULL,
+	0xc24b8b70d0f89791ULL, 0xc76c51a30654be30ULL, 0xd192e819d6ef5218ULL,
+	0xd69906245565a910ULL, 0xf40e35855771202aULL, 0x106aa07032bbd1b8ULL,
+	0x19a4c116b8d2d0c8ULL, 0x1e376c085141ab53ULL, 0x2748774cdf8eeb99ULL,
+	0x34b0bcb5e19b48a8ULL, 0x391c0cb3c5c95a63ULL, 0x4ed8aa4ae3418acbULL,
+	0x5b9cca4f7763e373ULL, 0x682e6ff3d6b2b8a3ULL, 0x748f82ee5defb2fcULL,
+	0x78a5636f43172f60ULL, 0x84c87814a1f0ab72ULL, 0x8cc702081a6439ecULL,
+	0x90befffa23631e28ULL, 0xa4506cebde82bde9ULL, 0xbef9a3f7b2c67915ULL,
+	0xc67178f2e372532bULL, 0xca273eceea26619cULL, 0xd186b8c721c0c207ULL,
+	0xeada7dd6cde0eb1eULL, 0xf57d4f7fee6ed178ULL, 0x06f067aa72176fbaULL,
+	0x0a637dc5a2c898a6ULL, 0x113f9804bef90daeULL, 0x1b710b35131c471bULL,
+	0x28db77f523047d84ULL, 0x32caab7b40c72493ULL, 0x3c9ebe0a15c9bebcULL,
+	0x431d67c49c100d4cULL, 0x4cc5d4becb3e42b6ULL, 0x597f299cfc657e2aULL,
+	0x5fcb6fab3ad6faecULL, 0x6c44198c4a475817ULL,
+};
+
+void sha512_starts(sha512_context *ctx)
+{
+	ctx->count[0] = 0;
+	ctx->count[1] = 0;
+
+	ctx->state[0] = 0x6a09e667f3bcc908ULL;
+	ctx->state[1] = 0xbb67ae8584caa73bULL;
+	ctx->state[2] = 0x3c6ef372fe94f82bULL;
+	ctx->state[3] = 0xa54ff53a5f1d36f1ULL;
+	ctx->state[4] = 0x510e527fade682d1ULL;
+	ctx->state[5] = 0x9b05688c2b3e6c1fULL;
+	ctx->state[6] = 0x1f83d9abfb41bd6bULL;
+	ctx->state[7] = 0x5be0cd19137e2179ULL;
+}
+
+void sha384_starts(sha512_context *ctx)
+{
+	ctx->count[0] = 0;
+	ctx->count[1] = 0;
+
+	ctx->state[0] = 0xcbbb9d5dc1059ed8ULL;
+	ctx->state[1] = 0x629a292a367cd507ULL;
+	ctx->state[2] = 0x9159015a3070dd17ULL;
+	ctx->state[3] = 0x152fecd8f70e5939ULL;
+	ctx->state[4] = 0x67332667ffc00b31ULL;
+	ctx->state[5] = 0x8eb44a8768581511ULL;
+	ctx->state[6] = 0xdb0c2e0d64f98fa7ULL;
+	ctx->state[7] = 0x47b5481dbefa4fa4ULL;
+}
+
+#define ROTR64(x, n)	(((x) >> (n)) | ((x) << (64 - (n))))
+
+#define S0(x)	(ROTR64(x,  1) ^ ROTR64(x,  8) ^ ((x) >> 7))
+#define S1(x)	(ROTR64(x, 19) ^ ROTR64(x, 61) ^ ((x) >> 6))
+
+#define S2(x)	(ROTR64(x, 28) ^ ROTR64(x, 34) ^ ROTR64(x, 39))
+#define S3(x)	(ROTR64(x, 14) ^ ROTR64(x, 18) ^ ROTR64(x, 41))
+
+#define F0(x, y, z)	(((x) & (y)) | ((z) & ((x) | (y))))
+#define F1(x, y, z)	((z) ^ ((x) & ((y) ^ (z))))
+
+/*
+ * The message schedule is kept as a ring of 16 words rather than all 80,
+ * which keeps it in registers on 64-bit CPUs. R(j) extends it in place.
+ */
+#define W0(j)	(W[(j)])
+#define R(j)	(W[(j)] += S1(W[((j) + 14) & 15]) + W[((j) + 9) & 15] + \
+			   S0(W[((j) + 1) & 15]))
+
+#define P(a, b, c, d, e, f, g, h, x, K) {		\
+	temp1 = h + S3(e) + F1(e, f, g) + K + x;	\
+	temp2 = S2(a) + F0(a, b, c);			\
+	d += temp1; h = temp1 + temp2;			\
+}
+
+/* Sixteen rounds starting at sha512_k[i], loading words with X() */
+#define ROUNDS16(X) {							\
+	P(A, B, C, D, E, F, G, H, X(0),  sha512_k[i +  0]);		\
+	P(H, A, B, C, D, E, F, G, X(1),  sha512_k[i +  1]);		\
+	P(G, H, A, B, C, D, E, F, X(2),  sha512_k[i +  2]);		\
+	P(F, G, H, A, B, C, D, E, X(3),  sha512_k[i +  3]);		\
+	P(E, F, G, H, A, B, C, D, X(4),  sha512_k[i +  4]);		\
+	P(D, E, F, G, H, A, B, C, X(5),  sha512_k[i +  5]);		\
+	P(C, D, E, F, G, H, A, B, X(6),  sha512_k[i +  6]);		\
+	P(B, C, D, E, F, G, H, A, X(7),  sha512_k[i +  7]);		\
+	P(A, B, C, D, E, F, G, H, X(8),  sha512_k[i +  8]);		\
+	P(H, A, B, C, D, E, F, G, X(9),  sha512_k[i +  9]);		\
+	P(G, H, A, B, C, D, E, F, X(10), sha512_k[i + 10]);		\
+	P(F, G, H, A, B, C, D, E, X(11), sha512_k[i + 11]);		\
+	P(E, F, G, H, A, B, C, D, X(12), sha512_k[i + 12]);		\
+	P(D, E, F, G, H, A, B, C, X(13), sha512_k[i + 13]);		\
+	P(C, D, E, F, G, H, A, B, X(14), sha512_k[i + 14]);		\
+	P(B, C, D, E, F, G, H, A, X(15), sha512_k[i + 15]);		\
+}
+
+static void sha512_process(uint64_t state[8], const uint8_t *data,
+			   uint32_t blocks)
+{
+	uint64_t temp1, temp2;
+	uint64_t W[16];
+	uint64_t A, B, C, D, E, F, G, H;
+	int i;
+
+	for (; blocks; blocks--, data += SHA512_BLOCK_SIZE) {
+		for (i = 0; i < 16; i++)
+			GET_UINT64_BE(W[i], data, i * 8);
+
+		A = state[0];
+		B = state[1];
+		C = state[2];
+		D = state[3];
+		E = state[4];
+		F = state[5];
+		G = state[6];
+		H = state[7];
+
+		i = 0;
+		ROUNDS16(W0);
+		for (i = 16; i < 80; i += 16)
+			ROUNDS16(R);
+
+		state[0] += A;
+		state[1] += B;
+		state[2] += C;
+		state[3] += D;
+		state[4] += E;
+		state[5] += F;
+		state[6] += G;
+		state[7] += H;
+	}
+}
+
+#ifdef SHA512_ARMV8_CE
+/*
+ * The SHA512 instructions were added in ARMv8.2 and are optional there, so
+ * check ID_AA64ISAR0_EL1: SHA2 reads 2 when they are present. This is a
+ * single register read, which keeps it usable before relocation.
+ */
+static int sha512_armv8_ce_present(void)
+{
+	uint64_t isar0;
+
+	asm volatile("mrs %0, id_aa64isar0_el1" : "=r" (isar0));
+
+	return ((isar0 >> 12) & 0xf) >= 2;
+}
+#endif
+
+int sha512_engine_supported(enum sha512_engine engine)
+{
+	switch (engine) {
+	case SHA512_ENGINE_C:
+		return 1;
+#ifdef SHA512_ARMV8_CE
+	case SHA512_ENGINE_ARMV8_CE:
+		return sha512_armv8_ce_present();
+#endif
+	default:
+		return 0;
+	}
+}
+
+/* The fastest engine this CPU supports */
+static enum sha512_engine sha512_best_engine(void)
+{
+#ifdef SHA512_ARMV8_CE
+	if (sha512_armv8_ce_present())
+		return SHA512_ENGINE_ARMV8_CE;
+#endif
+	return SHA512_ENGINE_C;
+}
+
+static void sha512_blocks(enum sha512_engine engine, sha512_context *ctx,
+			  const uint8_t *data, uint32_t blocks)
+{
+	switch (engine) {
+#ifdef SHA512_ARMV8_CE
+	case SHA512_ENGINE_ARMV8_CE:
+		sha512_ce_transform(ctx->state, data, blocks);
+		break;
+#endif
+	default:
+		sha512_process(ctx->state, data, blocks);
+		break;
+	}
+}
+
+void sha512_engine_update(enum sha512_engine engine, sha512_context *ctx,
+			  const uint8_t *input, uint32_t length)
+{
+	uint32_t left, fill;
+
+	if (!length)
+		return;
+
+	left = ctx->count[0] & (SHA512_BLOCK_SIZE - 1);
+	fill = SHA512_BLOCK_SIZE - left;
+
+	ctx->count[0] += length;
+	if (ctx->count[0] < length)
+		ctx->count[1]++;
+
+	if (!sha512_engine_supported(engine))
+		engine = SHA512_ENGINE_C;
+
+	if (left && length >= fill) {
+		memcpy(ctx->buf + left, input, fill);
+		sha512_blocks(engine, ctx, ctx->buf, 1);
+		length -= fill;
+		input += fill;
+		left = 0;
+	}
+
+	if (length >= SHA512_BLOCK_SIZE) {
+		sha512_blocks(engine, ctx, input, length / SHA512_BLOCK_SIZE);
+		input += length & ~(SHA512_BLOCK_SIZE - 1);
+		length &= SHA512_BLOCK_SIZE - 1;
+	}
+
+	if (length)
+		memcpy(ctx->buf + left, input, length);
+}
+
+void sha512_update(sha512_context *ctx, const uint8_t *input, uint32_t length)
+{
+	sha512_engine_update(sha512_best_engine(), ctx, input, length);
+}
+
+void sha384_update(sha512_context *ctx, const uint8_t *input, uint32_t length)
+{
+	sha512_update(ctx, input, length);
+}
+
+static const uint8_t sha512_padding[SHA512_BLOCK_SIZE] = {
+	0x80,
+};
+
+/* Pad the message and write out the first @len bytes of the state */
+static void sha512_finish_len(sha512_context *ctx, uint8_t *digest, int len)
+{
+	uint32_t last, padn;
+	uint8_t msglen[16];
+	int i;
+
+	PUT_UINT64_BE((ctx->count[1] << 3) | (ctx->count[0] >> 61), msglen, 0);
+	PUT_UINT64_BE(ctx->count[0] << 3, msglen, 8);
+
+	last = ctx->count[0] & (SHA512_BLOCK_SIZE - 1);
+	padn = (last < 112) ? (112 - last) : (240 - last);
+
+	sha512_update(ctx, sha512_padding, padn);
+	sha512_update(ctx, msglen, 16);
+
+	for (i = 0; i < len / 8; i++)
+		PUT_UINT64_BE(ctx->state[i], digest, i * 8);
+}
+
+void sha512_finish(sha512_context *ctx, uint8_t digest[SHA512_SUM_LEN])
+{
+	sha512_finish_len(ctx, digest, SHA512_SUM_LEN);
+}
+
+void sha384_finish(sha512_context *ctx, uint8_t digest[SHA384_SUM_LEN])
+{
+	sha512_finish_len(ctx, digest, SHA384_SUM_LEN);
+}
+
+static void sha512_csum_len(sha512_context *ctx, const unsigned char *input,
+			    unsigned int ilen, unsigned int chunk_sz)
+{
+#if defined(CONFIG_HW_WATCHDOG) || defined(CONFIG_WATCHDOG)
+	const unsigned char *end;
+	unsigned char *curr;
+	int chunk;
+
+	curr = (unsigned char *)input;
+	end = input + ilen;
+	while (curr < end) {
+		chunk = end - curr;
+		if (chunk > chunk_sz)
+			chunk = chunk_sz;
+		sha512_update(ctx, curr, chunk);
+		curr += chunk;
+		WATCHDOG_RESET();
+	}
+#else
+	sha512_update(ctx, input, ilen);
+#endif
+}
+
+/*
+ * Output = SHA-512( input buffer ). Trigger the watchdog every 'chunk_sz'
+ * bytes of input processed.
+ */
+void sha512_csum_wd(const unsigned char *input, unsigned int ilen,
+		unsigned char *output, unsigned int chunk_sz)
+{
+	sha512_context ctx;
+
+	sha512_starts(&ctx);
+	sha512_csum_len(&ctx, input, ilen, chunk_sz);
+	sha512_finish(&ctx, output);
+}
+
+/*
+ * Output = SHA-384( input buffer ). Trigger the watchdog every 'chunk_sz'
+ * bytes of input processed.
+ */
+void sha384_csum_wd(const unsigned char *input, unsigned int ilen,
+		unsigned char *output, unsigned int chunk_sz)
+{
+	sha512_context ctx;
+
+	sha384_starts(&ctx);
+	sha512_csum_len(&ctx, input, ilen, chunk_sz);
+	sha384_finish(&ctx, output);
+}
@@ -0,0 +1,63 @@
+/*
+ * Zstandard decompression for U-Boot
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <malloc.h>
+#include "zstd.h"
+
+/* zstd gets its memory from here; see common/zstd_deps.h */
+void *zstd_malloc(size_t size)
+{
+	return malloc(size);
+}
+
+void *zstd_calloc(size_t nmemb, size_t size)
+{
+	return calloc(nmemb, size);
+}
+
+void zstd_free(void *ptr)
+{
+	free(ptr);
+}
+
+int zstd_decompress(const void *src, size_t srcn, void *dst, size_t *dstn)
+{
+	size_t frame, len, out = 0;
+	ZSTD_ErrorCode err;
+	ZSTD_DCtx *dctx;
+	int ret = 0;
+
+	dctx = ZSTD_createDCtx();
+	if (!dctx)
+		return -ENOMEM;
+
+	/* Decompress each frame, stopping at whatever follows the last */
+	while (srcn) {
+		frame = ZSTD_findFrameCompressedSize(src, srcn);
+		if (ZSTD_isError(frame)) {
+			if (!out)
+				ret = -EINVAL;
+			break;
+		}
+		len = ZSTD_decompressDCtx(dctx, dst + out, *dstn - out, src,
+					  frame);
+		if (ZSTD_isError(len)) {
+			debug("%s: %s\n", __func__, ZSTD_getErrorName(len));
+			err = ZSTD_getErrorCode(len);
+			ret = err == ZSTD_error_dstSize_tooSmall ? -ENOBUFS :
+				-EINVAL;
+			break;
+		}
+		src += frame;
+		srcn -= frame;
+		out += len;
+	}
+	ZSTD_freeDCtx(dctx);
+	*dstn = out;
+
+	return ret;
+}
@@ -164,10 +164,12 @@ static void mcast_cleanup(void)
 
 #endif	/* CONFIG_MCAST_TFTP */
 
-static inline void store_block(int block, uchar *src, unsigned len)
+/* Returns where the block was put in memory, or NULL if it went to flash */
+static inline void *store_block(int block, uchar *src, unsigned len)
 {
 	ulong offset = block * tftp_block_size + tftp_block_wrap_offset;
 	ulong newsize = offset + len;
+	void *ptr = NULL;
 #ifdef CONFIG_SYS_DIRECT_FLASH_TFTP
 	int i, rc = 0;
 
@@ -186,12 +188,12 @@ static inline void store_block(int block, uchar *src, unsigned len)
 		if (rc) {
 			flash_perror(rc);
 			net_set_state(NETLOOP_FAIL);
-			return;
+			return NULL;
 		}
 	} else
 #endif /* CONFIG_SYS_DIRECT_FLASH_TFTP */
 	{
-		void *ptr = map_sysmem(load_addr + offset, len);
+		ptr = map_sysmem(load_addr + offset, len);
 
 		memcpy(ptr, src, len);
 		unmap_sysmem(ptr);
@@ -203,6 +205,8 @@ static inline void store_block(int block, uchar *src, unsigned len)
 
 	if (net_boot_file_size < newsize)
 		net_boot_file_size = newsize;
+
+	return ptr;
 }
 
 /* Clear our state ready for a new transfer */
@@ -322,6 +326,7 @@ static void tftp_complete(void)
 			time_start * 1000, "/s");
 	}
 	puts("\ndone\n");
+	fit_stream_end(net_boot_file_size);
 	net_set_state(NETLOOP_SUCCESS);
 }
 
@@ -462,6 +467,7 @@ static void tftp_handler(uchar *pkt, unsigned dest, struct in_addr sip,
 {
 	__be16 proto;
 	__be16 *s;
+	void *block;
 	int i;
 
 	if (dest != tftp_our_port) {
@@ -606,7 +612,7 @@ static void tftp_handler(uchar *pkt, unsigned dest, struct in_addr sip,
 		timeout_count_max = tftp_timeout_count_max;
 		net_set_timeout_handler(timeout_ms, tftp_timeout_handler);
 
-		store_block(tftp_cur_block - 1, pkt + 2, len);
+		block = store_block(tftp_cur_block - 1, pkt + 2, len);
 
 		/*
 		 *	Acknowledge the block just received, which will prompt
@@ -640,6 +646,9 @@ static void tftp_handler(uchar *pkt, unsigned dest, struct in_addr sip,
 #endif
 		tftp_send();
 
+		/* Hash the block while the server sends the next one */
+		fit_stream_update(block, len);
+
 #ifdef CONFIG_MCAST_TFTP
 		if (tftp_mcast_active) {
 			if (tftp_mcast_master_client &&
@@ -805,6 +814,7 @@ void tftp_start(enum proto_t protocol)
 		printf("Load address: 0x%lx\n", load_addr);
 		puts("Loading: *\b");
 		tftp_state = STATE_SEND_RRQ;
+		fit_stream_start(map_sysmem(load_addr, 0));
 #ifdef CONFIG_CMD_BOOTEFI
 		efi_set_bootdev("Net", "", tftp_filename);
 #endif
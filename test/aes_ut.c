@@ -0,0 +1,369 @@
+/*
+ * Tests and benchmark for the AES engines in lib/aes.c
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <command.h>
+#include <image.h>
+#include <libfdt.h>
+#include <malloc.h>
+#include <uboot_aes.h>
+#include <test/aes.h>
+#include <test/suites.h>
+#include <test/ut.h>
+
+DECLARE_GLOBAL_DATA_PTR;
+
+#define AES_BENCH_SIZE		(1 << 20)
+#define AES_BENCH_LOOPS		8
+#define AES_TEST_BLOCKS		37
+
+static const char * const engine_name[AES_ENGINE_COUNT] = {
+	[AES_ENGINE_BYTE]	= "byte",
+	[AES_ENGINE_TTABLE]	= "ttable",
+	[AES_ENGINE_ARMV8_CE]	= "armv8-ce",
+	[AES_ENGINE_AES_NI]	= "aes-ni",
+};
+
+/* FIPS-197 appendix C.1 */
+static const u8 fips_key[AES_KEY_LENGTH] = {
+	0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+	0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+};
+
+static const u8 fips_plain[AES_KEY_LENGTH] = {
+	0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+	0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff,
+};
+
+static const u8 fips_cipher[AES_KEY_LENGTH] = {
+	0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30,
+	0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a,
+};
+
+/* NIST SP 800-38A appendix F.2.1 and F.5.1 */
+static const u8 sp800_key[AES_KEY_LENGTH] = {
+	0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+	0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c,
+};
+
+static const u8 sp800_plain[4 * AES_KEY_LENGTH] = {
+	0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96,
+	0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a,
+	0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c,
+	0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51,
+	0x30, 0xc8, 0x1c, 0x46, 0xa3, 0x5c, 0xe4, 0x11,
+	0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef,
+	0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17,
+	0xad, 0x2b, 0x41, 0x7b, 0xe6, 0x6c, 0x37, 0x10,
+};
+
+static const u8 sp800_cbc_iv[AES_KEY_LENGTH] = {
+	0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+	0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+};
+
+static const u8 sp800_cbc_cipher[4 * AES_KEY_LENGTH] = {
+	0x76, 0x49, 0xab, 0xac, 0x81, 0x19, 0xb2, 0x46,
+	0xce, 0xe9, 0x8e, 0x9b, 0x12, 0xe9, 0x19, 0x7d,
+	0x50, 0x86, 0xcb, 0x9b, 0x50, 0x72, 0x19, 0xee,
+	0x95, 0xdb, 0x11, 0x3a, 0x91, 0x76, 0x78, 0xb2,
+	0x73, 0xbe, 0xd6, 0xb8, 0xe3, 0xc1, 0x74, 0x3b,
+	0x71, 0x16, 0xe6, 0x9e, 0x22, 0x22, 0x95, 0x16,
+	0x3f, 0xf1, 0xca, 0xa1, 0x68, 0x1f, 0xac, 0x09,
+	0x12, 0x0e, 0xca, 0x30, 0x75, 0x86, 0xe1, 0xa7,
+};
+
+static const u8 sp800_ctr[AES_KEY_LENGTH] = {
+	0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7,
+	0xf8, 0xf9, 0xfa, 0xfb, 0xfc, 0xfd, 0xfe, 0xff,
+};
+
+static const u8 sp800_ctr_cipher[4 * AES_KEY_LENGTH] = {
+	0x87, 0x4d, 0x61, 0x91, 0xb6, 0x20, 0xe3, 0x26,
+	0x1b, 0xef, 0x68, 0x64, 0x99, 0x0d, 0xb6, 0xce,
+	0x98, 0x06, 0xf6, 0x6b, 0x79, 0x70, 0xfd, 0xff,
+	0x86, 0x17, 0x18, 0x7b, 0xb9, 0xff, 0xfd, 0xff,
+	0x5a, 0xe4, 0xdf, 0x3e, 0xdb, 0xd5, 0xd3, 0x5e,
+	0x5b, 0x4f, 0x09, 0x02, 0x0d, 0xb0, 0x3e, 0xab,
+	0x1e, 0x03, 0x1d, 0xda, 0x2f, 0xbe, 0x03, 0xd1,
+	0x79, 0x21, 0x70, 0xa0, 0xf3, 0x00, 0x9c, 0xee,
+};
+
+static void fill_pattern(unsigned char *buf, uint len)
+{
+	uint32_t seed = 0x12345678;
+	uint i;
+
+	for (i = 0; i < len; i++) {
+		seed = seed * 1103515245 + 12345;
+		buf[i] = seed >> 16;
+	}
+}
+
+/* The single-block functions match FIPS-197 */
+static int aes_test_block(struct unit_test_state *uts)
+{
+	u8 key_exp[AES_EXPAND_KEY_LENGTH];
+	u8 buf[AES_KEY_LENGTH];
+
+	aes_expand_key((u8 *)fips_key, key_exp);
+	aes_encrypt((u8 *)fips_plain, key_exp, buf);
+	ut_assertok(memcmp(fips_cipher, buf, AES_KEY_LENGTH));
+	aes_decrypt(buf, key_exp, buf);
+	ut_assertok(memcmp(fips_plain, buf, AES_KEY_LENGTH));
+
+	return 0;
+}
+AES_TEST(aes_test_block, 0);
+
+/* Each engine matches the SP 800-38A CBC and CTR examples */
+static int aes_test_modes(struct unit_test_state *uts)
+{
+	u8 key_exp[AES_EXPAND_KEY_LENGTH];
+	u8 buf[sizeof(sp800_plain)];
+	u8 iv[AES_KEY_LENGTH];
+	int engine;
+
+	aes_expand_key((u8 *)sp800_key, key_exp);
+	for (engine = 0; engine < AES_ENGINE_COUNT; engine++) {
+		if (!aes_engine_supported(engine))
+			continue;
+
+		memcpy(iv, sp800_cbc_iv, sizeof(iv));
+		aes_engine_cbc_encrypt(engine, key_exp, iv, (u8 *)sp800_plain,
+				       buf, 4);
+		ut_assertok(memcmp(sp800_cbc_cipher, buf, sizeof(buf)));
+		ut_assertok(memcmp(sp800_cbc_cipher + 48, iv, sizeof(iv)));
+
+		memcpy(iv, sp800_cbc_iv, sizeof(iv));
+		aes_engine_cbc_decrypt(engine, key_exp, iv, buf, buf, 4);
+		ut_assertok(memcmp(sp800_plain, buf, sizeof(buf)));
+		ut_assertok(memcmp(sp800_cbc_cipher + 48, iv, sizeof(iv)));
+
+		/* The counter carries into the next byte after one block */
+		memcpy(iv, sp800_ctr, sizeof(iv));
+		aes_engine_ctr_crypt(engine, key_exp, iv, (u8 *)sp800_plain,
+				     buf, sizeof(buf));
+		ut_assertok(memcmp(sp800_ctr_cipher, buf, sizeof(buf)));
+		ut_asserteq(0x03, iv[15]);
+		ut_asserteq(0xff, iv[14]);
+	}
+
+	return 0;
+}
+AES_TEST(aes_test_modes, 0);
+
+/*
+ * All engines give the same results as the byte-wise code for any number
+ * of blocks, in place or not, with the counter wrapping past 64 bits
+ */
+static int aes_test_engines_agree(struct unit_test_state *uts)
+{
+	const uint size = AES_TEST_BLOCKS * AES_KEY_LENGTH;
+	u8 expect_iv[AES_KEY_LENGTH], iv[AES_KEY_LENGTH];
+	u8 key_exp[AES_EXPAND_KEY_LENGTH];
+	u8 *src, *expect, *buf;
+	int engine, in_place;
+	uint blocks, len;
+
+	src = malloc(size * 3);
+	ut_assertnonnull(src);
+	expect = src + size;
+	buf = expect + size;
+	fill_pattern(src, size);
+	aes_expand_key(src, key_exp);
+
+	for (engine = 0; engine < AES_ENGINE_COUNT; engine++) {
+		if (!aes_engine_supported(engine))
+			continue;
+		for (in_place = 0; in_place < 2; in_place++) {
+			for (blocks = 0; blocks <= AES_TEST_BLOCKS; blocks++) {
+				memcpy(expect_iv, src + 16, AES_KEY_LENGTH);
+				aes_engine_cbc_encrypt(AES_ENGINE_BYTE,
+						       key_exp, expect_iv, src,
+						       expect, blocks);
+				memcpy(iv, src + 16, AES_KEY_LENGTH);
+				memcpy(buf, src, size);
+				aes_engine_cbc_encrypt(engine, key_exp, iv,
+						       in_place ? buf : src,
+						       buf, blocks);
+				ut_assertok(memcmp(expect, buf,
+						   blocks * AES_KEY_LENGTH));
+				ut_assertok(memcmp(expect_iv, iv,
+						   AES_KEY_LENGTH));
+
+				memcpy(iv, src + 16, AES_KEY_LENGTH);
+				aes_engine_cbc_decrypt(engine, key_exp, iv,
+						       in_place ? buf : expect,
+						       buf, blocks);
+				ut_assertok(memcmp(src, buf,
+						   blocks * AES_KEY_LENGTH));
+				ut_assertok(memcmp(expect_iv, iv,
+						   AES_KEY_LENGTH));
+			}
+
+			for (len = 0; len <= size; len += 7) {
+				memset(expect_iv, '\0', 8);
+				memset(expect_iv + 8, 0xff, 8);
+				expect_iv[15] = 0xfd;
+				memcpy(iv, expect_iv, AES_KEY_LENGTH);
+				aes_engine_ctr_crypt(AES_ENGINE_BYTE, key_exp,
+						     expect_iv, src, expect,
+						     len);
+				memcpy(buf, src, size);
+				aes_engine_ctr_crypt(engine, key_exp, iv,
+						     in_place ? buf : src,
+						     buf, len);
+				ut_assertok(memcmp(expect, buf, len));
+				ut_assertok(memcmp(expect_iv, iv,
+						   AES_KEY_LENGTH));
+			}
+		}
+	}
+	free(src);
+
+	return 0;
+}
+AES_TEST(aes_test_engines_agree, 0);
+
+/* Report the throughput of each supported engine */
+static int aes_test_benchmark(struct unit_test_state *uts)
+{
+	u8 key_exp[AES_EXPAND_KEY_LENGTH];
+	u8 iv[AES_KEY_LENGTH];
+	ulong start, cbc_us, ctr_us;
+	unsigned char *buf;
+	int engine, i;
+
+	buf = malloc(AES_BENCH_SIZE);
+	ut_assertnonnull(buf);
+	fill_pattern(buf, AES_BENCH_SIZE);
+	aes_expand_key(buf, key_exp);
+	memset(iv, '\0', sizeof(iv));
+
+	for (engine = 0; engine < AES_ENGINE_COUNT; engine++) {
+		if (!aes_engine_supported(engine)) {
+			printf("%12s: not available\n", engine_name[engine]);
+			continue;
+		}
+
+		start = timer_get_us();
+		for (i = 0; i < AES_BENCH_LOOPS; i++)
+			aes_engine_cbc_decrypt(engine, key_exp, iv, buf, buf,
+					       AES_BENCH_SIZE / AES_KEY_LENGTH);
+		cbc_us = max(timer_get_us() - start, 1UL);
+
+		start = timer_get_us();
+		for (i = 0; i < AES_BENCH_LOOPS; i++)
+			aes_engine_ctr_crypt(engine, key_exp, iv, buf, buf,
+					     AES_BENCH_SIZE);
+		ctr_us = max(timer_get_us() - start, 1UL);
+
+		printf("%12s: cbc decrypt %lu KB/s, ctr %lu KB/s\n",
+		       engine_name[engine],
+		       (ulong)((u64)AES_BENCH_LOOPS * AES_BENCH_SIZE *
+			       1000000 / 1024 / cbc_us),
+		       (ulong)((u64)AES_BENCH_LOOPS * AES_BENCH_SIZE *
+			       1000000 / 1024 / ctr_us));
+	}
+	free(buf);
+
+	return 0;
+}
+AES_TEST(aes_test_benchmark, 0);
+
+#ifdef CONFIG_FIT_CIPHER
+/* Make a FIT image node with a cipher node, and a control FDT with a key */
+static int aes_test_make_fit(struct unit_test_state *uts, void *fit,
+			     void *blob, const char *algo, const void *data,
+			     int size, int unciphered, const u8 *iv)
+{
+	char name[40];
+	int node;
+
+	ut_assertok(fdt_create_empty_tree(fit, 1024));
+	node = fdt_add_subnode(fit, 0, "kernel");
+	ut_assert(node >= 0);
+	ut_assertok(fdt_setprop(fit, node, FIT_DATA_PROP, data, size));
+	if (unciphered)
+		ut_assertok(fdt_setprop_u32(fit, node,
+					    FIT_DATA_SIZE_UNCIPHERED_PROP,
+					    unciphered));
+	node = fdt_add_subnode(fit, node, FIT_CIPHER_NODENAME);
+	ut_assert(node >= 0);
+	ut_assertok(fdt_setprop_string(fit, node, FIT_ALGO_PROP, algo));
+	ut_assertok(fdt_setprop_string(fit, node, FIT_KEY_HINT_PROP, "test"));
+	ut_assertok(fdt_setprop(fit, node, FIT_IV_PROP, iv, AES_KEY_LENGTH));
+
+	ut_assertok(fdt_create_empty_tree(blob, 1024));
+	node = fdt_add_subnode(blob, 0, FIT_CIPHER_NODENAME);
+	ut_assert(node >= 0);
+	snprintf(name, sizeof(name), "key-%s-test", algo);
+	node = fdt_add_subnode(blob, node, name);
+	ut_assert(node >= 0);
+	ut_assertok(fdt_setprop(blob, node, "key", sp800_key,
+				AES_KEY_LENGTH));
+
+	return 0;
+}
+
+/* Encrypted FIT images are decrypted with the key from the control FDT */
+static int aes_test_fit_decrypt(struct unit_test_state *uts)
+{
+	const void *old_blob = gd->fdt_blob;
+	u8 fit[1024], blob[1024], out[sizeof(sp800_plain)];
+	int node, ret;
+	ulong len;
+
+	/* CBC, with the last 10 bytes being padding */
+	ut_assertok(aes_test_make_fit(uts, fit, blob, "aes128",
+				      sp800_cbc_cipher,
+				      sizeof(sp800_cbc_cipher),
+				      sizeof(sp800_plain) - 10, sp800_cbc_iv));
+	node = fdt_path_offset(fit, "/kernel");
+	ut_asserteq(1, fit_image_is_ciphered(fit, node));
+	gd->fdt_blob = blob;
+	ret = fit_image_decrypt(fit, node, sp800_cbc_cipher,
+				sizeof(sp800_cbc_cipher), out, &len);
+	gd->fdt_blob = old_blob;
+	ut_assertok(ret);
+	ut_asserteq(sizeof(sp800_plain) - 10, len);
+	ut_assertok(memcmp(sp800_plain, out, sizeof(out)));
+
+	/* CTR needs no padding */
+	ut_assertok(aes_test_make_fit(uts, fit, blob, "aes128-ctr",
+				      sp800_ctr_cipher, 50, 0, sp800_ctr));
+	node = fdt_path_offset(fit, "/kernel");
+	gd->fdt_blob = blob;
+	ret = fit_image_decrypt(fit, node, sp800_ctr_cipher, 50, out, &len);
+	gd->fdt_blob = old_blob;
+	ut_assertok(ret);
+	ut_asserteq(50, len);
+	ut_assertok(memcmp(sp800_plain, out, 50));
+
+	/* CBC data must be whole blocks, and the key must be there */
+	ut_assertok(aes_test_make_fit(uts, fit, blob, "aes128",
+				      sp800_cbc_cipher, 50, 0, sp800_cbc_iv));
+	node = fdt_path_offset(fit, "/kernel");
+	gd->fdt_blob = blob;
+	ret = fit_image_decrypt(fit, node, sp800_cbc_cipher, 50, out, &len);
+	gd->fdt_blob = old_blob;
+	ut_asserteq(-EINVAL, ret);
+	ut_asserteq(-ENOENT, fit_image_decrypt(fit, node, sp800_cbc_cipher,
+					       48, out, &len));
+
+	return 0;
+}
+AES_TEST(aes_test_fit_decrypt, 0);
+#endif
+
+int do_ut_aes(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
+{
+	struct unit_test *tests = ll_entry_start(struct unit_test, aes_test);
+	const int n_ents = ll_entry_count(struct unit_test, aes_test);
+
+	return cmd_ut_category("aes", tests, n_ents, argc, argv);
+}
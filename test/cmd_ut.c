@@ -50,6 +50,31 @@ static cmd_tbl_t cmd_ut_sub[] = {
 #ifdef CONFIG_UT_TIME
 	U_BOOT_CMD_MKENT(time, CONFIG_SYS_MAXARGS, 1, do_ut_time, "", ""),
 #endif
+#ifdef CONFIG_UT_CRC32
+	U_BOOT_CMD_MKENT(crc32, CONFIG_SYS_MAXARGS, 1, do_ut_crc32, "", ""),
+#endif
+#ifdef CONFIG_UT_SHA256
+	U_BOOT_CMD_MKENT(sha256, CONFIG_SYS_MAXARGS, 1, do_ut_sha256, "", ""),
+#endif
+#ifdef CONFIG_UT_SHA512
+	U_BOOT_CMD_MKENT(sha512, CONFIG_SYS_MAXARGS, 1, do_ut_sha512, "", ""),
+#endif
+#ifdef CONFIG_UT_RSA
+	U_BOOT_CMD_MKENT(rsa, CONFIG_SYS_MAXARGS, 1, do_ut_rsa, "", ""),
+#endif
+#ifdef CONFIG_UT_ECDSA
+	U_BOOT_CMD_MKENT(ecdsa, CONFIG_SYS_MAXARGS, 1, do_ut_ecdsa, "", ""),
+#endif
+#ifdef CONFIG_UT_AES
+	U_BOOT_CMD_MKENT(aes, CONFIG_SYS_MAXARGS, 1, do_ut_aes, "", ""),
+#endif
+#ifdef CONFIG_UT_FIT_STREAM
+	U_BOOT_CMD_MKENT(fit_stream, CONFIG_SYS_MAXARGS, 1, do_ut_fit_stream,
+			 "", ""),
+#endif
+#ifdef CONFIG_UT_NAI
+	U_BOOT_CMD_MKENT(nai, CONFIG_SYS_MAXARGS, 1, do_ut_nai, "", ""),
+#endif
 #ifdef CONFIG_SANDBOX
 	U_BOOT_CMD_MKENT(compression, CONFIG_SYS_MAXARGS, 1, do_ut_compression,
 			 "", ""),
@@ -106,6 +131,30 @@ static char ut_help_text[] =
 #ifdef CONFIG_UT_TIME
 	"ut time - Very basic test of time functions\n"
 #endif
+#ifdef CONFIG_UT_CRC32
+	"ut crc32 - Test and benchmark the CRC32 and CRC32C engines\n"
+#endif
+#ifdef CONFIG_UT_SHA256
+	"ut sha256 - Test and benchmark the SHA256 engines\n"
+#endif
+#ifdef CONFIG_UT_SHA512
+	"ut sha512 - Test and benchmark the SHA384/512 engines\n"
+#endif
+#ifdef CONFIG_UT_RSA
+	"ut rsa - Test and benchmark the RSA engines\n"
+#endif
+#ifdef CONFIG_UT_ECDSA
+	"ut ecdsa - Test and benchmark ECDSA P-256 verification\n"
+#endif
+#ifdef CONFIG_UT_AES
+	"ut aes - Test and benchmark the AES engines\n"
+#endif
+#ifdef CONFIG_UT_FIT_STREAM
+	"ut fit_stream - Test hashing FIT images while they are loaded\n"
+#endif
+#ifdef CONFIG_UT_NAI
+	"ut nai - Test the NAI serdes message packet pool\n"
+#endif
 #ifdef CONFIG_SANDBOX
 	"ut compression - Test compressors and bootm decompression\n"
 #endif
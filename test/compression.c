@@ -9,7 +9,9 @@
 #include <command.h>
 #include <malloc.h>
 #include <mapmem.h>
+#include <mp_run.h>
 #include <asm/io.h>
+#include <asm/unaligned.h>
 
 #include <u-boot/zlib.h>
 #include <bzlib.h>
@@ -71,6 +73,34 @@ static const char lzma_compressed[] =
 	"\xfd\xf5\x50\x8d\xca";
 static const unsigned long lzma_compressed_size = 229;
 
+/*
+ * 48 copies of plain.txt with the smallest dictionary, which holds only
+ * part of the output:
+ * xz --format=lzma --lzma1=dict=4KiB -c /tmp/plain48.txt > /tmp/plain48.lzma
+ */
+static const char lzma_dict4k_compressed[] =
+	"\x5d\x00\x10\x00\x00\xff\xff\xff\xff\xff\xff\xff\xff\x00\x24\x88"
+	"\x08\x26\xd8\x41\xff\x99\xc8\xcf\x66\x3d\x80\xac\xba\x17\xf1\xc8"
+	"\xb9\xdf\x49\x37\xb1\x68\xa0\x2a\xdd\x63\xd1\xa7\xa3\x66\xf8\x15"
+	"\xef\xa6\x67\x8a\x14\x18\x80\xcb\xc7\xb1\xcb\x84\x6a\xb2\x51\x16"
+	"\xa1\x45\xa0\xd6\x3e\x55\x44\x8a\x5c\xa0\x7c\xe5\xa8\xbd\x04\x57"
+	"\x8f\x24\xfd\xb9\x34\x50\x83\x2f\xf3\x46\x3e\xb9\xb0\x00\x1a\xf5"
+	"\xd3\x86\x7e\x8f\x77\xd1\x5d\x0e\x7c\xe1\xac\xde\xf8\x65\x1f\x4d"
+	"\xce\x7f\xa7\x3d\xaa\xcf\x26\xa7\x58\x69\x1e\x4c\xea\x68\x8a\xe5"
+	"\x89\xd1\xdc\x4d\xc7\xe0\x07\x42\xbf\x0c\x9d\x06\xd7\x51\xa2\x0b"
+	"\x7c\x83\x35\xe1\x85\xdf\xee\xfb\xa3\xee\x2f\x47\x5f\x8b\x70\x2b"
+	"\xe1\x37\xf3\x16\xf6\x27\x54\x8a\x33\x72\x49\xea\x53\x7d\x60\x0b"
+	"\x21\x90\x66\xe7\x9e\x56\x61\x5d\xd8\xdc\x59\xf0\xac\x2f\xd6\x49"
+	"\x6b\x85\x40\x08\x1f\xdf\x26\x25\x3b\x72\x44\xb0\xb8\x21\x2f\xb3"
+	"\xd7\x9b\x24\x30\x78\x26\x44\x07\xc3\x33\xf8\x90\x14\x22\xe4\xb2"
+	"\x20\x5e\xdc\xc4\x66\x68\x03\xba\xb6\x3c\xb2\xfa\xa7\xb6\x66\x2a"
+	"\xf2\x54\x3f\x0e\x24\x89\xcc\x5e\x2b\x6c\xc6\x44\x65\xf7\xa6\x16"
+	"\xf1\xdb\xc0\xe0\x13\x3e\x0d\x16\x0e\xad\x61\xa9\xfb\x55\x5e\x38"
+	"\xbe\x68\x55\xdb\x56\xff\xea\x48\xca\x51";
+static const unsigned long lzma_dict4k_compressed_size = 282;
+#define LZMA_DICT4K_COPIES	48
+#define LZMA_DICT4K_SIZE	4096
+
 /* lzop -c /tmp/plain.txt > /tmp/plain.lzo */
 static const char lzo_compressed[] =
 	"\x89\x4c\x5a\x4f\x00\x0d\x0a\x1a\x0a\x10\x30\x20\x60\x09\x40\x01"
@@ -118,6 +148,23 @@ static const char lz4_compressed[] =
 	"\x9d\x12\x8c\x9d";
 static const unsigned long lz4_compressed_size = 276;
 
+/* zstd -19 /tmp/plain.txt -o /tmp/plain.zst */
+static const char zstd_compressed[] =
+	"\x28\xb5\x2f\xfd\x64\x5e\x00\xad\x05\x00\x42\x4e\x26\x17\x90\x3b"
+	"\x07\x04\x5a\x13\x8b\xa7\x65\x34\x12\x21\x6d\xb0\x39\xbb\xae\xe8"
+	"\xba\xc9\xcd\x5e\x02\x49\xd0\x2b\xa9\xfa\x96\x92\xe7\x1f\x19\x19"
+	"\x7c\x8f\xf1\x9d\x54\x37\xfc\xd6\x0a\xf3\x0c\x93\x56\xc7\x52\x4f"
+	"\x0a\x62\x3e\xd1\xa5\x83\x17\x31\xab\x5d\x8f\x57\xf3\xcc\x3b\x58"
+	"\xf8\x91\x8c\xf1\x2a\x5c\x89\xdd\xf2\x9b\x15\xb7\x92\x5b\xbe\xba"
+	"\xab\xd5\xd1\x34\xdf\xf0\x02\x0e\x61\xcd\x7b\xd6\x01\xfc\xc2\xa7"
+	"\xd4\xd1\x3d\x26\x9c\x10\x49\xb8\x5b\xcd\xba\x7c\xf7\xac\x4b\xad"
+	"\xb7\x31\x1c\xbc\xf9\xcb\x62\x8e\x2e\x9b\x0f\xd3\x87\x57\x45\x12"
+	"\x16\xfa\x3a\x79\xde\x65\xf8\xcc\x48\xd5\x43\xa6\xbd\xc3\x91\x29"
+	"\x65\x29\xa7\x5b\x9a\x08\x08\x00\x60\x13\x00\x63\xa3\x8e\x28\x94"
+	"\x79\x41\x2a\x78\xc2\x91\x70\x9f\xaa\x6a\x21\x7a\xa1\xaa\x0c\xe4"
+	"\xf4\x6e\xfa";
+static const unsigned long zstd_compressed_size = 195;
+
 
 #define TEST_BUFFER_SIZE	512
 
@@ -293,6 +340,40 @@ static int uncompress_using_lz4(struct unit_test_state *uts,
 	return (ret != 0);
 }
 
+static int compress_using_zstd(struct unit_test_state *uts,
+			       void *in, unsigned long in_size,
+			       void *out, unsigned long out_max,
+			       unsigned long *out_size)
+{
+	/* There is no zstd compression in u-boot, so fake it. */
+	ut_asserteq(in_size,  strlen(plain));
+	ut_asserteq(0, memcmp(plain, in, in_size));
+
+	if (zstd_compressed_size > out_max)
+		return -1;
+
+	memcpy(out, zstd_compressed, zstd_compressed_size);
+	if (out_size)
+		*out_size = zstd_compressed_size;
+
+	return 0;
+}
+
+static int uncompress_using_zstd(struct unit_test_state *uts,
+				 void *in, unsigned long in_size,
+				 void *out, unsigned long out_max,
+				 unsigned long *out_size)
+{
+	size_t output_size = out_max;
+	int ret;
+
+	ret = zstd_decompress(in, in_size, out, &output_size);
+	if (out_size)
+		*out_size = output_size;
+
+	return (ret != 0);
+}
+
 #define errcheck(statement) if (!(statement)) { \
 	fprintf(stderr, "\tFailed: %s\n", #statement); \
 	ret = 1; \
@@ -437,6 +518,520 @@ static int compression_test_lz4(struct unit_test_state *uts)
 }
 COMPRESSION_TEST(compression_test_lz4, 0);
 
+static int compression_test_zstd(struct unit_test_state *uts)
+{
+	return run_test(uts, "zstd", compress_using_zstd,
+			uncompress_using_zstd);
+}
+COMPRESSION_TEST(compression_test_zstd, 0);
+
+#define SPEED_LOOPS	2000
+
+struct speed_codec {
+	const char *name;
+	mutate_func compress;
+	mutate_func uncompress;
+};
+
+static const struct speed_codec speed_codecs[] = {
+	{ "gzip", compress_using_gzip, uncompress_using_gzip },
+	{ "bzip2", compress_using_bzip2, uncompress_using_bzip2 },
+	{ "lzma", compress_using_lzma, uncompress_using_lzma },
+	{ "lzo", compress_using_lzo, uncompress_using_lzo },
+	{ "lz4", compress_using_lz4, uncompress_using_lz4 },
+	{ "zstd", compress_using_zstd, uncompress_using_zstd },
+};
+
+/* Compare the ratio and decompression speed of each codec on 'plain' */
+static int compression_test_speed(struct unit_test_state *uts)
+{
+	ulong orig_size = strlen(plain);
+	const struct speed_codec *codec;
+	char comp[TEST_BUFFER_SIZE];
+	char out[TEST_BUFFER_SIZE];
+	ulong comp_size, out_size;
+	ulong start, us;
+	int i;
+
+	printf("%-6s %6s %6s %8s\n", "codec", "size", "ratio", "MB/s");
+	for (codec = speed_codecs; codec < speed_codecs +
+	     ARRAY_SIZE(speed_codecs); codec++) {
+		ut_assertok(codec->compress(uts, (void *)plain, orig_size, comp,
+					    sizeof(comp), &comp_size));
+		start = timer_get_us();
+		for (i = 0; i < SPEED_LOOPS; i++) {
+			ut_assertok(codec->uncompress(uts, comp, comp_size, out,
+						      sizeof(out), &out_size));
+		}
+		us = max(timer_get_us() - start, 1UL);
+		ut_asserteq(orig_size, out_size);
+		ut_assertok(memcmp(plain, out, orig_size));
+		printf("%-6s %6lu %3lu.%02lu %8lu\n", codec->name, comp_size,
+		       orig_size / comp_size, orig_size * 100 / comp_size % 100,
+		       orig_size * SPEED_LOOPS / us);
+	}
+
+	return 0;
+}
+COMPRESSION_TEST(compression_test_speed, 0);
+
+#define LZ4_MP_BLOCK_CODE	4	/* 64KB blocks */
+#define LZ4_MP_BLOCK		(1 << (2 * LZ4_MP_BLOCK_CODE + 8))
+#define LZ4_MP_SIZE		(4 * 1024 * 1024 + 1000)
+#define LZ4_MP_PERIOD		16
+#define LZ4_MP_LOOPS		10
+
+static u8 *lz4_put_len(u8 *p, uint len)
+{
+	for (; len >= 255; len -= 255)
+		*p++ = 255;
+	*p++ = len;
+
+	return p;
+}
+
+/*
+ * There is no lz4 compression in u-boot, so write a frame by hand. Each
+ * block repeats a pattern of its own, so is one run of literals, one long
+ * match and the literals at the end that LZ4 needs. Every third block is
+ * stored instead. Block @short_block, if not -1, is made half size, which the
+ * lz4 tool never does.
+ */
+static ulong lz4_make_frame(u8 *frame, u8 *data, ulong size, int short_block)
+{
+	u8 *p = frame, *hdr;
+	ulong pos, len;
+	int block, i;
+
+	put_unaligned_le32(0x184d2204, p);
+	p += 4;
+	*p++ = 0x60;	/* version 1, independent blocks */
+	*p++ = LZ4_MP_BLOCK_CODE << 4;
+	*p++ = 0;	/* header checksum, not checked */
+
+	for (pos = 0, block = 0; pos < size; pos += len, block++) {
+		len = min(size - pos, (ulong)LZ4_MP_BLOCK);
+		if (block == short_block)
+			len /= 2;
+		for (i = 0; i < len; i++)
+			data[pos + i] = block * 37 + i % LZ4_MP_PERIOD * 11;
+
+		hdr = p;
+		p += 4;
+		if (block % 3 == 2 || len < 4 * LZ4_MP_PERIOD) {
+			memcpy(p, data + pos, len);
+			p += len;
+			put_unaligned_le32(len | 1U << 31, hdr);
+			continue;
+		}
+		/* 16 literals, a match at offset 16, then 16 more literals */
+		*p++ = 0xff;
+		p = lz4_put_len(p, LZ4_MP_PERIOD - 15);
+		memcpy(p, data + pos, LZ4_MP_PERIOD);
+		p += LZ4_MP_PERIOD;
+		put_unaligned_le16(LZ4_MP_PERIOD, p);
+		p += 2;
+		p = lz4_put_len(p, len - 2 * LZ4_MP_PERIOD - 4 - 15);
+		*p++ = 0xf0;
+		p = lz4_put_len(p, LZ4_MP_PERIOD - 15);
+		memcpy(p, data + pos + len - LZ4_MP_PERIOD, LZ4_MP_PERIOD);
+		p += LZ4_MP_PERIOD;
+		put_unaligned_le32(p - hdr - 4, hdr);
+	}
+	put_unaligned_le32(0, p);	/* end mark */
+	p += 4;
+
+	return p - frame;
+}
+
+/* Check that decompressing on @cpus CPUs gives what ulz4fn() gives */
+static int lz4_mp_check(struct unit_test_state *uts, u8 *frame,
+			ulong frame_size, u8 *out, u8 *expect, size_t out_size,
+			int cpus)
+{
+	size_t len = out_size, expect_len = out_size;
+	int ret, expect_ret;
+
+	expect_ret = ulz4fn_cpus(frame, frame_size, expect, &expect_len, 1);
+	memset(out, '\0', out_size);
+	ret = ulz4fn_cpus(frame, frame_size, out, &len, cpus);
+	ut_asserteq(expect_ret, ret);
+	ut_asserteq(expect_len, len);
+	ut_assertok(memcmp(expect, out, len));
+
+	return 0;
+}
+
+/* Decompressing an LZ4 frame on several CPUs gives the same result */
+static int compression_test_lz4_mp(struct unit_test_state *uts)
+{
+	u8 *data, *frame, *out, *expect, *in_place;
+	ulong frame_size;
+	size_t len;
+	int cpus;
+
+	data = malloc(LZ4_MP_SIZE);
+	frame = malloc(LZ4_MP_SIZE);
+	out = malloc(LZ4_MP_SIZE);
+	expect = malloc(LZ4_MP_SIZE);
+	ut_assertnonnull(data);
+	ut_assertnonnull(frame);
+	ut_assertnonnull(out);
+	ut_assertnonnull(expect);
+
+	frame_size = lz4_make_frame(frame, data, LZ4_MP_SIZE, -1);
+	for (cpus = 1; cpus <= 8; cpus++) {
+		len = LZ4_MP_SIZE;
+		ut_assertok(ulz4fn_cpus(frame, frame_size, out, &len, cpus));
+		ut_asserteq(LZ4_MP_SIZE, len);
+		ut_assertok(memcmp(data, out, len));
+	}
+	ut_assertok(lz4_mp_check(uts, frame, frame_size, out, expect,
+				 LZ4_MP_SIZE - 1, 4));
+	ut_assertok(lz4_mp_check(uts, frame, frame_size - 4, out, expect,
+				 LZ4_MP_SIZE, 4));
+
+	/* A block that is not full is found and the frame done again */
+	frame_size = lz4_make_frame(frame, data, LZ4_MP_SIZE, 10);
+	ut_assertok(lz4_mp_check(uts, frame, frame_size, out, expect,
+				 LZ4_MP_SIZE, 4));
+
+	/* Decompressing in place is left to one CPU */
+	frame_size = lz4_make_frame(frame, data, LZ4_MP_SIZE - LZ4_MP_BLOCK,
+				    -1);
+	in_place = out + LZ4_MP_SIZE - frame_size;
+	memcpy(in_place, frame, frame_size);
+	len = LZ4_MP_SIZE;
+	ut_assertok(ulz4fn_cpus(in_place, frame_size, out, &len, 4));
+	ut_asserteq(LZ4_MP_SIZE - LZ4_MP_BLOCK, len);
+	ut_assertok(memcmp(data, out, len));
+
+	free(expect);
+	free(out);
+	free(frame);
+	free(data);
+
+	return 0;
+}
+COMPRESSION_TEST(compression_test_lz4_mp, 0);
+
+/* Report the LZ4 decompression speed on one CPU and on all of them */
+static int compression_test_lz4_mp_speed(struct unit_test_state *uts)
+{
+	int cpu_counts[] = { 1, 2, 4, mp_run_count() };
+	u8 *data, *frame, *out;
+	ulong frame_size, start, us;
+	size_t len;
+	int i, j;
+
+	data = malloc(LZ4_MP_SIZE);
+	frame = malloc(LZ4_MP_SIZE);
+	out = malloc(LZ4_MP_SIZE);
+	ut_assertnonnull(data);
+	ut_assertnonnull(frame);
+	ut_assertnonnull(out);
+	frame_size = lz4_make_frame(frame, data, LZ4_MP_SIZE, -1);
+
+	printf("%d CPUs available\n", mp_run_count());
+	for (i = 0; i < ARRAY_SIZE(cpu_counts); i++) {
+		start = timer_get_us();
+		for (j = 0; j < LZ4_MP_LOOPS; j++) {
+			len = LZ4_MP_SIZE;
+			ut_assertok(ulz4fn_cpus(frame, frame_size, out, &len,
+						cpu_counts[i]));
+		}
+		us = max(timer_get_us() - start, 1UL);
+		ut_assertok(memcmp(data, out, LZ4_MP_SIZE));
+		printf("%d CPUs: %lu MB/s\n", cpu_counts[i],
+		       (ulong)((u64)LZ4_MP_SIZE * LZ4_MP_LOOPS / us));
+	}
+	free(out);
+	free(frame);
+	free(data);
+
+	return 0;
+}
+COMPRESSION_TEST(compression_test_lz4_mp_speed, 0);
+
+#define STREAM_SIZE	(256 * 1024)
+
+/* Where a stream test is collecting its output and reading its input */
+struct stream_state {
+	uint8_t *out;
+	ulong out_len;
+	ulong out_max;
+	int sink_calls;
+	int fail_after;		/* Sink calls before it fails, -1 for never */
+	const uint8_t *in;
+	ulong in_len;
+	ulong in_pos;
+	ulong in_chunk;
+};
+
+static int stream_sink(void *priv, const void *buf, ulong len)
+{
+	struct stream_state *st = priv;
+
+	if (st->sink_calls++ == st->fail_after)
+		return -EIO;
+	if (st->out_len + len > st->out_max)
+		return -ENOSPC;
+	memcpy(st->out + st->out_len, buf, len);
+	st->out_len += len;
+
+	return 0;
+}
+
+static long stream_source(void *priv, void *buf, ulong size)
+{
+	struct stream_state *st = priv;
+	ulong len = min(min(size, st->in_chunk), st->in_len - st->in_pos);
+
+	memcpy(buf, st->in + st->in_pos, len);
+	st->in_pos += len;
+
+	return len;
+}
+
+/* Feed @in_len bytes of @in to a new stream @chunk bytes at a time */
+static int stream_run(struct stream_state *st, void *out, ulong out_size,
+		      gzip_sink_t sink, uint flags, const uint8_t *in,
+		      ulong in_len, ulong chunk, ulong *lenp)
+{
+	struct gzip_stream *gs;
+	ulong pos, len;
+
+	gs = gzip_stream_start(out, out_size, sink, st, flags);
+	if (!gs)
+		return -ENOMEM;
+	for (pos = 0; pos < in_len; pos += len) {
+		len = min(chunk, in_len - pos);
+		if (gzip_stream_write(gs, in + pos, len))
+			break;
+	}
+
+	return gzip_stream_finish(gs, lenp);
+}
+
+/* Compressible data that is not just repeats */
+static void stream_fill(uint8_t *buf, ulong len)
+{
+	uint32_t seed = 1;
+	ulong i;
+
+	for (i = 0; i < len; i++) {
+		seed = seed * 1103515245 + 12345;
+		buf[i] = (seed >> 16) % 20 + 'a';
+	}
+}
+
+/* Streamed gzip data decompresses the same whatever the chunk sizes */
+static int compression_test_gzip_stream(struct unit_test_state *uts)
+{
+	static const ulong chunks[] = { 1, 7, 512, 4099, STREAM_SIZE };
+	struct stream_state st;
+	uint8_t *orig, *comp, *out;
+	ulong comp_len, len;
+	int i, offset;
+
+	orig = malloc(STREAM_SIZE);
+	comp = malloc(STREAM_SIZE);
+	out = malloc(STREAM_SIZE);
+	ut_assertnonnull(orig);
+	ut_assertnonnull(comp);
+	ut_assertnonnull(out);
+	stream_fill(orig, STREAM_SIZE);
+	comp_len = STREAM_SIZE;
+	ut_assertok(gzip(comp, &comp_len, orig, STREAM_SIZE));
+
+	/* Through a sink, with an odd-sized buffer */
+	for (i = 0; i < ARRAY_SIZE(chunks); i++) {
+		memset(&st, '\0', sizeof(st));
+		st.out = out;
+		st.out_max = STREAM_SIZE;
+		st.fail_after = -1;
+		ut_assertok(stream_run(&st, NULL, 1000, stream_sink, 0, comp,
+				       comp_len, chunks[i], &len));
+		ut_asserteq(STREAM_SIZE, len);
+		ut_asserteq(STREAM_SIZE, st.out_len);
+		ut_asserteq(DIV_ROUND_UP(STREAM_SIZE, 1000), st.sink_calls);
+		ut_assertok(memcmp(orig, out, STREAM_SIZE));
+	}
+
+	/* Straight to memory, which must be big enough */
+	memset(out, '\0', STREAM_SIZE);
+	ut_assertok(stream_run(&st, out, STREAM_SIZE, NULL, 0, comp, comp_len,
+			       4096, &len));
+	ut_asserteq(STREAM_SIZE, len);
+	ut_assertok(memcmp(orig, out, STREAM_SIZE));
+	ut_asserteq(-ENOSPC, stream_run(&st, out, STREAM_SIZE - 1, NULL, 0,
+					comp, comp_len, 4096, NULL));
+
+	/* Raw deflate data, as for zunzip() */
+	offset = gzip_parse_header(comp, comp_len);
+	ut_assert(offset > 0);
+	ut_assertok(stream_run(&st, out, STREAM_SIZE, NULL, GZIP_STREAM_RAW,
+			       comp + offset, comp_len - offset, 4096, &len));
+	ut_asserteq(STREAM_SIZE, len);
+
+	/* Pulling the data through a source */
+	memset(&st, '\0', sizeof(st));
+	st.out = out;
+	st.out_max = STREAM_SIZE;
+	st.fail_after = -1;
+	st.in = comp;
+	st.in_len = comp_len;
+	st.in_chunk = 333;
+	memset(out, '\0', STREAM_SIZE);
+	ut_assertok(gunzip_stream(stream_source, stream_sink, &st, 4096, 0,
+				  &len));
+	ut_asserteq(STREAM_SIZE, len);
+	ut_assertok(memcmp(orig, out, STREAM_SIZE));
+	ut_asserteq(comp_len, st.in_pos);
+
+	/* The sink can stop it */
+	memset(&st, '\0', sizeof(st));
+	st.out = out;
+	st.out_max = STREAM_SIZE;
+	st.fail_after = 3;
+	ut_asserteq(-EIO, stream_run(&st, NULL, 1000, stream_sink, 0, comp,
+				     comp_len, 512, NULL));
+	ut_asserteq(4, st.sink_calls);
+
+	/* Data that is cut short or damaged is caught */
+	ut_asserteq(-EBADMSG, stream_run(&st, out, STREAM_SIZE, NULL, 0, comp,
+					 comp_len - 1, 4096, NULL));
+	comp[comp_len - 8] ^= 1;	/* The CRC in the trailer */
+	ut_asserteq(-EBADMSG, stream_run(&st, out, STREAM_SIZE, NULL, 0, comp,
+					 comp_len, 4096, NULL));
+
+	free(out);
+	free(comp);
+	free(orig);
+
+	return 0;
+}
+COMPRESSION_TEST(compression_test_gzip_stream, 0);
+
+/* Feed @in_len bytes of @in to a new LZMA stream @chunk bytes at a time */
+static int lzma_stream_run(struct stream_state *st, void *out, ulong out_size,
+			   lzma_sink_t sink, const void *in, ulong in_len,
+			   ulong chunk, ulong *lenp)
+{
+	struct lzma_stream *ls;
+	ulong pos, len;
+
+	ls = lzma_stream_start(out, out_size, sink, st);
+	if (!ls)
+		return -ENOMEM;
+	for (pos = 0; pos < in_len; pos += len) {
+		len = min(chunk, in_len - pos);
+		if (lzma_stream_write(ls, in + pos, len))
+			break;
+	}
+
+	return lzma_stream_finish(ls, lenp);
+}
+
+/* Check that @out holds @copies copies of the plain text */
+static int lzma_stream_check(struct unit_test_state *uts, const uint8_t *out,
+			     int copies)
+{
+	ulong plain_len = strlen(plain);
+	int i;
+
+	for (i = 0; i < copies; i++)
+		ut_assertok(memcmp(out + i * plain_len, plain, plain_len));
+
+	return 0;
+}
+
+/* Streamed LZMA data decompresses the same whatever the chunk sizes */
+static int compression_test_lzma_stream(struct unit_test_state *uts)
+{
+	static const ulong chunks[] = { 1, 7, 13, 64, 4096 };
+	const ulong plain_len = strlen(plain);
+	const ulong total = plain_len * LZMA_DICT4K_COPIES;
+	char sized[sizeof(lzma_compressed)];
+	struct stream_state st;
+	uint8_t *out;
+	ulong len;
+	int i;
+
+	out = malloc(total);
+	ut_assertnonnull(out);
+
+	for (i = 0; i < ARRAY_SIZE(chunks); i++) {
+		/* Through a sink, a dictionary-full at a time */
+		memset(&st, '\0', sizeof(st));
+		st.out = out;
+		st.out_max = total;
+		st.fail_after = -1;
+		ut_assertok(lzma_stream_run(&st, NULL, 0, stream_sink,
+					    lzma_dict4k_compressed,
+					    lzma_dict4k_compressed_size,
+					    chunks[i], &len));
+		ut_asserteq(total, len);
+		ut_asserteq(total, st.out_len);
+		ut_asserteq(DIV_ROUND_UP(total, LZMA_DICT4K_SIZE),
+			    st.sink_calls);
+		ut_assertok(lzma_stream_check(uts, out, LZMA_DICT4K_COPIES));
+
+		/* Straight to memory, which may be just big enough */
+		memset(out, '\0', total);
+		ut_assertok(lzma_stream_run(&st, out, total, NULL,
+					    lzma_dict4k_compressed,
+					    lzma_dict4k_compressed_size,
+					    chunks[i], &len));
+		ut_asserteq(total, len);
+		ut_assertok(lzma_stream_check(uts, out, LZMA_DICT4K_COPIES));
+	}
+	ut_asserteq(-ENOSPC, lzma_stream_run(&st, out, total - 1, NULL,
+					     lzma_dict4k_compressed,
+					     lzma_dict4k_compressed_size,
+					     64, NULL));
+
+	/* With the size in the header, which must fit */
+	memcpy(sized, lzma_compressed, lzma_compressed_size);
+	put_unaligned_le64(plain_len, sized + LZMA_PROPS_SIZE);
+	memset(out, '\0', plain_len);
+	ut_assertok(lzma_stream_run(&st, out, plain_len, NULL, sized,
+				    lzma_compressed_size, 7, &len));
+	ut_asserteq(plain_len, len);
+	ut_assertok(lzma_stream_check(uts, out, 1));
+	ut_asserteq(-ENOSPC, lzma_stream_run(&st, out, plain_len - 1, NULL,
+					     sized, lzma_compressed_size, 7,
+					     NULL));
+
+	/* The sink can stop it */
+	memset(&st, '\0', sizeof(st));
+	st.out = out;
+	st.out_max = total;
+	st.fail_after = 2;
+	ut_asserteq(-EIO, lzma_stream_run(&st, NULL, 0, stream_sink,
+					  lzma_dict4k_compressed,
+					  lzma_dict4k_compressed_size, 64,
+					  NULL));
+	ut_asserteq(3, st.sink_calls);
+
+	/* Data that is cut short or damaged is caught */
+	ut_asserteq(-EBADMSG, lzma_stream_run(&st, out, total, NULL,
+					      lzma_dict4k_compressed,
+					      lzma_dict4k_compressed_size - 1,
+					      64, NULL));
+	ut_asserteq(-EBADMSG, lzma_stream_run(&st, out, total, NULL,
+					      lzma_dict4k_compressed, 10, 64,
+					      NULL));
+	sized[0] = 9 * 5 * 5;		/* Properties out of range */
+	ut_asserteq(-EBADMSG, lzma_stream_run(&st, out, total, NULL, sized,
+					      lzma_compressed_size, 64, NULL));
+
+	free(out);
+
+	return 0;
+}
+COMPRESSION_TEST(compression_test_lzma_stream, 0);
+
 static int compress_using_none(struct unit_test_state *uts,
 			       void *in, unsigned long in_size,
 			       void *out, unsigned long out_max,
@@ -527,12 +1122,105 @@ static int compression_test_bootm_lz4(struct unit_test_state *uts)
 }
 COMPRESSION_TEST(compression_test_bootm_lz4, 0);
 
+static int compression_test_bootm_zstd(struct unit_test_state *uts)
+{
+	return run_bootm_test(uts, IH_COMP_ZSTD, compress_using_zstd);
+}
+COMPRESSION_TEST(compression_test_bootm_zstd, 0);
+
 static int compression_test_bootm_none(struct unit_test_state *uts)
 {
 	return run_bootm_test(uts, IH_COMP_NONE, compress_using_none);
 }
 COMPRESSION_TEST(compression_test_bootm_none, 0);
 
+/* Size of the kernel that is decompressed in place */
+#define INPLACE_SIZE	(256 << 10)
+#define INPLACE_LOAD	0x1000000
+
+/* Load a kernel from @addr, as if bootm had found it there */
+static int inplace_load(ulong addr, const void *comp, ulong comp_len)
+{
+	int ret;
+
+	memmove(map_sysmem(addr, comp_len), comp, comp_len);
+	ret = do_bootm_states(NULL, 0, 0, NULL, BOOTM_STATE_START, &images, 0);
+	if (ret)
+		return ret;
+	images.os.type = IH_TYPE_KERNEL;
+	images.os.comp = IH_COMP_GZIP;
+	images.os.os = IH_OS_LINUX;
+	images.os.arch = IH_ARCH_DEFAULT;
+	images.os.start = addr;
+	images.os.end = addr + comp_len;
+	images.os.image_start = addr;
+	images.os.image_len = comp_len;
+	images.os.load = INPLACE_LOAD;
+
+	return do_bootm_states(NULL, 0, 0, NULL, BOOTM_STATE_LOADOS, &images,
+			       0);
+}
+
+/* bootm decompresses an image over itself only when there is room */
+static int compression_test_bootm_inplace(struct unit_test_state *uts)
+{
+	ulong addr, comp_len = INPLACE_SIZE;
+	size_t size;
+	long margin;
+	char cmd[50];
+	u8 *data, *comp;
+
+	data = malloc(INPLACE_SIZE);
+	comp = malloc(comp_len);
+	ut_assertnonnull(data);
+	ut_assertnonnull(comp);
+	stream_fill(data, INPLACE_SIZE);
+	ut_assertok(gzip(comp, &comp_len, data, INPLACE_SIZE));
+
+	/* The sizes that in-place decompression is checked against */
+	ut_asserteq(LZO_E_OK, lzop_get_size((void *)lzo_compressed,
+					    lzo_compressed_size, &size));
+	ut_asserteq(strlen(plain), size);
+	ut_assertok(ulz4fn_size(lz4_compressed, lz4_compressed_size, &size));
+	ut_assert(size >= strlen(plain));
+
+	ut_asserteq(-EPROTONOSUPPORT,
+		    bootm_inplace_addr(IH_COMP_BZIP2, INPLACE_LOAD,
+				       INPLACE_SIZE, comp_len, &addr));
+	ut_assertok(bootm_inplace_addr(IH_COMP_NONE, INPLACE_LOAD,
+				       INPLACE_SIZE, INPLACE_SIZE, &addr));
+	ut_asserteq(INPLACE_LOAD, addr);
+
+	ut_assertok(bootm_inplace_addr(IH_COMP_GZIP, INPLACE_LOAD,
+				       INPLACE_SIZE, comp_len, &addr));
+	margin = bootm_inplace_margin(IH_COMP_GZIP, INPLACE_SIZE);
+	ut_assert(addr + comp_len >= INPLACE_LOAD + INPLACE_SIZE + margin);
+	ut_assert(addr + comp_len < INPLACE_LOAD + INPLACE_SIZE + margin +
+		  ARCH_DMA_MINALIGN);
+	snprintf(cmd, sizeof(cmd), "iminplace %x gzip %lx %x", INPLACE_LOAD,
+		 comp_len, INPLACE_SIZE);
+	ut_assertok(run_command(cmd, 0));
+	ut_asserteq(addr, env_get_hex("inplace_addr", 0));
+
+	ut_assertok(inplace_load(addr, comp, comp_len));
+	ut_assertok(memcmp(map_sysmem(INPLACE_LOAD, INPLACE_SIZE), data,
+			   INPLACE_SIZE));
+
+	/* Any closer and the output could overrun the input */
+	ut_asserteq(-ENOSPC, inplace_load(addr - ARCH_DMA_MINALIGN, comp,
+					  comp_len));
+
+	/* A size in the gzip trailer beyond CONFIG_SYS_BOOTM_LEN is refused */
+	put_unaligned_le32(0xffffffff, comp + comp_len - 4);
+	ut_asserteq(-E2BIG, inplace_load(addr, comp, comp_len));
+
+	free(comp);
+	free(data);
+
+	return 0;
+}
+COMPRESSION_TEST(compression_test_bootm_inplace, 0);
+
 int do_ut_compression(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 {
 	struct unit_test *tests = ll_entry_start(struct unit_test,
@@ -0,0 +1,213 @@
+/*
+ * Tests and benchmark for the CRC32 and CRC32C engines in lib/crc32*.c
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <command.h>
+#include <malloc.h>
+#include <u-boot/crc.h>
+#include <test/crc32.h>
+#include <test/suites.h>
+#include <test/ut.h>
+
+#define CRC32_BENCH_SIZE	(1 << 20)
+#define CRC32_BENCH_LOOPS	16
+
+static const char * const engine_name[CRC32_ENGINE_COUNT] = {
+	[CRC32_ENGINE_TABLE]	= "table",
+	[CRC32_ENGINE_SLICE8]	= "slice-by-8",
+	[CRC32_ENGINE_ARMV8]	= "armv8",
+	[CRC32_ENGINE_PMULL]	= "pmull",
+	[CRC32_ENGINE_PCLMUL]	= "pclmul",
+};
+
+/* Fill a buffer with a repeatable pseudo-random pattern */
+static void fill_pattern(unsigned char *buf, uint len)
+{
+	uint32_t seed = 0x12345678;
+	uint i;
+
+	for (i = 0; i < len; i++) {
+		seed = seed * 1103515245 + 12345;
+		buf[i] = seed >> 16;
+	}
+}
+
+/* Every supported engine must give the standard check value */
+static int crc32_test_check_value(struct unit_test_state *uts)
+{
+	const unsigned char check[] = "123456789";
+	int engine;
+
+	ut_asserteq(0xcbf43926, crc32(0, check, 9));
+	for (engine = 0; engine < CRC32_ENGINE_COUNT; engine++) {
+		if (!crc32_engine_supported(engine))
+			continue;
+		ut_asserteq(0xcbf43926, crc32_engine(engine, 0, check, 9));
+	}
+
+	return 0;
+}
+CRC32_TEST(crc32_test_check_value, 0);
+
+/*
+ * All engines agree for every alignment and tail length, on both sides of
+ * the point where folding starts
+ */
+static int crc32_test_engines_agree(struct unit_test_state *uts)
+{
+	unsigned char buf[512];
+	uint32_t expect;
+	int engine, ofs, len;
+
+	fill_pattern(buf, sizeof(buf));
+	for (ofs = 0; ofs < 8; ofs++) {
+		for (len = 0; len < 300; len++) {
+			expect = crc32_engine(CRC32_ENGINE_TABLE, 0, buf + ofs,
+					      len);
+			for (engine = 0; engine < CRC32_ENGINE_COUNT; engine++)
+				ut_asserteq(expect, crc32_engine(engine, 0,
+								 buf + ofs,
+								 len));
+		}
+	}
+
+	return 0;
+}
+CRC32_TEST(crc32_test_engines_agree, 0);
+
+/* A CRC may be carried across calls, as the NAI message code does */
+static int crc32_test_incremental(struct unit_test_state *uts)
+{
+	unsigned char buf[512];
+	uint32_t crc;
+	int split;
+
+	fill_pattern(buf, sizeof(buf));
+	for (split = 0; split <= sizeof(buf); split += 37) {
+		crc = crc32(0, buf, split);
+		crc = crc32(crc, buf + split, sizeof(buf) - split);
+		ut_asserteq(crc32(0, buf, sizeof(buf)), crc);
+	}
+
+	return 0;
+}
+CRC32_TEST(crc32_test_incremental, 0);
+
+/* Report the throughput of each supported engine */
+static int crc32_test_benchmark(struct unit_test_state *uts)
+{
+	unsigned char *buf;
+	ulong start, us;
+	uint32_t crc;
+	int engine, i;
+
+	buf = malloc(CRC32_BENCH_SIZE);
+	ut_assertnonnull(buf);
+	fill_pattern(buf, CRC32_BENCH_SIZE);
+
+	for (engine = 0; engine < CRC32_ENGINE_COUNT; engine++) {
+		if (!crc32_engine_supported(engine)) {
+			printf("%12s: not available\n", engine_name[engine]);
+			continue;
+		}
+
+		crc = 0;
+		start = timer_get_us();
+		for (i = 0; i < CRC32_BENCH_LOOPS; i++)
+			crc = crc32_engine(engine, crc, buf, CRC32_BENCH_SIZE);
+		us = max(timer_get_us() - start, 1UL);
+
+		printf("%12s: %lu KB/s (crc %08x)\n", engine_name[engine],
+		       (ulong)((u64)CRC32_BENCH_LOOPS * CRC32_BENCH_SIZE *
+			       1000000 / 1024 / us), crc);
+	}
+	free(buf);
+
+	return 0;
+}
+CRC32_TEST(crc32_test_benchmark, 0);
+
+#ifdef CONFIG_CRC32C
+/* CRC32C has its own check value, and the same engines */
+static int crc32_test_crc32c(struct unit_test_state *uts)
+{
+	const unsigned char check[] = "123456789";
+	unsigned char buf[512];
+	uint32_t table[256];
+	uint32_t expect;
+	int engine, ofs, len;
+
+	crc32c_init(table, 0x82f63b78);
+	ut_asserteq(0xe3069283, ~crc32c_cal(~0, (const char *)check, 9,
+					    table));
+
+	fill_pattern(buf, sizeof(buf));
+	for (ofs = 0; ofs < 8; ofs++) {
+		for (len = 0; len < 300; len++) {
+			expect = crc32c_engine(CRC32_ENGINE_TABLE, ~0,
+					       buf + ofs, len);
+			ut_asserteq(expect, crc32c_cal(~0,
+						       (const char *)buf + ofs,
+						       len, table));
+			for (engine = 0; engine < CRC32_ENGINE_COUNT; engine++)
+				ut_asserteq(expect, crc32c_engine(engine, ~0,
+								  buf + ofs,
+								  len));
+		}
+	}
+
+	/* Tables for other polynomials are still honoured */
+	crc32c_init(table, 0xedb88320);
+	ut_asserteq(crc32_no_comp(~0, buf, sizeof(buf)),
+		    crc32c_cal(~0, (const char *)buf, sizeof(buf), table));
+
+	return 0;
+}
+CRC32_TEST(crc32_test_crc32c, 0);
+
+/* Report the CRC32C throughput of each supported engine */
+static int crc32_test_crc32c_benchmark(struct unit_test_state *uts)
+{
+	unsigned char *buf;
+	ulong start, us;
+	uint32_t crc;
+	int engine, i;
+
+	buf = malloc(CRC32_BENCH_SIZE);
+	ut_assertnonnull(buf);
+	fill_pattern(buf, CRC32_BENCH_SIZE);
+
+	for (engine = 0; engine < CRC32_ENGINE_COUNT; engine++) {
+		if (!crc32_engine_supported(engine)) {
+			printf("%12s: not available\n", engine_name[engine]);
+			continue;
+		}
+
+		crc = ~0;
+		start = timer_get_us();
+		for (i = 0; i < CRC32_BENCH_LOOPS; i++)
+			crc = crc32c_engine(engine, crc, buf,
+					    CRC32_BENCH_SIZE);
+		us = max(timer_get_us() - start, 1UL);
+
+		printf("%12s: %lu KB/s (crc32c %08x)\n", engine_name[engine],
+		       (ulong)((u64)CRC32_BENCH_LOOPS * CRC32_BENCH_SIZE *
+			       1000000 / 1024 / us), ~crc);
+	}
+	free(buf);
+
+	return 0;
+}
+CRC32_TEST(crc32_test_crc32c_benchmark, 0);
+#endif
+
+int do_ut_crc32(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
+{
+	struct unit_test *tests = ll_entry_start(struct unit_test, crc32_test);
+	const int n_ents = ll_entry_count(struct unit_test, crc32_test);
+
+	return cmd_ut_category("crc32", tests, n_ents, argc, argv);
+}
@@ -0,0 +1,241 @@
+/*
+ * Tests for the crypto uclass
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <crypto.h>
+#include <dm.h>
+#include <hash.h>
+#include <image.h>
+#include <libfdt.h>
+#include <malloc.h>
+#include <asm/test.h>
+#include <dm/device-internal.h>
+#include <dm/test.h>
+#include <test/ut.h>
+#include <u-boot/sha1.h>
+#include <u-boot/sha256.h>
+
+#define CRYPTO_TEST_SIZE	(100 * 1024)
+
+static void fill_pattern(uint8_t *buf, uint len)
+{
+	uint32_t seed = 0x12345678;
+	uint i;
+
+	for (i = 0; i < len; i++) {
+		seed = seed * 1103515245 + 12345;
+		buf[i] = seed >> 16;
+	}
+}
+
+/* Hashes go to the engine, and match the software ones */
+static int dm_test_crypto_hash(struct unit_test_state *uts)
+{
+	uint8_t expect[SHA256_SUM_LEN], digest[HASH_MAX_DIGEST_SIZE];
+	struct udevice *dev;
+	uint8_t *buf;
+	int size;
+
+	ut_assertok(uclass_first_device_err(UCLASS_CRYPTO, &dev));
+	buf = malloc(CRYPTO_TEST_SIZE);
+	ut_assertnonnull(buf);
+	fill_pattern(buf, CRYPTO_TEST_SIZE);
+	sha256_csum_wd(buf, CRYPTO_TEST_SIZE, expect, CHUNKSZ_SHA256);
+
+	size = sizeof(digest);
+	ut_assertok(crypto_hash("sha256", buf, CRYPTO_TEST_SIZE, digest,
+				&size));
+	ut_asserteq(SHA256_SUM_LEN, size);
+	ut_assertok(memcmp(expect, digest, SHA256_SUM_LEN));
+	ut_asserteq(1, sandbox_crypto_get_count(dev));
+
+	/* hash_block() uses the engine too */
+	size = sizeof(digest);
+	ut_assertok(hash_block("sha256", buf, CRYPTO_TEST_SIZE, digest,
+			       &size));
+	ut_assertok(memcmp(expect, digest, SHA256_SUM_LEN));
+	ut_asserteq(2, sandbox_crypto_get_count(dev));
+
+	/* The engine does not do crc32, so that stays in software */
+	size = sizeof(digest);
+	ut_asserteq(-ENODEV, crypto_hash("crc32", buf, CRYPTO_TEST_SIZE,
+					 digest, &size));
+	ut_assertok(hash_block("crc32", buf, CRYPTO_TEST_SIZE, digest, &size));
+	ut_asserteq(2, sandbox_crypto_get_count(dev));
+
+	/* The digest must fit */
+	size = SHA256_SUM_LEN - 1;
+	ut_asserteq(-ENOSPC, crypto_hash("sha256", buf, CRYPTO_TEST_SIZE,
+					 digest, &size));
+	free(buf);
+
+	return 0;
+}
+DM_TEST(dm_test_crypto_hash, DM_TESTF_SCAN_FDT);
+
+/* Jobs run in the background, in the order they were submitted */
+static int dm_test_crypto_queue(struct unit_test_state *uts)
+{
+	uint8_t digest[3][HASH_MAX_DIGEST_SIZE], expect[SHA256_SUM_LEN];
+	struct crypto_job job[3];
+	struct udevice *dev;
+	uint8_t *buf;
+	int i;
+
+	ut_assertok(uclass_first_device_err(UCLASS_CRYPTO, &dev));
+	buf = malloc(CRYPTO_TEST_SIZE);
+	ut_assertnonnull(buf);
+	fill_pattern(buf, CRYPTO_TEST_SIZE);
+
+	sandbox_crypto_set_chunk(dev, 0);
+	memset(job, '\0', sizeof(job));
+	for (i = 0; i < 3; i++) {
+		job[i].type = CRYPTO_JOB_HASH;
+		job[i].algo = i == 1 ? "sha1" : "sha256";
+		job[i].in = buf + i;
+		job[i].in_len = CRYPTO_TEST_SIZE - i * 4096;
+		job[i].out = digest[i];
+		job[i].out_len = sizeof(digest[i]);
+		ut_assertok(crypto_submit(&job[i]));
+		ut_asserteq_ptr(dev, job[i].dev);
+	}
+	ut_asserteq(-EBUSY, crypto_poll(&job[0]));
+	ut_asserteq(-EBUSY, crypto_poll(&job[2]));
+
+	/* Polling any job moves the first one on */
+	sandbox_crypto_set_chunk(dev, 4096);
+	while (crypto_poll(&job[2]) == -EBUSY)
+		ut_assert(!job[0].busy || job[1].busy);
+	ut_assert(!job[0].busy && !job[1].busy);
+	ut_asserteq(3, sandbox_crypto_get_count(dev));
+
+	for (i = 0; i < 3; i++) {
+		ut_assertok(crypto_wait(&job[i]));
+		if (i == 1) {
+			ut_asserteq(SHA1_SUM_LEN, job[i].out_len);
+			sha1_csum_wd(job[i].in, job[i].in_len, expect,
+				     CHUNKSZ_SHA1);
+		} else {
+			ut_asserteq(SHA256_SUM_LEN, job[i].out_len);
+			sha256_csum_wd(job[i].in, job[i].in_len, expect,
+				       CHUNKSZ_SHA256);
+		}
+		ut_assertok(memcmp(expect, digest[i], job[i].out_len));
+	}
+	free(buf);
+
+	return 0;
+}
+DM_TEST(dm_test_crypto_queue, DM_TESTF_SCAN_FDT);
+
+/* Removing the device fails the jobs that it has not finished */
+static int dm_test_crypto_remove(struct unit_test_state *uts)
+{
+	uint8_t buf[256], digest[SHA256_SUM_LEN];
+	struct crypto_job job = {
+		.type = CRYPTO_JOB_HASH,
+		.algo = "sha256",
+		.in = buf,
+		.in_len = sizeof(buf),
+		.out = digest,
+		.out_len = sizeof(digest),
+	};
+	struct udevice *dev;
+
+	ut_assertok(uclass_first_device_err(UCLASS_CRYPTO, &dev));
+	sandbox_crypto_set_chunk(dev, 0);
+	ut_assertok(crypto_submit(&job));
+	ut_asserteq(-EBUSY, crypto_poll(&job));
+	ut_assertok(device_remove(dev, DM_REMOVE_NORMAL));
+	ut_asserteq(-ENODEV, crypto_poll(&job));
+
+	/* A new job probes it again */
+	ut_assertok(crypto_run(&job));
+
+	return 0;
+}
+DM_TEST(dm_test_crypto_remove, DM_TESTF_SCAN_FDT);
+
+#ifdef CONFIG_FIT_HASH_OFFLOAD
+/* Add an image with a sha256 hash node to a FIT */
+static int crypto_test_add_image(struct unit_test_state *uts, void *fit,
+				 const char *name, const void *data, int size)
+{
+	uint8_t value[SHA256_SUM_LEN];
+	int images, node;
+
+	images = fdt_path_offset(fit, FIT_IMAGES_PATH);
+	if (images < 0)
+		images = fdt_add_subnode(fit, 0, "images");
+	ut_assert(images >= 0);
+	node = fdt_add_subnode(fit, images, name);
+	ut_assert(node >= 0);
+	ut_assertok(fdt_setprop(fit, node, FIT_DATA_PROP, data, size));
+	node = fdt_add_subnode(fit, node, "hash-1");
+	ut_assert(node >= 0);
+	ut_assertok(fdt_setprop_string(fit, node, FIT_ALGO_PROP, "sha256"));
+	sha256_csum_wd(data, size, value, CHUNKSZ_SHA256);
+	ut_assertok(fdt_setprop(fit, node, FIT_VALUE_PROP, value,
+				sizeof(value)));
+
+	return 0;
+}
+
+/* FIT images are hashed on the engine while others are checked */
+static int dm_test_crypto_fit(struct unit_test_state *uts)
+{
+	const int fit_size = 2 * CRYPTO_TEST_SIZE + 4096;
+	uint8_t value[SHA256_SUM_LEN];
+	int kernel, ramdisk, len;
+	const void *data;
+	struct udevice *dev;
+	size_t size;
+	uint8_t *buf;
+	void *fit;
+
+	ut_assertok(uclass_first_device_err(UCLASS_CRYPTO, &dev));
+	buf = malloc(CRYPTO_TEST_SIZE + fit_size);
+	ut_assertnonnull(buf);
+	fit = buf + CRYPTO_TEST_SIZE;
+	fill_pattern(buf, CRYPTO_TEST_SIZE);
+	ut_assertok(fdt_create_empty_tree(fit, fit_size));
+	/* fdt_add_subnode() puts new nodes first, so the kernel goes last */
+	ut_assertok(crypto_test_add_image(uts, fit, "ramdisk", buf + 1,
+					  CRYPTO_TEST_SIZE - 1));
+	ut_assertok(crypto_test_add_image(uts, fit, "kernel", buf,
+					  CRYPTO_TEST_SIZE));
+	kernel = fdt_path_offset(fit, "/images/kernel");
+	ramdisk = fdt_path_offset(fit, "/images/ramdisk");
+
+	/* Both are submitted; checking the kernel only waits for the kernel */
+	sandbox_crypto_set_chunk(dev, 4096);
+	fit_offload_hash_images(fit, -1);
+	ut_asserteq(1, fit_image_verify(fit, kernel));
+	ut_asserteq(1, sandbox_crypto_get_count(dev));
+	ut_asserteq(1, fit_image_verify(fit, ramdisk));
+	ut_asserteq(2, sandbox_crypto_get_count(dev));
+
+	/* Each digest is used once; after that images are hashed again */
+	ut_assertok(fit_image_get_data(fit, kernel, &data, &size));
+	ut_asserteq(-ENOENT, fit_offload_get_hash(data, size, "sha256", value,
+						  &len));
+	ut_asserteq(1, fit_image_verify(fit, kernel));
+	ut_asserteq(3, sandbox_crypto_get_count(dev));
+
+	/* Writing over an image waits for its job and drops the digest */
+	sandbox_crypto_set_chunk(dev, 4096);
+	fit_offload_hash_images(fit, -1);
+	ut_assertok(fit_offload_get_hash(data, size, "sha256", NULL, NULL));
+	fit_offload_invalidate(data, 1);
+	ut_asserteq(4, sandbox_crypto_get_count(dev));
+	ut_asserteq(-ENOENT, fit_offload_get_hash(data, size, "sha256", NULL,
+						  NULL));
+	free(buf);
+
+	return 0;
+}
+DM_TEST(dm_test_crypto_fit, DM_TESTF_SCAN_FDT);
+#endif
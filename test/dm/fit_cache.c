@@ -0,0 +1,250 @@
+/*
+ * Tests for the cache of verified FIT image digests
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <blk.h>
+#include <command.h>
+#include <dm.h>
+#include <image.h>
+#include <libfdt.h>
+#include <malloc.h>
+#include <mmc.h>
+#include <asm/test.h>
+#include <dm/test.h>
+#include <test/ut.h>
+#include <u-boot/sha256.h>
+
+#define FIT_CACHE_TEST_SIZE	(64 * 1024)
+#define FIT_CACHE_TEST_FIT_SIZE	(FIT_CACHE_TEST_SIZE + 4096)
+
+static void fill_pattern(uint8_t *buf, uint len)
+{
+	uint32_t seed = 0x12345678;
+	uint i;
+
+	for (i = 0; i < len; i++) {
+		seed = seed * 1103515245 + 12345;
+		buf[i] = seed >> 16;
+	}
+}
+
+/* Build a FIT with a kernel that has a sha256 hash node */
+static int fit_cache_test_make_fit(struct unit_test_state *uts, void *fit,
+				   int *kernelp)
+{
+	uint8_t value[SHA256_SUM_LEN];
+	int node, hash;
+	uint8_t *data;
+
+	data = malloc(FIT_CACHE_TEST_SIZE);
+	ut_assertnonnull(data);
+	fill_pattern(data, FIT_CACHE_TEST_SIZE);
+	sha256_csum_wd(data, FIT_CACHE_TEST_SIZE, value, CHUNKSZ_SHA256);
+
+	ut_assertok(fdt_create_empty_tree(fit, FIT_CACHE_TEST_FIT_SIZE));
+	node = fdt_add_subnode(fit, 0, "images");
+	ut_assert(node >= 0);
+	node = fdt_add_subnode(fit, node, "kernel");
+	ut_assert(node >= 0);
+	ut_assertok(fdt_setprop(fit, node, FIT_DATA_PROP, data,
+				FIT_CACHE_TEST_SIZE));
+	hash = fdt_add_subnode(fit, node, "hash-1");
+	ut_assert(hash >= 0);
+	ut_assertok(fdt_setprop_string(fit, hash, FIT_ALGO_PROP, "sha256"));
+	ut_assertok(fdt_setprop(fit, hash, FIT_VALUE_PROP, value,
+				sizeof(value)));
+	free(data);
+	*kernelp = fdt_path_offset(fit, "/images/kernel");
+
+	return 0;
+}
+
+/* Pretend that the FIT was read from the start of mmc0 */
+static void fit_cache_test_load(void *fit, struct blk_desc *desc)
+{
+	fit_cache_load_start(fit, desc, 1, "fit.itb", 0);
+	fit_cache_load_end(fdt_totalsize(fit));
+}
+
+/* An image loaded from the same place again is not hashed again */
+static int dm_test_fit_cache_hit(struct unit_test_state *uts)
+{
+	uint8_t value[SHA256_SUM_LEN];
+	struct udevice *crypto;
+	struct blk_desc *desc;
+	int kernel, hash, len;
+	const void *data;
+	size_t size;
+	void *fit;
+	int count;
+
+	ut_assertok(uclass_first_device_err(UCLASS_CRYPTO, &crypto));
+	ut_assertok(blk_get_device_by_str("mmc", "0", &desc));
+	fit = malloc(FIT_CACHE_TEST_FIT_SIZE);
+	ut_assertnonnull(fit);
+	ut_assertok(fit_cache_test_make_fit(uts, fit, &kernel));
+	ut_assertok(fit_image_get_data(fit, kernel, &data, &size));
+	fit_cache_clear();
+
+	/* The first check hashes the image and adds it to the cache */
+	fit_cache_test_load(fit, desc);
+	ut_asserteq(-ENOENT, fit_cache_get_hash(data, size, "sha256", NULL,
+						NULL));
+	count = sandbox_crypto_get_count(crypto);
+	ut_asserteq(1, fit_image_verify(fit, kernel));
+	ut_asserteq(count + 1, sandbox_crypto_get_count(crypto));
+	ut_assertok(fit_cache_get_hash(data, size, "sha256", value, &len));
+	ut_asserteq(SHA256_SUM_LEN, len);
+
+	/* Later checks compare the cached digest with the hash node */
+	fit_cache_test_load(fit, desc);
+	ut_asserteq(1, fit_image_verify(fit, kernel));
+	ut_asserteq(count + 1, sandbox_crypto_get_count(crypto));
+
+	/* The same bytes from another file are not the same image */
+	fit_cache_load_start(fit, desc, 1, "other.itb", 0);
+	fit_cache_load_end(fdt_totalsize(fit));
+	ut_asserteq(-ENOENT, fit_cache_get_hash(data, size, "sha256", NULL,
+						NULL));
+
+	/* A hash node that does not match is checked the usual way */
+	fit_cache_test_load(fit, desc);
+	hash = fdt_subnode_offset(fit, kernel, "hash-1");
+	value[0] ^= 1;
+	ut_assertok(fdt_setprop_inplace(fit, hash, FIT_VALUE_PROP, value,
+					SHA256_SUM_LEN));
+	ut_asserteq(0, fit_image_verify(fit, kernel));
+	ut_asserteq(count + 2, sandbox_crypto_get_count(crypto));
+	free(fit);
+
+	return 0;
+}
+DM_TEST(dm_test_fit_cache_hit, DM_TESTF_SCAN_FDT);
+
+/* Cached digests go stale when the storage or the buffer is written */
+static int dm_test_fit_cache_invalidate(struct unit_test_state *uts)
+{
+	struct blk_desc *desc;
+	uint8_t buf[512];
+	const void *data;
+	int kernel;
+	size_t size;
+	void *fit;
+
+	ut_assertok(blk_get_device_by_str("mmc", "0", &desc));
+	fit = malloc(FIT_CACHE_TEST_FIT_SIZE);
+	ut_assertnonnull(fit);
+	ut_assertok(fit_cache_test_make_fit(uts, fit, &kernel));
+	ut_assertok(fit_image_get_data(fit, kernel, &data, &size));
+	fit_cache_clear();
+	fit_cache_test_load(fit, desc);
+	ut_asserteq(1, fit_image_verify(fit, kernel));
+	ut_assertok(fit_cache_get_hash(data, size, "sha256", NULL, NULL));
+
+	/* Once anything is written to the device, what is read is hashed */
+	ut_asserteq(1, blk_dread(desc, 0, 1, buf));
+	blk_dwrite(desc, 0, 1, buf);
+	fit_cache_test_load(fit, desc);
+	ut_asserteq(-ENOENT, fit_cache_get_hash(data, size, "sha256", NULL,
+						NULL));
+
+	/* A digest of data read before a write is not added after it */
+	blk_derase(desc, 0, 1);
+	ut_asserteq(1, fit_image_verify(fit, kernel));
+	fit_cache_test_load(fit, desc);
+	ut_asserteq(-ENOENT, fit_cache_get_hash(data, size, "sha256", NULL,
+						NULL));
+	ut_asserteq(1, fit_image_verify(fit, kernel));
+	fit_cache_test_load(fit, desc);
+	ut_assertok(fit_cache_get_hash(data, size, "sha256", NULL, NULL));
+
+	/* Overwriting the buffer forgets where it came from */
+	fit_cache_invalidate(data + size - 1, 1);
+	ut_asserteq(-ENOENT, fit_cache_get_hash(data, size, "sha256", NULL,
+						NULL));
+
+	/* Where it came from is only believed in the next command */
+	fit_cache_test_load(fit, desc);
+	ut_assertok(run_command("setenv fit_cache_test 1", 0));
+	ut_assertok(fit_cache_get_hash(data, size, "sha256", NULL, NULL));
+	ut_assertok(run_command("setenv fit_cache_test", 0));
+	ut_asserteq(-ENOENT, fit_cache_get_hash(data, size, "sha256", NULL,
+						NULL));
+
+	/* A failed load tells nothing */
+	fit_cache_load_start(fit, desc, 1, "fit.itb", 0);
+	fit_cache_load_end(0);
+	ut_asserteq(-ENOENT, fit_cache_get_hash(data, size, "sha256", NULL,
+						NULL));
+	free(fit);
+
+	return 0;
+}
+DM_TEST(dm_test_fit_cache_invalidate, DM_TESTF_SCAN_FDT);
+
+/* Digests belong to the medium, which must not be swappable */
+static int dm_test_fit_cache_media(struct unit_test_state *uts)
+{
+	char vendor[BLK_VEN_SIZE + 1];
+	struct blk_desc *desc, other;
+	const void *data;
+	struct mmc *mmc;
+	int kernel;
+	size_t size;
+	void *fit;
+
+	ut_assertok(blk_get_device_by_str("mmc", "0", &desc));
+	fit = malloc(FIT_CACHE_TEST_FIT_SIZE);
+	ut_assertnonnull(fit);
+	ut_assertok(fit_cache_test_make_fit(uts, fit, &kernel));
+	ut_assertok(fit_image_get_data(fit, kernel, &data, &size));
+	fit_cache_clear();
+	fit_cache_test_load(fit, desc);
+	ut_asserteq(1, fit_image_verify(fit, kernel));
+	fit_cache_test_load(fit, desc);
+	ut_assertok(fit_cache_get_hash(data, size, "sha256", NULL, NULL));
+
+	/* Another card in the same slot is not the same storage */
+	strcpy(vendor, desc->vendor);
+	strcpy(desc->vendor, "Man 000001 Snr 12345678");
+	fit_cache_test_load(fit, desc);
+	ut_asserteq(-ENOENT, fit_cache_get_hash(data, size, "sha256", NULL,
+						NULL));
+	strcpy(desc->vendor, vendor);
+	fit_cache_test_load(fit, desc);
+	ut_assertok(fit_cache_get_hash(data, size, "sha256", NULL, NULL));
+
+	/* Nothing from a removable disk or a USB device is believed */
+	other = *desc;
+	other.if_type = IF_TYPE_SCSI;
+	other.removable = 0;
+	fit_cache_test_load(fit, &other);
+	ut_asserteq(1, fit_image_verify(fit, kernel));
+	fit_cache_test_load(fit, &other);
+	ut_assertok(fit_cache_get_hash(data, size, "sha256", NULL, NULL));
+	other.removable = 1;
+	fit_cache_test_load(fit, &other);
+	ut_asserteq(-ENOENT, fit_cache_get_hash(data, size, "sha256", NULL,
+						NULL));
+	other.removable = 0;
+	other.if_type = IF_TYPE_USB;
+	fit_cache_test_load(fit, &other);
+	ut_asserteq(-ENOENT, fit_cache_get_hash(data, size, "sha256", NULL,
+						NULL));
+
+	/* The card may have been written elsewhere before it was set up */
+	mmc = find_mmc_device(0);
+	ut_assertnonnull(mmc);
+	mmc->has_init = 0;
+	ut_assertok(mmc_init(mmc));
+	fit_cache_test_load(fit, desc);
+	ut_asserteq(-ENOENT, fit_cache_get_hash(data, size, "sha256", NULL,
+						NULL));
+	free(fit);
+
+	return 0;
+}
+DM_TEST(dm_test_fit_cache_media, DM_TESTF_SCAN_FDT);
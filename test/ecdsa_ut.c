@@ -0,0 +1,187 @@
+/*
+ * Tests and benchmark for ECDSA P-256 verification in lib/ecdsa/p256.c
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <command.h>
+#include <u-boot/ecdsa.h>
+#include <u-boot/sha256.h>
+#include <u-boot/sha512.h>
+#include <test/ecdsa.h>
+#include <test/suites.h>
+#include <test/ut.h>
+
+#define ECDSA_BENCH_LOOPS	16
+
+/* Key and deterministic signatures from RFC 6979, appendix A.2.5 */
+static const uint8_t ecdsa_test_qx[ECDSA256_BYTES / 2] = {
+	0x60, 0xfe, 0xd4, 0xba, 0x25, 0x5a, 0x9d, 0x31,
+	0xc9, 0x61, 0xeb, 0x74, 0xc6, 0x35, 0x6d, 0x68,
+	0xc0, 0x49, 0xb8, 0x92, 0x3b, 0x61, 0xfa, 0x6c,
+	0xe6, 0x69, 0x62, 0x2e, 0x60, 0xf2, 0x9f, 0xb6,
+};
+
+static const uint8_t ecdsa_test_qy[ECDSA256_BYTES / 2] = {
+	0x79, 0x03, 0xfe, 0x10, 0x08, 0xb8, 0xbc, 0x99,
+	0xa4, 0x1a, 0xe9, 0xe9, 0x56, 0x28, 0xbc, 0x64,
+	0xf2, 0xf1, 0xb2, 0x0c, 0x2d, 0x7e, 0x9f, 0x51,
+	0x77, 0xa3, 0xc2, 0x94, 0xd4, 0x46, 0x22, 0x99,
+};
+
+static const struct {
+	const char *msg;
+	bool sha512;
+	uint8_t sig[ECDSA256_BYTES];
+} ecdsa_vectors[] = {
+	{
+		"sample", false,
+		{
+			0xef, 0xd4, 0x8b, 0x2a, 0xac, 0xb6, 0xa8, 0xfd,
+			0x11, 0x40, 0xdd, 0x9c, 0xd4, 0x5e, 0x81, 0xd6,
+			0x9d, 0x2c, 0x87, 0x7b, 0x56, 0xaa, 0xf9, 0x91,
+			0xc3, 0x4d, 0x0e, 0xa8, 0x4e, 0xaf, 0x37, 0x16,
+			0xf7, 0xcb, 0x1c, 0x94, 0x2d, 0x65, 0x7c, 0x41,
+			0xd4, 0x36, 0xc7, 0xa1, 0xb6, 0xe2, 0x9f, 0x65,
+			0xf3, 0xe9, 0x00, 0xdb, 0xb9, 0xaf, 0xf4, 0x06,
+			0x4d, 0xc4, 0xab, 0x2f, 0x84, 0x3a, 0xcd, 0xa8,
+		},
+	}, {
+		"test", false,
+		{
+			0xf1, 0xab, 0xb0, 0x23, 0x51, 0x83, 0x51, 0xcd,
+			0x71, 0xd8, 0x81, 0x56, 0x7b, 0x1e, 0xa6, 0x63,
+			0xed, 0x3e, 0xfc, 0xf6, 0xc5, 0x13, 0x2b, 0x35,
+			0x4f, 0x28, 0xd3, 0xb0, 0xb7, 0xd3, 0x83, 0x67,
+			0x01, 0x9f, 0x41, 0x13, 0x74, 0x2a, 0x2b, 0x14,
+			0xbd, 0x25, 0x92, 0x6b, 0x49, 0xc6, 0x49, 0x15,
+			0x5f, 0x26, 0x7e, 0x60, 0xd3, 0x81, 0x4b, 0x4c,
+			0x0c, 0xc8, 0x42, 0x50, 0xe4, 0x6f, 0x00, 0x83,
+		},
+	}, {
+		/* The SHA512 hash is cut to its first 256 bits */
+		"sample", true,
+		{
+			0x84, 0x96, 0xa6, 0x0b, 0x5e, 0x9b, 0x47, 0xc8,
+			0x25, 0x48, 0x88, 0x27, 0xe0, 0x49, 0x5b, 0x0e,
+			0x3f, 0xa1, 0x09, 0xec, 0x45, 0x68, 0xfd, 0x3f,
+			0x8d, 0x10, 0x97, 0x67, 0x8e, 0xb9, 0x7f, 0x00,
+			0x23, 0x62, 0xab, 0x1a, 0xdb, 0xe2, 0xb8, 0xad,
+			0xf9, 0xcb, 0x9e, 0xda, 0xb7, 0x40, 0xea, 0x60,
+			0x49, 0xc0, 0x28, 0x11, 0x4f, 0x24, 0x60, 0xf9,
+			0x65, 0x54, 0xf6, 0x1f, 0xae, 0x33, 0x02, 0xfe,
+		},
+	},
+};
+
+/* Hash a test message, returning the hash length or 0 if not built in */
+static int ecdsa_test_hash(int i, uint8_t *hash)
+{
+	const uint8_t *msg = (const uint8_t *)ecdsa_vectors[i].msg;
+	uint len = strlen(ecdsa_vectors[i].msg);
+
+	if (!ecdsa_vectors[i].sha512) {
+		sha256_csum_wd(msg, len, hash, CHUNKSZ_SHA256);
+		return SHA256_SUM_LEN;
+	}
+#ifdef CONFIG_SHA512
+	sha512_csum_wd(msg, len, hash, CHUNKSZ_SHA512);
+	return SHA512_SUM_LEN;
+#else
+	return 0;
+#endif
+}
+
+/* The RFC 6979 signatures are accepted */
+static int ecdsa_test_vectors(struct unit_test_state *uts)
+{
+	uint8_t hash[SHA512_SUM_LEN];
+	int i, len;
+
+	for (i = 0; i < ARRAY_SIZE(ecdsa_vectors); i++) {
+		len = ecdsa_test_hash(i, hash);
+		if (!len)
+			continue;
+		ut_assertok(p256_ecdsa_verify(hash, len, ecdsa_test_qx,
+					      ecdsa_test_qy,
+					      ecdsa_vectors[i].sig));
+	}
+
+	return 0;
+}
+ECDSA_TEST(ecdsa_test_vectors, 0);
+
+/* Any change to the hash, signature or key is caught */
+static int ecdsa_test_corrupt(struct unit_test_state *uts)
+{
+	uint8_t sig[ECDSA256_BYTES], qy[ECDSA256_BYTES / 2];
+	uint8_t hash[SHA256_SUM_LEN];
+	int i;
+
+	ecdsa_test_hash(0, hash);
+	for (i = 0; i < SHA256_SUM_LEN; i += 7) {
+		hash[i] ^= 0x10;
+		ut_asserteq(-EACCES, p256_ecdsa_verify(hash, SHA256_SUM_LEN,
+				ecdsa_test_qx, ecdsa_test_qy,
+				ecdsa_vectors[0].sig));
+		hash[i] ^= 0x10;
+	}
+
+	memcpy(sig, ecdsa_vectors[0].sig, sizeof(sig));
+	for (i = 0; i < ECDSA256_BYTES; i += 5) {
+		sig[i] ^= 0x01;
+		ut_asserteq(-EACCES, p256_ecdsa_verify(hash, SHA256_SUM_LEN,
+				ecdsa_test_qx, ecdsa_test_qy, sig));
+		sig[i] ^= 0x01;
+	}
+
+	/* Another message's signature */
+	ut_asserteq(-EACCES, p256_ecdsa_verify(hash, SHA256_SUM_LEN,
+			ecdsa_test_qx, ecdsa_test_qy, ecdsa_vectors[1].sig));
+
+	/* A key that is not on the curve */
+	memcpy(qy, ecdsa_test_qy, sizeof(qy));
+	qy[31] ^= 0x01;
+	ut_asserteq(-EINVAL, p256_ecdsa_verify(hash, SHA256_SUM_LEN,
+			ecdsa_test_qx, qy, ecdsa_vectors[0].sig));
+
+	/* r and s must be in 1..n-1 */
+	memset(sig, '\0', ECDSA256_BYTES / 2);
+	ut_asserteq(-EINVAL, p256_ecdsa_verify(hash, SHA256_SUM_LEN,
+			ecdsa_test_qx, ecdsa_test_qy, sig));
+	memset(sig, 0xff, ECDSA256_BYTES / 2);
+	ut_asserteq(-EINVAL, p256_ecdsa_verify(hash, SHA256_SUM_LEN,
+			ecdsa_test_qx, ecdsa_test_qy, sig));
+
+	return 0;
+}
+ECDSA_TEST(ecdsa_test_corrupt, 0);
+
+/* Report the time taken to check a signature */
+static int ecdsa_test_benchmark(struct unit_test_state *uts)
+{
+	uint8_t hash[SHA256_SUM_LEN];
+	ulong start, us;
+	int i;
+
+	ecdsa_test_hash(0, hash);
+	start = timer_get_us();
+	for (i = 0; i < ECDSA_BENCH_LOOPS; i++)
+		ut_assertok(p256_ecdsa_verify(hash, SHA256_SUM_LEN,
+					      ecdsa_test_qx, ecdsa_test_qy,
+					      ecdsa_vectors[0].sig));
+	us = timer_get_us() - start;
+	printf("ecdsa256: %lu us per signature\n", us / ECDSA_BENCH_LOOPS);
+
+	return 0;
+}
+ECDSA_TEST(ecdsa_test_benchmark, 0);
+
+int do_ut_ecdsa(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
+{
+	struct unit_test *tests = ll_entry_start(struct unit_test, ecdsa_test);
+	const int n_ents = ll_entry_count(struct unit_test, ecdsa_test);
+
+	return cmd_ut_category("ecdsa", tests, n_ents, argc, argv);
+}
@@ -0,0 +1,443 @@
+/*
+ * Tests for hashing FIT images while they are loaded
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <command.h>
+#include <errno.h>
+#include <image.h>
+#include <malloc.h>
+#include <mapmem.h>
+#include <test/fit_stream.h>
+#include <test/suites.h>
+#include <test/ut.h>
+
+#define KERNEL_SIZE	(300 * 1024 + 3)
+#define FDT_SIZE	(5 * 1024 + 1)
+#define SCRIPT_SIZE	100
+#define FIT_MAX_SIZE	(KERNEL_SIZE + FDT_SIZE + SCRIPT_SIZE + 4096)
+
+#define BENCH_KERNEL_SIZE	(8 << 20)
+#define BENCH_CHUNK_SIZE	(64 << 10)
+
+/* Fill a buffer with a repeatable pseudo-random pattern */
+static void fill_pattern(unsigned char *buf, uint len, uint32_t seed)
+{
+	uint i;
+
+	for (i = 0; i < len; i++) {
+		seed = seed * 1103515245 + 12345;
+		buf[i] = seed >> 16;
+	}
+}
+
+static int add_image(void *fit, const char *name, uint size, uint32_t seed)
+{
+	uint8_t value[FIT_MAX_HASH_LEN];
+	unsigned char *data;
+	int value_len;
+	int ret;
+
+	data = malloc(size);
+	if (!data)
+		return -ENOMEM;
+	fill_pattern(data, size, seed);
+	ret = calculate_hash(data, size, CONFIG_FIT_STREAM_VERIFY_ALGO, value,
+			     &value_len);
+
+	ret = ret ?: fdt_begin_node(fit, name);
+	ret = ret ?: fdt_property_string(fit, FIT_DESC_PROP, name);
+	ret = ret ?: fdt_property(fit, FIT_DATA_PROP, data, size);
+	ret = ret ?: fdt_property_string(fit, FIT_TYPE_PROP, "kernel");
+	ret = ret ?: fdt_begin_node(fit, FIT_HASH_NODENAME "@1");
+	ret = ret ?: fdt_property_string(fit, FIT_ALGO_PROP,
+					 CONFIG_FIT_STREAM_VERIFY_ALGO);
+	ret = ret ?: fdt_property(fit, FIT_VALUE_PROP, value, value_len);
+	ret = ret ?: fdt_end_node(fit);
+	ret = ret ?: fdt_end_node(fit);
+	free(data);
+
+	return ret;
+}
+
+/* Build a FIT the way dtc lays it out, with the strings at the end */
+static int make_fit(void *fit, uint size, uint kernel_size)
+{
+	int ret;
+
+	ret = fdt_create(fit, size);
+	ret = ret ?: fdt_finish_reservemap(fit);
+	ret = ret ?: fdt_begin_node(fit, "");
+	ret = ret ?: fdt_property_string(fit, FIT_DESC_PROP, "fit_stream");
+	ret = ret ?: fdt_begin_node(fit, FIT_IMAGES_PATH + 1);
+	ret = ret ?: add_image(fit, "kernel@1", kernel_size, 1);
+	ret = ret ?: add_image(fit, "fdt@1", FDT_SIZE, 2);
+	ret = ret ?: add_image(fit, "script@1", SCRIPT_SIZE, 3);
+	ret = ret ?: fdt_end_node(fit);
+	ret = ret ?: fdt_begin_node(fit, FIT_CONFS_PATH + 1);
+	ret = ret ?: fdt_property_string(fit, FIT_DEFAULT_PROP, "conf@1");
+	ret = ret ?: fdt_begin_node(fit, "conf@1");
+	ret = ret ?: fdt_property_string(fit, FIT_KERNEL_PROP, "kernel@1");
+	ret = ret ?: fdt_end_node(fit);
+	ret = ret ?: fdt_end_node(fit);
+	ret = ret ?: fdt_end_node(fit);
+	ret = ret ?: fdt_finish(fit);
+
+	return ret;
+}
+
+/*
+ * Copy @src to @dst as a loader would, @chunk bytes at a time. Chunk number
+ * @skip is copied without being reported, as if it went through a bounce
+ * buffer.
+ */
+static void load(void *dst, const void *src, uint size, uint chunk, int skip)
+{
+	uint pos, len;
+	int i;
+
+	fit_stream_start(dst);
+	for (pos = 0, i = 0; pos < size; pos += len, i++) {
+		len = min(chunk, size - pos);
+		memcpy(dst + pos, src + pos, len);
+		if (i != skip)
+			fit_stream_update(dst + pos, len);
+	}
+	fit_stream_end(size);
+}
+
+static int get_image(struct unit_test_state *uts, const void *fit,
+		     const char *name, const void **data, size_t *size)
+{
+	int images, noffset;
+
+	images = fdt_path_offset(fit, FIT_IMAGES_PATH);
+	ut_assert(images >= 0);
+	noffset = fdt_subnode_offset(fit, images, name);
+	ut_assert(noffset >= 0);
+	ut_assertok(fit_image_get_data(fit, noffset, data, size));
+
+	return noffset;
+}
+
+/* Check that a hash was taken for an image, and that it is right */
+static int check_streamed(struct unit_test_state *uts, const void *fit,
+			  const char *name)
+{
+	uint8_t expect[FIT_MAX_HASH_LEN], value[FIT_MAX_HASH_LEN];
+	int expect_len, value_len;
+	const void *data;
+	size_t size;
+
+	get_image(uts, fit, name, &data, &size);
+	ut_assertok(calculate_hash(data, size, CONFIG_FIT_STREAM_VERIFY_ALGO,
+				   expect, &expect_len));
+	ut_assertok(fit_stream_get_hash(data, size,
+					CONFIG_FIT_STREAM_VERIFY_ALGO, value,
+					&value_len));
+	ut_asserteq(expect_len, value_len);
+	ut_assertok(memcmp(expect, value, value_len));
+
+	/* Each hash can only be used once */
+	ut_asserteq(-ENOENT, fit_stream_get_hash(data, size,
+					CONFIG_FIT_STREAM_VERIFY_ALGO, value,
+					&value_len));
+
+	return 0;
+}
+
+static int check_not_streamed(struct unit_test_state *uts, const void *fit,
+			      const char *name)
+{
+	uint8_t value[FIT_MAX_HASH_LEN];
+	const void *data;
+	size_t size;
+	int value_len;
+
+	get_image(uts, fit, name, &data, &size);
+	ut_asserteq(-ENOENT, fit_stream_get_hash(data, size,
+					CONFIG_FIT_STREAM_VERIFY_ALGO, value,
+					&value_len));
+
+	return 0;
+}
+
+/* Large images are hashed whatever size the chunks arrive in */
+static int fit_stream_test_chunks(struct unit_test_state *uts)
+{
+	static const uint chunks[] = { 1, 7, 512, 4096, 65536, FIT_MAX_SIZE };
+	void *src, *dst;
+	int i;
+
+	src = malloc(FIT_MAX_SIZE);
+	dst = malloc(FIT_MAX_SIZE);
+	ut_assertnonnull(src);
+	ut_assertnonnull(dst);
+	ut_assertok(make_fit(src, FIT_MAX_SIZE, KERNEL_SIZE));
+
+	for (i = 0; i < ARRAY_SIZE(chunks); i++) {
+		load(dst, src, fdt_totalsize(src), chunks[i], -1);
+		ut_assertok(check_streamed(uts, dst, "kernel@1"));
+		ut_assertok(check_streamed(uts, dst, "fdt@1"));
+		/* Too small to be worth it */
+		ut_assertok(check_not_streamed(uts, dst, "script@1"));
+	}
+
+	/* Chunks that are not reported are caught up at the end */
+	for (i = 0; i < 20; i++) {
+		load(dst, src, fdt_totalsize(src), 16384, i);
+		ut_assertok(check_streamed(uts, dst, "kernel@1"));
+		ut_assertok(check_streamed(uts, dst, "fdt@1"));
+	}
+
+	free(dst);
+	free(src);
+
+	return 0;
+}
+FIT_STREAM_TEST(fit_stream_test_chunks, 0);
+
+/* fit_image_verify() uses the hashes and still catches bad data */
+static int fit_stream_test_verify(struct unit_test_state *uts)
+{
+	const void *data;
+	void *src, *dst;
+	size_t size;
+	int noffset;
+
+	src = malloc(FIT_MAX_SIZE);
+	dst = malloc(FIT_MAX_SIZE);
+	ut_assertnonnull(src);
+	ut_assertnonnull(dst);
+	ut_assertok(make_fit(src, FIT_MAX_SIZE, KERNEL_SIZE));
+
+	load(dst, src, fdt_totalsize(src), 4096, -1);
+	noffset = get_image(uts, dst, "kernel@1", &data, &size);
+	ut_asserteq(1, fit_image_verify(dst, noffset));
+	/* The hash taken while loading was used up */
+	ut_assertok(check_not_streamed(uts, dst, "kernel@1"));
+	/* Without it, verification hashes the data again */
+	ut_asserteq(1, fit_image_verify(dst, noffset));
+
+	/* Damage the kernel on its way into memory */
+	((uint8_t *)data - (uint8_t *)dst + (uint8_t *)src)[size / 2] ^= 1;
+	load(dst, src, fdt_totalsize(src), 4096, -1);
+	ut_asserteq(0, fit_image_verify(dst, noffset));
+
+	free(dst);
+	free(src);
+
+	return 0;
+}
+FIT_STREAM_TEST(fit_stream_test_verify, 0);
+
+/* Hashes are not used once another command may have changed memory */
+static int fit_stream_test_commands(struct unit_test_state *uts)
+{
+	uint8_t value[FIT_MAX_HASH_LEN];
+	const void *data;
+	void *src, *dst;
+	size_t size;
+	int value_len;
+
+	src = malloc(FIT_MAX_SIZE);
+	dst = malloc(FIT_MAX_SIZE);
+	ut_assertnonnull(src);
+	ut_assertnonnull(dst);
+	ut_assertok(make_fit(src, FIT_MAX_SIZE, KERNEL_SIZE));
+
+	/* Each command run from here counts as one after 'ut' */
+	load(dst, src, fdt_totalsize(src), 4096, -1);
+	ut_assertok(run_command("setenv fit_stream_test 1", 0));
+	ut_assertok(check_streamed(uts, dst, "kernel@1"));
+	ut_assertok(run_command("setenv fit_stream_test", 0));
+	ut_assertok(check_not_streamed(uts, dst, "fdt@1"));
+
+	/* A failed load leaves nothing behind */
+	load(dst, src, fdt_totalsize(src), 4096, -1);
+	fit_stream_start(dst);
+	fit_stream_update(dst, 4096);
+	fit_stream_end(0);
+	ut_assertok(check_not_streamed(uts, dst, "kernel@1"));
+
+	/* Nor does one that stops short */
+	load(dst, src, fdt_totalsize(src) / 2, 4096, -1);
+	ut_assertok(check_not_streamed(uts, dst, "kernel@1"));
+
+	/* Nor does something that is not a FIT */
+	get_image(uts, dst, "kernel@1", &data, &size);
+	fill_pattern(src, FIT_MAX_SIZE, 4);
+	load(dst, src, FIT_MAX_SIZE, 4096, -1);
+	ut_asserteq(-ENOENT, fit_stream_get_hash(data, size,
+					CONFIG_FIT_STREAM_VERIFY_ALGO, value,
+					&value_len));
+
+	free(dst);
+	free(src);
+
+	return 0;
+}
+FIT_STREAM_TEST(fit_stream_test_commands, 0);
+
+/* Rewriting data which has already been hashed drops the stream */
+static int fit_stream_test_rewrite(struct unit_test_state *uts)
+{
+	uint chunk = 4096, pos, len, size;
+	const void *data;
+	void *src, *dst;
+	size_t data_size;
+	int noffset, i;
+
+	src = malloc(FIT_MAX_SIZE);
+	dst = malloc(FIT_MAX_SIZE);
+	ut_assertnonnull(src);
+	ut_assertnonnull(dst);
+	ut_assertok(make_fit(src, FIT_MAX_SIZE, KERNEL_SIZE));
+	size = fdt_totalsize(src);
+
+	/*
+	 * Chunk 10 is in the middle of the kernel; once chunk 20 has landed,
+	 * it has been hashed. Write it again with one bit flipped.
+	 */
+	fit_stream_start(dst);
+	for (pos = 0, i = 0; pos < size; pos += len, i++) {
+		len = min(chunk, size - pos);
+		memcpy(dst + pos, src + pos, len);
+		fit_stream_update(dst + pos, len);
+		if (i == 20) {
+			((uint8_t *)dst)[10 * chunk] ^= 1;
+			fit_stream_update(dst + 10 * chunk, chunk);
+		}
+	}
+	fit_stream_end(size);
+	ut_assertok(check_not_streamed(uts, dst, "kernel@1"));
+	ut_assertok(check_not_streamed(uts, dst, "fdt@1"));
+	noffset = get_image(uts, dst, "kernel@1", &data, &data_size);
+	ut_asserteq(0, fit_image_verify(dst, noffset));
+
+	/* A write which only overlaps the start of the FIT counts too */
+	load(dst, src, size, chunk, -1);
+	fit_stream_update(dst - chunk / 2, chunk);
+	ut_assertok(check_not_streamed(uts, dst, "kernel@1"));
+
+	/* As does one after loading finished */
+	load(dst, src, size, chunk, -1);
+	((uint8_t *)data)[data_size / 2] ^= 1;
+	fit_stream_update(data + data_size / 2, 1);
+	ut_asserteq(0, fit_image_verify(dst, noffset));
+
+	free(dst);
+	free(src);
+
+	return 0;
+}
+FIT_STREAM_TEST(fit_stream_test_rewrite, 0);
+
+/* A subimage loaded over another drops the hash of the one underneath */
+static int fit_stream_test_load_over(struct unit_test_state *uts)
+{
+	bootm_headers_t images;
+	const char *uname = "fdt@1";
+	const void *data;
+	void *src, *dst;
+	ulong addr, len;
+	size_t size;
+	int images_off, noffset;
+
+	src = malloc(FIT_MAX_SIZE);
+	dst = malloc(FIT_MAX_SIZE);
+	ut_assertnonnull(src);
+	ut_assertnonnull(dst);
+	ut_assertok(make_fit(src, FIT_MAX_SIZE, KERNEL_SIZE));
+
+	/* Give fdt@1 a load address in the middle of the kernel's data */
+	ut_assertok(fdt_open_into(src, src, FIT_MAX_SIZE));
+	ut_assertok(fdt_setprop_u32(src, 0, FIT_TIMESTAMP_PROP, 0));
+	images_off = fdt_path_offset(src, FIT_IMAGES_PATH);
+	noffset = fdt_subnode_offset(src, images_off, uname);
+	ut_assertok(fdt_setprop_string(src, noffset, FIT_OS_PROP, "linux"));
+	ut_assertok(fdt_setprop_u32(src, noffset, FIT_LOAD_PROP, 0));
+	get_image(uts, src, "kernel@1", &data, &size);
+	addr = map_to_sysmem(dst + (data - src) + size / 2);
+	ut_assertok(fdt_setprop_inplace_u32(src, noffset, FIT_LOAD_PROP,
+					    addr));
+
+	load(dst, src, fdt_totalsize(src), 4096, -1);
+	noffset = get_image(uts, dst, "kernel@1", &data, &size);
+	ut_assertok(fit_stream_get_hash(data, size,
+					CONFIG_FIT_STREAM_VERIFY_ALGO, NULL,
+					NULL));
+
+	memset(&images, '\0', sizeof(images));
+	images.verify = 1;
+	ut_assert(fit_image_load(&images, map_to_sysmem(dst), &uname, NULL,
+				 IH_ARCH_DEFAULT, IH_TYPE_KERNEL,
+				 BOOTSTAGE_ID_FIT_KERNEL_START,
+				 FIT_LOAD_OPTIONAL, &addr, &len) >= 0);
+	ut_asserteq(0, fit_image_verify(dst, noffset));
+	ut_assertok(check_not_streamed(uts, dst, "kernel@1"));
+
+	free(dst);
+	free(src);
+
+	return 0;
+}
+FIT_STREAM_TEST(fit_stream_test_load_over, 0);
+
+/*
+ * Report the time spent hashing a large kernel during and after loading,
+ * next to loading it and then hashing it the usual way
+ */
+static int fit_stream_test_benchmark(struct unit_test_state *uts)
+{
+	uint fit_size = BENCH_KERNEL_SIZE + FIT_MAX_SIZE;
+	ulong start, load_us, stream_us, verify_us;
+	void *src, *dst;
+	int noffset;
+
+	src = malloc(fit_size);
+	dst = malloc(fit_size);
+	ut_assertnonnull(src);
+	ut_assertnonnull(dst);
+	ut_assertok(make_fit(src, fit_size, BENCH_KERNEL_SIZE));
+
+	/* Plain load, then verify */
+	start = timer_get_us();
+	memcpy(dst, src, fdt_totalsize(src));
+	load_us = timer_get_us() - start;
+	noffset = fdt_path_offset(dst, FIT_IMAGES_PATH "/kernel@1");
+	ut_assert(noffset >= 0);
+	start = timer_get_us();
+	ut_asserteq(1, fit_image_verify(dst, noffset));
+	verify_us = timer_get_us() - start;
+	printf("\nload %lu us + verify %lu us = %lu us\n", load_us, verify_us,
+	       load_us + verify_us);
+
+	/* Hashing while loading */
+	start = timer_get_us();
+	load(dst, src, fdt_totalsize(src), BENCH_CHUNK_SIZE, -1);
+	stream_us = timer_get_us() - start;
+	start = timer_get_us();
+	ut_asserteq(1, fit_image_verify(dst, noffset));
+	verify_us = timer_get_us() - start;
+	printf("load+hash %lu us + verify %lu us = %lu us\n", stream_us,
+	       verify_us, stream_us + verify_us);
+
+	free(dst);
+	free(src);
+
+	return 0;
+}
+FIT_STREAM_TEST(fit_stream_test_benchmark, 0);
+
+int do_ut_fit_stream(cmd_tbl_t *cmdtp, int flag, int argc,
+		     char * const argv[])
+{
+	struct unit_test *tests = ll_entry_start(struct unit_test,
+						 fit_stream_test);
+	const int n_ents = ll_entry_count(struct unit_test, fit_stream_test);
+
+	return cmd_ut_category("fit_stream", tests, n_ents, argc, argv);
+}
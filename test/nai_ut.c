@@ -0,0 +1,136 @@
+/*
+ * Tests for the NAI serdes message packet pool, run against the loopback
+ * modules emulated by cmd/naisandbox.c
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <command.h>
+#include <malloc.h>
+#include "NAIComms.h"
+#include "cmd_naiconfigmsgutils.h"
+#include "cmd_naiopermsgutils.h"
+#include "cmd_naimsgutils.h"
+#include <test/nai.h>
+#include <test/suites.h>
+#include <test/ut.h>
+
+#define NAI_UT_SLOT		MODULE_1_SLOT
+#define NAI_UT_FLASH_OFFSET	0x600000
+#define NAI_UT_MB		0x100000
+#define NAI_UT_PAGE_BYTES	0x10000	/* Largest stop and wait request */
+
+/* Packets needed for one message carrying @bytes of payload */
+#define NAI_UT_PACKETS(bytes) \
+	DIV_ROUND_UP(bytes, CONFIG_MAX_PAYLOAD_IN_WORDS * 2)
+
+/* Requests and responses that fit in one packet */
+#define NAI_UT_ERASE_PACKETS	2
+
+/*
+ * Each write request of @chunk bytes is answered with one packet; each
+ * 64K read is asked for with one packet and answered with a full message
+ */
+#define NAI_UT_WRITE_PACKETS(chunk) \
+	((NAI_UT_PACKETS(chunk) + 1) * (NAI_UT_MB / (chunk)))
+#define NAI_UT_READ_PACKETS \
+	((1 + NAI_UT_PACKETS(NAI_UT_PAGE_BYTES)) * \
+	 (NAI_UT_MB / NAI_UT_PAGE_BYTES))
+
+static void nai_ut_fill(uint8_t *buf, uint len, uint seed)
+{
+	uint i;
+
+	for (i = 0; i < len; i++)
+		buf[i] = (uint8_t)(i ^ (i >> 8) ^ (seed * 0x3b));
+}
+
+/*
+ * Erase, write and read back a megabyte of module flash, then check the
+ * packets taken for it
+ */
+static int nai_ut_transfer_mb(struct unit_test_state *uts, bool windowed,
+			      uint seed)
+{
+	uint8_t *image, *readback;
+	MsgPoolStats stats;
+	uint pos, expect;
+
+	image = malloc(NAI_UT_MB);
+	readback = malloc(NAI_UT_MB);
+	ut_assertnonnull(image);
+	ut_assertnonnull(readback);
+	nai_ut_fill(image, NAI_UT_MB, seed);
+	memset(readback, '\0', NAI_UT_MB);
+
+	nai_get_msg_pool_stats(NULL, TRUE);
+	ut_assertok(nai_erase_flash_request(MB_SLOT, NAI_UT_SLOT,
+					    NAI_UT_FLASH_OFFSET,
+					    NAI_UT_MB / NAI_UT_PAGE_BYTES));
+	if (windowed) {
+		ut_assertok(nai_write_module_flash_windowed_request(MB_SLOT,
+				NAI_UT_SLOT, NAI_UT_FLASH_OFFSET, image,
+				NAI_UT_MB));
+		expect = NAI_UT_WRITE_PACKETS(SERDES_WINDOW_CHUNK_BYTES);
+	} else {
+		for (pos = 0; pos < NAI_UT_MB; pos += NAI_UT_PAGE_BYTES)
+			ut_assertok(nai_write_module_flash_request(MB_SLOT,
+					NAI_UT_SLOT, NAI_UT_FLASH_OFFSET + pos,
+					image + pos, NAI_UT_PAGE_BYTES));
+		expect = NAI_UT_WRITE_PACKETS(NAI_UT_PAGE_BYTES);
+	}
+	for (pos = 0; pos < NAI_UT_MB; pos += NAI_UT_PAGE_BYTES)
+		ut_assertok(nai_read_module_flash_request(MB_SLOT, NAI_UT_SLOT,
+				NAI_UT_FLASH_OFFSET + pos, readback + pos,
+				NAI_UT_PAGE_BYTES));
+	nai_get_msg_pool_stats(&stats, FALSE);
+	ut_assertok(memcmp(image, readback, NAI_UT_MB));
+	free(readback);
+	free(image);
+
+	printf("%u packets from the pool, %u from the heap, high water %u\n",
+	       stats.unPoolAcquires, stats.unHeapAllocs, stats.unHighWater);
+	expect += NAI_UT_ERASE_PACKETS + NAI_UT_READ_PACKETS;
+	ut_asserteq(expect, stats.unPoolAcquires);
+	ut_asserteq(0, stats.unHeapAllocs);
+	ut_asserteq(0, stats.unInUse);
+	/* A request and its response are the most that are held at once */
+	ut_assert(stats.unHighWater <= NAI_UT_PACKETS(NAI_UT_PAGE_BYTES) + 1);
+
+	return 0;
+}
+
+/* Stop and wait transfers take all their packets from the pool */
+static int nai_test_pool_per_mb(struct unit_test_state *uts)
+{
+	int i;
+
+	nai_init_msg_utils(MB_SLOT);
+	for (i = 0; i < 2; i++)
+		ut_assertok(nai_ut_transfer_mb(uts, false, i));
+
+	return 0;
+}
+NAI_TEST(nai_test_pool_per_mb, 0);
+
+/* So do windowed writes, with several requests in flight */
+static int nai_test_pool_per_mb_windowed(struct unit_test_state *uts)
+{
+	int i;
+
+	nai_init_msg_utils(MB_SLOT);
+	for (i = 0; i < 2; i++)
+		ut_assertok(nai_ut_transfer_mb(uts, true, i));
+
+	return 0;
+}
+NAI_TEST(nai_test_pool_per_mb_windowed, 0);
+
+int do_ut_nai(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
+{
+	struct unit_test *tests = ll_entry_start(struct unit_test, nai_test);
+	const int n_ents = ll_entry_count(struct unit_test, nai_test);
+
+	return cmd_ut_category("nai", tests, n_ents, argc, argv);
+}
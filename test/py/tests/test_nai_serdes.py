@@ -0,0 +1,48 @@
+# SPDX-License-Identifier: GPL-2.0
+#
+# Runs the NAI serdes benchmarks against the loopback modules emulated by
+# cmd/naisandbox.c, checking the data and logging the throughput figures.
+
+import pytest
+
+def run_bench(u_boot_console, cmd):
+    response = u_boot_console.run_command(cmd)
+    for line in response.splitlines():
+        u_boot_console.log.info(line)
+    assert('0 mismatches' in response)
+    assert('Failed' not in response)
+
+@pytest.mark.boardspec('sandbox')
+@pytest.mark.buildconfigspec('nai_serdes_sandbox')
+@pytest.mark.buildconfigspec('cmd_naibench')
+def test_nai_flash_bench(u_boot_console):
+    """Test that a module flash image written with stop and wait requests
+    reads back intact."""
+
+    run_bench(u_boot_console, 'naiflashbench 1 600000 40000 2 0')
+
+@pytest.mark.boardspec('sandbox')
+@pytest.mark.buildconfigspec('nai_serdes_sandbox')
+@pytest.mark.buildconfigspec('cmd_naibench')
+def test_nai_flash_bench_windowed(u_boot_console):
+    """Test that a module flash image written with windowed requests reads
+    back intact, including an unaligned offset and size."""
+
+    run_bench(u_boot_console, 'naiflashbench 1 600000 40000 2 1')
+    run_bench(u_boot_console, 'naiflashbench 2 608100 12345 1 1')
+
+@pytest.mark.boardspec('sandbox')
+@pytest.mark.buildconfigspec('nai_serdes_sandbox')
+@pytest.mark.buildconfigspec('cmd_naibench')
+def test_nai_eeprom_bench(u_boot_console):
+    """Test that module EEPROM images read back intact."""
+
+    run_bench(u_boot_console, 'naieeprombench 1 51 16')
+
+@pytest.mark.boardspec('sandbox')
+@pytest.mark.buildconfigspec('nai_serdes_sandbox')
+@pytest.mark.buildconfigspec('cmd_naibench')
+def test_nai_batch_bench(u_boot_console):
+    """Test that batched register requests agree with single requests."""
+
+    run_bench(u_boot_console, 'naibatchbench 1 0 64')
@@ -22,11 +22,14 @@ For configuration verification:
 - Corrupt the signature
 - Check that image verification no-longer works
 
-Tests run with both SHA1 and SHA256 hashing.
+Tests run with SHA1 and SHA256 hashing, and with SHA384 and SHA512 when
+the build supports them. When ECDSA is enabled, SHA256 is also run with a
+P-256 key and the time taken by fit_check_sign is logged against RSA.
 """
 
 import pytest
 import sys
+import time
 import u_boot_utils as util
 
 @pytest.mark.boardspec('sandbox')
@@ -66,8 +69,8 @@ def test_vboot(u_boot_console):
         Args:
             test_type: A string identifying the test type.
             expect_string: A string which is expected in the output.
-            sha_algo: Either 'sha1' or 'sha256', to select the algorithm to
-                    use.
+            sha_algo: 'sha1', 'sha256', 'sha384' or 'sha512', to select the
+                    algorithm to use.
             boots: A boolean that is True if Linux should boot and False if
                     we are expected to not boot
         """
@@ -81,6 +84,19 @@ def test_vboot(u_boot_console):
         if boots:
             assert('sandbox: continuing, as we cannot run' in ''.join(output))
 
+    def check_sign_time(sha_algo):
+        """Check the signed FIT on the host and log how long it took
+
+        Args:
+            sha_algo: The algorithm name, used in the log message.
+        """
+        tstart = time.time()
+        util.run_and_log(cons, [fit_check_sign, '-f', fit, '-k', tmpdir,
+                                '-k', dtb])
+        tend = time.time()
+        cons.log.info('%s: fit_check_sign took %d ms' %
+                      (sha_algo, (tend - tstart) * 1000))
+
     def make_fit(its):
         """Make a new FIT from the .its source file.
 
@@ -99,23 +115,28 @@ def test_vboot(u_boot_console):
         public key into the dtb.
 
         Args:
-            sha_algo: Either 'sha1' or 'sha256', to select the algorithm to
-                    use.
+            sha_algo: 'sha1', 'sha256', 'sha384' or 'sha512', to select the
+                    algorithm to use.
         """
         cons.log.action('%s: Sign images' % sha_algo)
         util.run_and_log(cons, [mkimage, '-F', '-k', tmpdir, '-K', dtb,
                                 '-r', fit])
 
-    def test_with_algo(sha_algo):
+    def test_with_algo(sha_algo, crypto_algo=None):
         """Test verified boot with the given hash algorithm.
 
         This is the main part of the test code. The same procedure is followed
         for both hashing algorithms.
 
         Args:
-            sha_algo: Either 'sha1' or 'sha256', to select the algorithm to
-                    use.
+            sha_algo: 'sha1', 'sha256', 'sha384' or 'sha512', to select the
+                    algorithm to use.
+            crypto_algo: None for the 'dev' RSA key, or 'ecdsa256' for the
+                    'ecdev' P-256 key.
         """
+        its_algo = sha_algo
+        if crypto_algo:
+            its_algo = '%s-%s' % (sha_algo, crypto_algo)
         # Compile our device tree files for kernel and U-Boot. These are
         # regenerated here since mkimage will modify them (by adding a
         # public key) below.
@@ -124,7 +145,7 @@ def test_vboot(u_boot_console):
 
         # Build the FIT, but don't sign anything yet
         cons.log.action('%s: Test FIT with signed images' % sha_algo)
-        make_fit('sign-images-%s.its' % sha_algo)
+        make_fit('sign-images-%s.its' % its_algo)
         run_bootm(sha_algo, 'unsigned images', 'dev-', True)
 
         # Sign images with our dev keys
@@ -135,17 +156,15 @@ def test_vboot(u_boot_console):
         dtc('sandbox-u-boot.dts')
 
         cons.log.action('%s: Test FIT with signed configuration' % sha_algo)
-        make_fit('sign-configs-%s.its' % sha_algo)
+        make_fit('sign-configs-%s.its' % its_algo)
         run_bootm(sha_algo, 'unsigned config', '%s+ OK' % sha_algo, True)
 
         # Sign images with our dev keys
         sign_fit(sha_algo)
         run_bootm(sha_algo, 'signed config', 'dev+', True)
 
-        cons.log.action('%s: Check signed config on the host' % sha_algo)
-
-        util.run_and_log(cons, [fit_check_sign, '-f', fit, '-k', tmpdir,
-                                '-k', dtb])
+        cons.log.action('%s: Check signed config on the host' % its_algo)
+        check_sign_time(its_algo)
 
         # Increment the first byte of the signature, which should cause failure
         sig = util.run_and_log(cons, 'fdtget -t bx %s %s value' %
@@ -185,6 +204,12 @@ def test_vboot(u_boot_console):
     util.run_and_log(cons, 'openssl req -batch -new -x509 -key %sdev.key -out '
                      '%sdev.crt' % (tmpdir, tmpdir))
 
+    # Create a P-256 key pair
+    ecdsa = cons.config.buildconfig.get('config_ecdsa', 'n') == 'y'
+    if ecdsa:
+        util.run_and_log(cons, 'openssl ecparam -genkey -name prime256v1 '
+                         '-noout -out %secdev.key' % tmpdir)
+
     # Create a number kernel image with zeroes
     with open('%stest-kernel.bin' % tmpdir, 'w') as fd:
         fd.write(5000 * chr(0))
@@ -196,6 +221,12 @@ def test_vboot(u_boot_console):
         cons.config.dtb = dtb
         test_with_algo('sha1')
         test_with_algo('sha256')
+        for sha_algo in ('sha384', 'sha512'):
+            if cons.config.buildconfig.get(
+                    'config_fit_enable_%s_support' % sha_algo, 'n') == 'y':
+                test_with_algo(sha_algo)
+        if ecdsa:
+            test_with_algo('sha256', 'ecdsa256')
     finally:
         # Go back to the original U-Boot with the correct dtb.
         cons.config.dtb = old_dtb
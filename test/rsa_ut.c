@@ -0,0 +1,238 @@
+/*
+ * Tests and benchmark for the RSA engines in lib/rsa/rsa-mod-exp.c
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <command.h>
+#include <malloc.h>
+#include <u-boot/rsa.h>
+#include <u-boot/rsa-mod-exp.h>
+#include <test/rsa.h>
+#include <test/suites.h>
+#include <test/ut.h>
+#include <asm/unaligned.h>
+
+#define RSA_BENCH_LOOPS		8
+
+static const char * const engine_name[RSA_MOD_EXP_ENGINE_COUNT] = {
+	[RSA_MOD_EXP_ENGINE_BASIC]	= "basic",
+	[RSA_MOD_EXP_ENGINE_FAST]	= "fast",
+};
+
+/* F4, the smallest allowed, and a 64-bit one needing the largest window */
+static const uint64_t rsa_test_exponents[] = {
+	65537, 3, 0x1d5b, 0xc96f2a4e3b81d907ULL,
+};
+
+/*
+ * Any odd modulus will do to compare the engines, so the keys are random
+ * numbers with the top bit set rather than products of two primes
+ */
+struct rsa_test_key {
+	struct key_prop prop;
+	uint8_t modulus[RSA4096_BYTES];
+	uint8_t rr[RSA4096_BYTES];
+	uint64_t exponent;
+};
+
+/* Fill a buffer with a repeatable pseudo-random pattern */
+static void fill_pattern(uint8_t *buf, uint len, uint32_t seed)
+{
+	uint i;
+
+	for (i = 0; i < len; i++) {
+		seed = seed * 1103515245 + 12345;
+		buf[i] = seed >> 16;
+	}
+}
+
+/* R^2 mod modulus, with R = 2^bits, by doubling 1 2 * bits times */
+static void rsa_test_calc_rr(struct rsa_test_key *key, int bits)
+{
+	uint words = bits / 32;
+	uint32_t n[words], r[words];
+	uint64_t acc;
+	int64_t diff;
+	uint32_t top;
+	int i, j;
+
+	for (i = 0; i < words; i++)
+		n[i] = get_unaligned_be32(key->modulus + (words - 1 - i) * 4);
+	memset(r, '\0', sizeof(r));
+	r[0] = 1;
+	for (j = 0; j < 2 * bits; j++) {
+		for (i = 0, top = 0; i < words; i++) {
+			acc = (uint64_t)r[i] << 1 | top;
+			top = r[i] >> 31;
+			r[i] = acc;
+		}
+		for (i = words - 1; !top && i >= 0 && r[i] == n[i]; i--)
+			;
+		if (top || i < 0 || r[i] > n[i]) {
+			for (i = 0, diff = 0; i < words; i++) {
+				diff += (uint64_t)r[i] - n[i];
+				r[i] = diff;
+				diff >>= 32;
+			}
+		}
+	}
+	for (i = 0; i < words; i++)
+		put_unaligned_be32(r[i], key->rr + (words - 1 - i) * 4);
+}
+
+static void rsa_test_make_key(struct rsa_test_key *key, int bits,
+			      uint64_t exponent, uint32_t seed)
+{
+	uint32_t n0, inv;
+	int i;
+
+	fill_pattern(key->modulus, bits / 8, seed);
+	key->modulus[0] |= 0x80;
+	key->modulus[bits / 8 - 1] |= 1;
+	rsa_test_calc_rr(key, bits);
+	key->exponent = cpu_to_fdt64(exponent);
+
+	n0 = get_unaligned_be32(key->modulus + bits / 8 - 4);
+	for (inv = n0, i = 0; i < 4; i++)
+		inv *= 2 - n0 * inv;
+
+	key->prop.modulus = key->modulus;
+	key->prop.rr = key->rr;
+	key->prop.public_exponent = &key->exponent;
+	key->prop.n0inv = -inv;
+	key->prop.num_bits = bits;
+	key->prop.exp_len = sizeof(uint64_t);
+}
+
+/* A signature is less than the modulus */
+static void rsa_test_make_sig(uint8_t *sig, int bits, uint32_t seed)
+{
+	fill_pattern(sig, bits / 8, seed);
+	sig[0] &= 0x7f;
+}
+
+/* Results that do not depend on the engines being right */
+static int rsa_test_known_values(struct unit_test_state *uts)
+{
+	uint8_t sig[RSA2048_BYTES], out[RSA2048_BYTES];
+	struct rsa_test_key key;
+	int engine, i;
+
+	rsa_test_make_key(&key, 2048, 3, 1);
+	for (engine = 0; engine < RSA_MOD_EXP_ENGINE_COUNT; engine++) {
+		/* 2^3 */
+		memset(sig, '\0', sizeof(sig));
+		sig[sizeof(sig) - 1] = 2;
+		ut_assertok(rsa_mod_exp_sw_engine(engine, sig, sizeof(sig),
+						  &key.prop, out));
+		sig[sizeof(sig) - 1] = 8;
+		ut_assertok(memcmp(sig, out, sizeof(sig)));
+
+		/* (-1)^e for any odd e */
+		for (i = 0; i < ARRAY_SIZE(rsa_test_exponents); i++) {
+			key.exponent = cpu_to_fdt64(rsa_test_exponents[i]);
+			memcpy(sig, key.modulus, sizeof(sig));
+			sig[sizeof(sig) - 1] &= ~1;
+			ut_assertok(rsa_mod_exp_sw_engine(engine, sig,
+							  sizeof(sig),
+							  &key.prop, out));
+			ut_assertok(memcmp(sig, out, sizeof(sig)));
+		}
+		key.exponent = cpu_to_fdt64(3);
+	}
+
+	/* Even exponents are refused */
+	key.exponent = cpu_to_fdt64(65536);
+	for (engine = 0; engine < RSA_MOD_EXP_ENGINE_COUNT; engine++)
+		ut_asserteq(-EINVAL, rsa_mod_exp_sw_engine(engine, sig,
+							   sizeof(sig),
+							   &key.prop, out));
+
+	return 0;
+}
+RSA_TEST(rsa_test_known_values, 0);
+
+/* The engines agree for every key size and exponent */
+static int rsa_test_engines_agree(struct unit_test_state *uts)
+{
+	static const int sizes[] = { 2048, 3072, 4096 };
+	uint8_t sig[RSA4096_BYTES], expect[RSA4096_BYTES];
+	uint8_t out[RSA4096_BYTES];
+	struct rsa_test_key *key;
+	int engine, bits, s, i;
+
+	key = malloc(sizeof(*key));
+	ut_assertnonnull(key);
+	for (s = 0; s < ARRAY_SIZE(sizes); s++) {
+		bits = sizes[s];
+		for (i = 0; i < ARRAY_SIZE(rsa_test_exponents); i++) {
+			rsa_test_make_key(key, bits, rsa_test_exponents[i],
+					  bits + i);
+			rsa_test_make_sig(sig, bits, i);
+			ut_assertok(rsa_mod_exp_sw_engine(
+					RSA_MOD_EXP_ENGINE_BASIC, sig, bits / 8,
+					&key->prop, expect));
+			for (engine = 0; engine < RSA_MOD_EXP_ENGINE_COUNT;
+			     engine++) {
+				ut_assertok(rsa_mod_exp_sw_engine(engine, sig,
+						bits / 8, &key->prop, out));
+				ut_assertok(memcmp(expect, out, bits / 8));
+			}
+			ut_assertok(rsa_mod_exp_sw(sig, bits / 8, &key->prop,
+						   out));
+			ut_assertok(memcmp(expect, out, bits / 8));
+		}
+	}
+	free(key);
+
+	return 0;
+}
+RSA_TEST(rsa_test_engines_agree, 0);
+
+/* Report the time each engine takes for 2048 and 4096-bit keys */
+static int rsa_test_benchmark(struct unit_test_state *uts)
+{
+	static const int sizes[] = { 2048, 4096 };
+	uint8_t sig[RSA4096_BYTES], out[RSA4096_BYTES];
+	struct rsa_test_key *key;
+	unsigned long long exp;
+	ulong start, us;
+	int engine, bits, s, i, j;
+
+	key = malloc(sizeof(*key));
+	ut_assertnonnull(key);
+	for (s = 0; s < ARRAY_SIZE(sizes); s++) {
+		bits = sizes[s];
+		rsa_test_make_sig(sig, bits, bits);
+		for (i = 0; i < ARRAY_SIZE(rsa_test_exponents); i += 3) {
+			exp = rsa_test_exponents[i];
+			rsa_test_make_key(key, bits, exp, bits);
+			for (engine = 0; engine < RSA_MOD_EXP_ENGINE_COUNT;
+			     engine++) {
+				start = timer_get_us();
+				for (j = 0; j < RSA_BENCH_LOOPS; j++)
+					ut_assertok(rsa_mod_exp_sw_engine(
+						engine, sig, bits / 8,
+						&key->prop, out));
+				us = timer_get_us() - start;
+				printf("%6s: rsa%d, e=%#llx: %lu us\n",
+				       engine_name[engine], bits, exp,
+				       us / RSA_BENCH_LOOPS);
+			}
+		}
+	}
+	free(key);
+
+	return 0;
+}
+RSA_TEST(rsa_test_benchmark, 0);
+
+int do_ut_rsa(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
+{
+	struct unit_test *tests = ll_entry_start(struct unit_test, rsa_test);
+	const int n_ents = ll_entry_count(struct unit_test, rsa_test);
+
+	return cmd_ut_category("rsa", tests, n_ents, argc, argv);
+}
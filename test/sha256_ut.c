@@ -0,0 +1,301 @@
+/*
+ * Tests and benchmark for the SHA256 engines in lib/sha256.c
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <command.h>
+#include <malloc.h>
+#include <u-boot/sha256.h>
+#include <test/sha256.h>
+#include <test/suites.h>
+#include <test/ut.h>
+
+#define SHA256_BENCH_SIZE	(1 << 20)
+#define SHA256_BENCH_LOOPS	16
+#define SHA256_MB_TEST_JOBS	9
+
+static const char * const engine_name[SHA256_ENGINE_COUNT] = {
+	[SHA256_ENGINE_C]		= "c",
+	[SHA256_ENGINE_ARMV8_CE]	= "armv8-ce",
+	[SHA256_ENGINE_SHA_NI]		= "sha-ni",
+};
+
+/* FIPS 180-2 examples */
+static const struct {
+	const char *msg;
+	uint8_t digest[SHA256_SUM_LEN];
+} sha256_vectors[] = {
+	{
+		"abc",
+		{
+			0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea,
+			0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23,
+			0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c,
+			0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad,
+		},
+	}, {
+		"abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+		{
+			0x24, 0x8d, 0x6a, 0x61, 0xd2, 0x06, 0x38, 0xb8,
+			0xe5, 0xc0, 0x26, 0x93, 0x0c, 0x3e, 0x60, 0x39,
+			0xa3, 0x3c, 0xe4, 0x59, 0x64, 0xff, 0x21, 0x67,
+			0xf6, 0xec, 0xed, 0xd4, 0x19, 0xdb, 0x06, 0xc1,
+		},
+	},
+};
+
+/* Fill a buffer with a repeatable pseudo-random pattern */
+static void fill_pattern(unsigned char *buf, uint len)
+{
+	uint32_t seed = 0x12345678;
+	uint i;
+
+	for (i = 0; i < len; i++) {
+		seed = seed * 1103515245 + 12345;
+		buf[i] = seed >> 16;
+	}
+}
+
+static void sha256_engine_csum(enum sha256_engine engine,
+			       const uint8_t *buf, uint32_t len,
+			       uint8_t digest[SHA256_SUM_LEN])
+{
+	sha256_context ctx;
+
+	sha256_starts(&ctx);
+	sha256_engine_update(engine, &ctx, buf, len);
+	sha256_finish(&ctx, digest);
+}
+
+/* Every supported engine must give the FIPS 180-2 digests */
+static int sha256_test_vectors(struct unit_test_state *uts)
+{
+	uint8_t digest[SHA256_SUM_LEN];
+	int engine, i;
+
+	for (i = 0; i < ARRAY_SIZE(sha256_vectors); i++) {
+		const uint8_t *msg = (const uint8_t *)sha256_vectors[i].msg;
+		uint32_t len = strlen(sha256_vectors[i].msg);
+
+		sha256_csum_wd(msg, len, digest, CHUNKSZ_SHA256);
+		ut_assertok(memcmp(sha256_vectors[i].digest, digest,
+				   SHA256_SUM_LEN));
+		for (engine = 0; engine < SHA256_ENGINE_COUNT; engine++) {
+			if (!sha256_engine_supported(engine))
+				continue;
+			sha256_engine_csum(engine, msg, len, digest);
+			ut_assertok(memcmp(sha256_vectors[i].digest, digest,
+				   SHA256_SUM_LEN));
+		}
+	}
+
+	return 0;
+}
+SHA256_TEST(sha256_test_vectors, 0);
+
+/* All engines agree with the C rounds for every alignment and length */
+static int sha256_test_engines_agree(struct unit_test_state *uts)
+{
+	uint8_t expect[SHA256_SUM_LEN], digest[SHA256_SUM_LEN];
+	unsigned char buf[512];
+	int engine, ofs, len;
+
+	fill_pattern(buf, sizeof(buf));
+	for (ofs = 0; ofs < 8; ofs++) {
+		for (len = 0; len <= 300; len++) {
+			sha256_engine_csum(SHA256_ENGINE_C, buf + ofs, len,
+					   expect);
+			for (engine = 0; engine < SHA256_ENGINE_COUNT;
+			     engine++) {
+				sha256_engine_csum(engine, buf + ofs, len,
+						   digest);
+				ut_assertok(memcmp(expect, digest,
+						   SHA256_SUM_LEN));
+			}
+		}
+	}
+
+	return 0;
+}
+SHA256_TEST(sha256_test_engines_agree, 0);
+
+/* Data may arrive in pieces, and engines may be mixed on one context */
+static int sha256_test_incremental(struct unit_test_state *uts)
+{
+	uint8_t expect[SHA256_SUM_LEN], digest[SHA256_SUM_LEN];
+	unsigned char buf[1024];
+	sha256_context ctx;
+	int engine, split;
+
+	fill_pattern(buf, sizeof(buf));
+	sha256_engine_csum(SHA256_ENGINE_C, buf, sizeof(buf), expect);
+	for (engine = 0; engine < SHA256_ENGINE_COUNT; engine++) {
+		for (split = 0; split <= sizeof(buf); split += 37) {
+			sha256_starts(&ctx);
+			sha256_engine_update(SHA256_ENGINE_C, &ctx, buf, split);
+			sha256_engine_update(engine, &ctx, buf + split,
+					     sizeof(buf) - split);
+			sha256_finish(&ctx, digest);
+			ut_assertok(memcmp(expect, digest, SHA256_SUM_LEN));
+
+			sha256_starts(&ctx);
+			sha256_update(&ctx, buf, split);
+			sha256_update(&ctx, buf + split, sizeof(buf) - split);
+			sha256_finish(&ctx, digest);
+			ut_assertok(memcmp(expect, digest, SHA256_SUM_LEN));
+		}
+	}
+
+	return 0;
+}
+SHA256_TEST(sha256_test_incremental, 0);
+
+/* Report the throughput of each supported engine */
+static int sha256_test_benchmark(struct unit_test_state *uts)
+{
+	uint8_t digest[SHA256_SUM_LEN];
+	unsigned char *buf;
+	sha256_context ctx;
+	ulong start, us;
+	int engine, i;
+
+	buf = malloc(SHA256_BENCH_SIZE);
+	ut_assertnonnull(buf);
+	fill_pattern(buf, SHA256_BENCH_SIZE);
+
+	for (engine = 0; engine < SHA256_ENGINE_COUNT; engine++) {
+		if (!sha256_engine_supported(engine)) {
+			printf("%12s: not available\n", engine_name[engine]);
+			continue;
+		}
+
+		sha256_starts(&ctx);
+		start = timer_get_us();
+		for (i = 0; i < SHA256_BENCH_LOOPS; i++)
+			sha256_engine_update(engine, &ctx, buf,
+					     SHA256_BENCH_SIZE);
+		sha256_finish(&ctx, digest);
+		us = max(timer_get_us() - start, 1UL);
+
+		printf("%12s: %lu KB/s (sha256 %02x%02x%02x%02x...)\n",
+		       engine_name[engine],
+		       (ulong)((u64)SHA256_BENCH_LOOPS * SHA256_BENCH_SIZE *
+			       1000000 / 1024 / us),
+		       digest[0], digest[1], digest[2], digest[3]);
+	}
+	free(buf);
+
+	return 0;
+}
+SHA256_TEST(sha256_test_benchmark, 0);
+
+#ifdef CONFIG_SHA256_MB
+static const char * const mb_engine_name[SHA256_MB_ENGINE_COUNT] = {
+	[SHA256_MB_ENGINE_SERIAL]	= "serial",
+	[SHA256_MB_ENGINE_LANES]	= "lanes",
+	[SHA256_MB_ENGINE_MP]		= "mp",
+};
+
+/* Multi-buffer engines agree with sha256_csum_wd() for any mix of buffers */
+static int sha256_test_mb_engines_agree(struct unit_test_state *uts)
+{
+	static const uint32_t lens[] = {
+		0, 1, 55, 56, 63, 64, 65, 119, 120, 128, 1000, 70000,
+	};
+	struct sha256_mb_job jobs[SHA256_MB_TEST_JOBS];
+	uint8_t expect[SHA256_MB_TEST_JOBS][SHA256_SUM_LEN];
+	unsigned char *buf;
+	int engine, count, i;
+
+	buf = malloc(SHA256_MB_TEST_JOBS * (70000 + 8));
+	ut_assertnonnull(buf);
+	fill_pattern(buf, SHA256_MB_TEST_JOBS * (70000 + 8));
+
+	for (count = 1; count <= SHA256_MB_TEST_JOBS; count++) {
+		for (i = 0; i < count; i++) {
+			jobs[i].data = buf + i * (70000 + 8) + i % 8;
+			jobs[i].len = lens[(i * 7 + count) % ARRAY_SIZE(lens)];
+			sha256_csum_wd(jobs[i].data, jobs[i].len, expect[i],
+				       CHUNKSZ_SHA256);
+		}
+		for (engine = 0; engine < SHA256_MB_ENGINE_COUNT; engine++) {
+			for (i = 0; i < count; i++)
+				memset(jobs[i].digest, '\0', SHA256_SUM_LEN);
+			sha256_mb_engine_hash(engine, jobs, count);
+			for (i = 0; i < count; i++)
+				ut_assertok(memcmp(expect[i], jobs[i].digest,
+						   SHA256_SUM_LEN));
+		}
+		sha256_mb_hash(jobs, count);
+		for (i = 0; i < count; i++)
+			ut_assertok(memcmp(expect[i], jobs[i].digest,
+					   SHA256_SUM_LEN));
+	}
+	free(buf);
+
+	return 0;
+}
+SHA256_TEST(sha256_test_mb_engines_agree, 0);
+
+/*
+ * Hash the images of a typical FIT configuration with each multi-buffer
+ * engine, against the time taken by the largest image alone
+ */
+static int sha256_test_mb_benchmark(struct unit_test_state *uts)
+{
+	static const uint32_t sizes[] = {
+		8 << 20, 4 << 20, 64 << 10, 1 << 20, 1 << 20,
+	};
+	struct sha256_mb_job jobs[ARRAY_SIZE(sizes)];
+	uint8_t digest[SHA256_SUM_LEN];
+	unsigned char *buf;
+	ulong start, us, total = 0;
+	int engine, i;
+
+	for (i = 0; i < ARRAY_SIZE(sizes); i++)
+		total += sizes[i];
+	buf = malloc(total);
+	ut_assertnonnull(buf);
+	fill_pattern(buf, total);
+	for (i = 0, total = 0; i < ARRAY_SIZE(sizes); i++) {
+		jobs[i].data = buf + total;
+		jobs[i].len = sizes[i];
+		total += sizes[i];
+	}
+
+	start = timer_get_us();
+	sha256_csum_wd(jobs[0].data, jobs[0].len, digest, CHUNKSZ_SHA256);
+	printf("%12s: %lu us for the largest image\n", "single",
+	       timer_get_us() - start);
+
+	for (engine = 0; engine < SHA256_MB_ENGINE_COUNT; engine++) {
+		if (!sha256_mb_engine_supported(engine)) {
+			printf("%12s: not available\n", mb_engine_name[engine]);
+			continue;
+		}
+
+		start = timer_get_us();
+		sha256_mb_engine_hash(engine, jobs, ARRAY_SIZE(jobs));
+		us = max(timer_get_us() - start, 1UL);
+		ut_assertok(memcmp(digest, jobs[0].digest, SHA256_SUM_LEN));
+
+		printf("%12s: %lu us for %d images (%lu KB/s)\n",
+		       mb_engine_name[engine], us, (int)ARRAY_SIZE(jobs),
+		       (ulong)((u64)total * 1000000 / 1024 / us));
+	}
+	free(buf);
+
+	return 0;
+}
+SHA256_TEST(sha256_test_mb_benchmark, 0);
+#endif
+
+int do_ut_sha256(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
+{
+	struct unit_test *tests = ll_entry_start(struct unit_test, sha256_test);
+	const int n_ents = ll_entry_count(struct unit_test, sha256_test);
+
+	return cmd_ut_category("sha256", tests, n_ents, argc, argv);
+}
@@ -0,0 +1,266 @@
+/*
+ * Tests and benchmark for the SHA384/512 engines in lib/sha512.c
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <command.h>
+#include <malloc.h>
+#include <u-boot/sha256.h>
+#include <u-boot/sha512.h>
+#include <test/sha512.h>
+#include <test/suites.h>
+#include <test/ut.h>
+
+#define SHA512_BENCH_SIZE	(1 << 20)
+#define SHA512_BENCH_LOOPS	16
+
+static const char * const engine_name[SHA512_ENGINE_COUNT] = {
+	[SHA512_ENGINE_C]		= "c",
+	[SHA512_ENGINE_ARMV8_CE]	= "armv8-ce",
+};
+
+/* FIPS 180-2 examples */
+static const struct {
+	const char *msg;
+	uint8_t digest[SHA384_SUM_LEN];
+} sha384_vectors[] = {
+	{
+		"abc",
+		{
+			0xcb, 0x00, 0x75, 0x3f, 0x45, 0xa3, 0x5e, 0x8b,
+			0xb5, 0xa0, 0x3d, 0x69, 0x9a, 0xc6, 0x50, 0x07,
+			0x27, 0x2c, 0x32, 0xab, 0x0e, 0xde, 0xd1, 0x63,
+			0x1a, 0x8b, 0x60, 0x5a, 0x43, 0xff, 0x5b, 0xed,
+			0x80, 0x86, 0x07, 0x2b, 0xa1, 0xe7, 0xcc, 0x23,
+			0x58, 0xba, 0xec, 0xa1, 0x34, 0xc8, 0x25, 0xa7,
+		},
+	}, {
+		"abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmn"
+		"hijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu",
+		{
+			0x09, 0x33, 0x0c, 0x33, 0xf7, 0x11, 0x47, 0xe8,
+			0x3d, 0x19, 0x2f, 0xc7, 0x82, 0xcd, 0x1b, 0x47,
+			0x53, 0x11, 0x1b, 0x17, 0x3b, 0x3b, 0x05, 0xd2,
+			0x2f, 0xa0, 0x80, 0x86, 0xe3, 0xb0, 0xf7, 0x12,
+			0xfc, 0xc7, 0xc7, 0x1a, 0x55, 0x7e, 0x2d, 0xb9,
+			0x66, 0xc3, 0xe9, 0xfa, 0x91, 0x74, 0x60, 0x39,
+		},
+	},
+};
+
+static const struct {
+	const char *msg;
+	uint8_t digest[SHA512_SUM_LEN];
+} sha512_vectors[] = {
+	{
+		"abc",
+		{
+			0xdd, 0xaf, 0x35, 0xa1, 0x93, 0x61, 0x7a, 0xba,
+			0xcc, 0x41, 0x73, 0x49, 0xae, 0x20, 0x41, 0x31,
+			0x12, 0xe6, 0xfa, 0x4e, 0x89, 0xa9, 0x7e, 0xa2,
+			0x0a, 0x9e, 0xee, 0xe6, 0x4b, 0x55, 0xd3, 0x9a,
+			0x21, 0x92, 0x99, 0x2a, 0x27, 0x4f, 0xc1, 0xa8,
+			0x36, 0xba, 0x3c, 0x23, 0xa3, 0xfe, 0xeb, 0xbd,
+			0x45, 0x4d, 0x44, 0x23, 0x64, 0x3c, 0xe8, 0x0e,
+			0x2a, 0x9a, 0xc9, 0x4f, 0xa5, 0x4c, 0xa4, 0x9f,
+		},
+	}, {
+		"abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmn"
+		"hijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu",
+		{
+			0x8e, 0x95, 0x9b, 0x75, 0xda, 0xe3, 0x13, 0xda,
+			0x8c, 0xf4, 0xf7, 0x28, 0x14, 0xfc, 0x14, 0x3f,
+			0x8f, 0x77, 0x79, 0xc6, 0xeb, 0x9f, 0x7f, 0xa1,
+			0x72, 0x99, 0xae, 0xad, 0xb6, 0x88, 0x90, 0x18,
+			0x50, 0x1d, 0x28, 0x9e, 0x49, 0x00, 0xf7, 0xe4,
+			0x33, 0x1b, 0x99, 0xde, 0xc4, 0xb5, 0x43, 0x3a,
+			0xc7, 0xd3, 0x29, 0xee, 0xb6, 0xdd, 0x26, 0x54,
+			0x5e, 0x96, 0xe5, 0x5b, 0x87, 0x4b, 0xe9, 0x09,
+		},
+	},
+};
+
+/* Fill a buffer with a repeatable pseudo-random pattern */
+static void fill_pattern(unsigned char *buf, uint len)
+{
+	uint32_t seed = 0x12345678;
+	uint i;
+
+	for (i = 0; i < len; i++) {
+		seed = seed * 1103515245 + 12345;
+		buf[i] = seed >> 16;
+	}
+}
+
+static void sha512_engine_csum(enum sha512_engine engine,
+			       const uint8_t *buf, uint32_t len,
+			       uint8_t digest[SHA512_SUM_LEN])
+{
+	sha512_context ctx;
+
+	sha512_starts(&ctx);
+	sha512_engine_update(engine, &ctx, buf, len);
+	sha512_finish(&ctx, digest);
+}
+
+/* Every supported engine must give the FIPS 180-2 digests */
+static int sha512_test_vectors(struct unit_test_state *uts)
+{
+	uint8_t digest[SHA512_SUM_LEN];
+	sha512_context ctx;
+	int engine, i;
+
+	for (i = 0; i < ARRAY_SIZE(sha384_vectors); i++) {
+		const uint8_t *msg = (const uint8_t *)sha384_vectors[i].msg;
+		uint32_t len = strlen(sha384_vectors[i].msg);
+
+		sha384_csum_wd(msg, len, digest, CHUNKSZ_SHA384);
+		ut_assertok(memcmp(sha384_vectors[i].digest, digest,
+				   SHA384_SUM_LEN));
+		for (engine = 0; engine < SHA512_ENGINE_COUNT; engine++) {
+			if (!sha512_engine_supported(engine))
+				continue;
+			sha384_starts(&ctx);
+			sha512_engine_update(engine, &ctx, msg, len);
+			sha384_finish(&ctx, digest);
+			ut_assertok(memcmp(sha384_vectors[i].digest, digest,
+					   SHA384_SUM_LEN));
+		}
+	}
+
+	for (i = 0; i < ARRAY_SIZE(sha512_vectors); i++) {
+		const uint8_t *msg = (const uint8_t *)sha512_vectors[i].msg;
+		uint32_t len = strlen(sha512_vectors[i].msg);
+
+		sha512_csum_wd(msg, len, digest, CHUNKSZ_SHA512);
+		ut_assertok(memcmp(sha512_vectors[i].digest, digest,
+				   SHA512_SUM_LEN));
+		for (engine = 0; engine < SHA512_ENGINE_COUNT; engine++) {
+			if (!sha512_engine_supported(engine))
+				continue;
+			sha512_engine_csum(engine, msg, len, digest);
+			ut_assertok(memcmp(sha512_vectors[i].digest, digest,
+					   SHA512_SUM_LEN));
+		}
+	}
+
+	return 0;
+}
+SHA512_TEST(sha512_test_vectors, 0);
+
+/* All engines agree with the C rounds for every alignment and length */
+static int sha512_test_engines_agree(struct unit_test_state *uts)
+{
+	uint8_t expect[SHA512_SUM_LEN], digest[SHA512_SUM_LEN];
+	unsigned char buf[512];
+	int engine, ofs, len;
+
+	fill_pattern(buf, sizeof(buf));
+	for (ofs = 0; ofs < 8; ofs++) {
+		for (len = 0; len <= 300; len++) {
+			sha512_engine_csum(SHA512_ENGINE_C, buf + ofs, len,
+					   expect);
+			for (engine = 0; engine < SHA512_ENGINE_COUNT;
+			     engine++) {
+				sha512_engine_csum(engine, buf + ofs, len,
+						   digest);
+				ut_assertok(memcmp(expect, digest,
+						   SHA512_SUM_LEN));
+			}
+		}
+	}
+
+	return 0;
+}
+SHA512_TEST(sha512_test_engines_agree, 0);
+
+/* Data may arrive in pieces, and engines may be mixed on one context */
+static int sha512_test_incremental(struct unit_test_state *uts)
+{
+	uint8_t expect[SHA512_SUM_LEN], digest[SHA512_SUM_LEN];
+	unsigned char buf[1024];
+	sha512_context ctx;
+	int engine, split;
+
+	fill_pattern(buf, sizeof(buf));
+	sha512_engine_csum(SHA512_ENGINE_C, buf, sizeof(buf), expect);
+	for (engine = 0; engine < SHA512_ENGINE_COUNT; engine++) {
+		for (split = 0; split <= sizeof(buf); split += 37) {
+			sha512_starts(&ctx);
+			sha512_engine_update(SHA512_ENGINE_C, &ctx, buf, split);
+			sha512_engine_update(engine, &ctx, buf + split,
+					     sizeof(buf) - split);
+			sha512_finish(&ctx, digest);
+			ut_assertok(memcmp(expect, digest, SHA512_SUM_LEN));
+
+			sha512_starts(&ctx);
+			sha512_update(&ctx, buf, split);
+			sha512_update(&ctx, buf + split, sizeof(buf) - split);
+			sha512_finish(&ctx, digest);
+			ut_assertok(memcmp(expect, digest, SHA512_SUM_LEN));
+		}
+	}
+
+	return 0;
+}
+SHA512_TEST(sha512_test_incremental, 0);
+
+static void sha512_bench_print(const char *name, ulong us)
+{
+	printf("%12s: %lu KB/s\n", name,
+	       (ulong)((u64)SHA512_BENCH_LOOPS * SHA512_BENCH_SIZE * 1000000 /
+		       1024 / max(us, 1UL)));
+}
+
+/* Report the throughput of each supported engine, and of sha256 */
+static int sha512_test_benchmark(struct unit_test_state *uts)
+{
+	uint8_t digest[SHA512_SUM_LEN];
+	sha256_context ctx256;
+	sha512_context ctx;
+	unsigned char *buf;
+	ulong start;
+	int engine, i;
+
+	buf = malloc(SHA512_BENCH_SIZE);
+	ut_assertnonnull(buf);
+	fill_pattern(buf, SHA512_BENCH_SIZE);
+
+	for (engine = 0; engine < SHA512_ENGINE_COUNT; engine++) {
+		if (!sha512_engine_supported(engine)) {
+			printf("%12s: not available\n", engine_name[engine]);
+			continue;
+		}
+
+		sha512_starts(&ctx);
+		start = timer_get_us();
+		for (i = 0; i < SHA512_BENCH_LOOPS; i++)
+			sha512_engine_update(engine, &ctx, buf,
+					     SHA512_BENCH_SIZE);
+		sha512_finish(&ctx, digest);
+		sha512_bench_print(engine_name[engine], timer_get_us() - start);
+	}
+
+	/* The fastest sha256 engine, for comparison */
+	sha256_starts(&ctx256);
+	start = timer_get_us();
+	for (i = 0; i < SHA512_BENCH_LOOPS; i++)
+		sha256_update(&ctx256, buf, SHA512_BENCH_SIZE);
+	sha256_finish(&ctx256, digest);
+	sha512_bench_print("sha256", timer_get_us() - start);
+
+	free(buf);
+
+	return 0;
+}
+SHA512_TEST(sha512_test_benchmark, 0);
+
+int do_ut_sha512(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
+{
+	struct unit_test *tests = ll_entry_start(struct unit_test, sha512_test);
+	const int n_ents = ll_entry_count(struct unit_test, sha512_test);
+
+	return cmd_ut_category("sha512", tests, n_ents, argc, argv);
+}